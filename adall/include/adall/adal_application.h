@@ -4,15 +4,46 @@
 #include "adal_core.h"
 #include "adal_editor.h"
 #include "adal_pch.h"
+#include "adal_render_thread.h"
+#include "adal_sprite.h"
+#include "adal_system.h"
+
+/// @struct adlApplicationConfig
+/// @brief Start-up options of the application, set before the first adlApplication::getInstance() call.
+struct adlApplicationConfig {
+	bool          headless         = false;           ///< Run the simulation without a window or GL context, on a virtual clock.
+	bool          vsync            = true;            ///< Cap rendering to the display refresh instead of spinning.
+	double        fixedStep        = 1.0 / 60.0;      ///< Simulation step in seconds.
+	int           maxCatchUpSteps  = 5;               ///< Most simulation steps taken to catch up after a slow frame.
+	std::uint64_t maxFrames        = 0;               ///< Stop after this many frames, 0 runs until the window closes.
+	std::string   archivePath;                        ///< Packed asset archive to mount, empty to read loose files only.
+	std::string   programCachePath = "cache/program"; ///< Where linked shader binaries are kept, empty to always compile.
+	bool          renderThread     = false;           ///< Draw on a dedicated thread that owns the GL context. The editor is not drawn then.
+	bool          hotReload        = false;           ///< Reload loose shader and texture files when they change on disk.
+	std::string   scenePath;                          ///< Binary scene whose entities are loaded at start-up, empty for none.
+
+	/// @brief Reads --headless, --no-vsync, --step=<seconds>, --max-steps=<n>, --frames=<n>, --archive=<path>,
+	/// --program-cache=<directory>, --render-thread, --hot-reload and --scene=<path>.
+	/// @return False, after printing the usage, if a number is malformed or not above zero.
+	static bool fromArguments(int argc, char **argv, adlApplicationConfig &config);
+};
 
 class adlApplication {
 private:
+	static adlApplicationConfig s_config;
+
 	GLFWwindow *m_window;
 
 	std::unique_ptr<adlCore::adlRegistry> m_registry;
 
 	std::unique_ptr<adlEditor> m_editor;
 
+	std::unique_ptr<adlSystem::Renderer> m_renderer;     ///< Lives on whichever thread owns the GL context.
+	adlSpriteBatch                       m_batch;
+	adlRenderFrame                       m_frame;        ///< The frame being recorded; swapped with older frames on submit.
+	adlRenderThread                      m_renderThread;
+	adlSystem::SpriteRecorder            m_spriteRecorder;
+
 	bool m_running = true;
 
 	adlApplication();
@@ -25,6 +56,20 @@ private:
 
 	void makeGraphicsPipeline();
 
+	void renderFrame();
+
+	/// @brief Forwards the window's new framebuffer size to the camera system.
+	static void onFramebufferResize(GLFWwindow *window, int width, int height);
+
+	/// @brief Runs the asset reloads and uploads due this frame. GL thread only, while the simulation is held back.
+	void syncAssets();
+
+	/// @brief Sets the per-program uniforms of the programs a frame draws with. GL thread only, after syncAssets().
+	void setProgramUniforms(const std::vector<adlCore::adlShaderHandle> &shaders);
+
+	/// @brief Draws a recorded frame. GL thread only.
+	void drawFrame(adlRenderFrame &frame);
+
 public:
 	adlApplication(const adlApplication &) = delete;
 
@@ -32,7 +77,10 @@ public:
 
 	static adlApplication &getInstance();
 
-	virtual ~adlApplication() = default;
+	/// @brief Sets the start-up options. Has no effect once the instance exists.
+	static void configure(const adlApplicationConfig &config);
+
+	virtual ~adlApplication();
 
 	void run();
 };
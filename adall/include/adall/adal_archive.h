@@ -0,0 +1,144 @@
+#ifndef ADALGL_ARCHIVE_H
+#define ADALGL_ARCHIVE_H
+
+#include <span>
+#include <string_view>
+
+#include "adal_pch.h"
+
+// ###################################################################
+//                          adlArchiveFormat
+// -------------------------------------------------------------------
+// [header][entry data, 16-byte aligned][entry table][name strings]
+// The entry table is sorted by name hash so lookups binary search it
+// straight out of the mapped file.
+// ###################################################################
+enum struct adlArchiveEntryType : std::uint32_t {
+    BLOB = 0, TEXTURE_RGBA8, TEXTURE_ENCODED, SHADER_SOURCE, ATLAS_TABLE
+};
+
+struct adlArchiveHeader {
+    static constexpr std::uint32_t MAGIC   = 0x414C4441; // "ADLA"
+    static constexpr std::uint32_t VERSION = 1;
+
+    std::uint32_t magic, version;
+    std::uint32_t entryCount, reserved;
+    std::uint64_t entryTableOffset, stringTableOffset;
+};
+
+struct adlArchiveEntry {
+    std::uint64_t       nameHash;
+    std::uint32_t       nameOffset, nameLength;  ///< Into the string table.
+    std::uint64_t       dataOffset, dataSize;    ///< From the start of the archive.
+    adlArchiveEntryType type;
+    std::uint32_t       width, height;           ///< Texture entries only.
+    std::uint32_t       reserved;
+};
+
+static_assert(sizeof(adlArchiveHeader) == 32 && sizeof(adlArchiveEntry) == 48, "archive layout changed");
+
+/// FNV-1a, the hash used for archive entry names.
+///
+/// @param name The bytes to hash.
+/// @param hash A previous result to continue from, so several strings can be hashed as one.
+constexpr std::uint64_t adlHashName(const std::string_view name, std::uint64_t hash = 14695981039346656037ull) {
+    for (const char c: name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// ###################################################################
+//                          adlMappedFile
+// ###################################################################
+class adlMappedFile {
+private:
+    const std::byte       *m_data = nullptr;
+    std::size_t            m_size = 0;
+    std::vector<std::byte> m_fallback;  ///< File contents on platforms without mmap support here.
+
+public:
+    adlMappedFile() = default;
+
+    adlMappedFile(const adlMappedFile &) = delete;
+
+    adlMappedFile &operator=(const adlMappedFile &) = delete;
+
+    ~adlMappedFile() { close(); };
+
+    /// Maps a whole file read-only.
+    ///
+    /// @param path The path to the file.
+    /// @return True if the file was mapped, false otherwise.
+    bool open(const std::string &path);
+
+    /// Unmaps the file. Every span handed out before becomes dangling.
+    void close();
+
+    [[nodiscard]] inline std::span<const std::byte> bytes() const { return {m_data, m_size}; };
+};
+
+// ###################################################################
+//                          adlArchive
+// ###################################################################
+class adlArchive {
+private:
+    adlMappedFile                    m_file;
+    std::span<const adlArchiveEntry> m_entries;
+    std::string_view                 m_strings;
+
+public:
+    /// Maps an archive and validates its header and tables.
+    ///
+    /// @param archivePath The path to the archive written by adlArchiveWriter.
+    /// @return True if the archive is usable, false otherwise.
+    bool open(const std::string &archivePath);
+
+    /// Looks up an entry by the name it was packed under.
+    ///
+    /// @param name The entry name, usually the asset's relative path.
+    /// @return The entry, or nullptr if the archive does not contain it.
+    [[nodiscard]] const adlArchiveEntry *find(std::string_view name) const;
+
+    /// @return A view of the entry's bytes inside the mapped archive.
+    [[nodiscard]] std::span<const std::byte> data(const adlArchiveEntry &entry) const;
+
+    /// @return The entry's name inside the mapped archive.
+    [[nodiscard]] std::string_view name(const adlArchiveEntry &entry) const;
+
+    [[nodiscard]] inline std::span<const adlArchiveEntry> entries() const { return m_entries; };
+};
+
+// ###################################################################
+//                          adlArchiveWriter
+// ###################################################################
+class adlArchiveWriter {
+private:
+    struct PendingEntry {
+        std::string            name;
+        adlArchiveEntryType    type;
+        std::uint32_t          width, height;
+        std::vector<std::byte> data;
+    };
+
+    std::vector<PendingEntry>       m_entries;
+    std::unordered_set<std::string> m_names; ///< Of m_entries, so packing thousands of files stays linear.
+
+public:
+    /// Queues an entry. Names must be unique within an archive.
+    ///
+    /// @return False if the name is already queued.
+    bool add(const std::string &name, adlArchiveEntryType type, std::span<const std::byte> data
+           , std::uint32_t width = 0, std::uint32_t height = 0);
+
+    /// Writes every queued entry into a single archive file.
+    ///
+    /// @param archivePath The output path.
+    /// @return True if the archive was written completely.
+    bool write(const std::string &archivePath) const;
+
+    [[nodiscard]] inline std::size_t entryCount() const { return m_entries.size(); };
+};
+
+#endif //ADALGL_ARCHIVE_H
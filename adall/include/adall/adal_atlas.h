@@ -0,0 +1,147 @@
+#ifndef ADALGL_ATLAS_H
+#define ADALGL_ATLAS_H
+
+#include "adal_pch.h"
+#include "adal_view.h"
+
+// ###################################################################
+//                          adlRect
+// ###################################################################
+struct adlRect {
+    int x, y, width, height;
+};
+
+// ###################################################################
+//                          adlSkylinePacker
+// -------------------------------------------------------------------
+// Bottom-left skyline rectangle packer for a single page. Keeps the
+// top edge of the packed area as a list of horizontal segments and
+// places each rectangle where its top ends lowest.
+// ###################################################################
+class adlSkylinePacker {
+private:
+    struct Segment {
+        int x, y, width;
+    };
+
+    int                  m_width = 0, m_height = 0;
+    std::vector<Segment> m_skyline;
+    std::int64_t         m_usedArea = 0;
+
+    /// @return The y the rectangle would rest at on segment index, or -1 if it does not fit there.
+    [[nodiscard]] int fitAt(std::size_t index, int width, int height) const;
+
+public:
+    adlSkylinePacker() = default;
+
+    adlSkylinePacker(const int width, const int height) { reset(width, height); };
+
+    /// Empties the page.
+    void reset(int width, int height);
+
+    /// Places a rectangle.
+    ///
+    /// @param width The rectangle width.
+    /// @param height The rectangle height.
+    /// @param placed The placed rectangle will be stored here.
+    /// @return True if the rectangle fits on the page, false otherwise.
+    bool insert(int width, int height, adlRect &placed);
+
+    /// @return The fraction of the page covered by inserted rectangles.
+    [[nodiscard]] inline float occupancy() const {
+        return m_width * m_height > 0 ? static_cast<float>(m_usedArea) / static_cast<float>(m_width * m_height) : 0.f;
+    };
+};
+
+// ###################################################################
+//                          adlAtlasBuilder
+// -------------------------------------------------------------------
+// Packs many images into as few fixed-size pages as possible and
+// emits a UV rectangle per image. Packing only looks at sizes, so it
+// can run without pixels; compose() blits the pixels afterwards.
+// ###################################################################
+class adlAtlasBuilder {
+public:
+    struct Region {
+        std::string   name;
+        std::uint32_t page;
+        adlRect       rect;    ///< Pixel rectangle inside the page, padding excluded.
+        glm::vec4     uvRect;  ///< (u0, v0, u1, v1) inside the page.
+    };
+
+private:
+    struct Input {
+        std::string name;
+        int         width, height;
+        adlImage    image;
+    };
+
+    int m_pageWidth, m_pageHeight, m_padding;
+
+    std::vector<Input>                       m_inputs;
+    std::vector<Region>                      m_regions;
+    std::vector<adlSkylinePacker>            m_packers;
+    std::vector<std::vector<unsigned char> > m_pagePixels;
+
+public:
+    /// @param pageWidth Width of every atlas page.
+    /// @param pageHeight Height of every atlas page.
+    /// @param padding Empty pixels kept between neighbouring images to avoid filtering bleed.
+    explicit adlAtlasBuilder(int pageWidth = 2048, int pageHeight = 2048, int padding = 1);
+
+    /// Queues an image by size only, e.g. to plan a layout.
+    void add(const std::string &name, int width, int height);
+
+    /// Queues a decoded image. Its pixels are copied into a page by compose().
+    void add(const std::string &name, adlImage image);
+
+    /// Assigns every queued image a page and a rectangle, tallest first.
+    ///
+    /// @return False if an image is larger than a page.
+    bool pack();
+
+    /// Blits the queued pixels into RGBA8 pages. Call after pack().
+    void compose();
+
+    /// @return The fraction of the page area covered by images, padding excluded.
+    [[nodiscard]] float occupancy() const;
+
+    [[nodiscard]] inline const std::vector<Region> &regions() const { return m_regions; };
+
+    [[nodiscard]] inline std::size_t pageCount() const { return m_packers.size(); };
+
+    [[nodiscard]] inline int pageWidth() const { return m_pageWidth; };
+
+    [[nodiscard]] inline int pageHeight() const { return m_pageHeight; };
+
+    [[nodiscard]] inline const std::vector<unsigned char> &pagePixels(const std::size_t page) const { return m_pagePixels[page]; };
+};
+
+// ###################################################################
+//                          adlAtlasTable
+// -------------------------------------------------------------------
+// Serialized UV table stored next to the atlas pages in an archive:
+// [adlAtlasTableHeader][adlAtlasTableEntry * count][names]
+// Pages are stored as "<atlas>#<page>" TEXTURE_RGBA8 entries.
+// ###################################################################
+struct adlAtlasTableHeader {
+    static constexpr std::uint32_t MAGIC = 0x53544C41; // "ALTS"
+
+    std::uint32_t magic, entryCount, pageCount, reserved;
+};
+
+struct adlAtlasTableEntry {
+    std::uint32_t nameOffset, nameLength;
+    std::uint32_t page, reserved;
+    float         u0, v0, u1, v1;
+};
+
+struct adlAtlasTable {
+    /// Serializes the regions of a packed builder.
+    static std::vector<std::byte> write(const adlAtlasBuilder &builder);
+
+    /// Gets the archive entry name of an atlas page.
+    static std::string pageName(const std::string &atlasName, std::size_t page);
+};
+
+#endif //ADALGL_ATLAS_H
@@ -0,0 +1,104 @@
+#ifndef ADALGL_BATCH_H
+#define ADALGL_BATCH_H
+
+#include <functional>
+
+#include "adal_pch.h"
+#include "adal_view.h"
+
+// ###################################################################
+//                          adlSprite
+// ###################################################################
+struct adlSprite {
+    glm::vec2 position{0.f};                ///< Bottom-left corner in world units.
+    glm::vec2 size{1.f};                    ///< Width and height in world units.
+    glm::vec4 uvRect{0.f, 0.f, 1.f, 1.f};   ///< (u0, v0, u1, v1) texture rectangle.
+    float     rotation = 0.f;               ///< Rotation around the sprite center, in radians.
+    adlColor  color{.r = 255, .g = 255, .b = 255, .a = 255};
+    GLuint    textureID       = 0;
+    GLuint    shaderProgramID = 0;
+};
+
+// ###################################################################
+//                          adlDrawBatch
+// ###################################################################
+struct adlDrawBatch {
+    GLuint shaderProgramID, textureID;
+    GLuint firstQuad;   ///< Index of the first quad inside the batch vertex arena.
+    GLuint quadCount;   ///< Number of quads drawn by this batch.
+};
+
+/// Issues one run of a streamed batch. run.firstQuad counts from the quad at baseVertex.
+typedef std::function<void(const adlDrawBatch &run, GLint baseVertex)> adlStreamDraw;
+
+// ###################################################################
+//                          adlSpriteBatch
+// -------------------------------------------------------------------
+// GL-free batch builder: collects sprites between begin() and end(),
+// sorts them by shader and texture and expands them into one
+// contiguous adlVertex arena plus a draw list with one entry per
+// shader/texture run. The renderer only uploads and issues draws.
+// ###################################################################
+class adlSpriteBatch {
+private:
+    struct SortEntry {
+        std::uint64_t key;
+        std::uint32_t index;
+    };
+
+    std::vector<adlSprite>    m_sprites;
+    std::vector<SortEntry>    m_sortEntries;
+    std::vector<adlVertex>    m_vertices;
+    std::vector<adlDrawBatch> m_drawBatches;
+
+    std::size_t m_maxQuadsPerDraw;
+    bool        m_isBuilding = false;
+
+    static void writeQuad(const adlSprite &sprite, adlVertex *out);
+
+public:
+    /// Default quad capacity of a single draw call, matches the shared quad index buffer.
+    static constexpr std::size_t DEFAULT_MAX_QUADS = 16384;
+
+    /// @param maxQuadsPerDraw The largest run of quads a single draw may cover.
+    explicit adlSpriteBatch(std::size_t maxQuadsPerDraw = DEFAULT_MAX_QUADS);
+
+    /// Starts a new batch, discarding the output of the previous one.
+    ///
+    /// @param expectedSprites Capacity hint for the number of sprites submitted this frame.
+    void begin(std::size_t expectedSprites = 0);
+
+    /// Queues a sprite. Sprites sharing shader and texture keep their submission order.
+    void submit(const adlSprite &sprite);
+
+    /// Sorts the queued sprites and builds the vertex arena and draw list.
+    ///
+    /// @param sortByState False keeps submission order, for sprites that arrive already sorted,
+    ///                    e.g. from adlRenderQueue. Runs are then only merged where neighbours share state.
+    void end(bool sortByState = true);
+
+    [[nodiscard]] inline std::size_t spriteCount() const { return m_sprites.size(); };
+
+    [[nodiscard]] inline std::size_t maxQuadsPerDraw() const { return m_maxQuadsPerDraw; };
+
+    [[nodiscard]] inline const std::vector<adlVertex> &vertices() const { return m_vertices; };
+
+    [[nodiscard]] inline const std::vector<adlDrawBatch> &drawBatches() const { return m_drawBatches; };
+
+    /// Writes the vertex arena into a stream buffer and draws it. A batch larger than a frame
+    /// region is cut into region-sized pieces, each streamed into a region of its own and drawn
+    /// before the next one begins, so only the fence of an older region is ever waited on.
+    ///
+    /// @param stream The stream buffer, outside of a frame.
+    /// @param draw Called for every run of a piece, after the piece was flushed and while its region is current.
+    /// @return False if a region fence timed out or a region cannot hold a single quad. Pieces before it were drawn.
+    bool stream(adlStreamBuffer &stream, const adlStreamDraw &draw) const;
+
+    /// Builds the static index buffer shared by every batch (0, 1, 2, 2, 3, 0 per quad).
+    ///
+    /// @param quadCount The number of quads the index buffer must cover.
+    /// @return The quad indices, 6 per quad.
+    static std::vector<GLuint> makeQuadIndices(std::size_t quadCount);
+};
+
+#endif //ADALGL_BATCH_H
@@ -1,17 +1,91 @@
 #ifndef ADALLGL_COMPONENT_H
 #define ADALLGL_COMPONENT_H
 
+#include "entt/entt.hpp"
+
+#include "adal_handle.h"
 #include "adal_pch.h"
+#include "adal_string.h"
+#include "adal_view.h"
 
 namespace adlComponent {
+	/// @struct Name
+	/// @brief An entity's interned name; adlEntityManager indexes it for lookup.
+	struct Name {
+		adlStringID id = 0;
+	};
+
+	/// @struct Group
+	/// @brief The interned name of the group an entity belongs to. Members are also kept in a tag storage per group.
+	struct Group {
+		adlStringID id = 0;
+	};
+
+	/// @struct GroupMember
+	/// @brief Empty tag; each group has its own storage of it, named by adlCore::adlGroupStorageID().
+	struct GroupMember {
+	};
+
+	/// @struct Transform
+	/// @brief Placement of an entity relative to its Parent, or to the world for roots. Move entities through
+	/// registry.patch() or replace() so the hierarchy sees the change.
+	struct Transform {
+		glm::vec2 position{0.0f};
+		float     rotation = 0.0f; ///< Radians, counter-clockwise.
+		glm::vec2 scale{1.0f};
+	};
+
+	/// @struct WorldTransform
+	/// @brief World matrix of an entity, the product of its Transform and every ancestor's. Owned by the hierarchy
+	/// system, which adds it next to every Transform and announces new values through on_update.
+	struct WorldTransform {
+		glm::mat3 matrix{1.0f};
+	};
+
+	/// @struct Parent
+	/// @brief The entity a Transform is relative to. Change it through adlSystem::Hierarchy::setParent().
+	struct Parent {
+		entt::entity entity = entt::null;
+	};
+
+	/// @struct Children
+	/// @brief The entities parented to this one, kept by adlSystem::Hierarchy::setParent().
+	struct Children {
+		std::vector<entt::entity> entities;
+	};
+
+	/// @struct Bounds
+	/// @brief Local half extents of an entity's box, before its WorldTransform is applied.
+	struct Bounds {
+		glm::vec2 halfExtents{0.5f};
+	};
+
 	struct Camera {
-		int width;
-		int height;
-		float scale;
+		int width = 0;
+		int height = 0;
+		float scale = 1.0f;
+
+		glm::vec2 position{0.0f};
+		glm::mat4 cameraMatrix{1.0f};
+		glm::mat4 orthorProjection{1.0f};
+	};
+
+	/// @struct Sprite
+	/// @brief Draws an entity's Bounds box, placed by its WorldTransform, with a texture region through a shader.
+	/// adlSystem::SpriteRecorder records the sprites the main camera sees each frame.
+	struct Sprite {
+		adlCore::adlHandle<adlTexture> texture;
+		adlCore::adlHandle<adlShader>  shader;
+		glm::vec4                      uvRect{0.0f, 0.0f, 1.0f, 1.0f}; ///< (u0, v0, u1, v1), as adlTextureRegion gives it.
+		adlColor                       color{.r = 255, .g = 255, .b = 255, .a = 255};
+		std::uint8_t                   layer = 0;    ///< Lower layers are drawn first.
+		float                          depth = 0.0f; ///< Order inside a layer and state, 0 first to 1 last.
+	};
 
-		glm::vec2 position;
-		glm::mat4 cameraMatrix;
-		glm::mat4 orthorProjection;
+	/// @struct Visibility
+	/// @brief What a camera sees, refilled every step by the culling system. Add it next to Camera before the scheduler runs.
+	struct Visibility {
+		std::vector<entt::entity> entities; ///< In storage order of the WorldTransform pool, which the culling pass gathers its bounds SoA in.
 	};
 
 }
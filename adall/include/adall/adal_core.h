@@ -1,11 +1,22 @@
 #ifndef ADAL_CORE_H
 #define ADAL_CORE_H
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
 #include <utility>
 
 #include "entt/entt.hpp"
 
 #include "adal_pch.h"
+#include "adal_atlas.h"
+#include "adal_component.h"
+#include "adal_file_watcher.h"
+#include "adal_handle.h"
 #include "adal_view.h"
 
 namespace adlCore {
@@ -19,14 +30,23 @@ namespace adlCore {
 	private:
 		std::unique_ptr<entt::registry> m_registry; ///< Pointer to the underlying entt::registry instance.
 
+		std::vector<void (*)(entt::registry &)> m_contextErasers; ///< One per added context, in the order they were added.
+
 	public:
 		/// @brief Constructs an adlRegistry instance.
 		adlRegistry() {
 			m_registry = std::make_unique<entt::registry>();
 		};
 
-		/// @brief @brief Default destructor.
-		~adlRegistry() = default;
+		/// @brief Erases the contexts newest first, then destroys the registry.
+		///
+		/// entt destroys its context after its pools, and systems kept as contexts disconnect from those pools
+		/// when they go, so they have to go while the pools are still there.
+		~adlRegistry() {
+			for (auto itr = m_contextErasers.rbegin(); itr != m_contextErasers.rend(); ++itr) {
+				(*itr)(*m_registry);
+			}
+		};
 
 		/// @brief Gets a reference to the underlying entt::registry.
 		/// @return A reference to the entt::registry.
@@ -42,12 +62,36 @@ namespace adlCore {
 			return m_registry->destroy(entity);
 		};
 
+		/// @brief Creates one entity per element of [first, last) in a single pass.
+		template<typename TIterator>
+		void makeEntities(TIterator first, TIterator last) const {
+			m_registry->create(first, last);
+		}
+
+		/// @brief Destroys every entity of [first, last), storage by storage rather than entity by entity.
+		template<typename TIterator>
+		void destroyEntities(TIterator first, TIterator last) const {
+			m_registry->destroy(first, last);
+		}
+
+		/// @brief Grows a component storage so the next count components land without reallocating.
+		template<typename TComponent>
+		void reserve(const std::size_t count) const {
+			auto &storage = m_registry->storage<TComponent>();
+			storage.reserve(storage.size() + count);
+		}
+
 		/// @brief Adds a context to the registry.
     	/// @tparam TContext The type of the context.
     	/// @param context The context instance to add.
     	/// @return The added context instance.
 		template<typename TContext>
 		TContext adlAddContext(TContext context) {
+			if (!m_registry->ctx().contains<TContext>()) {
+				m_contextErasers.push_back([](entt::registry &registry) {
+					registry.ctx().erase<TContext>();
+				});
+			}
 			return m_registry->ctx().emplace<TContext>(context);
 		}
 
@@ -63,112 +107,417 @@ namespace adlCore {
 	// ###################################################################
 	//							  adlEntity
 	// ###################################################################
-	class adlEntityManager;
 
-	class adlEntity {
-		friend adlEntityManager;
+	/// @brief Gets the storage that tags the members of a group.
+	///
+	/// Odd multipliers are bijective on 32 bits, so two groups never share a storage.
+	inline entt::id_type adlGroupStorageID(const adlStringID group) {
+		return entt::type_hash<adlComponent::GroupMember>::value() + 0x9E3779B9u * group;
+	}
 
+	/// @class adlEntity
+	/// @brief A trivially copyable handle to an entity. Its name and group live in the registry as components.
+	class adlEntity {
 	private:
-		adlRegistry &m_registry;
-		entt::entity m_entity;
-		std::string  m_name, m_group;
+		adlRegistry *m_registry = nullptr;
+		entt::entity m_entity   = entt::null;
 
 	public:
-		adlEntity(adlRegistry &registry, entt::entity entity, std::string name, const std::string &group);;
+		adlEntity() = default;
+
+		adlEntity(adlRegistry &registry, const entt::entity entity)
+			: m_registry(&registry),
+			  m_entity(entity) {
+		};
 
-		inline entt::entity &getEntity() { return m_entity; };
+		inline entt::entity getEntity() const { return m_entity; };
 
-		inline const std::string &name() { return m_name; };
-		inline const std::string &group() { return m_group; };
+		/// @brief Checks that the handle refers to a live entity.
+		[[nodiscard]] inline bool isValid() const {
+			return m_registry != nullptr && m_registry->getRegistry().valid(m_entity);
+		};
+
+		/// @return The name, or an empty view if the entity has none.
+		[[nodiscard]] std::string_view name() const;
+
+		/// @return The group, or an empty view if the entity is in none.
+		[[nodiscard]] std::string_view group() const;
 
-		inline void setName(const std::string &name) { m_name = name; };
-		inline void setGroup(const std::string &group) { m_group = group; };
+		/// @brief Names the entity; an empty name removes it. The manager's name index follows.
+		void setName(std::string_view name) const;
+
+		/// @brief Moves the entity to a group; an empty group removes it from its group.
+		void setGroup(std::string_view group) const;
 
 		template<typename TComponent, typename... Args>
-		TComponent &addComponent(Args &&... args) {
-			return m_registry.getRegistry().emplace<TComponent>(m_entity, std::forward<Args>(args)...);
+		TComponent &addComponent(Args &&... args) const {
+			return m_registry->getRegistry().emplace<TComponent>(m_entity, std::forward<Args>(args)...);
 		}
 
 		template<typename TComponent>
 		[[nodiscard]] bool adlHasComponent() const {
-			if (m_registry.getRegistry().all_of<TComponent>(m_entity)) {
-				return true;
-			}
-
-			return false;
+			return m_registry->getRegistry().all_of<TComponent>(m_entity);
 		}
 
 		template<typename TComponent, typename... Args>
-		TComponent &adlReplaceComponent(Args &&... args) {
-			if (adlHasComponent<TComponent>()) {
-				return m_registry.getRegistry().replace<TComponent>(std::forward<Args>(args)...);
-			}
-			return nullptr;
+		TComponent &adlReplaceComponent(Args &&... args) const {
+			return m_registry->getRegistry().replace<TComponent>(m_entity, std::forward<Args>(args)...);
 		}
 
+		/// @brief Gets a component the entity is known to have.
 		template<typename TComponent>
-		TComponent &adlGetComponent() {
-			if (adlHasComponent<TComponent>()) {
-				return m_registry.getRegistry().get<TComponent>(m_entity);
-			}
-			return nullptr;
+		TComponent &adlGetComponent() const {
+			return m_registry->getRegistry().get<TComponent>(m_entity);
+		}
+
+		template<typename TComponent>
+		void adlRemoveComponent() const {
+			m_registry->getRegistry().remove<TComponent>(m_entity);
 		}
+	};
+
+	static_assert(std::is_trivially_copyable_v<adlEntity>, "entity handles are passed around by value");
+
+	// ###################################################################
+	//							  adlPrefab
+	// ###################################################################
+
+	/// @class adlPrefab
+	/// @brief A component set stamped onto many entities at once.
+	///
+	/// Instantiating reserves each component storage once and fills it with entt's range insert, so spawning
+	/// n entities costs one growth per storage instead of one lookup and emplace per entity and component.
+	class adlPrefab {
+	private:
+		typedef std::function<void(entt::registry &, std::span<const entt::entity>)> Inserter;
 
+		std::vector<std::pair<entt::id_type, Inserter> > m_inserters; ///< One per component type.
+		adlStringID                                      m_group = 0;
+
+	public:
+		/// @brief Adds a component every instance gets a copy of. Adding a type again replaces its value.
 		template<typename TComponent>
-		void adlRemoveComponent(entt::entity &entity) const {
-			if (adlHasComponent<TComponent>(entity)) {
-				m_registry.getRegistry().remove<TComponent>(entity);
+		adlPrefab &with(TComponent component) {
+			Inserter inserter = [component = std::move(component)](entt::registry &registry, const std::span<const entt::entity> entities) {
+				// growing to the exact size would reallocate on every single-entity instantiate
+				auto             &storage = registry.storage<TComponent>();
+				const std::size_t needed  = storage.size() + entities.size();
+				if (needed > storage.capacity()) {
+					storage.reserve(std::max(needed, storage.capacity() * 2));
+				}
+				registry.insert<TComponent>(entities.begin(), entities.end(), component);
+			};
+
+			const entt::id_type type = entt::type_hash<TComponent>::value();
+			const auto          it   = std::find_if(m_inserters.begin(), m_inserters.end(), [type](const auto &entry) {
+				return entry.first == type;
+			});
+			if (it != m_inserters.end()) {
+				it->second = std::move(inserter);
 			}
+			else {
+				m_inserters.emplace_back(type, std::move(inserter));
+			}
+			return *this;
 		}
+
+		/// @brief Puts every instance in a group.
+		adlPrefab &inGroup(std::string_view group);
+
+		/// @brief Adds the prefab's components to entities that have none of them yet.
+		void instantiate(entt::registry &registry, std::span<const entt::entity> entities) const;
 	};
 
 	// ###################################################################
 	//							  adlEntityManager
 	// ###################################################################
+
+	/// @class adlEntityManager
+	/// @brief Creates entities and finds them by name in O(1) and by group in O(group size).
+	///
+	/// The name index follows the Name component through registry signals, so entities renamed or destroyed
+	/// behind the manager's back are still found correctly. A name belongs to the entity it was given to last.
 	class adlEntityManager {
 	private:
 		adlRegistry &m_registry;
 
+		std::vector<entt::entity> m_names; ///< Entity by name id; interned ids are dense, so this needs no hashing.
+
+		void onNameSet(entt::registry &registry, entt::entity entity);
+
+		void onNameRemoved(entt::registry &registry, entt::entity entity);
+
 	public:
-		explicit adlEntityManager(adlRegistry &registry)
-			: m_registry(registry) {
-		};
+		explicit adlEntityManager(adlRegistry &registry);
 
-		~adlEntityManager() = default;
+		adlEntityManager(const adlEntityManager &) = delete;
 
-		[[nodiscard]] adlEntity makeEntity(const std::string &name = "", const std::string &group = "") const {
-			return {m_registry, m_registry.makeEntity(), name, group};
-		};
+		adlEntityManager &operator=(const adlEntityManager &) = delete;
+
+		~adlEntityManager();
+
+		[[nodiscard]] adlEntity makeEntity(std::string_view name = {}, std::string_view group = {}) const;
+
+		/// @brief Creates a named entity from a prefab.
+		[[nodiscard]] adlEntity makeEntity(const adlPrefab &prefab, std::string_view name = {}) const;
+
+		/// @brief Creates entities.size() unnamed entities in one pass.
+		/// @param entities Receives the new entities.
+		/// @param group The group of every new entity, empty for none.
+		void makeEntities(std::span<entt::entity> entities, std::string_view group = {}) const;
+
+		/// @brief Creates entities.size() unnamed entities and stamps a prefab onto all of them.
+		/// @param entities Receives the new entities.
+		void makeEntities(std::span<entt::entity> entities, const adlPrefab &prefab) const;
+
+		/// @brief Destroys an entity and invalidates the handle.
+		/// @return The version the entity's identifier will be recycled with.
+		std::uint32_t killEntity(adlEntity &entity) const;
 
-		std::uint32_t killEntity(adlEntity &entity);
+		/// @brief Destroys many entities at once. Entities that are already gone are skipped, and one listed twice is destroyed once.
+		void killEntities(std::span<const entt::entity> entities) const;
+
+		/// @brief Finds an entity by name.
+		/// @return The entity, or an invalid handle if no live entity has the name.
+		[[nodiscard]] adlEntity findEntity(std::string_view name) const;
+
+		/// @brief Gets the number of entities in a group.
+		[[nodiscard]] std::size_t groupSize(std::string_view group) const;
+
+		/// @brief Calls function(adlEntity) for every member of a group. Members must not join or leave the group meanwhile.
+		template<typename TFunction>
+		void forEachInGroup(const std::string_view group, TFunction &&function) const {
+			const adlStringID id = adlStringInterner::global().find(group);
+			if (id == 0) {
+				return;
+			}
+
+			const auto *members = std::as_const(m_registry.getRegistry()).storage(adlGroupStorageID(id));
+			if (members == nullptr) {
+				return;
+			}
+
+			for (const auto entity: *members) {
+				function(adlEntity{m_registry, entity});
+			}
+		}
 	};
 
 
 	// ###################################################################
 	//							  adlAssetManager
 	// ###################################################################
-	typedef std::unordered_map<std::string, std::shared_ptr<adlTexture> > adlTextureMap;
-	typedef std::unordered_map<std::string, std::shared_ptr<adlShader> >  adlShaderMap;
+	typedef adlHandle<adlTexture> adlTextureHandle;
+	typedef adlHandle<adlShader>  adlShaderHandle;
+
+	/// @brief Creates the GL texture for decoded pixels. Swappable so decoding can run without a GL context.
+	typedef std::function<GLuint(const adlImage &image, bool isPixelated)> adlTextureUploader;
+
+	/// @brief Destroys a GL texture created by the matching adlTextureUploader.
+	typedef std::function<void(GLuint textureID)> adlTextureReleaser;
+
+	/// @struct adlTextureRegion
+	/// @brief What a sprite samples: a texture and the (u0, v0, u1, v1) part of it.
+	///
+	/// Loose textures cover the whole texture, atlas sprites a part of their page.
+	struct adlTextureRegion {
+		adlTextureHandle texture;
+		glm::vec4        uvRect;
+	};
 
 	class adlAssetManager {
 	private:
-		adlTextureMap m_textureMap;
-		adlShaderMap  m_shaderMap;
+		struct DecodeRequest {
+			adlTextureHandle texture;
+			std::string      texturePath;
+			bool             isPixelated;
+		};
 
-	public:
-		adlAssetManager() = default;
+		struct PendingUpload {
+			adlTextureHandle texture;
+			adlImage         image;
+			bool             isPixelated;
+		};
+
+		struct ShaderProgram {
+			std::string                                        vertShaderPath, fragShaderPath;
+			std::unordered_map<std::uint64_t, adlShaderHandle> variants; ///< Compiled permutations only.
+		};
+
+		struct TextureSource {
+			adlTextureHandle texture;
+			std::string      texturePath;
+			bool             isPixelated;
+		};
+
+		// handles are resolved from names once, every later access is an indexed load
+		adlSlotMap<adlTexture> m_textures;
+		adlSlotMap<adlShader>  m_shaders;
+
+		std::unordered_map<std::string, adlTextureHandle> m_textureNames;
+		std::unordered_map<std::string, adlTextureRegion> m_atlasRegions; ///< Sprites packed into atlas pages, by sprite name.
+		std::unordered_map<std::string, ShaderProgram>    m_shaderPrograms;
+
+		std::unique_ptr<adlArchive>      m_archive;      ///< Mounted archive, consulted before the file system.
+		std::unique_ptr<adlProgramCache> m_programCache; ///< Linked program binaries from earlier runs.
 
-		~adlAssetManager() = default;
+		adlShaderPreprocessor m_preprocessor{[this](const std::string &path, std::string &source) {
+			return adlShaderLoader::readShaderSource(path, m_archive.get(), source);
+		}};
 
-		bool makeTexture(const std::string &name, const std::string &texturePath, bool isPixelated = true);
+		adlTextureUploader m_uploader = adlTextureLoader::uploadImage;
+		adlTextureReleaser m_releaser = [](const GLuint textureID) { glDeleteTextures(1, &textureID); };
 
-		bool makeShader(const std::string &name
-		              , const std::string &vertShaderPath
-		              , const std::string &fragShaderPath);
+		// decode side: loader threads pull requests and push decoded images to the upload queue
+		std::vector<std::thread>  m_decodeThreads;
+		std::deque<DecodeRequest> m_decodeQueue;
+		std::mutex                m_decodeMutex;
+		std::condition_variable   m_decodeCondition;
+		bool                      m_isStopping = false;
 
-		const adlTexture &getTexture(const std::string &name);
+		std::deque<PendingUpload> m_uploadQueue;
+		std::mutex                m_uploadMutex;
+		std::atomic<std::size_t>  m_pendingTextures{0};
+
+		// hot reload: what to rebuild when a loose source file changes, by normalized path
+		std::unique_ptr<adlFileWatcher>                              m_watcher;
+		std::unordered_map<std::string, std::vector<TextureSource> > m_textureSources;
+		std::vector<std::string>                                     m_staleShaders; ///< Programs to recompile, by name, oldest first.
+		std::vector<std::string>                                     m_changes;
+
+		// GL objects a reload replaced, released a call later: a frame recorded before the reload may still draw with them
+		std::vector<GLuint> m_retiredPrograms, m_retiredTextures;
+
+		void decodeLoop();
+
+		void queueDecode(const adlTextureHandle &texture, const std::string &texturePath, bool isPixelated);
+
+		/// @brief Watches a source file for hot reload, unless it is read from the mounted archive.
+		void watchSource(const std::string &path);
+
+		void watchShaderSources(const ShaderProgram &program);
+
+		/// @brief Recompiles every compiled variant of a program and swaps each in under its old handle.
+		void reloadShader(const std::string &name, ShaderProgram &program);
+
+	public:
+		/// @brief Constructs the asset manager and its loader threads.
+		/// @param decodeThreadCount Number of threads decoding images for makeTextureAsync().
+		explicit adlAssetManager(std::size_t decodeThreadCount = std::max(1u, std::thread::hardware_concurrency() / 2));
+
+		/// @brief Stops the loader threads. Images still queued for decoding are dropped.
+		~adlAssetManager();
+
+		/// @brief Mounts a packed asset archive. Asset paths found in it are read from the mapping instead of loose files.
+		///
+		/// Mount before loading assets; only one archive can be mounted and it stays mounted.
+		/// @param archivePath The path to an archive written by adall_pack.
+		/// @return True if the archive was mapped and validated.
+		bool mountArchive(const std::string &archivePath);
+
+		/// @brief Loads a texture on the calling (GL) thread.
+		/// @return The texture handle, or an invalid handle if the name is taken or loading failed.
+		adlTextureHandle makeTexture(const std::string &name, const std::string &texturePath, bool isPixelated = true);
+
+		/// @brief Queues a texture for decoding on a loader thread and returns at once.
+		///
+		/// The texture has a textureID of 0 until processUploads() has created it on the GL thread.
+		/// @return The texture handle, or an invalid handle if the name is already taken.
+		adlTextureHandle makeTextureAsync(const std::string &name, const std::string &texturePath, bool isPixelated = true);
+
+		/// @brief Creates GL textures for decoded images. Call once per frame on the GL thread.
+		///
+		/// A reloaded texture's old GL texture is released by the next call, as draws recorded before the upload
+		/// still name it.
+		/// @param byteBudget Pixel bytes to upload this call. At least one image is uploaded if any is ready.
+		/// @return The number of textures uploaded.
+		std::size_t processUploads(std::size_t byteBudget = 16 * 1024 * 1024);
+
+		/// @brief Replaces the GL upload and release stages, e.g. with stubs for headless runs.
+		inline void setTextureUploader(adlTextureUploader uploader, adlTextureReleaser releaser = [](GLuint) {}) {
+			m_uploader = std::move(uploader);
+			m_releaser = std::move(releaser);
+		};
 
-		adlShader &getShader(const std::string &name);
+		/// @brief Starts watching the loose files behind every texture and shader, loaded so far and later.
+		///
+		/// Changed files are reloaded by processReloads() under the handles they already have. Files read from
+		/// the mounted archive are not watched.
+		/// @param debounce How long a file has to stay unchanged before it is reloaded.
+		/// @return False if files cannot be watched on this platform.
+		bool watchAssets(std::chrono::milliseconds debounce = std::chrono::milliseconds(100));
+
+		/// @brief Queues changed textures for decoding and recompiles changed shaders. Call once per frame on the GL thread.
+		///
+		/// Never waits for the file watcher. Reloaded textures reach the GPU through processUploads(), so call
+		/// this first. A shader that fails to compile keeps its last good program. Programs replaced by the
+		/// previous call are deleted now, as draws recorded before a reload still name them.
+		/// @param shaderBudget Programs to recompile this call; the rest wait for later calls.
+		/// @return The number of programs recompiled.
+		std::size_t processReloads(std::size_t shaderBudget = 1);
+
+		/// @brief Gets the number of async textures not yet uploaded.
+		[[nodiscard]] inline std::size_t pendingTextureCount() const { return m_pendingTextures.load(); };
+
+		/// @brief Loads an atlas packed by adall_pack --atlas from the mounted archive.
+		///
+		/// Every page becomes a texture named "<atlasName>#<page>" and every packed image becomes a sprite
+		/// that resolveTexture() maps to its page and UV rectangle.
+		/// @return True if the atlas table and all of its pages were loaded.
+		bool loadAtlas(const std::string &atlasName, bool isPixelated = true);
+
+		/// @brief Resolves a texture or atlas sprite name. Do this once and keep the result.
+		///
+		/// Loose textures cover {0, 0, 1, 1}, atlas sprites their part of the page.
+		/// Unknown names give an invalid handle.
+		[[nodiscard]] adlTextureRegion resolveTexture(const std::string &name) const;
+
+		/// @brief Gets a texture by handle.
+		/// @return The texture, or nullptr if the handle is stale. Valid until the next texture is made or unloaded.
+		[[nodiscard]] inline const adlTexture *getTexture(const adlTextureHandle handle) const { return m_textures.get(handle); };
+
+		/// @brief Keeps a texture loaded until a matching releaseTexture(). Textures nobody retains live until unloadTexture().
+		inline bool retainTexture(const adlTextureHandle handle) { return m_textures.retain(handle); };
+
+		/// @brief Drops a reference added by retainTexture() and unloads the texture when it was the last one.
+		void releaseTexture(adlTextureHandle handle);
+
+		/// @brief Destroys a texture and frees its name. Every handle to it goes stale.
+		bool unloadTexture(adlTextureHandle handle);
+
+		/// @brief Opens an on-disk cache of linked program binaries used by every later makeShader().
+		///
+		/// Needs a current GL context, the driver identity is part of every cache key.
+		/// @param directory Where the binaries are kept. Created if missing.
+		/// @return True if the cache directory is usable.
+		bool openProgramCache(const std::string &directory);
+
+		/// @brief Registers a shader program and compiles its base variant, the one without features.
+		/// @return The base variant's handle, or an invalid handle if the name is taken or compiling failed.
+		adlShaderHandle makeShader(const std::string &name
+		                         , const std::string &vertShaderPath
+		                         , const std::string &fragShaderPath);
+
+		/// @brief Gets the permutation bit of a shader feature, see adlShaderPreprocessor::feature().
+		inline std::uint64_t shaderFeature(const std::string &featureName) { return m_preprocessor.feature(featureName); };
+
+		/// @brief Resolves a variant of a registered shader, compiling it the first time it is asked for.
+		///
+		/// Do this once per variant and keep the handle.
+		/// @param name The name given to makeShader().
+		/// @param permutation Bits from shaderFeature().
+		/// @return The variant's handle, or an invalid handle if the shader is unknown or the variant failed to compile.
+		adlShaderHandle resolveShader(const std::string &name, std::uint64_t permutation = 0);
+
+		/// @brief Gets a shader by handle.
+		///
+		/// Read the program through the handle each frame; a hot reload replaces it.
+		/// @return The shader, or nullptr if the handle is stale.
+		[[nodiscard]] inline adlShader *getShader(const adlShaderHandle handle) { return m_shaders.get(handle); };
+
+		[[nodiscard]] inline std::size_t textureCount() const { return m_textures.size(); };
+
+		[[nodiscard]] inline std::size_t shaderCount() const { return m_shaders.size(); };
 	};
 }
 
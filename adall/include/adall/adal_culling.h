@@ -0,0 +1,88 @@
+#ifndef ADAL_CULLING_H
+#define ADAL_CULLING_H
+
+#include "entt/entt.hpp"
+
+#include "adal_component.h"
+#include "adal_core.h"
+#include "adal_pch.h"
+#include "adal_scheduler.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ADL_CULLING_SSE2 1
+#else
+#define ADL_CULLING_SSE2 0
+#endif
+
+namespace adlSystem {
+	// ###################################################################
+	//							  BoundsSoA
+	// ###################################################################
+
+	/// @struct BoundsSoA
+	/// @brief World boxes laid out one array per edge, so one SIMD load covers the same edge of LANES boxes.
+	///
+	/// The arrays are padded to a whole number of lanes with boxes that never overlap anything.
+	struct BoundsSoA {
+		static constexpr std::size_t LANES = 4;
+
+		std::vector<float>        minX, minY, maxX, maxY;
+		std::vector<entt::entity> entities;
+
+		/// @brief Resizes every array to count rounded up to LANES. New and padding boxes are empty.
+		void resize(std::size_t count);
+
+		/// @brief Marks a box as never visible, e.g. for an entity without Bounds.
+		inline void clear(const std::size_t index) {
+			minX[index] = minY[index] = std::numeric_limits<float>::infinity();
+			maxX[index] = maxY[index] = -std::numeric_limits<float>::infinity();
+		}
+
+		[[nodiscard]] inline std::size_t size() const { return entities.size(); };
+	};
+
+	// ###################################################################
+	//							  Culling
+	// ###################################################################
+
+	/// @class Culling
+	/// @brief Fills every camera's Visibility with the entities whose box overlaps its view rect.
+	///
+	/// Each step the world boxes are gathered into a BoundsSoA once, in parallel, and every camera then tests
+	/// them LANES at a time, one chunk per job; the chunks' survivors are joined in order.
+	class Culling {
+	public:
+		using adlAccess = adlCore::adlSystemSignature<
+			adlCore::adlReads<adlComponent::Camera, adlComponent::WorldTransform, adlComponent::Bounds>,
+			adlCore::adlWrites<adlComponent::Visibility> >;
+
+	private:
+		BoundsSoA                               m_bounds;
+		std::vector<std::vector<entt::entity> > m_chunkVisible; ///< Survivors per chunk, kept for their capacity.
+
+		void gather(entt::registry &registry, adlCore::adlJobSystem &jobSystem);
+
+	public:
+		/// @brief Culls for every entity holding a Camera and a Visibility.
+		void update(adlCore::adlRegistry &registry);
+
+		/// @brief Gets the world rect a camera sees, from its position, size and scale.
+		/// @return False if the camera has no area.
+		static bool viewRect(const adlComponent::Camera &camera, glm::vec2 &min, glm::vec2 &max);
+
+		/// @brief Appends the entities of [first, last) whose box overlaps [viewMin, viewMax].
+		/// @param first First box, a multiple of BoundsSoA::LANES.
+		/// @param last One past the last box, a multiple of BoundsSoA::LANES.
+		static void cull(const BoundsSoA &bounds, std::size_t first, std::size_t last, const glm::vec2 &viewMin, const glm::vec2 &viewMax,
+		                 std::vector<entt::entity> &out);
+
+		/// @brief cull() one box at a time; what cull() runs where SSE2 is missing.
+		static void cullScalar(const BoundsSoA &bounds, std::size_t first, std::size_t last, const glm::vec2 &viewMin, const glm::vec2 &viewMax,
+		                       std::vector<entt::entity> &out);
+
+		/// @brief Gets the boxes gathered by the last update.
+		[[nodiscard]] inline const BoundsSoA &bounds() const { return m_bounds; };
+	};
+}
+
+#endif //ADAL_CULLING_H
@@ -4,18 +4,28 @@
 #include <imgui.h>
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_opengl3.h>
+#include "adal_core.h"
 #include "adal_pch.h"
 
 class adlEditor {
 private:
 	GLFWwindow* m_window;
+	std::string m_traceStatus; ///< Outcome of the last trace export, shown under the capture button.
+
+	void drawMemoryPanel(adlCore::adlRegistry &registry);
+
+	void drawProfilerPanel();
+
+	/// @brief Draws the last frame's zones, one band per thread, nested zones stacked below their parent.
+	void drawTimeline();
 
 public:
 	explicit adlEditor(GLFWwindow* window);
 	~adlEditor();
 
 	bool init();
-	void render();
+	/// @brief Draws the editor; panels read the engine state from the registry's contexts.
+	void render(adlCore::adlRegistry &registry);
 	void update();
 };
 
@@ -6,6 +6,12 @@
 extern adlApplication& adlMakeApplication();
 
 int main(int argc, char** argv) {
+    adlApplicationConfig config;
+    if (!adlApplicationConfig::fromArguments(argc, argv, config)) {
+        return 1;
+    }
+    adlApplication::configure(config);
+
     auto& application = adlMakeApplication();
     application.run();
 
@@ -0,0 +1,70 @@
+#ifndef ADAL_FILE_WATCHER_H
+#define ADAL_FILE_WATCHER_H
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "adal_pch.h"
+
+namespace adlCore {
+	// ###################################################################
+	//							  adlFileWatcher
+	// ###################################################################
+
+	/// @class adlFileWatcher
+	/// @brief Reports watched files that changed on disk, each once it has been quiet for a debounce interval.
+	///
+	/// Watches the files' directories rather than the files, since editors often save by renaming a new file over
+	/// the old one, which a watch on the old file would never see. A thread reads the inotify events and holds each
+	/// path back until no event for it arrived for the debounce interval, so a save made of several writes is
+	/// reported once. takeChanges() never waits for that thread.
+	///
+	/// Linux only; elsewhere watch() fails and nothing is ever reported.
+	class adlFileWatcher {
+	private:
+		typedef std::chrono::steady_clock Clock;
+
+		int                       m_inotify = -1;
+		int                       m_wake    = -1; ///< Event fd that stops the thread.
+		std::chrono::milliseconds m_debounce;
+		std::thread               m_thread;
+
+		std::mutex                           m_mutex;       ///< Guards everything below but m_settling.
+		std::unordered_map<int, std::string> m_directories; ///< Watched directory by watch descriptor.
+		std::unordered_set<std::string>      m_files;
+		std::vector<std::string>             m_changes;     ///< Settled changes not yet taken.
+
+		std::unordered_map<std::string, Clock::time_point> m_settling; ///< Time of each path's last event. Watcher thread only.
+
+		void watchLoop();
+
+		/// @brief Reads every queued inotify event into m_settling.
+		void readEvents();
+
+	public:
+		/// @param debounce How long a file has to stay unchanged before its change is reported.
+		explicit adlFileWatcher(std::chrono::milliseconds debounce = std::chrono::milliseconds(100));
+
+		adlFileWatcher(const adlFileWatcher &) = delete;
+
+		adlFileWatcher &operator=(const adlFileWatcher &) = delete;
+
+		~adlFileWatcher();
+
+		/// @brief Gets the form paths are reported in: lexically normal, with forward slashes.
+		static std::string normalize(const std::string &path);
+
+		/// @brief Starts reporting changes to a file. The file does not have to exist yet, its directory does.
+		/// @return False if the directory cannot be watched or there is no inotify.
+		bool watch(const std::string &path);
+
+		/// @brief Moves the settled changes, normalized and oldest first, to the end of changes.
+		/// @return False if there were none, or the watcher thread held the lock; those are reported next call.
+		bool takeChanges(std::vector<std::string> &changes);
+
+		[[nodiscard]] inline bool isRunning() const { return m_thread.joinable(); };
+	};
+}
+
+#endif //ADAL_FILE_WATCHER_H
@@ -0,0 +1,169 @@
+#ifndef ADAL_HANDLE_H
+#define ADAL_HANDLE_H
+
+#include <span>
+
+#include "adal_pch.h"
+
+namespace adlCore {
+	// ###################################################################
+	//							  adlHandle
+	// ###################################################################
+
+	/// @struct adlHandle
+	/// @brief A 32-bit reference into an adlSlotMap: 20 bits of slot index and 12 bits of generation.
+	///
+	/// A handle goes stale once its slot is reused; lookups through a stale handle fail instead of aliasing.
+	/// @tparam T The stored type, so handles to different asset kinds do not mix.
+	template<typename T>
+	struct adlHandle {
+		static constexpr std::uint32_t INDEX_BITS      = 20;
+		static constexpr std::uint32_t INDEX_MASK      = (1u << INDEX_BITS) - 1;
+		static constexpr std::uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+		std::uint32_t value = 0; ///< 0 is never handed out, so a default handle is always invalid.
+
+		[[nodiscard]] inline std::uint32_t index() const { return value & INDEX_MASK; };
+
+		[[nodiscard]] inline std::uint32_t generation() const { return value >> INDEX_BITS; };
+
+		[[nodiscard]] inline bool isValid() const { return value != 0; };
+
+		[[nodiscard]] static inline adlHandle make(const std::uint32_t index, const std::uint32_t generation) {
+			return {.value = (generation << INDEX_BITS) | index};
+		};
+
+		inline bool operator==(const adlHandle &) const = default;
+	};
+
+	// ###################################################################
+	//							  adlSlotMap
+	// ###################################################################
+
+	/// @class adlSlotMap
+	/// @brief Dense storage addressed through generational handles.
+	///
+	/// Values are kept contiguous and removal swaps the last value into the hole, so pointers returned by get()
+	/// are only valid until the next insert or remove. Keep handles, not pointers.
+	/// Reference counts are kept per slot but only mean something for values someone chose to retain().
+	/// @tparam T The stored type.
+	template<typename T>
+	class adlSlotMap {
+	public:
+		using adlHandleType = adlHandle<T>;
+
+		static constexpr std::uint32_t MAX_SLOTS = adlHandleType::INDEX_MASK + 1;
+
+	private:
+		struct Slot {
+			std::uint32_t denseIndex;  ///< Where the value lives, or the next free slot while unused.
+			std::uint32_t generation;  ///< Bumped on removal; starts at 1 so no handle has the value 0.
+			std::uint32_t refCount;
+		};
+
+		static constexpr std::uint32_t NO_SLOT = ~0u;
+
+		std::vector<T>             m_values;
+		std::vector<std::uint32_t> m_valueSlots; ///< Slot index of every dense value, for the swap on removal.
+		std::vector<Slot>          m_slots;
+		std::uint32_t              m_freeSlot = NO_SLOT;
+
+		[[nodiscard]] inline const Slot *findSlot(const adlHandleType handle) const {
+			const std::uint32_t index = handle.index();
+			if (index >= m_slots.size() || m_slots[index].generation != handle.generation()) {
+				return nullptr;
+			}
+			return &m_slots[index];
+		};
+
+	public:
+		/// @brief Stores a value.
+		/// @return The handle to the value, or an invalid handle if every slot is in use.
+		adlHandleType insert(T value) {
+			std::uint32_t index;
+			if (m_freeSlot != NO_SLOT) {
+				index      = m_freeSlot;
+				m_freeSlot = m_slots[index].denseIndex;
+			}
+			else {
+				if (m_slots.size() == MAX_SLOTS) {
+					return {};
+				}
+				index = static_cast<std::uint32_t>(m_slots.size());
+				m_slots.push_back({.denseIndex = 0, .generation = 1, .refCount = 0});
+			}
+
+			m_slots[index].denseIndex = static_cast<std::uint32_t>(m_values.size());
+			m_slots[index].refCount   = 0;
+			m_values.push_back(std::move(value));
+			m_valueSlots.push_back(index);
+
+			return adlHandleType::make(index, m_slots[index].generation);
+		};
+
+		/// @brief Removes a value. Its handle and every copy of it go stale.
+		/// @return False if the handle was already stale.
+		bool remove(const adlHandleType handle) {
+			if (findSlot(handle) == nullptr) {
+				return false;
+			}
+
+			Slot               &slot      = m_slots[handle.index()];
+			const std::uint32_t hole      = slot.denseIndex;
+			const std::uint32_t lastIndex = static_cast<std::uint32_t>(m_values.size() - 1);
+			if (hole != lastIndex) {
+				m_values[hole]                        = std::move(m_values[lastIndex]);
+				m_valueSlots[hole]                    = m_valueSlots[lastIndex];
+				m_slots[m_valueSlots[hole]].denseIndex = hole;
+			}
+			m_values.pop_back();
+			m_valueSlots.pop_back();
+
+			// skip generation 0 on wrap-around so a recycled slot can never produce the invalid handle
+			slot.generation = (slot.generation & adlHandleType::GENERATION_MASK) == adlHandleType::GENERATION_MASK ? 1 : slot.generation + 1;
+			slot.denseIndex = m_freeSlot;
+			m_freeSlot      = handle.index();
+
+			return true;
+		};
+
+		/// @return The value, or nullptr if the handle is stale.
+		[[nodiscard]] inline T *get(const adlHandleType handle) {
+			const Slot *slot = findSlot(handle);
+			return slot != nullptr ? &m_values[slot->denseIndex] : nullptr;
+		};
+
+		[[nodiscard]] inline const T *get(const adlHandleType handle) const {
+			const Slot *slot = findSlot(handle);
+			return slot != nullptr ? &m_values[slot->denseIndex] : nullptr;
+		};
+
+		[[nodiscard]] inline bool contains(const adlHandleType handle) const { return findSlot(handle) != nullptr; };
+
+		/// @brief Adds a reference to a value.
+		/// @return False if the handle is stale.
+		bool retain(const adlHandleType handle) {
+			if (findSlot(handle) == nullptr) {
+				return false;
+			}
+			++m_slots[handle.index()].refCount;
+			return true;
+		};
+
+		/// @brief Drops a reference added by retain().
+		/// @return True if that was the last reference; the caller decides whether to remove the value.
+		bool release(const adlHandleType handle) {
+			if (findSlot(handle) == nullptr || m_slots[handle.index()].refCount == 0) {
+				return false;
+			}
+			return --m_slots[handle.index()].refCount == 0;
+		};
+
+		[[nodiscard]] inline std::size_t size() const { return m_values.size(); };
+
+		/// @brief Gets the dense values, e.g. to release every GL object at shutdown.
+		[[nodiscard]] inline std::span<T> values() { return m_values; };
+	};
+}
+
+#endif //ADAL_HANDLE_H
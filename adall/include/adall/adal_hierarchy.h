@@ -0,0 +1,93 @@
+#ifndef ADAL_HIERARCHY_H
+#define ADAL_HIERARCHY_H
+
+#include <mutex>
+
+#include "entt/entt.hpp"
+
+#include "adal_component.h"
+#include "adal_core.h"
+#include "adal_pch.h"
+#include "adal_scheduler.h"
+
+namespace adlSystem {
+	// ###################################################################
+	//							  Hierarchy
+	// ###################################################################
+
+	/// @class Hierarchy
+	/// @brief Keeps every entity's WorldTransform equal to its Transform applied after its ancestors'.
+	///
+	/// The Transform and WorldTransform storages are sorted alike, one root after another and each root's tree
+	/// breadth first, so every parent precedes its children and one tree is one contiguous range of both. update()
+	/// walks the trees in parallel, each in order, and recomputes only entities whose Transform changed or whose
+	/// parent was recomputed, so untouched subtrees cost a flag test per entity.
+	///
+	/// The order is rebuilt only when Transforms or Parents are added or removed, or an entity is reparented.
+	/// Recomputed world matrices are announced through on_update<WorldTransform> for listeners such as the
+	/// spatial index.
+	class Hierarchy {
+	public:
+		/// Sorting the Transform storage moves its elements, so it is written rather than read.
+		using adlAccess = adlCore::adlSystemSignature<
+			adlCore::adlReads<adlComponent::Parent>,
+			adlCore::adlWrites<adlComponent::Transform, adlComponent::WorldTransform, adlComponent::Children> >;
+
+	private:
+		static constexpr std::uint32_t NO_PARENT = std::numeric_limits<std::uint32_t>::max();
+
+		struct Tree {
+			std::uint32_t first, last;
+		};
+
+		adlCore::adlRegistry &m_registry;
+
+		std::vector<entt::entity>  m_order;      ///< Every entity with a Transform, tree by tree, parents first.
+		std::vector<std::uint32_t> m_parentSlot; ///< Position of each entity's parent in m_order, or NO_PARENT.
+		std::vector<Tree>          m_trees;
+		std::vector<std::uint32_t> m_slotOf;     ///< Position in m_order by entity index.
+		std::vector<std::uint8_t>  m_isStale;    ///< By position in m_order; needs a new world matrix.
+
+		std::mutex                m_dirtyMutex; ///< Systems may patch transforms from several workers at once.
+		std::vector<entt::entity> m_dirty;
+		std::vector<std::uint8_t> m_isDirty;    ///< By entity index.
+		bool                      m_needsReorder = true;
+
+		void onConstructed(entt::registry &registry, entt::entity entity);
+
+		void onChanged(entt::registry &registry, entt::entity entity);
+
+		void onReparented(entt::registry &registry, entt::entity entity);
+
+		void onRemoved(entt::registry &registry, entt::entity entity);
+
+		/// @brief Rebuilds m_order from the Parent and Children components and sorts both transform storages by it.
+		void reorder(entt::registry &registry);
+
+	public:
+		/// @brief Starts listening to the registry's Transform and Parent storages.
+		/// @param registry The registry the entities live in; it has to hold an adlJobSystem context.
+		explicit Hierarchy(adlCore::adlRegistry &registry);
+
+		Hierarchy(const Hierarchy &) = delete;
+
+		Hierarchy &operator=(const Hierarchy &) = delete;
+
+		~Hierarchy();
+
+		/// @brief Gets the matrix of a Transform on its own: scale, then rotation, then translation.
+		static glm::mat3 localMatrix(const adlComponent::Transform &transform);
+
+		/// @brief Makes child's Transform relative to parent. Not to be called while the scheduler runs.
+		/// @param parent The new parent, or entt::null to make child a root.
+		/// @return False if either entity is invalid, or parent is child or one of its descendants.
+		bool setParent(entt::entity child, entt::entity parent);
+
+		/// @brief Recomputes the world matrices of changed entities and their descendants.
+		void update(adlCore::adlRegistry &registry);
+
+		[[nodiscard]] inline std::size_t treeCount() const { return m_trees.size(); };
+	};
+}
+
+#endif //ADAL_HIERARCHY_H
@@ -0,0 +1,211 @@
+#ifndef ADAL_JOB_H
+#define ADAL_JOB_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#include "adal_pch.h"
+
+namespace adlCore {
+	// ###################################################################
+	//							  adlJobCounter
+	// ###################################################################
+
+	/// @struct adlJobCounter
+	/// @brief Counts the unfinished jobs of a group. A job that depends on the group waits for it to reach zero.
+	struct adlJobCounter {
+		std::atomic<std::int32_t> value{0};
+
+		[[nodiscard]] inline bool isDone() const { return value.load(std::memory_order_acquire) == 0; };
+	};
+
+	// ###################################################################
+	//							  adlJob
+	// ###################################################################
+
+	/// @struct adlJob
+	/// @brief A cache-line sized job: a trampoline, the counter to signal and the callable stored inline.
+	struct alignas(64) adlJob {
+		using adlJobFunction = void (*)(adlJob &);
+
+		static constexpr std::size_t PAYLOAD_SIZE = 64 - sizeof(adlJobFunction) - sizeof(adlJobCounter *) - 8;
+
+		adlJobFunction                       function;
+		adlJobCounter                       *counter;
+		std::atomic<bool>                    isPending{false}; ///< Set from submission until the job has run; the slot is not reused meanwhile.
+		alignas(8) std::array<std::byte, PAYLOAD_SIZE> payload;
+	};
+
+	static_assert(sizeof(adlJob) == 64, "jobs are one cache line");
+
+	// ###################################################################
+	//							  adlWorkStealingQueue
+	// ###################################################################
+
+	/// @class adlWorkStealingQueue
+	/// @brief Fixed capacity Chase-Lev deque. The owner pushes and pops at the bottom, thieves steal from the top.
+	class adlWorkStealingQueue {
+	public:
+		static constexpr std::int64_t CAPACITY = 4096;
+
+	private:
+		static constexpr std::int64_t MASK = CAPACITY - 1;
+
+		alignas(64) std::atomic<std::int64_t> m_top{0};
+		alignas(64) std::atomic<std::int64_t> m_bottom{0};
+		alignas(64) std::array<std::atomic<adlJob *>, CAPACITY> m_jobs{};
+
+	public:
+		/// @brief Pushes a job at the bottom. Owner thread only.
+		/// @return False if the deque is full.
+		bool push(adlJob *job);
+
+		/// @brief Pops the most recently pushed job. Owner thread only.
+		/// @return The job, or nullptr if the deque is empty or a thief won the last job.
+		adlJob *pop();
+
+		/// @brief Steals the oldest job. Any thread.
+		/// @return The job, or nullptr if the deque is empty or another thread won the race.
+		adlJob *steal();
+	};
+
+	// ###################################################################
+	//							  adlJobSystem
+	// ###################################################################
+
+	/// @class adlJobSystem
+	/// @brief Engine-owned worker pool with one work-stealing deque per thread.
+	///
+	/// The thread that constructs the job system becomes worker 0 and takes part in the work while it waits.
+	/// Jobs may be submitted from any worker; submissions from other threads run inline.
+	class adlJobSystem {
+	private:
+		static constexpr std::size_t JOB_POOL_SIZE = adlWorkStealingQueue::CAPACITY * 2;
+		static constexpr std::size_t JOB_PROBES    = 64; ///< Pool slots tried before a submission runs in place.
+
+		struct alignas(64) Worker {
+			adlWorkStealingQueue       queue;
+			std::array<adlJob, JOB_POOL_SIZE> jobPool;
+			std::size_t                nextJob = 0;
+		};
+
+		std::vector<std::unique_ptr<Worker> > m_workers;
+		std::vector<std::thread>              m_threads;
+
+		std::atomic<bool>          m_running{true};
+		std::atomic<std::uint64_t> m_jobEpoch{0};
+		std::atomic<std::uint32_t> m_sleepingWorkers{0};
+		std::mutex                 m_sleepMutex;
+		std::condition_variable    m_wakeCondition;
+
+		static thread_local adlJobSystem *t_owner;
+		static thread_local std::size_t   t_workerIndex;
+
+		adlJobSystem *m_previousOwner;       ///< The constructing thread's job system before this one, given back on destruction.
+		std::size_t   m_previousWorkerIndex;
+
+		void workerLoop(std::size_t workerIndex);
+
+		adlJob *allocateJob();
+
+		void submit(adlJob *job);
+
+		adlJob *findJob();
+
+		static void execute(adlJob &job);
+
+	public:
+		/// @brief Starts the worker threads. The calling thread stops being a worker of the job system it belonged
+		/// to until this one is destroyed.
+		/// @param threadCount Total number of threads doing work, the calling thread included.
+		explicit adlJobSystem(std::size_t threadCount = std::max(1u, std::thread::hardware_concurrency()));
+
+		adlJobSystem(const adlJobSystem &) = delete;
+
+		adlJobSystem &operator=(const adlJobSystem &) = delete;
+
+		/// @brief Stops and joins the worker threads. Outstanding jobs must have been waited on.
+		~adlJobSystem();
+
+		/// @brief Gets the number of threads doing work, the owning thread included.
+		[[nodiscard]] inline std::size_t threadCount() const { return m_workers.size(); };
+
+		/// @brief Gets the index of the calling worker.
+		/// @return The worker index, or threadCount() when called from a thread outside the pool.
+		[[nodiscard]] std::size_t workerIndex() const;
+
+		/// @brief Queues a callable on the calling worker's deque.
+		/// @tparam TFunction A callable small enough to be stored inline in adlJob.
+		/// @param function The callable to run.
+		/// @param counter Optional counter incremented now and decremented once the job has run.
+		template<typename TFunction>
+		void run(TFunction &&function, adlJobCounter *counter = nullptr) {
+			using TCallable = std::decay_t<TFunction>;
+			static_assert(sizeof(TCallable) <= adlJob::PAYLOAD_SIZE, "job callable does not fit in adlJob payload");
+			static_assert(alignof(TCallable) <= 8, "job callable is over-aligned for adlJob payload");
+
+			if (counter != nullptr) {
+				counter->value.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			adlJob *job = allocateJob();
+			if (job == nullptr) {
+				// not one of our threads, or every nearby slot still in flight: run in place
+				function();
+				if (counter != nullptr) {
+					counter->value.fetch_sub(1, std::memory_order_release);
+				}
+				return;
+			}
+
+			new(job->payload.data()) TCallable(std::forward<TFunction>(function));
+			job->counter  = counter;
+			job->function = [](adlJob &self) {
+				auto *callable = std::launder(reinterpret_cast<TCallable *>(self.payload.data()));
+				(*callable)();
+				callable->~TCallable();
+			};
+
+			submit(job);
+		}
+
+		/// @brief Runs queued jobs on the calling thread until the counter reaches zero.
+		void wait(const adlJobCounter &counter);
+
+		/// @brief Splits [begin, end) into chunks and runs them across all workers, then waits for them.
+		/// @tparam TFunction Callable invoked as function(first, last) for each chunk.
+		/// @param begin First index of the range.
+		/// @param end One past the last index of the range.
+		/// @param grainSize Smallest chunk worth a job of its own.
+		/// @param function The chunk callable, shared by reference between the chunks.
+		template<typename TFunction>
+		void parallelFor(const std::size_t begin, const std::size_t end, const std::size_t grainSize, TFunction &&function) {
+			if (begin >= end) {
+				return;
+			}
+
+			const std::size_t count = end - begin;
+			// a few chunks per thread so stealing can even out uneven chunks
+			const std::size_t chunkSize = std::max({grainSize, std::size_t{1}, (count + threadCount() * 4 - 1) / (threadCount() * 4)});
+			if (chunkSize >= count || threadCount() == 1 || workerIndex() == threadCount()) {
+				function(begin, end);
+				return;
+			}
+
+			adlJobCounter counter;
+			for (std::size_t first = begin + chunkSize; first < end; first += chunkSize) {
+				const std::size_t last = std::min(first + chunkSize, end);
+				run([&function, first, last] { function(first, last); }, &counter);
+			}
+			function(begin, begin + chunkSize);
+
+			wait(counter);
+		}
+	};
+}
+
+#endif //ADAL_JOB_H
@@ -0,0 +1,308 @@
+#ifndef ADAL_MEMORY_H
+#define ADAL_MEMORY_H
+
+#include <atomic>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+
+#include "adal_pch.h"
+
+namespace adlCore {
+	// ###################################################################
+	//							  adlMemoryStats
+	// ###################################################################
+
+	/// @struct adlMemoryStats
+	/// @brief A snapshot of one allocator, as shown in the editor.
+	struct adlMemoryStats {
+		std::string   name;
+		std::size_t   capacity        = 0; ///< Bytes taken from the system allocator.
+		std::size_t   used            = 0; ///< Bytes handed out right now, alignment padding included.
+		std::size_t   peak            = 0; ///< Highest used since construction.
+		std::uint64_t allocationCount = 0; ///< Allocations since the last reset.
+		std::uint64_t overflowCount   = 0; ///< Times the allocator had to grow.
+	};
+
+	// ###################################################################
+	//							  adlLinearArena
+	// ###################################################################
+
+	/// @class adlLinearArena
+	/// @brief Bump allocator for data that dies all at once, e.g. at the end of a frame.
+	///
+	/// Allocating moves a pointer, freeing single allocations is a no-op and reset() rewinds everything.
+	/// When a frame outgrows the arena, extra blocks are chained in; the next reset() folds them into one
+	/// block big enough for that frame, so a steady workload stops allocating after its first frame.
+	/// Destructors are never run. Not thread safe; see adlFrameMemory for one arena per thread.
+	class adlLinearArena {
+	private:
+		std::unique_ptr<std::byte[]>              m_block;
+		std::size_t                               m_capacity;
+		std::vector<std::unique_ptr<std::byte[]>> m_overflow; ///< Blocks chained in since the last reset.
+
+		std::byte *m_cursor, *m_end;
+
+		std::size_t   m_used            = 0;
+		std::size_t   m_overflowBytes   = 0;
+		std::size_t   m_peak            = 0;
+		std::uint64_t m_allocationCount = 0;
+		std::uint64_t m_overflowCount   = 0;
+
+		void *allocateOverflow(std::size_t size, std::size_t alignment);
+
+	public:
+		/// @brief Constructs an arena.
+		/// @param capacity Size of the first block in bytes.
+		explicit adlLinearArena(std::size_t capacity = 1 << 20);
+
+		adlLinearArena(const adlLinearArena &) = delete;
+
+		adlLinearArena &operator=(const adlLinearArena &) = delete;
+
+		/// @brief Allocates uninitialized memory. Never fails short of the system running out.
+		/// @param size Bytes to allocate.
+		/// @param alignment A power of two.
+		inline void *allocate(const std::size_t size, const std::size_t alignment = alignof(std::max_align_t)) {
+			const auto address = reinterpret_cast<std::uintptr_t>(m_cursor);
+			const auto aligned = (address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+			const auto next    = aligned + size;
+			if (next > reinterpret_cast<std::uintptr_t>(m_end)) {
+				return allocateOverflow(size, alignment);
+			}
+
+			m_used += next - address;
+			m_peak = std::max(m_peak, m_used);
+			++m_allocationCount;
+			m_cursor = reinterpret_cast<std::byte *>(next);
+			return reinterpret_cast<void *>(aligned);
+		}
+
+		/// @brief Allocates an uninitialized array.
+		template<typename T>
+		T *allocate(const std::size_t count) {
+			return static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+		}
+
+		/// @brief Constructs an object in the arena. Its destructor will not run, so it has to be trivial.
+		template<typename T, typename... Args>
+		T *make(Args &&... args) {
+			static_assert(std::is_trivially_destructible_v<T>, "arena objects are dropped without running destructors");
+			return new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+
+		/// @brief Rewinds the arena. Every pointer it handed out becomes invalid.
+		void reset();
+
+		[[nodiscard]] inline std::size_t used() const { return m_used; };
+
+		[[nodiscard]] inline std::size_t capacity() const { return m_capacity + m_overflowBytes; };
+
+		[[nodiscard]] adlMemoryStats stats(const std::string &name) const;
+	};
+
+	// ###################################################################
+	//							  adlPoolAllocator
+	// ###################################################################
+
+	/// @class adlPoolAllocator
+	/// @brief Fixed-size block allocator with an intrusive free list.
+	///
+	/// Blocks come from chunks that are only returned to the system on destruction, so allocating and
+	/// freeing are a pointer swap each. Not thread safe.
+	class adlPoolAllocator {
+	private:
+		struct FreeBlock {
+			FreeBlock *next;
+		};
+
+		std::size_t m_blockSize;
+		std::size_t m_blocksPerChunk;
+
+		std::vector<std::unique_ptr<std::byte[]>> m_chunks;
+		FreeBlock                                *m_free = nullptr;
+
+		std::size_t   m_usedBlocks      = 0;
+		std::size_t   m_peakBlocks      = 0;
+		std::uint64_t m_allocationCount = 0;
+
+		void grow();
+
+	public:
+		/// @brief Constructs a pool. No memory is taken until the first allocation.
+		/// @param blockSize Bytes per block, rounded up to a multiple of alignof(std::max_align_t).
+		/// @param blocksPerChunk Blocks taken from the system each time the pool runs dry.
+		explicit adlPoolAllocator(std::size_t blockSize, std::size_t blocksPerChunk = 256);
+
+		adlPoolAllocator(const adlPoolAllocator &) = delete;
+
+		adlPoolAllocator &operator=(const adlPoolAllocator &) = delete;
+
+		/// @brief Takes one block, aligned to alignof(std::max_align_t).
+		inline void *allocate() {
+			if (m_free == nullptr) {
+				grow();
+			}
+
+			FreeBlock *block = m_free;
+			m_free           = block->next;
+			m_peakBlocks     = std::max(m_peakBlocks, ++m_usedBlocks);
+			++m_allocationCount;
+			return block;
+		}
+
+		/// @brief Returns a block taken from this pool.
+		inline void deallocate(void *pointer) {
+			if (pointer == nullptr) {
+				return;
+			}
+
+			auto *block = static_cast<FreeBlock *>(pointer);
+			block->next = m_free;
+			m_free      = block;
+			--m_usedBlocks;
+		}
+
+		[[nodiscard]] inline std::size_t blockSize() const { return m_blockSize; };
+
+		[[nodiscard]] adlMemoryStats stats(const std::string &name) const;
+	};
+
+	// ###################################################################
+	//							  adlArenaResource
+	// ###################################################################
+
+	/// @class adlArenaResource
+	/// @brief Lets std::pmr containers allocate from an adlLinearArena.
+	///
+	/// Deallocation is a no-op, so a container that grows leaves its old storage behind until the arena is reset;
+	/// reserve up front where the size is known. The container must not outlive the reset.
+	class adlArenaResource final : public std::pmr::memory_resource {
+	private:
+		adlLinearArena &m_arena;
+
+		void *do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+			return m_arena.allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void *, std::size_t, std::size_t) override {
+		}
+
+		[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+			return this == &other;
+		}
+
+	public:
+		explicit adlArenaResource(adlLinearArena &arena) : m_arena(arena) {
+		}
+	};
+
+	// ###################################################################
+	//							  adlPoolResource
+	// ###################################################################
+
+	/// @class adlPoolResource
+	/// @brief Lets std::pmr node containers, e.g. std::pmr::list or std::pmr::map, allocate from an adlPoolAllocator.
+	///
+	/// Requests that do not fit a block go to the upstream resource.
+	class adlPoolResource final : public std::pmr::memory_resource {
+	private:
+		adlPoolAllocator          &m_pool;
+		std::pmr::memory_resource *m_upstream;
+
+		[[nodiscard]] inline bool fits(const std::size_t bytes, const std::size_t alignment) const {
+			return bytes <= m_pool.blockSize() && alignment <= alignof(std::max_align_t);
+		}
+
+		void *do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+			return fits(bytes, alignment) ? m_pool.allocate() : m_upstream->allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void *pointer, const std::size_t bytes, const std::size_t alignment) override {
+			if (fits(bytes, alignment)) {
+				m_pool.deallocate(pointer);
+			}
+			else {
+				m_upstream->deallocate(pointer, bytes, alignment);
+			}
+		}
+
+		[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+			return this == &other;
+		}
+
+	public:
+		explicit adlPoolResource(adlPoolAllocator &pool, std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+			: m_pool(pool),
+			  m_upstream(upstream) {
+		}
+	};
+
+	// ###################################################################
+	//							  adlFrameMemory
+	// ###################################################################
+
+	/// @class adlFrameMemory
+	/// @brief One linear arena per thread for frame-transient data, rewound once per frame.
+	///
+	/// Published as a registry context. Systems running on the job system call local() to get their own
+	/// arena, so allocating never takes a lock; a thread only locks once, the first time it asks.
+	/// Anything allocated here must be dropped before the next reset().
+	class adlFrameMemory {
+	private:
+		struct ThreadArena {
+			std::thread::id  thread;
+			adlLinearArena   arena;
+			adlArenaResource resource;
+
+			ThreadArena(const std::thread::id thread, const std::size_t capacity)
+				: thread(thread),
+				  arena(capacity),
+				  resource(arena) {
+			}
+		};
+
+		struct ThreadCache {
+			std::uint64_t owner = 0;
+			ThreadArena  *arena = nullptr;
+		};
+
+		static std::atomic<std::uint64_t> s_nextID;
+		static thread_local ThreadCache   t_cache;
+
+		std::uint64_t m_id; ///< Never reused, unlike the address, so a stale thread cache cannot match a new instance.
+		std::size_t   m_arenaCapacity;
+
+		mutable std::mutex                         m_mutex;
+		std::vector<std::unique_ptr<ThreadArena> > m_arenas;
+
+		ThreadArena &claim();
+
+	public:
+		/// @brief Constructs the frame memory. Arenas are created as threads first ask for them.
+		/// @param arenaCapacity Starting size of each thread's arena in bytes.
+		explicit adlFrameMemory(std::size_t arenaCapacity = 1 << 20);
+
+		adlFrameMemory(const adlFrameMemory &) = delete;
+
+		adlFrameMemory &operator=(const adlFrameMemory &) = delete;
+
+		/// @brief Gets the calling thread's arena.
+		inline adlLinearArena &local() {
+			return t_cache.owner == m_id ? t_cache.arena->arena : claim().arena;
+		}
+
+		/// @brief Gets the calling thread's arena as a memory resource, e.g. for a std::pmr::vector.
+		inline std::pmr::memory_resource &resource() {
+			return t_cache.owner == m_id ? t_cache.arena->resource : claim().resource;
+		}
+
+		/// @brief Rewinds every thread's arena. Call between frames, while no thread allocates.
+		void reset();
+
+		/// @brief Gets one entry per thread that allocated so far.
+		[[nodiscard]] std::vector<adlMemoryStats> stats() const;
+	};
+}
+
+#endif //ADAL_MEMORY_H
@@ -1,6 +1,11 @@
 #ifndef ADALLGL_PCH_H
 #define ADALLGL_PCH_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 
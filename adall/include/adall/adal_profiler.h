@@ -0,0 +1,240 @@
+#ifndef ADAL_PROFILER_H
+#define ADAL_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string_view>
+
+#include "adal_pch.h"
+
+/// Set to 0 to compile every zone and frame marker out.
+#ifndef ADL_PROFILE
+#define ADL_PROFILE 1
+#endif
+
+// zones stamp raw time stamp counter ticks where there is one, a fraction of a steady_clock read
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ADL_PROFILE_TSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#else
+#define ADL_PROFILE_TSC 0
+#endif
+
+#define ADL_PROFILE_CONCAT_INNER(lhs, rhs) lhs##rhs
+#define ADL_PROFILE_CONCAT(lhs, rhs) ADL_PROFILE_CONCAT_INNER(lhs, rhs)
+
+#if ADL_PROFILE
+/// Times the rest of the enclosing scope. The name has to outlive the profiler: a literal or an interned string.
+#define ADL_PROFILE_ZONE(name) const adlCore::adlProfileZone ADL_PROFILE_CONCAT(adlProfileZone_, __LINE__)(name)
+/// Times the rest of the enclosing function under its name.
+#define ADL_PROFILE_FUNCTION() ADL_PROFILE_ZONE(__func__)
+/// Closes a frame: collects every thread's zones since the last marker. Main thread only.
+#define ADL_PROFILE_FRAME() adlCore::adlProfiler::global().frameMark()
+#else
+#define ADL_PROFILE_ZONE(name) static_cast<void>(0)
+#define ADL_PROFILE_FUNCTION() static_cast<void>(0)
+#define ADL_PROFILE_FRAME() static_cast<void>(0)
+#endif
+
+namespace adlCore {
+	// ###################################################################
+	//							  adlZoneEvent
+	// ###################################################################
+
+	/// @struct adlZoneEvent
+	/// @brief One closed zone on one thread.
+	struct adlZoneEvent {
+		std::string_view name;   ///< A literal or an interned string, both outlive the profiler.
+		std::uint64_t    start;  ///< Nanoseconds on adlProfiler::now(), once drained by frameMark().
+		std::uint64_t    end;
+		std::uint32_t    depth;  ///< Zones that were open on the thread around this one.
+		std::uint32_t    thread; ///< Index into adlProfiler::threadNames().
+	};
+
+	/// @struct adlZoneStats
+	/// @brief Timings of one zone name over the last adlProfiler::HISTORY calls, as shown in the editor.
+	struct adlZoneStats {
+		std::string_view name;
+		std::uint64_t    calls       = 0; ///< Calls in the last frame.
+		double           frameMs     = 0; ///< Time spent in the zone in the last frame, all threads summed.
+		double           minMs       = 0;
+		double           averageMs   = 0;
+		double           p99Ms       = 0;
+		std::size_t      sampleCount = 0; ///< Calls the min, average and p99 are taken over.
+	};
+
+	// ###################################################################
+	//							  adlProfiler
+	// ###################################################################
+
+	/// @class adlProfiler
+	/// @brief Collects scoped CPU zones from every thread and turns them into per-frame timelines and statistics.
+	///
+	/// Each thread records into its own ring buffer without locks; only its first zone takes a mutex to join.
+	/// Zones are stamped in ticks(), which frameMark() converts to nanoseconds with a rate measured against
+	/// now() since the profiler started. frameMark() drains every ring once a frame, keeps that frame's events for the timeline and feeds the
+	/// per-zone history. While a capture runs the drained events are also kept for a Chrome trace export.
+	/// A ring that laps between two frame marks loses its oldest events, which are counted as dropped.
+	///
+	/// Recording is thread safe; everything else is for the main thread.
+	class adlProfiler {
+	public:
+		static constexpr std::size_t RING_CAPACITY       = std::size_t{1} << 16; ///< Events per thread between two frame marks.
+		static constexpr std::size_t HISTORY             = 1024;                 ///< Calls per zone the statistics cover.
+		static constexpr std::size_t MAX_CAPTURED_EVENTS = std::size_t{1} << 22;
+
+	private:
+		struct alignas(64) ThreadTimeline {
+			std::unique_ptr<adlZoneEvent[]> events = std::make_unique<adlZoneEvent[]>(RING_CAPACITY);
+			std::atomic<std::uint64_t>      head{0}; ///< Events ever written; the owning thread is the only writer.
+			std::uint64_t                   tail  = 0; ///< Events ever drained, by frameMark() only.
+			std::uint32_t                   depth = 0;
+			std::uint32_t                   index = 0;
+			std::string                     name;
+		};
+
+		struct ZoneHistory {
+			std::vector<std::uint64_t> durations;       ///< Ring of the last HISTORY durations, in nanoseconds.
+			std::uint64_t              callCount  = 0;  ///< Calls ever recorded.
+			std::uint64_t              frameCalls = 0;
+			std::uint64_t              frameTime  = 0;
+		};
+
+		inline static thread_local ThreadTimeline *t_timeline = nullptr; ///< Inline, so zones reach it without a TLS wrapper call.
+
+		mutable std::mutex                           m_mutex; ///< Guards the timeline list and the thread names.
+		std::vector<std::unique_ptr<ThreadTimeline> > m_timelines;
+
+		std::uint64_t m_originTicks;
+		std::uint64_t m_originTime;
+		double        m_nanosecondsPerTick = 1.0;
+
+		std::vector<adlZoneEvent>                         m_lastFrame;
+		std::uint64_t                                     m_frameStart     = 0;
+		std::uint64_t                                     m_lastFrameStart = 0;
+		std::uint64_t                                     m_lastFrameEnd   = 0;
+		std::uint64_t                                     m_droppedCount   = 0;
+		std::unordered_map<std::string_view, ZoneHistory> m_zones;
+
+		bool                       m_isCapturing = false;
+		std::vector<adlZoneEvent>  m_capture;
+		std::vector<std::uint64_t> m_captureFrames; ///< Frame mark times during the capture.
+
+		ThreadTimeline &join();
+
+		inline ThreadTimeline &local() {
+			return t_timeline != nullptr ? *t_timeline : join();
+		}
+
+		[[nodiscard]] inline std::uint64_t toNanoseconds(const std::uint64_t tick) const {
+			return m_originTime + static_cast<std::uint64_t>(static_cast<double>(static_cast<std::int64_t>(tick - m_originTicks)) * m_nanosecondsPerTick);
+		}
+
+	public:
+		adlProfiler();
+
+		adlProfiler(const adlProfiler &) = delete;
+
+		adlProfiler &operator=(const adlProfiler &) = delete;
+
+		/// @brief Gets the profiler the zone macros record into.
+		static adlProfiler &global();
+
+		/// @brief Gets the profiler clock, in nanoseconds.
+		static inline std::uint64_t now() {
+			return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count());
+		}
+
+		/// @brief Gets the clock zones are stamped with: time stamp counter ticks, or now() where there is none.
+		static inline std::uint64_t ticks() {
+#if ADL_PROFILE_TSC
+			return __rdtsc();
+#else
+			return now();
+#endif
+		}
+
+		/// @brief Opens a zone on the calling thread. Use ADL_PROFILE_ZONE rather than calling this directly.
+		inline void beginZone() {
+			++local().depth;
+		}
+
+		/// @brief Closes the zone opened last on the calling thread and records it.
+		inline void endZone(const std::string_view name, const std::uint64_t start, const std::uint64_t end) {
+			ThreadTimeline     &timeline = local();
+			const std::uint64_t head     = timeline.head.load(std::memory_order_relaxed);
+
+			timeline.events[head & (RING_CAPACITY - 1)] = {.name = name, .start = start, .end = end, .depth = --timeline.depth, .thread = timeline.index};
+			timeline.head.store(head + 1, std::memory_order_release);
+		}
+
+		/// @brief Names the calling thread in the timeline and in exported traces.
+		void setThreadName(std::string_view name);
+
+		/// @brief Ends the current frame: drains every thread's zones and updates the statistics.
+		void frameMark();
+
+		/// @brief Starts keeping every drained event for exportChromeTrace(), dropping any earlier capture.
+		void beginCapture();
+
+		void endCapture();
+
+		[[nodiscard]] inline bool isCapturing() const { return m_isCapturing; };
+
+		[[nodiscard]] inline std::size_t capturedCount() const { return m_capture.size(); };
+
+		/// @brief Writes the last capture as Chrome trace event JSON, for chrome://tracing or Perfetto.
+		/// @return False if the file could not be written.
+		bool exportChromeTrace(const std::string &path) const;
+
+		/// @brief Gets the statistics of every zone seen so far, the most expensive in the last frame first.
+		[[nodiscard]] std::vector<adlZoneStats> stats() const;
+
+		/// @brief Gets the zones of the last complete frame, thread by thread.
+		[[nodiscard]] inline const std::vector<adlZoneEvent> &lastFrame() const { return m_lastFrame; };
+
+		[[nodiscard]] inline std::uint64_t lastFrameStart() const { return m_lastFrameStart; };
+
+		[[nodiscard]] inline std::uint64_t lastFrameEnd() const { return m_lastFrameEnd; };
+
+		/// @brief Gets how many events were lost to lapped rings or a full capture.
+		[[nodiscard]] inline std::uint64_t droppedCount() const { return m_droppedCount; };
+
+		[[nodiscard]] std::vector<std::string> threadNames() const;
+	};
+
+	// ###################################################################
+	//							  adlProfileZone
+	// ###################################################################
+
+	/// @class adlProfileZone
+	/// @brief Records the time between its construction and destruction. Made by ADL_PROFILE_ZONE.
+	class adlProfileZone {
+	private:
+		std::string_view m_name;
+		std::uint64_t    m_start;
+
+	public:
+		explicit adlProfileZone(const std::string_view name)
+			: m_name(name) {
+			adlProfiler::global().beginZone();
+			m_start = adlProfiler::ticks();
+		}
+
+		adlProfileZone(const adlProfileZone &) = delete;
+
+		adlProfileZone &operator=(const adlProfileZone &) = delete;
+
+		~adlProfileZone() {
+			adlProfiler::global().endZone(m_name, m_start, adlProfiler::ticks());
+		}
+	};
+}
+
+#endif //ADAL_PROFILER_H
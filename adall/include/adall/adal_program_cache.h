@@ -0,0 +1,94 @@
+#ifndef ADALGL_PROGRAM_CACHE_H
+#define ADALGL_PROGRAM_CACHE_H
+
+#include <span>
+#include <string_view>
+
+#include "adal_archive.h"
+#include "adal_pch.h"
+
+// ###################################################################
+//                          adlProgramCacheFormat
+// -------------------------------------------------------------------
+// <directory>/index.bin: [adlProgramCacheHeader][adlProgramCacheEntry * count]
+// <directory>/<key as hex>.bin: the raw program binary of one entry
+// The header records the driver the binaries came from; a different
+// driver invalidates the whole cache on open.
+// ###################################################################
+struct adlProgramCacheHeader {
+    static constexpr std::uint32_t MAGIC   = 0x43504441; // "ADPC"
+    static constexpr std::uint32_t VERSION = 1;
+
+    std::uint32_t magic, version;
+    std::uint64_t driverHash;
+    std::uint32_t entryCount, reserved;
+};
+
+struct adlProgramCacheEntry {
+    std::uint64_t key;           ///< adlProgramCache::makeKey() of the program's sources.
+    std::uint64_t size;          ///< Byte size of the binary file.
+    std::uint64_t checksum;      ///< adlHashName() of the binary, catches truncated or damaged files.
+    std::uint32_t binaryFormat;  ///< The format glGetProgramBinary reported.
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(adlProgramCacheHeader) == 24 && sizeof(adlProgramCacheEntry) == 32, "program cache layout changed");
+
+// ###################################################################
+//                          adlProgramCache
+// -------------------------------------------------------------------
+// On-disk store of linked program binaries. Knows nothing about GL:
+// the shader loader asks it for bytes and hands it bytes back.
+// ###################################################################
+class adlProgramCache {
+private:
+    std::string                                             m_directory;
+    std::uint64_t                                           m_driverHash = 0;
+    std::unordered_map<std::uint64_t, adlProgramCacheEntry> m_entries;
+
+    [[nodiscard]] std::string binaryPath(std::uint64_t key) const;
+
+    /// Rewrites the index file from the in-memory entries.
+    bool saveIndex() const;
+
+public:
+    /// Hashes everything that decides what a program binary looks like.
+    ///
+    /// @param vertexSource The final vertex shader source, after preprocessing.
+    /// @param fragmentSource The final fragment shader source, after preprocessing.
+    /// @param driverIdentity Vendor, renderer and version of the GL driver.
+    /// @return The cache key for the program.
+    static std::uint64_t makeKey(std::string_view vertexSource, std::string_view fragmentSource, std::string_view driverIdentity);
+
+    /// Opens or creates a cache directory.
+    ///
+    /// @param directory Where the index and the binaries are kept. Created if missing.
+    /// @param driverIdentity Vendor, renderer and version of the GL driver. A cache written by a different driver is emptied.
+    /// @return False if the directory cannot be created or written.
+    bool open(const std::string &directory, std::string_view driverIdentity);
+
+    /// Loads a cached binary.
+    ///
+    /// @param key The program's cache key.
+    /// @param binaryFormat The binary's format will be stored here.
+    /// @param binary The binary will be stored here.
+    /// @return False on a miss, or if the file no longer matches its index entry, which drops the entry.
+    bool find(std::uint64_t key, std::uint32_t &binaryFormat, std::vector<std::byte> &binary);
+
+    /// Stores a binary, replacing any previous one for the key.
+    ///
+    /// @return False if the binary could not be written.
+    bool store(std::uint64_t key, std::uint32_t binaryFormat, std::span<const std::byte> binary);
+
+    /// Drops an entry, e.g. after the driver refused to load its binary.
+    void invalidate(std::uint64_t key);
+
+    /// Drops every entry.
+    void clear();
+
+    [[nodiscard]] inline std::size_t entryCount() const { return m_entries.size(); };
+
+    [[nodiscard]] inline bool isOpen() const { return !m_directory.empty(); };
+};
+
+#endif //ADALGL_PROGRAM_CACHE_H
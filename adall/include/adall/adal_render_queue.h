@@ -0,0 +1,108 @@
+#ifndef ADALGL_RENDER_QUEUE_H
+#define ADALGL_RENDER_QUEUE_H
+
+#include "adal_batch.h"
+#include "adal_pch.h"
+
+// ###################################################################
+//                          adlSortKey
+// -------------------------------------------------------------------
+// [63:56] layer | [55:40] shader | [39:24] texture | [23:0] depth
+// Commands are drawn in key order: layer first, then grouped by state,
+// then front to back inside a state. GL names are truncated to 16 bits,
+// which only weakens grouping; batches still split on the real names.
+// ###################################################################
+constexpr std::uint64_t adlMakeSortKey(const std::uint8_t layer, const GLuint shaderProgramID, const GLuint textureID, const float depth) {
+    const float         clamped = depth < 0.f ? 0.f : (depth > 1.f ? 1.f : depth);
+    const std::uint64_t depthBits = static_cast<std::uint64_t>(clamped * static_cast<float>(0xFFFFFF));
+
+    return static_cast<std::uint64_t>(layer) << 56
+           | static_cast<std::uint64_t>(shaderProgramID & 0xFFFF) << 40
+           | static_cast<std::uint64_t>(textureID & 0xFFFF) << 24
+           | depthBits;
+}
+
+// ###################################################################
+//                          adlRenderCommand
+// ###################################################################
+struct adlRenderCommand {
+    std::uint64_t sortKey;
+    adlSprite     sprite;
+};
+
+static_assert(std::is_trivially_copyable_v<adlRenderCommand>, "render commands are copied around as plain bytes");
+
+// ###################################################################
+//                          adlRenderCommandBuffer
+// -------------------------------------------------------------------
+// Linear command storage written by a single thread. Each buffer sits
+// on its own cache lines so recording threads never share one.
+// ###################################################################
+class alignas(64) adlRenderCommandBuffer {
+private:
+    std::vector<adlRenderCommand> m_commands;
+
+public:
+    inline void push(const std::uint64_t sortKey, const adlSprite &sprite) {
+        m_commands.push_back({.sortKey = sortKey, .sprite = sprite});
+    };
+
+    /// Drops the commands and keeps the storage for the next frame.
+    inline void clear() { m_commands.clear(); };
+
+    inline void reserve(const std::size_t count) { m_commands.reserve(count); };
+
+    [[nodiscard]] inline const std::vector<adlRenderCommand> &commands() const { return m_commands; };
+};
+
+// ###################################################################
+//                          adlRenderQueue
+// -------------------------------------------------------------------
+// One command buffer per recording thread. After recording, merge()
+// concatenates them and sort() radix sorts by key; commands with equal
+// keys keep buffer order, then recording order. Needs no GL context.
+// ###################################################################
+class adlRenderQueue {
+private:
+    struct SortEntry {
+        std::uint64_t key;
+        std::uint32_t index;
+    };
+
+    std::vector<adlRenderCommandBuffer> m_buffers;
+    std::vector<adlRenderCommand>       m_merged;
+    std::vector<adlRenderCommand>       m_sorted;
+    std::vector<SortEntry>              m_entries, m_scratch;
+
+public:
+    /// @param bufferCount Number of threads that may record at once, e.g. adlJobSystem::threadCount() + 1
+    ///                    so threads outside the pool get a buffer too.
+    explicit adlRenderQueue(std::size_t bufferCount);
+
+    /// Gets the buffer of one recording thread.
+    ///
+    /// @param index The recording thread's index, e.g. adlJobSystem::workerIndex().
+    [[nodiscard]] inline adlRenderCommandBuffer &buffer(const std::size_t index) { return m_buffers[index]; };
+
+    [[nodiscard]] inline std::size_t bufferCount() const { return m_buffers.size(); };
+
+    /// Clears every buffer for the next frame.
+    void reset();
+
+    /// Concatenates the buffers, in buffer order.
+    void merge();
+
+    /// Radix sorts the merged commands by key. Call after merge().
+    void sort();
+
+    /// Builds a sprite batch in command order, so layers and depth order survive batching.
+    ///
+    /// @param commands Commands in key order, e.g. sorted() or adlRenderFrame::commands.
+    /// @param batch The batch to rebuild.
+    static void build(const std::vector<adlRenderCommand> &commands, adlSpriteBatch &batch);
+
+    /// @return The commands in key order, filled by sort(). May be swapped out to hand the commands over.
+    [[nodiscard]] inline std::vector<adlRenderCommand> &sorted() { return m_sorted; };
+};
+
+#endif //ADALGL_RENDER_QUEUE_H
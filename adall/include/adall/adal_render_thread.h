@@ -0,0 +1,78 @@
+#ifndef ADALGL_RENDER_THREAD_H
+#define ADALGL_RENDER_THREAD_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "adal_handle.h"
+#include "adal_pch.h"
+#include "adal_render_queue.h"
+
+// ###################################################################
+//                          adlRenderFrame
+// ###################################################################
+struct adlRenderFrame {
+    std::vector<adlRenderCommand>               commands;    ///< Sorted commands to draw.
+    adlFrameUniforms                            uniforms{};
+    glm::ivec2                                  viewport{0};  ///< Framebuffer size to draw into, left as it was when zero.
+    std::vector<adlCore::adlHandle<adlShader> > shaders;     ///< Programs the commands draw with, their per-program uniforms set first.
+    std::vector<std::function<void()>>          syncTasks;   ///< GL work that touches state the simulation also reads, e.g. texture uploads.
+};
+
+// ###################################################################
+//                          adlRenderThread
+// -------------------------------------------------------------------
+// Owns the GL context and draws frame N while the simulation builds
+// frame N+1. submit() hands a frame over and returns once its sync
+// tasks ran; the simulation is blocked only for those, never for the
+// draws. At most one frame waits, so latency stays at one frame.
+// ###################################################################
+class adlRenderThread {
+public:
+    typedef std::function<void()>                 adlStartCallback;
+    typedef std::function<void(adlRenderFrame &)> adlFrameCallback;
+    typedef std::function<void()>                 adlStopCallback;
+
+private:
+    std::thread             m_thread;
+    std::mutex              m_mutex;
+    std::condition_variable m_condition;
+
+    adlRenderFrame m_pending;
+    bool           m_hasPending = false, m_isSynced = true, m_isStopping = false;
+
+    GLFWwindow *m_window = nullptr;
+
+    void renderLoop(adlStartCallback onStart, adlFrameCallback onFrame, adlStopCallback onStop);
+
+public:
+    adlRenderThread() = default;
+
+    adlRenderThread(const adlRenderThread &) = delete;
+
+    adlRenderThread &operator=(const adlRenderThread &) = delete;
+
+    ~adlRenderThread() { stop(); };
+
+    /// Moves the window's GL context to a new render thread.
+    ///
+    /// @param window The window whose context is current on the calling thread. It is released here.
+    /// @param onStart Runs first on the render thread, e.g. to create GL objects.
+    /// @param onFrame Draws one frame on the render thread, swapping buffers included.
+    /// @param onStop Runs last on the render thread, e.g. to destroy GL objects.
+    void start(GLFWwindow *window, adlStartCallback onStart, adlFrameCallback onFrame, adlStopCallback onStop = {});
+
+    /// Hands a frame to the render thread, swapping in the storage of an older frame for reuse.
+    ///
+    /// Waits for the previous frame to be picked up and for this frame's sync tasks to finish.
+    void submit(adlRenderFrame &frame);
+
+    /// Finishes the pending frame, joins the thread and makes the context current on the calling thread again.
+    void stop();
+
+    [[nodiscard]] inline bool isRunning() const { return m_thread.joinable(); };
+};
+
+#endif //ADALGL_RENDER_THREAD_H
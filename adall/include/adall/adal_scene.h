@@ -0,0 +1,243 @@
+#ifndef ADAL_SCENE_H
+#define ADAL_SCENE_H
+
+#include <functional>
+#include <span>
+
+#include "entt/entt.hpp"
+
+#include "adal_archive.h"
+#include "adal_core.h"
+#include "adal_pch.h"
+
+namespace adlCore {
+	// ###################################################################
+	//							  scene file layout
+	// ###################################################################
+
+	/// @struct adlSceneHeader
+	/// @brief Start of a scene file. Every section is 16-byte aligned, so pools load straight from the mapping.
+	struct adlSceneHeader {
+		static constexpr std::uint32_t MAGIC   = 0x534C4441; // "ADLS"
+		static constexpr std::uint32_t VERSION = 1;
+
+		std::uint32_t magic, version;
+		std::uint32_t entityCount, sectionCount;
+		std::uint32_t stringCount, reserved;
+		std::uint64_t entityOffset;       ///< entt::entity[entityCount], every live entity as saved.
+		std::uint64_t stringTableOffset;  ///< adlSceneString[stringCount], then their characters. Entry 0 is the empty string.
+		std::uint64_t sectionTableOffset; ///< adlSceneSection[sectionCount].
+	};
+
+	/// @struct adlSceneString
+	/// @brief A string the saved components refer to. Saved string fields hold its index in the table rather than
+	/// an interner id, since ids differ from run to run.
+	struct adlSceneString {
+		std::uint32_t offset, length; ///< Into the characters following the string table.
+	};
+
+	/// @struct adlSceneSection
+	/// @brief One component pool: its entities in storage order, then their values in the same order.
+	struct adlSceneSection {
+		std::uint64_t nameHash;     ///< adlHashName() of the component's schema name.
+		std::uint32_t version;      ///< Schema version the values were written with.
+		std::uint32_t elementSize;  ///< sizeof the component when saved, 0 for tags whose values are not saved.
+		std::uint64_t count;
+		std::uint64_t entityOffset; ///< entt::entity[count].
+		std::uint64_t dataOffset;   ///< count * elementSize bytes.
+	};
+
+	static_assert(sizeof(adlSceneHeader) == 48 && sizeof(adlSceneString) == 8 && sizeof(adlSceneSection) == 40, "scene layout changed");
+
+	// ###################################################################
+	//							  adlSceneSchema
+	// ###################################################################
+
+	/// @class adlSceneSchema
+	/// @brief The components a scene saves and loads, their versions and how older versions are upgraded.
+	///
+	/// Components are saved as raw bytes, so they have to be trivially copyable; fields holding interned
+	/// strings or entities are declared so loading can remap them. Tags save which entities have them and load
+	/// default-constructed, for components whose values are rebuilt at run time.
+	class adlSceneSchema {
+	private:
+		/// Upgrades count values from an older layout to the current one.
+		typedef std::function<void(const std::byte *from, std::size_t count, std::byte *to)> Migration;
+
+		struct ComponentType {
+			std::string   name;
+			std::uint64_t nameHash;
+			entt::id_type type;
+			std::uint32_t version;
+			std::uint32_t elementSize;   ///< 0 for tags.
+			std::size_t   pageSize;      ///< Values per contiguous storage page.
+
+			std::vector<std::size_t> stringOffsets; ///< Byte offsets of adlStringID fields.
+			std::vector<std::size_t> entityOffsets; ///< Byte offsets of entt::entity fields.
+
+			std::unordered_map<std::uint32_t, std::pair<std::uint32_t, Migration> > migrations; ///< Element size and upgrade, by the version they start from.
+
+			std::function<const entt::sparse_set *(const entt::registry &)>                          storage;
+			std::function<const std::byte *(const entt::sparse_set &, std::size_t)>                  value;  ///< Value at a storage position.
+			std::function<void(entt::registry &, std::span<const entt::entity>, const std::byte *)> insert; ///< Values are null for tags.
+			std::function<void(entt::registry &, std::span<const entt::entity>)>                     afterLoad;
+			std::function<void(entt::registry &, entt::entity, const std::byte *)>                   overwrite; ///< Replaces one value through patch().
+		};
+
+		std::vector<ComponentType> m_types;
+
+		template<typename TComponent>
+		ComponentType &find() {
+			const entt::id_type type = entt::type_hash<TComponent>::value();
+			const auto          itr  = std::find_if(m_types.begin(), m_types.end(), [type](const ComponentType &entry) {
+				return entry.type == type;
+			});
+			assert(itr != m_types.end() && "declare the component before its fields");
+			return *itr;
+		}
+
+		template<typename TComponent, typename TField>
+		static std::size_t offsetOf(TField TComponent::*field) {
+			const TComponent probe{};
+			return static_cast<std::size_t>(reinterpret_cast<const std::byte *>(&(probe.*field)) - reinterpret_cast<const std::byte *>(&probe));
+		}
+
+		template<typename TComponent>
+		ComponentType &declare(const std::string_view name, const std::uint32_t version, const std::uint32_t elementSize) {
+			assert(std::none_of(m_types.begin(), m_types.end(), [name](const ComponentType &entry) { return entry.name == name; }));
+
+			ComponentType &type = m_types.emplace_back();
+			type.name           = name;
+			type.nameHash       = adlHashName(name);
+			type.type           = entt::type_hash<TComponent>::value();
+			type.version        = version;
+			type.elementSize    = elementSize;
+			type.storage        = [](const entt::registry &registry) -> const entt::sparse_set * {
+				return registry.storage<TComponent>();
+			};
+			return type;
+		}
+
+	public:
+		/// @brief Saves a trivially copyable component's values.
+		/// @param name The name it is stored under in scene files; renaming it orphans the saved pools.
+		/// @param version Bump it whenever the layout changes, and add a migration from the old version.
+		template<typename TComponent>
+		adlSceneSchema &component(const std::string_view name, const std::uint32_t version = 1) {
+			static_assert(std::is_trivially_copyable_v<TComponent> && !std::is_empty_v<TComponent>, "scene components are saved as raw bytes");
+			static_assert(alignof(TComponent) <= 16, "scene sections are 16-byte aligned");
+
+			ComponentType &type = declare<TComponent>(name, version, sizeof(TComponent));
+			type.pageSize       = entt::component_traits<TComponent>::page_size;
+			type.value          = [](const entt::sparse_set &set, const std::size_t position) {
+				const auto &storage = static_cast<const entt::storage_for_t<TComponent> &>(set);
+				return reinterpret_cast<const std::byte *>(&storage.raw()[position / entt::component_traits<TComponent>::page_size][position % entt::component_traits<TComponent>::page_size]);
+			};
+			type.insert = [](entt::registry &registry, const std::span<const entt::entity> entities, const std::byte *values) {
+				auto &storage = registry.storage<TComponent>();
+				storage.reserve(storage.size() + entities.size());
+				storage.insert(entities.begin(), entities.end(), reinterpret_cast<const TComponent *>(values));
+			};
+			type.overwrite = [](entt::registry &registry, const entt::entity entity, const std::byte *value) {
+				registry.patch<TComponent>(entity, [value](TComponent &component) {
+					std::memcpy(&component, value, sizeof(TComponent));
+				});
+			};
+			return *this;
+		}
+
+		/// @brief Saves which entities have a component, whose values are default-constructed on load.
+		template<typename TComponent>
+		adlSceneSchema &tag(const std::string_view name) {
+			ComponentType &type = declare<TComponent>(name, 1, 0);
+			type.pageSize       = 0;
+			type.insert         = [](entt::registry &registry, const std::span<const entt::entity> entities, const std::byte *) {
+				auto &storage = registry.storage<TComponent>();
+				storage.reserve(storage.size() + entities.size());
+				storage.insert(entities.begin(), entities.end());
+			};
+			return *this;
+		}
+
+		/// @brief Declares a field holding an interned string, saved by its text and interned again on load.
+		template<typename TComponent>
+		adlSceneSchema &stringField(adlStringID TComponent::*field) {
+			find<TComponent>().stringOffsets.push_back(offsetOf(field));
+			return *this;
+		}
+
+		/// @brief Declares a field holding an entity, mapped to the entity it was loaded as. Entities that were not saved become null.
+		template<typename TComponent>
+		adlSceneSchema &entityField(entt::entity TComponent::*field) {
+			find<TComponent>().entityOffsets.push_back(offsetOf(field));
+			return *this;
+		}
+
+		/// @brief Upgrades values saved with an older version of a component straight to the current layout.
+		/// @param fromVersion The version TOld was saved as.
+		/// @param upgrade Builds the current value from an old one. String and entity fields are remapped after the
+		/// upgrade, so it has to copy them over as they are and give new ones 0 or entt::null.
+		template<typename TComponent, typename TOld>
+		adlSceneSchema &migration(const std::uint32_t fromVersion, std::function<TComponent(const TOld &)> upgrade) {
+			static_assert(std::is_trivially_copyable_v<TOld>, "old layouts are read as raw bytes");
+
+			find<TComponent>().migrations[fromVersion] = {
+				static_cast<std::uint32_t>(sizeof(TOld)),
+				[upgrade = std::move(upgrade)](const std::byte *from, const std::size_t count, std::byte *to) {
+					for (std::size_t i = 0; i < count; ++i) {
+						TOld old;
+						std::memcpy(&old, from + i * sizeof(TOld), sizeof(TOld));
+						const TComponent value = upgrade(old);
+						std::memcpy(to + i * sizeof(TComponent), &value, sizeof(TComponent));
+					}
+				},
+			};
+			return *this;
+		}
+
+		/// @brief Runs right after a component's pool was loaded, with the entities it went to, e.g. to rebuild
+		/// state derived from it.
+		template<typename TComponent>
+		adlSceneSchema &afterLoad(std::function<void(entt::registry &, std::span<const entt::entity>)> function) {
+			find<TComponent>().afterLoad = std::move(function);
+			return *this;
+		}
+
+		/// @brief Gets the schema of the engine's own components.
+		///
+		/// WorldTransform and Children are not saved: the hierarchy rebuilds them from Transform and Parent.
+		static const adlSceneSchema &engine();
+
+		friend class adlScene;
+		friend class adlSnapshotRing;
+	};
+
+	// ###################################################################
+	//							  adlScene
+	// ###################################################################
+
+	/// @class adlScene
+	/// @brief Saves a registry's components to a binary file pool by pool, and loads them back into another.
+	///
+	/// Loading maps the file and inserts every pool in one call. Pools saved with the current layout and without
+	/// string or entity fields are inserted straight from the mapping. The others are copied once, upgraded if
+	/// they are older, and then have their fields remapped in place. Loaded entities are new ones, so a scene
+	/// can be loaded into a registry that already has entities, and more than once.
+	class adlScene {
+	public:
+		/// @brief Writes every live entity and every schema component to a file.
+		/// @return False if the file could not be written.
+		static bool save(const adlRegistry &registry, const std::string &path, const adlSceneSchema &schema = adlSceneSchema::engine());
+
+		/// @brief Creates the entities of a scene file and gives them their saved components.
+		///
+		/// Pools of components the schema does not know are skipped. Nothing is created if the file is
+		/// corrupt, or holds a component newer than the schema or older without a migration.
+		/// @param loaded Receives the created entities, in saved order, if not null.
+		/// @return False if nothing was loaded.
+		static bool load(adlRegistry &registry, const std::string &path, const adlSceneSchema &schema = adlSceneSchema::engine()
+		               , std::vector<entt::entity> *loaded = nullptr);
+	};
+}
+
+#endif //ADAL_SCENE_H
@@ -0,0 +1,140 @@
+#ifndef ADAL_SCHEDULER_H
+#define ADAL_SCHEDULER_H
+
+#include <functional>
+
+#include "entt/entt.hpp"
+
+#include "adal_core.h"
+#include "adal_job.h"
+#include "adal_pch.h"
+#include "adal_profiler.h"
+#include "adal_string.h"
+
+namespace adlCore {
+	// ###################################################################
+	//							  adlSystemSignature
+	// ###################################################################
+
+	/// @brief Component types a system only reads.
+	template<typename... TComponents>
+	struct adlReads {};
+
+	/// @brief Component types a system reads and writes.
+	template<typename... TComponents>
+	struct adlWrites {};
+
+	template<typename TReads, typename TWrites>
+	struct adlSystemSignature;
+
+	/// @struct adlSystemSignature
+	/// @brief Compile-time description of the component pools a system touches.
+	///
+	/// A system exposes it as `using adlAccess = adlSystemSignature<adlReads<...>, adlWrites<...>>;`
+	/// and iterates through adlAccess::view(), which only hands out const access to the read set.
+	template<typename... TRead, typename... TWrite>
+	struct adlSystemSignature<adlReads<TRead...>, adlWrites<TWrite...> > {
+		/// @brief Gets the view over every entity holding the whole signature.
+		static auto view(entt::registry &registry) {
+			static_assert(sizeof...(TRead) + sizeof...(TWrite) > 0, "an empty signature has no view");
+			return registry.view<TWrite..., const TRead...>();
+		}
+
+		/// @brief Creates the pools up front, so that running systems never mutate the pool map concurrently.
+		static void assure(entt::registry &registry) {
+			(static_cast<void>(registry.storage<TRead>()), ...);
+			(static_cast<void>(registry.storage<TWrite>()), ...);
+		}
+
+		static std::vector<entt::id_type> readIDs() { return {entt::type_hash<TRead>::value()...}; }
+
+		static std::vector<entt::id_type> writeIDs() { return {entt::type_hash<TWrite>::value()...}; }
+	};
+
+	// ###################################################################
+	//							  adlScheduler
+	// ###################################################################
+
+	/// @class adlScheduler
+	/// @brief Runs registered systems on the job system, in parallel whenever their signatures do not conflict.
+	///
+	/// Two systems conflict when one writes a component type the other reads or writes. Conflicting systems
+	/// keep their registration order, everything else may overlap. Systems may change component values,
+	/// but must not create or destroy entities or components while the scheduler runs.
+	class adlScheduler {
+	private:
+		struct SystemNode {
+			std::string                                 name;
+			std::string_view                            profileName; ///< Interned, so profiler zones may keep it.
+			std::vector<entt::id_type>                  reads, writes;
+			std::function<void(adlRegistry &, float)>   update;
+			std::function<void(entt::registry &)>       assure;
+			std::vector<std::size_t>                    successors;
+			std::int32_t                                predecessorCount = 0;
+			std::size_t                                 level            = 0;
+		};
+
+		struct RunContext {
+			adlRegistry   &registry;
+			adlJobSystem  &jobSystem;
+			adlJobCounter &counter;
+			float          deltaTime;
+		};
+
+		std::vector<SystemNode>                          m_systems;
+		std::unique_ptr<std::atomic<std::int32_t>[]>     m_pending;
+		bool                                             m_isDirty = true;
+
+		static bool isConflicting(const SystemNode &lhs, const SystemNode &rhs);
+
+		void launch(RunContext &context, std::size_t index);
+
+	public:
+		adlScheduler() = default;
+
+		~adlScheduler() = default;
+
+		/// @brief Registers a system. Its update is called as update(registry, deltaTime) or update(registry).
+		/// @tparam TSystem A system type declaring `using adlAccess = adlSystemSignature<...>`.
+		/// @param name A name for debugging and schedule inspection.
+		/// @param system The system instance, shared with whoever else owns it.
+		template<typename TSystem>
+		void addSystem(const std::string &name, std::shared_ptr<TSystem> system) {
+			using TAccess = typename TSystem::adlAccess;
+
+			SystemNode node;
+			node.name        = name;
+			node.profileName = adlStringInterner::global().view(adlIntern(name));
+			node.reads       = TAccess::readIDs();
+			node.writes      = TAccess::writeIDs();
+			node.assure      = [](entt::registry &registry) { TAccess::assure(registry); };
+			node.update      = [system](adlRegistry &registry, const float deltaTime) {
+				if constexpr (requires { system->update(registry, deltaTime); }) {
+					system->update(registry, deltaTime);
+				}
+				else {
+					system->update(registry);
+				}
+			};
+
+			m_systems.push_back(std::move(node));
+			m_isDirty = true;
+		}
+
+		/// @brief Rebuilds the dependency graph. Called lazily by run() after systems were added.
+		void build();
+
+		/// @brief Runs every system once and returns when all of them are done.
+		/// @param registry The registry the systems operate on.
+		/// @param jobSystem The job system to spread the systems over. Must be called from one of its workers.
+		/// @param deltaTime The step passed to the systems.
+		void run(adlRegistry &registry, adlJobSystem &jobSystem, float deltaTime);
+
+		/// @brief Gets the systems grouped by their depth in the graph. Systems in one group may run together.
+		[[nodiscard]] std::vector<std::vector<std::string> > stages();
+
+		[[nodiscard]] inline std::size_t systemCount() const { return m_systems.size(); };
+	};
+}
+
+#endif //ADAL_SCHEDULER_H
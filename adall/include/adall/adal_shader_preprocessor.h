@@ -0,0 +1,95 @@
+#ifndef ADALGL_SHADER_PREPROCESSOR_H
+#define ADALGL_SHADER_PREPROCESSOR_H
+
+#include <functional>
+#include <string_view>
+
+#include "adal_pch.h"
+
+/// Reads a whole source file. Swappable so sources can come from an archive or from memory.
+typedef std::function<bool(const std::string &path, std::string &source)> adlShaderSourceReader;
+
+// ###################################################################
+//                          adlShaderPreprocessor
+// -------------------------------------------------------------------
+// Expands GLSL sources before they reach the driver:
+//  - #include "path" is resolved relative to the including file and
+//    every file is pasted at most once per expansion;
+//  - each bit set in a permutation mask becomes "#define <FEATURE> 1"
+//    right after the #version line.
+// Files are read once and every expansion is memoized, so asking for
+// a variant again costs a lookup.
+// ###################################################################
+class adlShaderPreprocessor {
+public:
+    static constexpr std::size_t MAX_FEATURES = 64;
+
+private:
+    struct Expansion {
+        std::string version;  ///< The #version line, kept first in every variant.
+        std::string body;     ///< Everything else, includes pasted in.
+        bool        isValid;
+
+        std::vector<std::string> files;  ///< Every file pasted in or tried, the root first.
+    };
+
+    struct VariantKey {
+        std::string   path;
+        std::uint64_t permutation;
+
+        bool operator==(const VariantKey &) const = default;
+    };
+
+    struct VariantKeyHash {
+        std::size_t operator()(const VariantKey &key) const {
+            return std::hash<std::string>()(key.path) ^ (std::hash<std::uint64_t>()(key.permutation) * 0x9E3779B97F4A7C15ull);
+        };
+    };
+
+    adlShaderSourceReader m_reader;
+
+    std::vector<std::string>                                    m_features;
+    std::unordered_map<std::string, std::string>                m_files;       ///< Raw sources, by path.
+    std::unordered_map<std::string, Expansion>                  m_expansions;  ///< Includes resolved, by root path.
+    std::unordered_map<VariantKey, std::string, VariantKeyHash> m_variants;    ///< Final sources, by root path and permutation.
+
+    const std::string *readFile(const std::string &path);
+
+    bool expandFile(const std::string &path, std::unordered_set<std::string> &included, std::string &out, std::uint32_t depth);
+
+    const Expansion &expand(const std::string &path);
+
+public:
+    /// @param reader Where sources come from, plain files when empty.
+    explicit adlShaderPreprocessor(adlShaderSourceReader reader = {});
+
+    /// Gets the permutation bit of a feature, declaring it on first use.
+    ///
+    /// @param name The macro defined when the bit is set, e.g. "USE_TINT".
+    /// @return The feature's bit, or 0 once MAX_FEATURES are declared.
+    std::uint64_t feature(const std::string &name);
+
+    /// Expands a shader for one permutation.
+    ///
+    /// @param path The root source file.
+    /// @param permutation Bits from feature(), each set bit defines its feature.
+    /// @return The expanded source, or nullptr if the file or one of its includes cannot be read.
+    ///         Both outcomes are remembered until clear().
+    const std::string *preprocess(const std::string &path, std::uint64_t permutation = 0);
+
+    /// Gets the files an expanded shader was built from.
+    ///
+    /// @param path The root source file.
+    /// @return The root and every file it includes, or nullptr if the root was not preprocessed since it was last forgotten.
+    [[nodiscard]] const std::vector<std::string> *sources(const std::string &path) const;
+
+    /// Forgets one file and every expansion and variant it was pasted into, e.g. after it changed on disk.
+    void forget(const std::string &path);
+
+    /// Forgets every read file and expansion, e.g. after sources changed on disk.
+    void clear();
+
+    [[nodiscard]] inline std::size_t variantCount() const { return m_variants.size(); };
+};
+
+#endif //ADALGL_SHADER_PREPROCESSOR_H
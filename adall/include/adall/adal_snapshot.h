@@ -0,0 +1,124 @@
+#ifndef ADAL_SNAPSHOT_H
+#define ADAL_SNAPSHOT_H
+
+#include <deque>
+#include <optional>
+
+#include "entt/entt.hpp"
+
+#include "adal_core.h"
+#include "adal_pch.h"
+#include "adal_scene.h"
+
+namespace adlCore {
+	// ###################################################################
+	//							  adlSnapshotRing
+	// ###################################################################
+
+	/// @class adlSnapshotRing
+	/// @brief Keeps the registry state of the last frames in memory, to roll back to one or replay from it.
+	///
+	/// A frame holds the entity storage and every schema component pool, cut into chunks of one storage page.
+	/// A chunk equal to the frame before's is shared. One that changed a little only holds the elements that
+	/// differ from it, and one that changed a lot, or sits on a long run of deltas, is copied whole. So a
+	/// window of frames costs about a copy per run of deltas plus the elements that changed.
+	///
+	/// Chunk hashes sum a hash of every element and its position, so a delta updates its chunk's hash from the
+	/// changed elements alone. A frame's checksum combines its chunk hashes, and two runs that stepped alike get
+	/// equal checksums. They hash raw bytes, so components with padding have to keep it zeroed.
+	///
+	/// Components outside the schema are not captured, and a restore leaves the registry without them.
+	class adlSnapshotRing {
+	private:
+		/// The bytes of one chunk, whole or as the elements that differ from a base block.
+		struct Block {
+			std::shared_ptr<const Block> base;    ///< Null for whole blocks.
+			std::uint32_t                depth;   ///< Deltas between this block and its whole one.
+			std::size_t                  size;    ///< Bytes in the chunk.
+			std::vector<std::uint32_t>   changed; ///< Element positions in the chunk, for deltas.
+			std::vector<std::byte>       bytes;   ///< The chunk, or the changed elements back to back.
+			std::uint64_t                hash;
+		};
+
+		typedef std::shared_ptr<const Block> Chunk;
+
+		/// One array of equally sized elements, such as a pool's entities or its values.
+		struct Stream {
+			std::size_t        stride;
+			std::size_t        count;
+			std::vector<Chunk> chunks;
+		};
+
+		struct Pool {
+			const adlSceneSchema::ComponentType *type;
+			Stream                               entities;
+			Stream                               values; ///< Empty for tags.
+		};
+
+		struct Frame {
+			std::uint64_t     frame;
+			std::uint64_t     checksum;
+			std::size_t       liveCount; ///< Free list position of the entity storage.
+			Stream            entities;  ///< Live entities first, then released ones in the order they are reused.
+			std::vector<Pool> pools;
+		};
+
+		const adlSceneSchema &m_schema;
+		std::size_t           m_capacity;
+		std::deque<Frame>     m_frames; ///< Oldest first.
+
+		/// The newest frame written out whole, by stream: the entity storage, then each schema type's
+		/// entities and values. Captures diff against it.
+		std::vector<std::vector<std::byte> > m_mirror;
+		std::optional<std::uint64_t>         m_mirrorFrame;
+
+		/// @brief Appends the chunk of length elements starting at element first to a stream, diffed against the
+		/// mirror and the block previous had there, and writes it to the mirror.
+		static void captureChunk(Stream &stream, const Stream *previous, std::vector<std::byte> &mirror, std::size_t first
+		                       , const std::byte *data, std::size_t length);
+
+		/// @brief Writes a chunk's bytes to out.
+		static void materialize(const Block &block, std::byte *out);
+
+		/// @brief Writes a whole stream to out.
+		static void gather(const Stream &stream, std::vector<std::byte> &out);
+
+		/// @brief Points the mirror at a frame.
+		void resetMirror(const Frame &frame);
+
+		/// @brief Restores a frame whose entities and pools match the registry's by patching the values that differ.
+		/// @return False if they do not match, or a component with derived state changed; nothing was touched then.
+		bool patch(entt::registry &registry, const Frame &frame) const;
+
+		/// @brief Rebuilds the entity storage and every schema pool from scratch.
+		static void rebuild(entt::registry &registry, const Frame &frame);
+
+	public:
+		/// @param capacity Frames kept; capturing more drops the oldest.
+		/// @param schema The components captured. It has to outlive the ring.
+		explicit adlSnapshotRing(std::size_t capacity = 60, const adlSceneSchema &schema = adlSceneSchema::engine());
+
+		/// @brief Captures the registry as it is at a frame. Frames from this one on that were captured before, e.g.
+		/// before a rollback, are dropped.
+		/// @return The frame's checksum.
+		std::uint64_t capture(const adlRegistry &registry, std::uint64_t frame);
+
+		/// @brief Puts the registry back as it was at a captured frame, with the same entities and storage order.
+		///
+		/// When no entity was made or destroyed since, only changed components are written, through patch() so
+		/// listeners see them. Otherwise every pool is cleared and refilled. Frames after it stay captured until
+		/// they are captured again.
+		/// @return False if the frame is not in the ring.
+		bool restore(adlRegistry &registry, std::uint64_t frame) const;
+
+		/// @return The checksum of a captured frame, or nothing if it is not in the ring.
+		[[nodiscard]] std::optional<std::uint64_t> checksum(std::uint64_t frame) const;
+
+		/// @brief Gets the bytes held by every frame together, shared blocks counted once, the mirror not counted.
+		[[nodiscard]] std::size_t byteSize() const;
+
+		[[nodiscard]] inline std::size_t frameCount() const { return m_frames.size(); };
+	};
+}
+
+#endif //ADAL_SNAPSHOT_H
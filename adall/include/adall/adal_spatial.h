@@ -0,0 +1,155 @@
+#ifndef ADAL_SPATIAL_H
+#define ADAL_SPATIAL_H
+
+#include <array>
+#include <mutex>
+
+#include "entt/entt.hpp"
+
+#include "adal_component.h"
+#include "adal_core.h"
+#include "adal_pch.h"
+#include "adal_scheduler.h"
+
+namespace adlSystem {
+	/// @struct RayHit
+	/// @brief An entity whose box a ray crosses, and how far along the ray it enters it.
+	struct RayHit {
+		entt::entity entity;
+		float        distance;
+	};
+
+	// ###################################################################
+	//							  SpatialIndex
+	// ###################################################################
+
+	/// @class SpatialIndex
+	/// @brief Loose spatial hash broadphase over every entity holding a WorldTransform and Bounds.
+	///
+	/// Each entity is filed once, in the grid cell holding its center; queries widen their cell range by the
+	/// largest half extent filed so far, so a box reaching into a neighbour cell is still found. Entities larger
+	/// than a cell would widen every query and are kept in a list of their own instead.
+	///
+	/// Registry signals mark entities whose WorldTransform or Bounds were emplaced, patched or replaced, and update()
+	/// refiles only those, touching the grid only when the center changed cells. When most of the index is
+	/// dirty, update() rebuilds it across the job system instead; cells are sharded by key so shards fill in
+	/// parallel.
+	///
+	/// Queries are const, may run from several threads at once and report each entity once. They see the
+	/// boxes as of the last update().
+	class SpatialIndex {
+	public:
+		using adlAccess = adlCore::adlSystemSignature<adlCore::adlReads<adlComponent::WorldTransform, adlComponent::Bounds>, adlCore::adlWrites<> >;
+
+		static constexpr std::size_t SHARD_COUNT = 16;
+
+	private:
+		static constexpr std::uint32_t INVALID_ENTRY  = std::numeric_limits<std::uint32_t>::max();
+		static constexpr std::uint64_t OVERSIZED_CELL = 0x8000000080000000ull; ///< Key of cell (INT32_MIN, INT32_MIN), which clamping never produces.
+
+		struct CellRange {
+			std::int32_t x0, y0, x1, y1;
+		};
+
+		struct Entry {
+			glm::vec2                   min, max;
+			std::uint64_t               cell; ///< Key of the cell holding the center, or OVERSIZED_CELL.
+			std::vector<std::uint32_t> *list; ///< That cell's list; map nodes never move and a cell is only erased once empty.
+			std::uint32_t               slot; ///< Position in the list.
+			entt::entity                entity;
+		};
+
+		struct alignas(64) Shard {
+			std::unordered_map<std::uint64_t, std::vector<std::uint32_t> > cells; ///< Entry indices by cell key.
+		};
+
+		adlCore::adlRegistry &m_registry;
+		float                 m_cellSize, m_inverseCellSize;
+		float                 m_looseMargin = 0.0f; ///< Largest half extent filed in a cell since the last rebuild.
+
+		std::vector<Entry>             m_entries;
+		std::vector<std::uint32_t>     m_entryOf;   ///< Entry index by entity index, INVALID_ENTRY when not indexed.
+		std::array<Shard, SHARD_COUNT> m_shards;
+		std::vector<std::uint32_t>     m_oversized; ///< Entries too large to file in a cell, checked by every query.
+
+		std::vector<Entry>                                                  m_moved;   ///< Scratch of update().
+		std::vector<std::vector<std::pair<std::uint64_t, std::uint32_t> > > m_buckets; ///< Scratch of rebuild(), per chunk and shard.
+
+		std::mutex                m_dirtyMutex; ///< Systems may patch transforms from several workers at once.
+		std::vector<entt::entity> m_dirty;
+		std::vector<std::uint8_t> m_isDirty;    ///< By entity index.
+		bool                      m_needsRebuild = true;
+
+		static inline std::uint64_t cellKey(const std::int32_t x, const std::int32_t y) {
+			return static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32 | static_cast<std::uint32_t>(y);
+		}
+
+		static inline std::size_t shardOf(const std::uint64_t key) {
+			return (key * 0x9E3779B97F4A7C15ull) >> 60;
+		}
+
+		[[nodiscard]] CellRange cellRange(const glm::vec2 &min, const glm::vec2 &max) const;
+
+		/// @brief Gets the cell an entry belongs in, or OVERSIZED_CELL.
+		[[nodiscard]] std::uint64_t homeCell(const glm::vec2 &min, const glm::vec2 &max) const;
+
+		std::vector<std::uint32_t> &cellList(std::uint64_t cell);
+
+		void fileEntry(std::uint32_t index);
+
+		void unfileEntry(std::uint32_t index);
+
+		void removeEntry(entt::entity entity);
+
+		void onChanged(entt::registry &registry, entt::entity entity);
+
+		void onRemoved(entt::registry &registry, entt::entity entity);
+
+		/// @brief Calls function(entryIndex) for every entry whose box may overlap [min, max], oversized ones included.
+		template<typename TFunction>
+		void forEachCandidate(const glm::vec2 &min, const glm::vec2 &max, TFunction &&function) const;
+
+		/// @brief Calls function(entryIndex) for every entry filed in one cell.
+		template<typename TFunction>
+		void forEachInCell(std::int32_t x, std::int32_t y, TFunction &&function) const;
+
+	public:
+		/// @brief Starts listening to the registry's WorldTransform and Bounds storages.
+		/// @param registry The registry the indexed entities live in; it has to hold an adlJobSystem context.
+		/// @param cellSize Edge of a grid cell in world units, about the size of a typical entity or a bit more.
+		explicit SpatialIndex(adlCore::adlRegistry &registry, float cellSize = 64.0f);
+
+		SpatialIndex(const SpatialIndex &) = delete;
+
+		SpatialIndex &operator=(const SpatialIndex &) = delete;
+
+		~SpatialIndex();
+
+		/// @brief Gets the world-space box of an entity, axis aligned around whatever rotation and scale its matrix holds.
+		static void worldBox(const adlComponent::WorldTransform &transform, const adlComponent::Bounds &bounds, glm::vec2 &min, glm::vec2 &max);
+
+		/// @brief Refiles the entities that changed since the last update. Scheduled after the systems that move entities.
+		void update(adlCore::adlRegistry &registry);
+
+		/// @brief Refiles every entity from scratch, split across the job system.
+		void rebuild(adlCore::adlRegistry &registry);
+
+		/// @brief Appends the entities whose box overlaps [min, max].
+		void queryAABB(const glm::vec2 &min, const glm::vec2 &max, std::vector<entt::entity> &out) const;
+
+		/// @brief Appends the entities whose box overlaps a circle.
+		void queryRadius(const glm::vec2 &center, float radius, std::vector<entt::entity> &out) const;
+
+		/// @brief Appends the entities whose box a ray segment crosses, nearest first.
+		/// @param origin Where the ray starts.
+		/// @param direction The ray direction, need not be normalized.
+		/// @param maxDistance Length of the segment, in multiples of the direction's length.
+		void queryRay(const glm::vec2 &origin, const glm::vec2 &direction, float maxDistance, std::vector<RayHit> &out) const;
+
+		[[nodiscard]] inline std::size_t entityCount() const { return m_entries.size(); };
+
+		[[nodiscard]] std::size_t cellCount() const;
+	};
+}
+
+#endif //ADAL_SPATIAL_H
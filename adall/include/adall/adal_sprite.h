@@ -0,0 +1,50 @@
+#ifndef ADAL_SPRITE_H
+#define ADAL_SPRITE_H
+
+#include "entt/entt.hpp"
+
+#include "adal_component.h"
+#include "adal_core.h"
+#include "adal_job.h"
+#include "adal_pch.h"
+#include "adal_render_queue.h"
+
+namespace adlSystem {
+	// ###################################################################
+	//							  SpriteRecorder
+	// ###################################################################
+
+	/// @class SpriteRecorder
+	/// @brief Records a draw command into the render queue for every Sprite a camera sees.
+	///
+	/// Runs once per rendered frame rather than as a scheduled system, since a frame takes zero to several
+	/// simulation steps. The camera's Visibility is split across the workers, and each records into its own
+	/// command buffer of the queue; merge() and sort() then put the commands in key order.
+	class SpriteRecorder {
+	private:
+		std::vector<std::vector<adlCore::adlShaderHandle> > m_workerShaders; ///< Programs seen, per recording thread.
+		std::vector<adlCore::adlShaderHandle>               m_shaders;
+
+	public:
+		/// @brief Gets the draw command of a sprite: its Bounds box scaled, turned and moved by its world matrix.
+		/// Shear cannot be drawn by a sprite and is dropped.
+		/// @param shaderProgramID The program of the sprite's shader.
+		/// @param textureID The GL texture of the sprite's texture.
+		static adlRenderCommand makeCommand(const adlComponent::Sprite &sprite, const adlComponent::WorldTransform &transform
+		                                  , const adlComponent::Bounds &bounds, GLuint shaderProgramID, GLuint textureID);
+
+		/// @brief Records the sprites a camera saw in the last culling pass. Sprites whose shader or texture is not
+		/// loaded yet are left out. Call from the thread that owns the job system, with no asset being loaded or
+		/// unloaded meanwhile.
+		/// @param registry The registry holding the sprites, with an adlJobSystem and an adlAssetManager in its context.
+		/// @param queue The queue to record into, with a buffer for every worker and one for threads outside the pool.
+		/// @param camera An entity with a Visibility.
+		/// @return The number of commands recorded.
+		std::size_t record(adlCore::adlRegistry &registry, adlRenderQueue &queue, entt::entity camera);
+
+		/// @brief Gets the programs the last record() drew with, each once.
+		[[nodiscard]] inline const std::vector<adlCore::adlShaderHandle> &shaders() const { return m_shaders; };
+	};
+}
+
+#endif //ADAL_SPRITE_H
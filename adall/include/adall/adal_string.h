@@ -0,0 +1,61 @@
+#ifndef ADALGL_STRING_H
+#define ADALGL_STRING_H
+
+#include <deque>
+#include <shared_mutex>
+#include <string_view>
+
+#include "adal_pch.h"
+
+// ###################################################################
+//                          adlStringID
+// ###################################################################
+/// Process-wide id of an interned string. Equal strings always get the same id, 0 is the empty string.
+typedef std::uint32_t adlStringID;
+
+// ###################################################################
+//                          adlStringInterner
+// -------------------------------------------------------------------
+// Maps strings to small ids once so hot paths compare and index by
+// integer. Interned strings are never freed, so only intern names
+// from a bounded set (uniforms, entity names, asset names).
+// ###################################################################
+class adlStringInterner {
+private:
+    std::deque<std::string>                           m_strings;  ///< Stable storage, the map keys view into it.
+    std::unordered_map<std::string_view, adlStringID> m_ids;
+    mutable std::shared_mutex                         m_mutex;
+
+public:
+    adlStringInterner();
+
+    adlStringInterner(const adlStringInterner &) = delete;
+
+    adlStringInterner &operator=(const adlStringInterner &) = delete;
+
+    /// Gets the interner shared by the whole engine.
+    static adlStringInterner &global();
+
+    /// Interns a string. Thread safe.
+    ///
+    /// @param string The string to intern.
+    /// @return The string's id, the same for every call with an equal string.
+    adlStringID intern(std::string_view string);
+
+    /// Looks up a string without interning it.
+    ///
+    /// @return The string's id, or 0 if it was never interned.
+    [[nodiscard]] adlStringID find(std::string_view string) const;
+
+    /// @return The interned string, or an empty view for an unknown id.
+    [[nodiscard]] std::string_view view(adlStringID id) const;
+
+    [[nodiscard]] std::size_t size() const;
+};
+
+/// Interns a string in the global interner.
+inline adlStringID adlIntern(const std::string_view string) {
+    return adlStringInterner::global().intern(string);
+}
+
+#endif //ADALGL_STRING_H
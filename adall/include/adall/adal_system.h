@@ -1,41 +1,124 @@
 #ifndef ADALLGL_SYSTEM_H
 #define ADALLGL_SYSTEM_H
 
+#include "adal_batch.h"
+#include "adal_component.h"
 #include "adal_core.h"
+#include "adal_job.h"
 #include "adal_pch.h"
+#include "adal_scheduler.h"
 
 namespace adlSystem {
 	class Renderer {
 	private:
-		GLuint m_VAO, m_VBO, m_IBO;
+		GLuint m_VAO, m_IBO, m_frameUBO;
+
+		adlStreamBuffer m_vertexStream; ///< Per-frame vertex regions, fenced against in-flight draws.
 
 		GLFWwindow *m_window;
 
+		std::size_t m_maxQuads; ///< Quad capacity of a stream region and of the shared quad index buffer.
+
+		adlFrameUniforms m_frameUniforms{};          ///< Last values uploaded to the FrameData block.
+		bool             m_hasFrameUniforms = false;
+
+		adlGLUniformBackend m_uniformBackend;
+		adlUniformState     m_uniformState{m_uniformBackend}; ///< Per-program uniforms, unchanged values dropped.
+		adlStringID         m_modelName, m_materialName;
+
 	private:
 		void init();
 
 		void makeGfxPipeline();
 
 	public:
-		Renderer(GLFWwindow *window);
+		explicit Renderer(GLFWwindow *window, std::size_t maxQuads = adlSpriteBatch::DEFAULT_MAX_QUADS);
 
 		void update();
 
-		void render();
+		/// @brief Uploads the per-frame block shared by every program that declares FrameData, skipping the matrices
+		/// when they did not change. Call once per frame.
+		void setFrameUniforms(const adlFrameUniforms &frameUniforms);
+
+		/// @brief Sets the uniforms a program keeps per program: the identity model matrix, as batched vertices are
+		/// already in world space, and texture unit 0 for the material sampler. Call every frame for each program
+		/// drawn with; values the program already holds are not sent again, and a reloaded program gets them anew.
+		/// @param shader A program the frame draws with.
+		void setProgramUniforms(adlShader &shader);
+
+		/// @brief Gets the per-program uniform state, e.g. to check how many sets were dropped.
+		[[nodiscard]] inline const adlUniformState &uniformState() const { return m_uniformState; };
+
+		/// @brief Streams the batch vertex arena and issues one draw per shader/texture run. A batch of more than
+		/// maxQuads quads takes a stream region per maxQuads piece.
+		/// @param batch A batch that went through adlSpriteBatch::end().
+		void render(const adlSpriteBatch &batch);
 	};
 
+	/// @class Camera2D
+	/// @brief Rebuilds the view and projection of cameras whose inputs changed, and publishes the main camera's for
+	/// the frame's FrameData block.
+	///
+	/// An observer collects the cameras added, patched or replaced since the last update, so a static camera costs
+	/// nothing per step. The window's framebuffer size reaches the main camera through resize().
 	class Camera2D {
+	public:
+		using adlAccess = adlCore::adlSystemSignature<adlCore::adlReads<>, adlCore::adlWrites<adlComponent::Camera> >;
+
 	private:
-		GLFWwindow *m_window;
-		GLuint      m_viewLocation;
-		glm::vec3   m_globalUp = {0.0f, 0.0f, 1.0f};
+		GLFWwindow    *m_window;
+		entt::observer m_observer;                ///< Cameras added, patched or replaced since the last update.
+		entt::entity   m_mainCamera = entt::null;
+		glm::ivec2     m_framebufferSize{0};
+		bool           m_hasResized   = false;
+		bool           m_needsPublish = false;
+
+		glm::mat4     m_view{1.0f};
+		glm::mat4     m_projection{1.0f};
+		std::uint64_t m_revision     = 0;
+		std::uint64_t m_rebuildCount = 0;
 
 	public:
-		explicit Camera2D(GLFWwindow* window)
-			: m_window(window),
-			  m_viewLocation(0) {
-		};
-		void     update();
+		/// @param registry The registry holding the cameras.
+		/// @param window The window whose framebuffer the main camera covers, or nullptr when headless.
+		Camera2D(adlCore::adlRegistry &registry, GLFWwindow *window);
+
+		Camera2D(const Camera2D &) = delete;
+
+		Camera2D &operator=(const Camera2D &) = delete;
+
+		/// @brief Rebuilds a camera's matrices from its size, scale and position.
+		/// @return False if the camera has no area, leaving the matrices as they were.
+		static bool rebuild(adlComponent::Camera &camera);
+
+		/// @brief Picks the camera that follows the framebuffer size and whose matrices are published.
+		void setMainCamera(entt::entity camera);
+
+		/// @brief Gets the camera set by setMainCamera(), or entt::null.
+		[[nodiscard]] inline entt::entity mainCamera() const { return m_mainCamera; };
+
+		/// @brief Records a new framebuffer size for the main camera; the next update applies it. Main thread only,
+		/// between scheduler runs, e.g. from the GLFW framebuffer size callback.
+		void resize(int width, int height);
+
+		/// @brief Rebuilds the cameras that changed since the last update and republishes the main camera if it did.
+		/// @param registry The registry holding the cameras.
+		void update(adlCore::adlRegistry &registry);
+
+		/// @brief Gets the main camera's view matrix as of the last update that changed it.
+		[[nodiscard]] inline const glm::mat4 &view() const { return m_view; };
+
+		/// @brief Gets the main camera's projection matrix as of the last update that changed it.
+		[[nodiscard]] inline const glm::mat4 &projection() const { return m_projection; };
+
+		/// @brief Gets a number that grows every time view() and projection() are republished.
+		[[nodiscard]] inline std::uint64_t revision() const { return m_revision; };
+
+		/// @brief Gets how many camera rebuilds ran in total, for checking that static cameras cost nothing.
+		[[nodiscard]] inline std::uint64_t rebuildCount() const { return m_rebuildCount; };
+
+		/// @brief Gets the last framebuffer size passed to resize().
+		[[nodiscard]] inline glm::ivec2 framebufferSize() const { return m_framebufferSize; };
 	};
 }
 
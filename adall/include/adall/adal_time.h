@@ -0,0 +1,75 @@
+#ifndef ADAL_TIME_H
+#define ADAL_TIME_H
+
+#include "adal_pch.h"
+
+namespace adlCore {
+	// ###################################################################
+	//							  adlFrameTime
+	// ###################################################################
+
+	/// @struct adlFrameTime
+	/// @brief Per-frame timing, published as a registry context for systems and the renderer.
+	struct adlFrameTime {
+		double        fixedStep      = 1.0 / 60.0; ///< Simulation step in seconds.
+		double        alpha          = 0.0;        ///< How far the renderer is between the last two simulation steps, in [0, 1).
+		double        simulationTime = 0.0;        ///< Simulated seconds since start.
+		std::uint64_t frameIndex     = 0;          ///< Number of rendered (or, headless, looped) frames.
+		std::uint64_t stepIndex      = 0;          ///< Number of simulation steps taken.
+	};
+
+	// ###################################################################
+	//							  adlFixedTimestep
+	// ###################################################################
+
+	/// @class adlFixedTimestep
+	/// @brief Accumulates frame time and hands it out as a whole number of fixed simulation steps.
+	class adlFixedTimestep {
+	private:
+		double        m_step;
+		double        m_accumulator = 0.0;
+		int           m_maxSteps;
+		std::uint64_t m_droppedSteps = 0;
+
+	public:
+		/// @brief Constructs a fixed timestep.
+		/// @param step The simulation step in seconds.
+		/// @param maxSteps Most steps taken in one frame; time beyond that is dropped instead of spiralling.
+		explicit adlFixedTimestep(const double step = 1.0 / 60.0, const int maxSteps = 5)
+			: m_step(step > 0.0 ? step : 1.0 / 60.0),
+			  m_maxSteps(std::max(maxSteps, 1)) {
+		};
+
+		/// @brief Adds elapsed real time and consumes it in whole steps.
+		/// @param frameTime Seconds since the previous call.
+		/// @return The number of simulation steps to run this frame.
+		int advance(const double frameTime) {
+			m_accumulator += std::max(frameTime, 0.0);
+
+			int steps = static_cast<int>(m_accumulator / m_step);
+			if (steps > m_maxSteps) {
+				m_droppedSteps += static_cast<std::uint64_t>(steps - m_maxSteps);
+				steps = m_maxSteps;
+				// keep the fractional part so interpolation stays continuous after a hitch
+				m_accumulator = std::fmod(m_accumulator, m_step);
+			}
+			else {
+				m_accumulator -= steps * m_step;
+			}
+
+			return steps;
+		}
+
+		/// @brief Gets the interpolation factor between the previous and the current simulation state.
+		[[nodiscard]] inline double alpha() const { return m_accumulator / m_step; };
+
+		[[nodiscard]] inline double step() const { return m_step; };
+
+		[[nodiscard]] inline int maxSteps() const { return m_maxSteps; };
+
+		/// @brief Gets how many steps were skipped because a frame needed more than maxSteps().
+		[[nodiscard]] inline std::uint64_t droppedSteps() const { return m_droppedSteps; };
+	};
+}
+
+#endif //ADAL_TIME_H
@@ -1,12 +1,11 @@
 #ifndef ADALGL_VIEW_H
 #define ADALGL_VIEW_H
 
+#include "adal_archive.h"
 #include "adal_pch.h"
-
-// ###################################################################
-//                          adlType
-// ###################################################################
-typedef std::unordered_map<std::string, GLint> adlUniformLocationMap;
+#include "adal_program_cache.h"
+#include "adal_shader_preprocessor.h"
+#include "adal_string.h"
 
 // ###################################################################
 //                          adlColor
@@ -71,12 +70,113 @@ struct adlTexture {
     };
 };
 
+// ###################################################################
+//                          adlUniform
+// ###################################################################
+struct adlUniform {
+    adlStringID   name;          ///< Interned name, array uniforms without their "[0]".
+    GLint         location;
+    GLenum        type;
+    GLsizei       count;         ///< Array length, 1 for plain uniforms.
+    std::uint32_t shadowOffset;  ///< Where the last submitted value lives in adlUniformTable::shadow.
+    bool          isWritten;     ///< False until a value went to GL, so the first set is never filtered.
+};
+
+/// @return The byte size of one element of a uniform type, or 0 for types the uniform setters do not handle.
+std::uint32_t adlUniformTypeSize(GLenum type);
+
+// ###################################################################
+//                          adlUniformTable
+// -------------------------------------------------------------------
+// The active uniforms of a program, reflected once at link time and
+// sorted by interned name. Also keeps the last value sent for each,
+// which is what lets adlUniformState drop redundant sets.
+// ###################################################################
+struct adlUniformTable {
+    std::vector<adlUniform> uniforms;
+    std::vector<std::byte>  shadow;
+
+    /// Finds a uniform by interned name.
+    ///
+    /// @return The uniform, or nullptr if the program has no such active uniform.
+    [[nodiscard]] adlUniform *find(adlStringID name);
+};
+
 // ###################################################################
 //                          adlShader
 // ###################################################################
 struct adlShader {
-    GLuint                shaderProgramID;
-    adlUniformLocationMap uniformLocationMap;
+    GLuint          shaderProgramID;
+    adlUniformTable uniforms;
+};
+
+// ###################################################################
+//                          adlFrameUniforms
+// -------------------------------------------------------------------
+// std140 layout of the FrameData uniform block, written once per
+// frame and shared by every program that declares the block.
+// ###################################################################
+struct adlFrameUniforms {
+    static constexpr GLuint      BINDING    = 0;
+    static constexpr const char *BLOCK_NAME = "FrameData";
+
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec4 time;  ///< (simulation seconds, interpolation alpha, frame index, 0)
+};
+
+static_assert(sizeof(adlFrameUniforms) == 144, "adlFrameUniforms must match the std140 FrameData block");
+
+// ###################################################################
+//                          adlUniformBackend
+// -------------------------------------------------------------------
+// Where uniform values end up. The GL backend issues the calls, a
+// recording backend can stand in to check what would be sent.
+// ###################################################################
+struct adlUniformBackend {
+    virtual ~adlUniformBackend() = default;
+
+    /// Sends count elements of a uniform to a program, without binding it.
+    virtual void setUniform(GLuint programID, GLint location, GLenum type, GLsizei count, const void *data) = 0;
+};
+
+struct adlGLUniformBackend final : adlUniformBackend {
+    void setUniform(GLuint programID, GLint location, GLenum type, GLsizei count, const void *data) override;
+};
+
+// ###################################################################
+//                          adlUniformState
+// -------------------------------------------------------------------
+// Front end for per-draw uniforms. Compares every value against the
+// program's shadow copy and only forwards changed ones.
+// ###################################################################
+class adlUniformState {
+private:
+    adlUniformBackend *m_backend;
+    std::size_t        m_submitted = 0, m_skipped = 0;
+
+public:
+    explicit adlUniformState(adlUniformBackend &backend) : m_backend(&backend) {};
+
+    /// Sets a uniform by interned name.
+    ///
+    /// @param shader The program to set it on.
+    /// @param name The interned uniform name.
+    /// @param data count tightly packed elements of the uniform's type.
+    /// @param count Number of array elements to set.
+    /// @return False if the program has no such uniform or the type is not handled.
+    bool set(adlShader &shader, adlStringID name, const void *data, GLsizei count = 1);
+
+    template<typename T>
+    inline bool set(adlShader &shader, const adlStringID name, const T &value) {
+        return set(shader, name, &value, 1);
+    };
+
+    /// @return Number of uniform sets forwarded to the backend.
+    [[nodiscard]] inline std::size_t submittedCount() const { return m_submitted; };
+
+    /// @return Number of uniform sets dropped because the value did not change.
+    [[nodiscard]] inline std::size_t skippedCount() const { return m_skipped; };
 };
 
 // ###################################################################
@@ -89,16 +189,237 @@ struct adlFrameBuffer {
     bool                        m_shouldResize, m_isUseRBO;
 };
 
+// ###################################################################
+//                          adlStreamBackend
+// -------------------------------------------------------------------
+// Storage and synchronisation primitives used by adlStreamBuffer.
+// The buffer only does region bookkeeping, every GL call lives here.
+// ###################################################################
+struct adlStreamBackend {
+    virtual ~adlStreamBackend() = default;
+
+    /// Allocates the backing storage and maps it for writing for its whole lifetime.
+    ///
+    /// @param bytes The total size of the storage, all regions included.
+    /// @return The mapped pointer, or nullptr on failure.
+    virtual std::byte *create(std::size_t bytes) = 0;
+
+    /// Releases the storage and every pending fence.
+    virtual void destroy() = 0;
+
+    /// Makes a written byte range visible to the GPU.
+    ///
+    /// @param offset The offset of the range from the start of the storage.
+    /// @param bytes The size of the range.
+    virtual void flush(std::size_t offset, std::size_t bytes) = 0;
+
+    /// Inserts a fence marking the end of the GPU commands reading a region.
+    ///
+    /// @param region The region index.
+    virtual void fence(std::size_t region) = 0;
+
+    /// Waits until the GPU is done with a region, then forgets its fence.
+    ///
+    /// @param region The region index.
+    /// @param timeoutNs How long to wait, in nanoseconds.
+    /// @return True if the region is free to overwrite, false on timeout.
+    virtual bool waitFence(std::size_t region, std::uint64_t timeoutNs) = 0;
+
+    /// @return The GL buffer name, or 0 when the backend is not GL backed.
+    [[nodiscard]] virtual GLuint bufferID() const = 0;
+};
+
+// ###################################################################
+//                          adlGLStreamBackend
+// ###################################################################
+class adlGLStreamBackend final : public adlStreamBackend {
+private:
+    GLenum                       m_target;
+    GLuint                       m_bufferID   = 0;
+    bool                         m_persistent = false;
+    std::vector<std::byte>       m_shadow;  ///< CPU copy used when ARB_buffer_storage is unavailable.
+    std::unordered_map<std::size_t, GLsync> m_fences;
+
+public:
+    /// @param target The buffer binding target, e.g. GL_ARRAY_BUFFER.
+    explicit adlGLStreamBackend(GLenum target = GL_ARRAY_BUFFER)
+        : m_target(target) {
+    };
+
+    ~adlGLStreamBackend() override { adlGLStreamBackend::destroy(); };
+
+    std::byte *create(std::size_t bytes) override;
+    void destroy() override;
+    void flush(std::size_t offset, std::size_t bytes) override;
+    void fence(std::size_t region) override;
+    bool waitFence(std::size_t region, std::uint64_t timeoutNs) override;
+
+    [[nodiscard]] GLuint bufferID() const override { return m_bufferID; };
+};
+
+// ###################################################################
+//                          adlCPUStreamBackend
+// -------------------------------------------------------------------
+// Heap backed storage for headless runs. There is no GPU to wait on,
+// so fences only record which regions were submitted.
+// ###################################################################
+class adlCPUStreamBackend final : public adlStreamBackend {
+private:
+    std::vector<std::byte>          m_storage;
+    std::unordered_set<std::size_t> m_pendingFences;
+
+public:
+    std::byte *create(std::size_t bytes) override {
+        m_storage.assign(bytes, std::byte{0});
+        return m_storage.data();
+    };
+
+    void destroy() override {
+        m_storage.clear();
+        m_pendingFences.clear();
+    };
+
+    void flush(std::size_t, std::size_t) override {};
+
+    void fence(const std::size_t region) override { m_pendingFences.insert(region); };
+
+    bool waitFence(const std::size_t region, std::uint64_t) override {
+        m_pendingFences.erase(region);
+        return true;
+    };
+
+    [[nodiscard]] GLuint bufferID() const override { return 0; };
+};
+
+// ###################################################################
+//                          adlStreamBuffer
+// -------------------------------------------------------------------
+// Triple-buffered streaming buffer. Each frame writes linearly into
+// its own region, and a region is only reused once the fence placed
+// at the end of its frame has signalled.
+// ###################################################################
+class adlStreamBuffer {
+public:
+    static constexpr std::size_t REGION_COUNT = 3;
+
+    struct Allocation {
+        std::byte  *data;    ///< Write pointer, nullptr if the region is full.
+        std::size_t offset;  ///< Offset from the start of the buffer, usable as a GL buffer offset.
+    };
+
+private:
+    std::unique_ptr<adlStreamBackend> m_backend;
+    std::byte                        *m_mapped     = nullptr;
+    std::size_t                       m_regionSize = 0;
+    std::size_t                       m_region     = 0;
+    std::size_t                       m_head       = 0;
+    std::size_t                       m_flushBegin = 0;
+    bool                              m_inFrame    = false;
+
+public:
+    adlStreamBuffer() = default;
+
+    adlStreamBuffer(const adlStreamBuffer &) = delete;
+
+    adlStreamBuffer &operator=(const adlStreamBuffer &) = delete;
+
+    ~adlStreamBuffer();
+
+    /// Creates the storage for all regions.
+    ///
+    /// @param backend The storage backend, owned by the stream buffer afterwards.
+    /// @param regionSize The number of bytes a single frame may write.
+    /// @return True if the backend could create and map the storage.
+    bool init(std::unique_ptr<adlStreamBackend> backend, std::size_t regionSize);
+
+    /// Waits for the GPU to release the current region and rewinds its write pointer.
+    ///
+    /// @param timeoutNs How long to wait on the region fence, in nanoseconds.
+    /// @return False if the fence timed out, in which case nothing may be written this frame.
+    bool beginFrame(std::uint64_t timeoutNs = 1'000'000'000);
+
+    /// Reserves bytes in the current region.
+    ///
+    /// @param bytes The number of bytes to reserve.
+    /// @param alignment The offset granularity, e.g. sizeof(adlVertex) to draw with a base vertex.
+    /// @return The allocation, with a null data pointer if the region cannot fit it.
+    Allocation allocate(std::size_t bytes, std::size_t alignment = 16);
+
+    /// Makes the bytes written since the last flush visible to the GPU. Call it before drawing from them.
+    void flush();
+
+    /// Flushes the bytes written this frame, fences the region and advances to the next one.
+    void endFrame();
+
+    [[nodiscard]] inline GLuint bufferID() const { return m_backend ? m_backend->bufferID() : 0; };
+
+    [[nodiscard]] inline std::size_t regionSize() const { return m_regionSize; };
+
+    [[nodiscard]] inline std::size_t currentRegion() const { return m_region; };
+
+    [[nodiscard]] inline std::size_t bytesUsed() const { return m_head; };
+};
+
+// ###################################################################
+//                          adlImage
+// ###################################################################
+struct adlImageDeleter {
+    void operator()(unsigned char *pixels) const;
+};
+
+/// RGBA8 pixels, CPU side only. Either owns decoded pixels or views pre-decoded ones in a mapped archive.
+struct adlImage {
+    int                                             width = 0, height = 0;
+    std::unique_ptr<unsigned char[], adlImageDeleter> pixels;
+    const unsigned char                            *view = nullptr;
+
+    [[nodiscard]] inline const unsigned char *data() const { return pixels ? pixels.get() : view; };
+
+    [[nodiscard]] inline std::size_t byteSize() const {
+        return static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4;
+    };
+};
+
 // ###################################################################
 //                          adlTextureLoader
 // ###################################################################
 struct adlTextureLoader {
+    /// Decodes an image file into RGBA8 pixels. Touches no GL state, so it is safe on any thread.
+    ///
+    /// @param texturePath The path to the texture image file.
+    /// @param image The decoded image will be stored here.
+    /// @return True if the image was decoded successfully, false otherwise.
+    static bool decodeImage(const std::string &texturePath, adlImage &image);
+
+    /// Decodes an encoded image (PNG, JPEG, ...) held in memory into RGBA8 pixels.
+    ///
+    /// @param encoded The encoded file contents.
+    /// @param image The decoded image will be stored here.
+    /// @return True if the image was decoded successfully, false otherwise.
+    static bool decodeImage(std::span<const std::byte> encoded, adlImage &image);
+
+    /// Resolves a texture through an archive first and falls back to the file system.
+    /// Pre-decoded archive entries are viewed in place without any copy or decode.
+    ///
+    /// @param texturePath The texture's path, also its archive entry name.
+    /// @param image The image will be stored here.
+    /// @param archive The archive to look in, or nullptr to read the file directly.
+    /// @return True if the image is available, false otherwise.
+    static bool loadImage(const std::string &texturePath, adlImage &image, const adlArchive *archive = nullptr);
+
+    /// Creates a GL texture from decoded pixels. Must run on the thread owning the GL context.
+    ///
+    /// @param image The decoded image.
+    /// @param isPixelated Whether to sample with nearest filtering instead of linear.
+    /// @return The texture ID, or 0 on failure.
+    static GLuint uploadImage(const adlImage &image, bool isPixelated);
+
     /// Loads a texture from the specified file path.
     ///
     /// @param texturePath The path to the texture image file.
     /// @param width The width of the loaded texture will be stored here.
     /// @param height The height of the loaded texture will be stored here.
-    /// @param isPixelated Whether to apply pixelation effects to the texture.
+    /// @param isPixelated Whether to sample with nearest filtering instead of linear.
     /// @return True if the texture is loaded successfully, false otherwise.
     static bool adlLoadTexture(const std::string& texturePath, int &width, int &height, bool isPixelated);
 
@@ -106,8 +427,10 @@ struct adlTextureLoader {
     ///
     /// @param texturePath The path to the texture image file.
     /// @param textureType The type of the texture (2D, cubemap, etc.).
+    /// @param archive The archive to resolve the path through, or nullptr to read the file directly.
     /// @return A shared pointer to the created adlTexture object, or nullptr on failure.
-    static std::shared_ptr<adlTexture> makeADLTexture(const std::string &texturePath, adlTextureType textureType);
+    static std::shared_ptr<adlTexture> makeADLTexture(const std::string &texturePath, adlTextureType textureType
+                                                    , const adlArchive *archive = nullptr);
 };
 
 // ###################################################################
@@ -115,33 +438,86 @@ struct adlTextureLoader {
 // -------------------------------------------------------------------
 struct adlShaderLoader {
 private:
-    ///  Compiles a GL shader of the specified type from the given shader path.
+    ///  Compiles a GL shader of the specified type from source text.
     ///
     ///  @param shaderType The type of shader (GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, etc.).
-    ///  @param shaderPath The path to the shader source file.
+    ///  @param source The shader source, not necessarily null terminated.
+    ///  @param path The file the source came from, named in the compile log.
     ///  @return The ID of the compiled shader, or 0 on failure.
-    static GLuint compileGLShader(GLuint shaderType, const std::string &shaderPath);
+    static GLuint compileGLShaderSource(GLuint shaderType, std::string_view source, std::string_view path);
 
-    /// Checks if the compilation of the shader was successful.
+    /// Checks if the compilation of the shader was successful, printing the compile log with the path if not.
     ///
     /// @param shaderID The ID of the shader to check.
+    /// @param path The file the shader was compiled from.
     /// @return True if compilation was successful, false otherwise.
-    static bool isCompileSuccess(GLuint shaderID);
+    static bool isCompileSuccess(GLuint shaderID, std::string_view path);
 
-    /// Checks if the GL program is valid.
+    /// Checks if the GL program is valid, printing the link log with both paths if not.
     ///
     /// @param programID The ID of the program to check.
+    /// @param vertPath The file the vertex shader was compiled from.
+    /// @param fragPath The file the fragment shader was compiled from.
     /// @return True if the program is valid, false otherwise.
-    static bool isValidGLProgram(GLuint programID);
+    static bool isValidGLProgram(GLuint programID, std::string_view vertPath, std::string_view fragPath);
+
+    /// Creates a program from a cached binary.
+    ///
+    /// @return The ID of the program, or 0 on a miss or if the driver rejected the binary.
+    static GLuint loadGLProgramBinary(std::uint64_t key, adlProgramCache &cache);
+
+    /// Compiles and links a program from sources.
+    ///
+    /// @param vertPath The file the vertex source came from, named in the logs.
+    /// @param fragPath The file the fragment source came from, named in the logs.
+    /// @param isRetrievable Whether glGetProgramBinary will be asked for the result.
+    /// @return The ID of the program, or 0 on failure.
+    static GLuint linkGLProgram(std::string_view vertSource, std::string_view fragSource
+                              , std::string_view vertPath, std::string_view fragPath, bool isRetrievable);
 
 public:
+    /// Reads a shader source in one go.
+    ///
+    /// @param shaderPath The path to the shader source file, also its archive entry name.
+    /// @param archive The archive to resolve the path through, or nullptr to read the file directly.
+    /// @param source The source will be stored here.
+    /// @return True if the source was read.
+    static bool readShaderSource(const std::string &shaderPath, const adlArchive *archive, std::string &source);
+
+    /// @return Vendor, renderer and version of the current GL driver, the part of a program cache key that is not source.
+    static std::string driverIdentity();
+
+    /// Reads the active uniforms of a linked program into a table and binds its FrameData block, if any.
+    ///
+    /// @param programID The ID of a successfully linked program.
+    /// @return The program's uniforms, sorted by interned name.
+    static adlUniformTable reflectUniforms(GLuint programID);
+
     /// Creates a shared pointer to an adlShader object, compiling and linking the given shaders.
     ///
     /// @param vertShaderPath The path to the vertex shader source file.
     /// @param fragShaderPath The path to the fragment shader source file.
+    /// @param archive The archive to resolve both paths through, or nullptr to read the files directly.
+    /// @param cache The program binary cache to try before compiling and to fill after, or nullptr to always compile.
     /// @return A shared pointer to the created adlShader object, or nullptr on failure.
     static std::shared_ptr<adlShader> makeADLShader(const std::string &vertShaderPath
-                                                  , const std::string &fragShaderPath);
+                                                  , const std::string &fragShaderPath
+                                                  , const adlArchive *archive = nullptr
+                                                  , adlProgramCache *cache = nullptr);
+
+    /// Creates a shared pointer to an adlShader object from shader sources.
+    ///
+    /// @param vertSource The vertex shader source.
+    /// @param fragSource The fragment shader source.
+    /// @param cache The program binary cache to try before compiling and to fill after, or nullptr to always compile.
+    /// @param vertPath The file the vertex source came from, named if it fails to compile or link.
+    /// @param fragPath The file the fragment source came from, named if it fails to compile or link.
+    /// @return A shared pointer to the created adlShader object, or nullptr on failure.
+    static std::shared_ptr<adlShader> makeADLShaderFromSource(std::string_view vertSource
+                                                            , std::string_view fragSource
+                                                            , adlProgramCache *cache = nullptr
+                                                            , std::string_view vertPath = "<vertex source>"
+                                                            , std::string_view fragPath = "<fragment source>");
 };
 
 #endif //ADALGL_VIEW_H
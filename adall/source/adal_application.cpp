@@ -1,7 +1,95 @@
+#include <charconv>
+
 #include "adall/adal_application.h"
 
 #include "adall/adal_component.h"
+#include "adall/adal_culling.h"
+#include "adall/adal_hierarchy.h"
+#include "adall/adal_memory.h"
+#include "adall/adal_profiler.h"
+#include "adall/adal_scene.h"
+#include "adall/adal_spatial.h"
 #include "adall/adal_system.h"
+#include "adall/adal_time.h"
+
+adlApplicationConfig adlApplication::s_config;
+
+/// @brief Reads a whole argument value as a finite number above zero.
+template<typename TNumber>
+static bool parsePositive(const std::string_view text, TNumber &value) {
+	TNumber parsed{};
+	const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), parsed);
+	if (error != std::errc{} || end != text.data() + text.size() || !(parsed > 0)) {
+		return false;
+	}
+	if constexpr (std::is_floating_point_v<TNumber>) {
+		if (!std::isfinite(parsed)) {
+			return false;
+		}
+	}
+
+	value = parsed;
+	return true;
+}
+
+static void printUsage(const char *program) {
+	std::cout << "usage: " << program << " [--headless] [--no-vsync] [--step=<seconds>] [--max-steps=<n>] [--frames=<n>]\n"
+	          << "       [--archive=<path>] [--program-cache=<directory>] [--render-thread] [--hot-reload] [--scene=<path>]\n"
+	          << "numbers have to be above zero" << std::endl;
+}
+
+bool adlApplicationConfig::fromArguments(const int argc, char **argv, adlApplicationConfig &config) {
+	config = {};
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string argument = argv[i];
+		const auto        value    = argument.substr(argument.find('=') + 1);
+
+		bool isValid = true;
+		if (argument == "--headless") {
+			config.headless = true;
+		}
+		else if (argument == "--no-vsync") {
+			config.vsync = false;
+		}
+		else if (argument.starts_with("--step=")) {
+			isValid = parsePositive(value, config.fixedStep);
+		}
+		else if (argument.starts_with("--max-steps=")) {
+			isValid = parsePositive(value, config.maxCatchUpSteps);
+		}
+		else if (argument.starts_with("--frames=")) {
+			isValid = parsePositive(value, config.maxFrames);
+		}
+		else if (argument.starts_with("--archive=")) {
+			config.archivePath = value;
+		}
+		else if (argument.starts_with("--program-cache=")) {
+			config.programCachePath = value;
+		}
+		else if (argument == "--render-thread") {
+			config.renderThread = true;
+		}
+		else if (argument == "--hot-reload") {
+			config.hotReload = true;
+		}
+		else if (argument.starts_with("--scene=")) {
+			config.scenePath = value;
+		}
+
+		if (!isValid) {
+			std::cout << "invalid argument " << argument << std::endl;
+			printUsage(argv[0]);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void adlApplication::configure(const adlApplicationConfig &config) {
+	s_config = config;
+}
 
 adlApplication::adlApplication()
 	: m_window(nullptr) {
@@ -13,6 +101,11 @@ adlApplication::adlApplication()
 	}
 }
 
+adlApplication::~adlApplication() {
+	// the renderer's GL objects belong to the render thread's context
+	m_renderThread.stop();
+}
+
 bool adlApplication::setupGLFW() {
 	if (!glfwInit()) {
 		std::cout << "failed to initialize glfw" << std::endl;
@@ -30,6 +123,9 @@ bool adlApplication::setupGLFW() {
 		return false;
 	}
 	glfwMakeContextCurrent(m_window);
+	glfwSwapInterval(s_config.vsync ? 1 : 0);
+	glfwSetWindowUserPointer(m_window, this);
+	glfwSetFramebufferSizeCallback(m_window, onFramebufferResize);
 
 	if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
 		return false;
@@ -38,13 +134,71 @@ bool adlApplication::setupGLFW() {
 	return true;
 }
 
+void adlApplication::onFramebufferResize(GLFWwindow *window, const int width, const int height) {
+	const auto *application = static_cast<adlApplication *>(glfwGetWindowUserPointer(window));
+	if (application == nullptr || application->m_registry == nullptr) {
+		return;
+	}
+
+	// events are polled between scheduler runs, so the camera system is idle here
+	if (const auto *camera2D = application->m_registry->getRegistry().ctx().find<std::shared_ptr<adlSystem::Camera2D> >(); camera2D != nullptr) {
+		(*camera2D)->resize(width, height);
+	}
+}
+
 bool adlApplication::setupAdallCore() {
 	m_registry = std::make_unique<adlCore::adlRegistry>();
-	m_editor   = std::make_unique<adlEditor>(m_window);
-	m_editor->init();
+	if (!s_config.headless) {
+		m_editor = std::make_unique<adlEditor>(m_window);
+		m_editor->init();
+	}
+
+	m_registry->adlAddContext<adlCore::adlFrameTime>(adlCore::adlFrameTime{.fixedStep = s_config.fixedStep});
+
+	if (const auto jobSystem = std::make_shared<adlCore::adlJobSystem>(); !m_registry->adlAddContext<
+		std::shared_ptr<adlCore::adlJobSystem> >(jobSystem)) {
+		return false;
+	}
+
+	if (const auto frameMemory = std::make_shared<adlCore::adlFrameMemory>(); !m_registry->adlAddContext<
+		std::shared_ptr<adlCore::adlFrameMemory> >(frameMemory)) {
+		return false;
+	}
+
+	const auto scheduler = std::make_shared<adlCore::adlScheduler>();
+	if (!m_registry->adlAddContext<std::shared_ptr<adlCore::adlScheduler> >(scheduler)) {
+		return false;
+	}
+
+	const auto camera2D = std::make_shared<adlSystem::Camera2D>(*m_registry, m_window);
+	if (!m_registry->adlAddContext<std::shared_ptr<adlSystem::Camera2D> >(camera2D)) {
+		return false;
+	}
+	scheduler->addSystem("Camera2D", camera2D);
+
+	// registered after anything that moves entities, so its update sees this step's moves
+	const auto hierarchy = std::make_shared<adlSystem::Hierarchy>(*m_registry);
+	if (!m_registry->adlAddContext<std::shared_ptr<adlSystem::Hierarchy> >(hierarchy)) {
+		return false;
+	}
+	scheduler->addSystem("Hierarchy", hierarchy);
+
+	// after the hierarchy, so it files this step's world matrices
+	const auto spatialIndex = std::make_shared<adlSystem::SpatialIndex>(*m_registry);
+	if (!m_registry->adlAddContext<std::shared_ptr<adlSystem::SpatialIndex> >(spatialIndex)) {
+		return false;
+	}
+	scheduler->addSystem("SpatialIndex", spatialIndex);
+
+	const auto culling = std::make_shared<adlSystem::Culling>();
+	if (!m_registry->adlAddContext<std::shared_ptr<adlSystem::Culling> >(culling)) {
+		return false;
+	}
+	scheduler->addSystem("Culling", culling);
 
-	if (const auto camera2D = std::make_shared<adlSystem::Camera2D>(m_window); !m_registry->adlAddContext<
-		std::shared_ptr<adlSystem::Camera2D> >(camera2D)) {
+	// one command buffer per worker plus one for threads outside the pool
+	const auto renderQueue = std::make_shared<adlRenderQueue>(m_registry->adlGetContext<std::shared_ptr<adlCore::adlJobSystem> >()->threadCount() + 1);
+	if (!m_registry->adlAddContext<std::shared_ptr<adlRenderQueue> >(renderQueue)) {
 		return false;
 	}
 
@@ -53,11 +207,25 @@ bool adlApplication::setupAdallCore() {
 		return false;
 	}
 
-	if (!assetManager->makeShader(
+	if (!s_config.archivePath.empty() && !assetManager->mountArchive(s_config.archivePath)) {
+		return false;
+	}
+
+	// a cache that cannot be opened only costs the compile time, it does not stop start-up
+	if (!s_config.headless && !s_config.programCachePath.empty()) {
+		assetManager->openProgramCache(s_config.programCachePath);
+	}
+
+	// before the first asset, so its files are watched as they load
+	if (s_config.hotReload && !assetManager->watchAssets()) {
+		std::cout << "hot reload is not available on this platform" << std::endl;
+	}
+
+	if (!s_config.headless && !assetManager->makeShader(
 	                         "shader",
 	                         "asset/shader/basic.vert.glsl",
 	                         "asset/shader/basic.frag.glsl"
-	                        )) {
+	                        ).isValid()) {
 		return false;
 	};
 
@@ -66,9 +234,16 @@ bool adlApplication::setupAdallCore() {
 		return false;
 	}
 
+	// after the entity manager and hierarchy, so they index the loaded names and parents
+	if (!s_config.scenePath.empty() && !adlCore::adlScene::load(*m_registry, s_config.scenePath)) {
+		return false;
+	}
+
 	auto em     = m_registry->adlGetContext<std::shared_ptr<adlCore::adlEntityManager> >();
 	auto camera = em->makeEntity();
-	camera.addComponent<adlComponent::Camera>();
+	camera.addComponent<adlComponent::Camera>(adlComponent::Camera{.width = 640, .height = 480, .scale = 1.0f});
+	camera.addComponent<adlComponent::Visibility>();
+	m_registry->adlGetContext<std::shared_ptr<adlSystem::Camera2D> >()->setMainCamera(camera.getEntity());
 
 
 	return true;
@@ -78,7 +253,7 @@ void adlApplication::makeGraphicsPipeline() {
 }
 
 bool adlApplication::init() {
-	if (!setupGLFW()) {
+	if (!s_config.headless && !setupGLFW()) {
 		std::cout << "failed to create glfw window" << std::endl;
 		return false;
 	}
@@ -91,14 +266,148 @@ bool adlApplication::init() {
 	return true;
 }
 
-void adlApplication::run() {
-	while (!glfwWindowShouldClose(m_window) && m_running) {
-		glClearColor(0, 0, 0, 1);
-		glClear(GL_COLOR_BUFFER_BIT);
-		m_editor->render();
+void adlApplication::renderFrame() {
+	const auto  renderQueue = m_registry->adlGetContext<std::shared_ptr<adlRenderQueue> >();
+	const auto  camera2D    = m_registry->adlGetContext<std::shared_ptr<adlSystem::Camera2D> >();
+	const auto &frameTime   = m_registry->adlGetContext<adlCore::adlFrameTime>();
+
+	const bool isThreaded = m_renderThread.isRunning();
+
+	// drawing here, this frame's reloads and uploads go first so its commands name the GL objects they made;
+	// a render thread runs them on submit, after recording, and the asset manager keeps the replaced ones a frame
+	if (!isThreaded) {
+		syncAssets();
+	}
+
+	m_spriteRecorder.record(*m_registry, *renderQueue, camera2D->mainCamera());
+	renderQueue->merge();
+	renderQueue->sort();
+
+	m_frame.commands.swap(renderQueue->sorted());
+	m_frame.shaders.assign(m_spriteRecorder.shaders().begin(), m_spriteRecorder.shaders().end());
+	m_frame.uniforms = {
+		.view = camera2D->view(),
+		.projection = camera2D->projection(),
+		.time = {frameTime.simulationTime, frameTime.alpha, static_cast<float>(frameTime.frameIndex), 0.0f},
+	};
+	m_frame.viewport = camera2D->framebufferSize();
+
+	if (isThreaded) {
+		m_frame.syncTasks.emplace_back([this, shaders = m_frame.shaders] {
+			syncAssets();
+			setProgramUniforms(shaders);
+		});
+		m_renderThread.submit(m_frame);
+	}
+	else {
+		setProgramUniforms(m_frame.shaders);
+		drawFrame(m_frame);
+		m_editor->render(*m_registry);
 		glfwSwapBuffers(m_window);
-		glfwPollEvents();
+		m_frame.commands.clear();
+		m_frame.shaders.clear();
+	}
+
+	renderQueue->reset();
+	glfwPollEvents();
+}
+
+void adlApplication::syncAssets() {
+	const auto assetManager = m_registry->adlGetContext<std::shared_ptr<adlCore::adlAssetManager> >();
+	assetManager->processReloads();
+	assetManager->processUploads();
+}
+
+void adlApplication::setProgramUniforms(const std::vector<adlCore::adlShaderHandle> &shaders) {
+	const auto assetManager = m_registry->adlGetContext<std::shared_ptr<adlCore::adlAssetManager> >();
+
+	// after the reloads, so a program swapped in under its old handle gets its values this frame
+	for (const auto handle: shaders) {
+		if (adlShader *shader = assetManager->getShader(handle); shader != nullptr) {
+			m_renderer->setProgramUniforms(*shader);
+		}
+	}
+}
+
+void adlApplication::drawFrame(adlRenderFrame &frame) {
+	if (frame.viewport.x > 0 && frame.viewport.y > 0) {
+		glViewport(0, 0, frame.viewport.x, frame.viewport.y);
+	}
+	glClearColor(0, 0, 0, 1);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	if (frame.commands.empty()) {
+		return;
+	}
+
+	m_renderer->setFrameUniforms(frame.uniforms);
+	adlRenderQueue::build(frame.commands, m_batch);
+	m_renderer->render(m_batch);
+}
+
+void adlApplication::run() {
+	if (!m_running) {
+		return;
+	}
+
+	const auto scheduler   = m_registry->adlGetContext<std::shared_ptr<adlCore::adlScheduler> >();
+	const auto jobSystem   = m_registry->adlGetContext<std::shared_ptr<adlCore::adlJobSystem> >();
+	const auto frameMemory = m_registry->adlGetContext<std::shared_ptr<adlCore::adlFrameMemory> >();
+	auto      &frameTime   = m_registry->adlGetContext<adlCore::adlFrameTime>();
+
+	adlCore::adlFixedTimestep timestep(s_config.fixedStep, s_config.maxCatchUpSteps);
+	frameTime.fixedStep = timestep.step();
+
+	if (!s_config.headless && s_config.renderThread) {
+		std::cout << "drawing on a render thread, the editor is disabled" << std::endl;
+		m_renderThread.start(m_window,
+		                     [this] { m_renderer = std::make_unique<adlSystem::Renderer>(m_window); },
+		                     [this](adlRenderFrame &frame) {
+			                     drawFrame(frame);
+			                     glfwSwapBuffers(m_window);
+		                     },
+		                     [this] { m_renderer.reset(); });
+	}
+	else if (!s_config.headless) {
+		m_renderer = std::make_unique<adlSystem::Renderer>(m_window);
+	}
+
+	adlCore::adlProfiler::global().setThreadName("main");
+
+	double lastTime = s_config.headless ? 0.0 : glfwGetTime();
+	while (m_running && (s_config.headless || !glfwWindowShouldClose(m_window))) {
+		// headless runs on a virtual clock: one step per loop, as fast as the CPU allows
+		double elapsed = timestep.step();
+		if (!s_config.headless) {
+			const double currentTime = glfwGetTime();
+			elapsed                  = currentTime - lastTime;
+			lastTime                 = currentTime;
+		}
+
+		// nothing from the last frame is alive any more: the workers are idle and the render frame owns its own storage
+		frameMemory->reset();
+
+		const int steps = timestep.advance(elapsed);
+		for (int step = 0; step < steps; ++step) {
+			ADL_PROFILE_ZONE("Simulation step");
+			scheduler->run(*m_registry, *jobSystem, static_cast<float>(timestep.step()));
+			frameTime.simulationTime += timestep.step();
+			++frameTime.stepIndex;
+		}
+		frameTime.alpha = timestep.alpha();
+
+		if (!s_config.headless) {
+			ADL_PROFILE_ZONE("Render frame");
+			renderFrame();
+		}
+		ADL_PROFILE_FRAME();
+
+		++frameTime.frameIndex;
+		if (s_config.maxFrames != 0 && frameTime.frameIndex >= s_config.maxFrames) {
+			m_running = false;
+		}
 	}
+	m_renderThread.stop();
 }
 
 adlApplication &adlApplication::getInstance() {
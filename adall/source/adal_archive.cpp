@@ -0,0 +1,216 @@
+#include "adall/adal_archive.h"
+
+#if defined(_WIN32)
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* -------------------------------------------------------------------------
+	adlMappedFile
+--------------------------------------------------------------------------*/
+bool adlMappedFile::open(const std::string &path) {
+	close();
+
+#if defined(_WIN32)
+	std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+	if (ifs.fail()) {
+		return false;
+	}
+
+	m_fallback.resize(static_cast<std::size_t>(ifs.tellg()));
+	ifs.seekg(0);
+	ifs.read(reinterpret_cast<char *>(m_fallback.data()), static_cast<std::streamsize>(m_fallback.size()));
+
+	m_data = m_fallback.data();
+	m_size = m_fallback.size();
+	return !ifs.fail();
+#else
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat status{};
+	if (fstat(fd, &status) != 0 || status.st_size <= 0) {
+		::close(fd);
+		return false;
+	}
+
+	void *mapped = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping keeps the file alive, the descriptor is not needed anymore
+	::close(fd);
+	if (mapped == MAP_FAILED) {
+		return false;
+	}
+
+	m_data = static_cast<const std::byte *>(mapped);
+	m_size = static_cast<std::size_t>(status.st_size);
+	return true;
+#endif
+}
+
+void adlMappedFile::close() {
+#if !defined(_WIN32)
+	if (m_data != nullptr) {
+		munmap(const_cast<std::byte *>(m_data), m_size);
+	}
+#endif
+	m_fallback.clear();
+	m_data = nullptr;
+	m_size = 0;
+}
+
+/* -------------------------------------------------------------------------
+	adlArchive
+--------------------------------------------------------------------------*/
+bool adlArchive::open(const std::string &archivePath) {
+	m_entries = {};
+	m_strings = {};
+
+	if (!m_file.open(archivePath)) {
+		return false;
+	}
+
+	const auto bytes = m_file.bytes();
+	if (bytes.size() < sizeof(adlArchiveHeader)) {
+		m_file.close();
+		return false;
+	}
+
+	adlArchiveHeader header{};
+	std::memcpy(&header, bytes.data(), sizeof(header));
+
+	const std::uint64_t tableSize = static_cast<std::uint64_t>(header.entryCount) * sizeof(adlArchiveEntry);
+	if (header.magic != adlArchiveHeader::MAGIC || header.version != adlArchiveHeader::VERSION
+	    || header.entryTableOffset % alignof(adlArchiveEntry) != 0
+	    || header.entryTableOffset + tableSize > header.stringTableOffset
+	    || header.stringTableOffset > bytes.size()) {
+		m_file.close();
+		return false;
+	}
+
+	m_entries = {reinterpret_cast<const adlArchiveEntry *>(bytes.data() + header.entryTableOffset), header.entryCount};
+	m_strings = {reinterpret_cast<const char *>(bytes.data() + header.stringTableOffset), bytes.size() - header.stringTableOffset};
+
+	for (const auto &entry: m_entries) {
+		if (entry.dataOffset + entry.dataSize > bytes.size()
+		    || static_cast<std::uint64_t>(entry.nameOffset) + entry.nameLength > m_strings.size()) {
+			m_entries = {};
+			m_strings = {};
+			m_file.close();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+const adlArchiveEntry *adlArchive::find(const std::string_view name) const {
+	const std::uint64_t hash = adlHashName(name);
+
+	auto itr = std::lower_bound(m_entries.begin(), m_entries.end(), hash, [](const adlArchiveEntry &entry, const std::uint64_t value) {
+		return entry.nameHash < value;
+	});
+	for (; itr != m_entries.end() && itr->nameHash == hash; ++itr) {
+		if (this->name(*itr) == name) {
+			return &*itr;
+		}
+	}
+
+	return nullptr;
+}
+
+std::span<const std::byte> adlArchive::data(const adlArchiveEntry &entry) const {
+	return m_file.bytes().subspan(entry.dataOffset, entry.dataSize);
+}
+
+std::string_view adlArchive::name(const adlArchiveEntry &entry) const {
+	return m_strings.substr(entry.nameOffset, entry.nameLength);
+}
+
+/* -------------------------------------------------------------------------
+	adlArchiveWriter
+--------------------------------------------------------------------------*/
+bool adlArchiveWriter::add(const std::string &name, const adlArchiveEntryType type, const std::span<const std::byte> data
+                         , const std::uint32_t width, const std::uint32_t height) {
+	if (!m_names.insert(name).second) {
+		return false;
+	}
+
+	m_entries.push_back({
+		.name = name,
+		.type = type,
+		.width = width,
+		.height = height,
+		.data = {data.begin(), data.end()},
+	});
+	return true;
+}
+
+bool adlArchiveWriter::write(const std::string &archivePath) const {
+	constexpr std::uint64_t DATA_ALIGNMENT = 16;
+	const auto              alignUp        = [](const std::uint64_t value) {
+		return (value + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+	};
+
+	std::vector<adlArchiveEntry> table;
+	std::string                  strings;
+	table.reserve(m_entries.size());
+
+	std::uint64_t offset = alignUp(sizeof(adlArchiveHeader));
+	for (const auto &pending: m_entries) {
+		table.push_back({
+			.nameHash = adlHashName(pending.name),
+			.nameOffset = static_cast<std::uint32_t>(strings.size()),
+			.nameLength = static_cast<std::uint32_t>(pending.name.size()),
+			.dataOffset = offset,
+			.dataSize = pending.data.size(),
+			.type = pending.type,
+			.width = pending.width,
+			.height = pending.height,
+			.reserved = 0,
+		});
+		strings += pending.name;
+		offset = alignUp(offset + pending.data.size());
+	}
+
+	const adlArchiveHeader header{
+		.magic = adlArchiveHeader::MAGIC,
+		.version = adlArchiveHeader::VERSION,
+		.entryCount = static_cast<std::uint32_t>(table.size()),
+		.reserved = 0,
+		.entryTableOffset = offset,
+		.stringTableOffset = offset + table.size() * sizeof(adlArchiveEntry),
+	};
+
+	// data is laid out in insertion order, only the table is sorted for lookups
+	std::vector<adlArchiveEntry> sortedTable = table;
+	std::sort(sortedTable.begin(), sortedTable.end(), [](const adlArchiveEntry &lhs, const adlArchiveEntry &rhs) {
+		return lhs.nameHash < rhs.nameHash;
+	});
+
+	std::ofstream ofs(archivePath, std::ios::binary | std::ios::trunc);
+	if (ofs.fail()) {
+		return false;
+	}
+
+	const auto pad = [&ofs](const std::uint64_t target) {
+		static constexpr char zeros[DATA_ALIGNMENT] = {};
+		const auto            position              = static_cast<std::uint64_t>(ofs.tellp());
+		ofs.write(zeros, static_cast<std::streamsize>(target - position));
+	};
+
+	ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	for (std::size_t i = 0; i < m_entries.size(); ++i) {
+		pad(table[i].dataOffset);
+		ofs.write(reinterpret_cast<const char *>(m_entries[i].data.data()), static_cast<std::streamsize>(m_entries[i].data.size()));
+	}
+	pad(header.entryTableOffset);
+	ofs.write(reinterpret_cast<const char *>(sortedTable.data()), static_cast<std::streamsize>(sortedTable.size() * sizeof(adlArchiveEntry)));
+	ofs.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+	return !ofs.fail();
+}
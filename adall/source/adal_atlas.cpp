@@ -0,0 +1,240 @@
+#include <limits>
+#include <numeric>
+
+#include "adall/adal_atlas.h"
+
+/* -------------------------------------------------------------------------
+	adlSkylinePacker
+--------------------------------------------------------------------------*/
+void adlSkylinePacker::reset(const int width, const int height) {
+	m_width    = width;
+	m_height   = height;
+	m_usedArea = 0;
+	m_skyline.assign(1, {.x = 0, .y = 0, .width = width});
+}
+
+int adlSkylinePacker::fitAt(const std::size_t index, const int width, const int height) const {
+	const int x = m_skyline[index].x;
+	if (x + width > m_width) {
+		return -1;
+	}
+
+	// the rectangle rests on the highest segment it spans
+	int y         = 0;
+	int remaining = width;
+	for (std::size_t i = index; remaining > 0; ++i) {
+		if (i == m_skyline.size()) {
+			return -1;
+		}
+		y = std::max(y, m_skyline[i].y);
+		if (y + height > m_height) {
+			return -1;
+		}
+		remaining -= m_skyline[i].width;
+	}
+
+	return y;
+}
+
+bool adlSkylinePacker::insert(const int width, const int height, adlRect &placed) {
+	if (width <= 0 || height <= 0) {
+		return false;
+	}
+
+	std::size_t bestIndex = m_skyline.size();
+	int         bestTop = std::numeric_limits<int>::max(), bestWidth = std::numeric_limits<int>::max(), bestY = 0;
+
+	for (std::size_t i = 0; i < m_skyline.size(); ++i) {
+		const int y = fitAt(i, width, height);
+		if (y < 0) {
+			continue;
+		}
+
+		const int top = y + height;
+		if (top < bestTop || (top == bestTop && m_skyline[i].width < bestWidth)) {
+			bestIndex = i;
+			bestTop   = top;
+			bestWidth = m_skyline[i].width;
+			bestY     = y;
+		}
+	}
+
+	if (bestIndex == m_skyline.size()) {
+		return false;
+	}
+
+	placed = {.x = m_skyline[bestIndex].x, .y = bestY, .width = width, .height = height};
+
+	// raise the skyline under the new rectangle and trim the segments it now covers
+	m_skyline.insert(m_skyline.begin() + static_cast<std::ptrdiff_t>(bestIndex), {.x = placed.x, .y = bestTop, .width = width});
+
+	const int right = placed.x + width;
+	for (std::size_t i = bestIndex + 1; i < m_skyline.size();) {
+		auto &segment = m_skyline[i];
+		if (segment.x >= right) {
+			break;
+		}
+
+		const int overlap = right - segment.x;
+		if (overlap < segment.width) {
+			segment.x += overlap;
+			segment.width -= overlap;
+			break;
+		}
+		m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(i));
+	}
+
+	for (std::size_t i = 0; i + 1 < m_skyline.size();) {
+		if (m_skyline[i].y == m_skyline[i + 1].y) {
+			m_skyline[i].width += m_skyline[i + 1].width;
+			m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+		}
+		else {
+			++i;
+		}
+	}
+
+	m_usedArea += static_cast<std::int64_t>(width) * height;
+	return true;
+}
+
+/* -------------------------------------------------------------------------
+	adlAtlasBuilder
+--------------------------------------------------------------------------*/
+adlAtlasBuilder::adlAtlasBuilder(const int pageWidth, const int pageHeight, const int padding)
+	: m_pageWidth(pageWidth),
+	  m_pageHeight(pageHeight),
+	  m_padding(std::max(padding, 0)) {
+}
+
+void adlAtlasBuilder::add(const std::string &name, const int width, const int height) {
+	m_inputs.push_back({.name = name, .width = width, .height = height, .image = {}});
+}
+
+void adlAtlasBuilder::add(const std::string &name, adlImage image) {
+	const int width  = image.width;
+	const int height = image.height;
+	m_inputs.push_back({.name = name, .width = width, .height = height, .image = std::move(image)});
+}
+
+bool adlAtlasBuilder::pack() {
+	m_regions.assign(m_inputs.size(), {});
+	m_packers.clear();
+	m_pagePixels.clear();
+
+	// tallest first keeps the skyline flat, which is where it wastes the least space
+	std::vector<std::size_t> order(m_inputs.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [this](const std::size_t lhs, const std::size_t rhs) {
+		const auto &a = m_inputs[lhs], &b = m_inputs[rhs];
+		return a.height != b.height ? a.height > b.height : a.width > b.width;
+	});
+
+	for (const std::size_t index: order) {
+		const auto &input  = m_inputs[index];
+		const int   width  = input.width + m_padding;
+		const int   height = input.height + m_padding;
+		if (width > m_pageWidth || height > m_pageHeight) {
+			return false;
+		}
+
+		adlRect       placed{};
+		std::uint32_t page = 0;
+		while (page < m_packers.size() && !m_packers[page].insert(width, height, placed)) {
+			++page;
+		}
+		if (page == m_packers.size()) {
+			m_packers.emplace_back(m_pageWidth, m_pageHeight);
+			m_packers.back().insert(width, height, placed);
+		}
+
+		const float pw = static_cast<float>(m_pageWidth), ph = static_cast<float>(m_pageHeight);
+		m_regions[index] = {
+			.name = input.name,
+			.page = page,
+			.rect = {.x = placed.x, .y = placed.y, .width = input.width, .height = input.height},
+			.uvRect = {
+				static_cast<float>(placed.x) / pw, static_cast<float>(placed.y) / ph,
+				static_cast<float>(placed.x + input.width) / pw, static_cast<float>(placed.y + input.height) / ph
+			},
+		};
+	}
+
+	return true;
+}
+
+void adlAtlasBuilder::compose() {
+	const std::size_t pageBytes = static_cast<std::size_t>(m_pageWidth) * static_cast<std::size_t>(m_pageHeight) * 4;
+	m_pagePixels.assign(m_packers.size(), std::vector<unsigned char>(pageBytes, 0));
+
+	for (std::size_t i = 0; i < m_inputs.size(); ++i) {
+		const auto          &input  = m_inputs[i];
+		const auto          &region = m_regions[i];
+		const unsigned char *source = input.image.data();
+		if (source == nullptr) {
+			continue;
+		}
+
+		auto             &page     = m_pagePixels[region.page];
+		const std::size_t rowBytes = static_cast<std::size_t>(input.width) * 4;
+		for (int row = 0; row < input.height; ++row) {
+			const std::size_t offset = (static_cast<std::size_t>(region.rect.y + row) * m_pageWidth + region.rect.x) * 4;
+			std::memcpy(page.data() + offset, source + row * rowBytes, rowBytes);
+		}
+	}
+}
+
+float adlAtlasBuilder::occupancy() const {
+	if (m_packers.empty()) {
+		return 0.f;
+	}
+
+	std::int64_t area = 0;
+	for (const auto &input: m_inputs) {
+		area += static_cast<std::int64_t>(input.width) * input.height;
+	}
+
+	const auto pageArea = static_cast<std::int64_t>(m_pageWidth) * m_pageHeight;
+	return static_cast<float>(area) / static_cast<float>(pageArea * static_cast<std::int64_t>(m_packers.size()));
+}
+
+/* -------------------------------------------------------------------------
+	adlAtlasTable
+--------------------------------------------------------------------------*/
+std::vector<std::byte> adlAtlasTable::write(const adlAtlasBuilder &builder) {
+	const auto &regions = builder.regions();
+
+	std::vector<adlAtlasTableEntry> entries;
+	std::string                     names;
+	entries.reserve(regions.size());
+
+	for (const auto &region: regions) {
+		entries.push_back({
+			.nameOffset = static_cast<std::uint32_t>(names.size()),
+			.nameLength = static_cast<std::uint32_t>(region.name.size()),
+			.page = region.page,
+			.reserved = 0,
+			.u0 = region.uvRect.x, .v0 = region.uvRect.y, .u1 = region.uvRect.z, .v1 = region.uvRect.w,
+		});
+		names += region.name;
+	}
+
+	const adlAtlasTableHeader header{
+		.magic = adlAtlasTableHeader::MAGIC,
+		.entryCount = static_cast<std::uint32_t>(entries.size()),
+		.pageCount = static_cast<std::uint32_t>(builder.pageCount()),
+		.reserved = 0,
+	};
+
+	const std::size_t      entryBytes = entries.size() * sizeof(adlAtlasTableEntry);
+	std::vector<std::byte> bytes(sizeof(header) + entryBytes + names.size());
+	std::memcpy(bytes.data(), &header, sizeof(header));
+	std::memcpy(bytes.data() + sizeof(header), entries.data(), entryBytes);
+	std::memcpy(bytes.data() + sizeof(header) + entryBytes, names.data(), names.size());
+
+	return bytes;
+}
+
+std::string adlAtlasTable::pageName(const std::string &atlasName, const std::size_t page) {
+	return atlasName + "#" + std::to_string(page);
+}
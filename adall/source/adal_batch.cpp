@@ -0,0 +1,178 @@
+#include "adall/adal_batch.h"
+
+/* -------------------------------------------------------------------------
+	adlSpriteBatch
+--------------------------------------------------------------------------*/
+adlSpriteBatch::adlSpriteBatch(const std::size_t maxQuadsPerDraw)
+	: m_maxQuadsPerDraw(std::max<std::size_t>(maxQuadsPerDraw, 1)) {
+}
+
+void adlSpriteBatch::begin(const std::size_t expectedSprites) {
+	m_sprites.clear();
+	m_sortEntries.clear();
+	m_vertices.clear();
+	m_drawBatches.clear();
+
+	m_sprites.reserve(expectedSprites);
+	m_isBuilding = true;
+}
+
+void adlSpriteBatch::submit(const adlSprite &sprite) {
+	if (!m_isBuilding) {
+		return;
+	}
+
+	m_sprites.push_back(sprite);
+}
+
+void adlSpriteBatch::end(const bool sortByState) {
+	if (!m_isBuilding) {
+		return;
+	}
+	m_isBuilding = false;
+
+	const auto spriteCount = static_cast<std::uint32_t>(m_sprites.size());
+	if (spriteCount == 0) {
+		return;
+	}
+
+	m_sortEntries.resize(spriteCount);
+	for (std::uint32_t i = 0; i < spriteCount; ++i) {
+		const auto &sprite = m_sprites[i];
+		m_sortEntries[i]   = {
+			.key = static_cast<std::uint64_t>(sprite.shaderProgramID) << 32 | sprite.textureID,
+			.index = i,
+		};
+	}
+
+	// ties are broken by submission index, so the sort is stable without paying for std::stable_sort
+	if (sortByState) {
+		std::sort(m_sortEntries.begin(), m_sortEntries.end(), [](const SortEntry &lhs, const SortEntry &rhs) {
+			return lhs.key != rhs.key ? lhs.key < rhs.key : lhs.index < rhs.index;
+		});
+	}
+
+	m_vertices.resize(static_cast<std::size_t>(spriteCount) * 4);
+	adlVertex *out = m_vertices.data();
+
+	for (std::uint32_t quad = 0; quad < spriteCount; ++quad) {
+		const auto &sprite = m_sprites[m_sortEntries[quad].index];
+		writeQuad(sprite, out + static_cast<std::size_t>(quad) * 4);
+
+		const bool isNewRun = m_drawBatches.empty()
+		                      || m_drawBatches.back().shaderProgramID != sprite.shaderProgramID
+		                      || m_drawBatches.back().textureID != sprite.textureID
+		                      || m_drawBatches.back().quadCount == m_maxQuadsPerDraw;
+		if (isNewRun) {
+			m_drawBatches.push_back({
+				.shaderProgramID = sprite.shaderProgramID,
+				.textureID = sprite.textureID,
+				.firstQuad = quad,
+				.quadCount = 0,
+			});
+		}
+		++m_drawBatches.back().quadCount;
+	}
+}
+
+void adlSpriteBatch::writeQuad(const adlSprite &sprite, adlVertex *out) {
+	// counter-clockwise from the bottom-left corner, matching makeQuadIndices()
+	glm::vec2 corners[4] = {
+		{0.f, 0.f},
+		{sprite.size.x, 0.f},
+		{sprite.size.x, sprite.size.y},
+		{0.f, sprite.size.y},
+	};
+
+	if (sprite.rotation != 0.f) {
+		const glm::vec2 center = sprite.size * 0.5f;
+		const float     c      = std::cos(sprite.rotation);
+		const float     s      = std::sin(sprite.rotation);
+		for (auto &corner: corners) {
+			const glm::vec2 local = corner - center;
+			corner                = center + glm::vec2{local.x * c - local.y * s, local.x * s + local.y * c};
+		}
+	}
+
+	const glm::vec2 uvs[4] = {
+		{sprite.uvRect.x, sprite.uvRect.y},
+		{sprite.uvRect.z, sprite.uvRect.y},
+		{sprite.uvRect.z, sprite.uvRect.w},
+		{sprite.uvRect.x, sprite.uvRect.w},
+	};
+
+	for (int i = 0; i < 4; ++i) {
+		out[i].position = sprite.position + corners[i];
+		out[i].uvs      = uvs[i];
+		out[i].color    = sprite.color;
+	}
+}
+
+bool adlSpriteBatch::stream(adlStreamBuffer &stream, const adlStreamDraw &draw) const {
+	constexpr std::size_t VERTEX_BYTES = sizeof(adlVertex);
+	constexpr std::size_t QUAD_BYTES   = 4 * VERTEX_BYTES;
+
+	const std::size_t quadCount = m_vertices.size() / 4;
+	std::size_t       run = 0, runDrawn = 0; // the next run to draw and how much of it earlier pieces drew
+
+	for (std::size_t first = 0; first < quadCount;) {
+		if (!stream.beginFrame()) {
+			return false;
+		}
+
+		// offsets are multiples of the vertex stride so they map straight onto a base vertex, which may leave
+		// a few bytes at the start of a region unused
+		const std::size_t regionBase = stream.currentRegion() * stream.regionSize();
+		const std::size_t padding    = std::min((VERTEX_BYTES - regionBase % VERTEX_BYTES) % VERTEX_BYTES, stream.regionSize());
+		const std::size_t pieceCount = std::min(quadCount - first, (stream.regionSize() - padding) / QUAD_BYTES);
+
+		const auto allocation = pieceCount > 0 ? stream.allocate(pieceCount * QUAD_BYTES, VERTEX_BYTES) : adlStreamBuffer::Allocation{nullptr, 0};
+		if (allocation.data == nullptr) {
+			stream.endFrame();
+			return false;
+		}
+		std::memcpy(allocation.data, m_vertices.data() + first * 4, pieceCount * QUAD_BYTES);
+		stream.flush();
+
+		// runs cover the arena in order, so each piece picks up where the last one stopped
+		const auto        baseVertex = static_cast<GLint>(allocation.offset / VERTEX_BYTES);
+		const std::size_t last       = first + pieceCount;
+		while (run < m_drawBatches.size() && m_drawBatches[run].firstQuad + runDrawn < last) {
+			const adlDrawBatch &source = m_drawBatches[run];
+			const std::size_t   begin  = source.firstQuad + runDrawn;
+			const std::size_t   count  = std::min<std::size_t>(source.quadCount - runDrawn, last - begin);
+
+			draw({.shaderProgramID = source.shaderProgramID, .textureID = source.textureID,
+			      .firstQuad = static_cast<GLuint>(begin - first), .quadCount = static_cast<GLuint>(count)}, baseVertex);
+
+			runDrawn += count;
+			if (runDrawn == source.quadCount) {
+				++run;
+				runDrawn = 0;
+			}
+		}
+
+		stream.endFrame();
+		first = last;
+	}
+
+	return true;
+}
+
+std::vector<GLuint> adlSpriteBatch::makeQuadIndices(const std::size_t quadCount) {
+	std::vector<GLuint> indices(quadCount * 6);
+
+	for (std::size_t quad = 0; quad < quadCount; ++quad) {
+		const auto base = static_cast<GLuint>(quad * 4);
+		GLuint    *out  = indices.data() + quad * 6;
+
+		out[0] = base + 0;
+		out[1] = base + 1;
+		out[2] = base + 2;
+		out[3] = base + 2;
+		out[4] = base + 3;
+		out[5] = base + 0;
+	}
+
+	return indices;
+}
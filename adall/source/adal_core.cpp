@@ -1,57 +1,614 @@
 #include "adall/adal_core.h"
 
 namespace adlCore {
-	adlEntity::adlEntity(adlRegistry &registry, const entt::entity entity, std::string name, const std::string &group): m_registry(registry),
-		m_entity(entity),
-		m_name(std::move(name)),
-		m_group(group) {
+	/* -------------------------------------------------------------------------
+		adlEntity
+	--------------------------------------------------------------------------*/
+	std::string_view adlEntity::name() const {
+		const auto *name = m_registry->getRegistry().try_get<adlComponent::Name>(m_entity);
+		return name != nullptr ? adlStringInterner::global().view(name->id) : std::string_view{};
+	}
+
+	std::string_view adlEntity::group() const {
+		const auto *group = m_registry->getRegistry().try_get<adlComponent::Group>(m_entity);
+		return group != nullptr ? adlStringInterner::global().view(group->id) : std::string_view{};
+	}
+
+	void adlEntity::setName(const std::string_view name) const {
+		auto &registry = m_registry->getRegistry();
+		if (name.empty()) {
+			registry.remove<adlComponent::Name>(m_entity);
+			return;
+		}
+
+		registry.emplace_or_replace<adlComponent::Name>(m_entity, adlIntern(name));
+	}
+
+	void adlEntity::setGroup(const std::string_view group) const {
+		auto &registry = m_registry->getRegistry();
+		if (const auto *current = registry.try_get<adlComponent::Group>(m_entity); current != nullptr) {
+			registry.storage<adlComponent::GroupMember>(adlGroupStorageID(current->id)).remove(m_entity);
+		}
+
+		if (group.empty()) {
+			registry.remove<adlComponent::Group>(m_entity);
+			return;
+		}
+
+		const adlStringID id = adlIntern(group);
+		registry.emplace_or_replace<adlComponent::Group>(m_entity, id);
+		registry.storage<adlComponent::GroupMember>(adlGroupStorageID(id)).emplace(m_entity);
+	}
+
+	/* -------------------------------------------------------------------------
+		adlPrefab
+	--------------------------------------------------------------------------*/
+	adlPrefab &adlPrefab::inGroup(const std::string_view group) {
+		m_group = group.empty() ? 0 : adlIntern(group);
+		return *this;
+	}
+
+	void adlPrefab::instantiate(entt::registry &registry, const std::span<const entt::entity> entities) const {
+		for (const auto &[type, inserter]: m_inserters) {
+			inserter(registry, entities);
+		}
+
+		if (m_group != 0) {
+			registry.insert<adlComponent::Group>(entities.begin(), entities.end(), adlComponent::Group{m_group});
+			registry.storage<adlComponent::GroupMember>(adlGroupStorageID(m_group)).insert(entities.begin(), entities.end());
+		}
+	}
+
+	/* -------------------------------------------------------------------------
+		adlEntityManager
+	--------------------------------------------------------------------------*/
+	adlEntityManager::adlEntityManager(adlRegistry &registry)
+		: m_registry(registry) {
+		auto &entities = m_registry.getRegistry();
+		entities.on_construct<adlComponent::Name>().connect<&adlEntityManager::onNameSet>(this);
+		entities.on_update<adlComponent::Name>().connect<&adlEntityManager::onNameSet>(this);
+		entities.on_destroy<adlComponent::Name>().connect<&adlEntityManager::onNameRemoved>(this);
+	}
+
+	adlEntityManager::~adlEntityManager() {
+		m_registry.getRegistry().on_construct<adlComponent::Name>().disconnect(this);
+		m_registry.getRegistry().on_update<adlComponent::Name>().disconnect(this);
+		m_registry.getRegistry().on_destroy<adlComponent::Name>().disconnect(this);
+	}
+
+	void adlEntityManager::onNameSet(entt::registry &registry, const entt::entity entity) {
+		const adlStringID id = registry.get<adlComponent::Name>(entity).id;
+		if (id >= m_names.size()) {
+			m_names.resize(std::max<std::size_t>(id + 1, m_names.size() * 2), entt::null);
+		}
+
+		// the entry of a replaced name goes stale; findEntity() sees that it no longer matches
+		m_names[id] = entity;
+	}
+
+	void adlEntityManager::onNameRemoved(entt::registry &registry, const entt::entity entity) {
+		if (const adlStringID id = registry.get<adlComponent::Name>(entity).id; m_names[id] == entity) {
+			m_names[id] = entt::null;
+		}
+	}
+
+	adlEntity adlEntityManager::makeEntity(const std::string_view name, const std::string_view group) const {
+		const adlEntity entity{m_registry, m_registry.makeEntity()};
+		if (!name.empty()) {
+			entity.setName(name);
+		}
+		if (!group.empty()) {
+			entity.setGroup(group);
+		}
+
+		return entity;
+	}
+
+	adlEntity adlEntityManager::makeEntity(const adlPrefab &prefab, const std::string_view name) const {
+		const adlEntity    entity{m_registry, m_registry.makeEntity()};
+		const entt::entity id = entity.getEntity();
+		prefab.instantiate(m_registry.getRegistry(), {&id, 1});
+		if (!name.empty()) {
+			entity.setName(name);
+		}
+
+		return entity;
+	}
+
+	void adlEntityManager::makeEntities(const std::span<entt::entity> entities, const std::string_view group) const {
+		m_registry.makeEntities(entities.begin(), entities.end());
+		if (group.empty()) {
+			return;
+		}
+
+		const adlStringID id       = adlIntern(group);
+		auto             &registry = m_registry.getRegistry();
+		registry.insert<adlComponent::Group>(entities.begin(), entities.end(), adlComponent::Group{id});
+		registry.storage<adlComponent::GroupMember>(adlGroupStorageID(id)).insert(entities.begin(), entities.end());
+	}
+
+	void adlEntityManager::makeEntities(const std::span<entt::entity> entities, const adlPrefab &prefab) const {
+		m_registry.makeEntities(entities.begin(), entities.end());
+		prefab.instantiate(m_registry.getRegistry(), entities);
+	}
+
+	std::uint32_t adlEntityManager::killEntity(adlEntity &entity) const {
+		if (!entity.isValid()) {
+			return 0;
+		}
+
+		// destroy() empties every storage, the group tags included
+		const std::uint32_t version = m_registry.destroyEntity(entity.getEntity());
+		entity                      = {};
+		return version;
+	}
+
+	void adlEntityManager::killEntities(const std::span<const entt::entity> entities) const {
+		auto &registry = m_registry.getRegistry();
+
+		// the range destroy asserts on dead entities and releases a repeated one twice,
+		// so only the first sighting of each live entity is passed on
+		std::vector<std::uint8_t> isSeen(registry.storage<entt::entity>().size(), 0);
+		std::vector<entt::entity> alive;
+		alive.reserve(entities.size());
+		for (const entt::entity entity: entities) {
+			if (registry.valid(entity) && std::exchange(isSeen[entt::to_entity(entity)], 1) == 0) {
+				alive.push_back(entity);
+			}
+		}
+		m_registry.destroyEntities(alive.begin(), alive.end());
+	}
+
+	adlEntity adlEntityManager::findEntity(const std::string_view name) const {
+		const adlStringID id = adlStringInterner::global().find(name);
+		if (id == 0 || id >= m_names.size()) {
+			return {};
+		}
+
+		const entt::entity entity   = m_names[id];
+		const auto        &registry = m_registry.getRegistry();
+		if (!registry.valid(entity)) {
+			return {};
+		}
+		if (const auto *current = registry.try_get<adlComponent::Name>(entity); current == nullptr || current->id != id) {
+			return {};
+		}
+
+		return {m_registry, entity};
 	}
 
+	std::size_t adlEntityManager::groupSize(const std::string_view group) const {
+		const adlStringID id = adlStringInterner::global().find(group);
+		if (id == 0) {
+			return 0;
+		}
+
+		const auto *members = std::as_const(m_registry.getRegistry()).storage(adlGroupStorageID(id));
+		return members != nullptr ? members->size() : 0;
+	}
 
 	/* -------------------------------------------------------------------------
 		adlAssetManager
 	--------------------------------------------------------------------------*/
-	bool adlAssetManager::makeTexture(const std::string &name, const std::string &texturePath, const bool isPixelated) {
-		if (!m_textureMap.contains(name)) {
+	adlAssetManager::adlAssetManager(const std::size_t decodeThreadCount) {
+		const std::size_t count = std::max<std::size_t>(decodeThreadCount, 1);
+
+		m_decodeThreads.reserve(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			m_decodeThreads.emplace_back(&adlAssetManager::decodeLoop, this);
+		}
+	}
+
+	adlAssetManager::~adlAssetManager() {
+		{
+			std::lock_guard lock(m_decodeMutex);
+			m_isStopping = true;
+		}
+		m_decodeCondition.notify_all();
+
+		for (auto &thread: m_decodeThreads) {
+			thread.join();
+		}
+	}
+
+	void adlAssetManager::decodeLoop() {
+		while (true) {
+			DecodeRequest request;
+			{
+				std::unique_lock lock(m_decodeMutex);
+				m_decodeCondition.wait(lock, [this] { return m_isStopping || !m_decodeQueue.empty(); });
+				if (m_isStopping) {
+					return;
+				}
+
+				request = std::move(m_decodeQueue.front());
+				m_decodeQueue.pop_front();
+			}
+
+			PendingUpload upload{.texture = std::move(request.texture), .image = {}, .isPixelated = request.isPixelated};
+			if (!adlTextureLoader::loadImage(request.texturePath, upload.image, m_archive.get())) {
+				std::cout << "failed to decode texture " << request.texturePath << std::endl;
+			}
+
+			// failed decodes are still queued, so the pending count drains and the placeholder stays at id 0
+			std::lock_guard lock(m_uploadMutex);
+			m_uploadQueue.push_back(std::move(upload));
+		}
+	}
+
+	bool adlAssetManager::mountArchive(const std::string &archivePath) {
+		// loader threads read the archive without locking, so it is never replaced once mounted
+		if (m_archive) {
 			return false;
 		}
 
+		auto archive = std::make_unique<adlArchive>();
+		if (!archive->open(archivePath)) {
+			std::cout << "failed to mount asset archive " << archivePath << std::endl;
+			return false;
+		}
+
+		m_archive = std::move(archive);
+		return true;
+	}
+
+	adlTextureHandle adlAssetManager::makeTexture(const std::string &name, const std::string &texturePath, const bool isPixelated) {
+		if (m_textureNames.contains(name)) {
+			return {};
+		}
+
 		const auto textureType = isPixelated ? adlTextureType::PIXEL : adlTextureType::SMOOTH;
-		auto texture = std::move(adlTextureLoader::makeADLTexture(texturePath, textureType));
-		m_textureMap.insert(std::make_pair(name, std::move(texture)));
+		const auto texture     = adlTextureLoader::makeADLTexture(texturePath, textureType, m_archive.get());
+		if (!texture) {
+			return {};
+		}
 
+		const auto handle = m_textures.insert(*texture);
+		if (handle.isValid()) {
+			m_textureNames.emplace(name, handle);
+			m_textureSources[adlFileWatcher::normalize(texturePath)].push_back({.texture = handle, .texturePath = texturePath, .isPixelated = isPixelated});
+			watchSource(texturePath);
+		}
+
+		return handle;
+	}
+
+	adlTextureHandle adlAssetManager::makeTextureAsync(const std::string &name
+	                                                 , const std::string &texturePath
+	                                                 , const bool isPixelated) {
+		if (m_textureNames.contains(name)) {
+			return {};
+		}
+
+		const auto handle = m_textures.insert(adlTexture{.width = 0, .height = 0, .textureID = 0});
+		if (!handle.isValid()) {
+			return {};
+		}
+		m_textureNames.emplace(name, handle);
+		m_textureSources[adlFileWatcher::normalize(texturePath)].push_back({.texture = handle, .texturePath = texturePath, .isPixelated = isPixelated});
+		watchSource(texturePath);
+		queueDecode(handle, texturePath, isPixelated);
+
+		return handle;
+	}
+
+	void adlAssetManager::queueDecode(const adlTextureHandle &texture, const std::string &texturePath, const bool isPixelated) {
+		m_pendingTextures.fetch_add(1);
+		{
+			std::lock_guard lock(m_decodeMutex);
+			m_decodeQueue.push_back({.texture = texture, .texturePath = texturePath, .isPixelated = isPixelated});
+		}
+		m_decodeCondition.notify_one();
+	}
+
+	std::size_t adlAssetManager::processUploads(const std::size_t byteBudget) {
+		for (const GLuint textureID: m_retiredTextures) {
+			m_releaser(textureID);
+		}
+		m_retiredTextures.clear();
+
+		std::size_t uploaded = 0, uploadedBytes = 0;
+
+		while (uploaded == 0 || uploadedBytes < byteBudget) {
+			PendingUpload upload;
+			{
+				std::lock_guard lock(m_uploadMutex);
+				if (m_uploadQueue.empty()) {
+					break;
+				}
+				upload = std::move(m_uploadQueue.front());
+				m_uploadQueue.pop_front();
+			}
+
+			// the texture may have been unloaded while it was decoding
+			if (adlTexture *texture = m_textures.get(upload.texture); texture != nullptr && upload.image.data() != nullptr) {
+				// a hot reload replaces a live texture, the handle stays and the old GL texture goes next call
+				if (texture->textureID != 0) {
+					m_retiredTextures.push_back(texture->textureID);
+				}
+				texture->width     = upload.image.width;
+				texture->height    = upload.image.height;
+				texture->textureID = m_uploader(upload.image, upload.isPixelated);
+			}
+
+			uploadedBytes += upload.image.byteSize();
+			++uploaded;
+			m_pendingTextures.fetch_sub(1);
+		}
+
+		return uploaded;
+	}
+
+	bool adlAssetManager::openProgramCache(const std::string &directory) {
+		auto cache = std::make_unique<adlProgramCache>();
+		if (!cache->open(directory, adlShaderLoader::driverIdentity())) {
+			std::cout << "failed to open program cache " << directory << std::endl;
+			return false;
+		}
+
+		m_programCache = std::move(cache);
 		return true;
 	}
 
-	bool adlAssetManager::makeShader(const std::string &name, const std::string &vertexShaderSourcePath, const std::string &fragmentShaderSourcePath) {
-		if (m_shaderMap.contains(name)) {
+	adlShaderHandle adlAssetManager::makeShader(const std::string &name, const std::string &vertexShaderSourcePath, const std::string &fragmentShaderSourcePath) {
+		if (m_shaderPrograms.contains(name)) {
+			return {};
+		}
+
+		// normal paths are what the file watcher reports and what includes resolve to
+		m_shaderPrograms.emplace(name, ShaderProgram{
+			                         .vertShaderPath = adlFileWatcher::normalize(vertexShaderSourcePath),
+			                         .fragShaderPath = adlFileWatcher::normalize(fragmentShaderSourcePath),
+			                         .variants = {},
+		                         });
+
+		const auto handle = resolveShader(name, 0);
+		if (!handle.isValid()) {
+			m_shaderPrograms.erase(name);
+		}
+
+		return handle;
+	}
+
+	adlShaderHandle adlAssetManager::resolveShader(const std::string &name, const std::uint64_t permutation) {
+		const auto programItr = m_shaderPrograms.find(name);
+		if (programItr == m_shaderPrograms.end()) {
+			return {};
+		}
+
+		auto &program = programItr->second;
+		if (const auto itr = program.variants.find(permutation); itr != program.variants.end()) {
+			return itr->second;
+		}
+
+		// failed variants are remembered as invalid so a broken permutation is not recompiled every call
+		adlShaderHandle   &handle     = program.variants[permutation];
+		const std::string *vertSource = m_preprocessor.preprocess(program.vertShaderPath, permutation);
+		const std::string *fragSource = m_preprocessor.preprocess(program.fragShaderPath, permutation);
+		watchShaderSources(program);
+		if (vertSource == nullptr || fragSource == nullptr) {
+			return handle;
+		}
+
+		const auto shader = adlShaderLoader::makeADLShaderFromSource(*vertSource, *fragSource, m_programCache.get()
+		                                                             , program.vertShaderPath, program.fragShaderPath);
+		if (shader) {
+			handle = m_shaders.insert(std::move(*shader));
+		}
+
+		return handle;
+	}
+
+	bool adlAssetManager::watchAssets(const std::chrono::milliseconds debounce) {
+		if (m_watcher) {
+			return true;
+		}
+
+		auto watcher = std::make_unique<adlFileWatcher>(debounce);
+		if (!watcher->isRunning()) {
 			return false;
 		}
+		m_watcher = std::move(watcher);
 
-		auto shader = std::move(adlShaderLoader::makeADLShader(vertexShaderSourcePath, fragmentShaderSourcePath));
-		m_shaderMap.insert(std::make_pair(name, std::move(shader)));
+		for (const auto &[path, sources]: m_textureSources) {
+			if (!sources.empty()) {
+				watchSource(sources.front().texturePath);
+			}
+		}
+		for (const auto &[name, program]: m_shaderPrograms) {
+			watchShaderSources(program);
+		}
 
 		return true;
 	}
 
-	const adlTexture & adlAssetManager::getTexture(const std::string &name) {
-		const auto itr = m_textureMap.find(name);
-		if (itr != m_textureMap.end()) {
-			static auto defaultTexture = adlTexture{.width= 0, .height= {}, .textureID = 0};
-			return defaultTexture;
+	void adlAssetManager::watchSource(const std::string &path) {
+		// archived files never change under a running program, the archive is mapped
+		if (m_watcher && (!m_archive || m_archive->find(path) == nullptr)) {
+			m_watcher->watch(path);
+		}
+	}
+
+	void adlAssetManager::watchShaderSources(const ShaderProgram &program) {
+		if (!m_watcher) {
+			return;
 		}
 
-		return *(itr->second);
+		for (const auto *root: {&program.vertShaderPath, &program.fragShaderPath}) {
+			if (const auto *files = m_preprocessor.sources(*root); files != nullptr) {
+				for (const auto &file: *files) {
+					watchSource(file);
+				}
+			}
+			else {
+				watchSource(*root);
+			}
+		}
 	}
 
-	adlShader &adlAssetManager::getShader(const std::string &name) {
-		const auto itr = m_shaderMap.find(name);
-		if (itr != m_shaderMap.end()) {
-			static auto defaultShader = adlShader{.shaderProgramID =  0, .uniformLocationMap = {}};
-			return defaultShader;
+	std::size_t adlAssetManager::processReloads(const std::size_t shaderBudget) {
+		for (const GLuint programID: m_retiredPrograms) {
+			glDeleteProgram(programID);
 		}
+		m_retiredPrograms.clear();
 
-		return *(itr->second);
+		if (!m_watcher) {
+			return 0;
+		}
+
+		m_changes.clear();
+		m_watcher->takeChanges(m_changes);
+		for (const auto &path: m_changes) {
+			if (const auto itr = m_textureSources.find(path); itr != m_textureSources.end()) {
+				for (const auto &source: itr->second) {
+					queueDecode(source.texture, source.texturePath, source.isPixelated);
+				}
+			}
+
+			// which programs use the file is only known until the preprocessor forgets it
+			for (const auto &[name, program]: m_shaderPrograms) {
+				bool usesFile = false;
+				for (const auto *root: {&program.vertShaderPath, &program.fragShaderPath}) {
+					if (const auto *files = m_preprocessor.sources(*root); files != nullptr) {
+						usesFile |= std::find(files->begin(), files->end(), path) != files->end();
+					}
+					else {
+						usesFile |= *root == path;
+					}
+				}
+				if (usesFile && std::find(m_staleShaders.begin(), m_staleShaders.end(), name) == m_staleShaders.end()) {
+					m_staleShaders.push_back(name);
+				}
+			}
+			m_preprocessor.forget(path);
+		}
+
+		std::size_t reloaded = 0;
+		while (reloaded < shaderBudget && !m_staleShaders.empty()) {
+			const std::string name = std::move(m_staleShaders.front());
+			m_staleShaders.erase(m_staleShaders.begin());
+
+			if (const auto itr = m_shaderPrograms.find(name); itr != m_shaderPrograms.end()) {
+				reloadShader(name, itr->second);
+				++reloaded;
+			}
+		}
+
+		return reloaded;
+	}
+
+	void adlAssetManager::reloadShader(const std::string &name, ShaderProgram &program) {
+		for (auto &[permutation, handle]: program.variants) {
+			const std::string *vertSource = m_preprocessor.preprocess(program.vertShaderPath, permutation);
+			const std::string *fragSource = m_preprocessor.preprocess(program.fragShaderPath, permutation);
+			const auto         shader     = vertSource != nullptr && fragSource != nullptr
+				                                ? adlShaderLoader::makeADLShaderFromSource(*vertSource, *fragSource, m_programCache.get()
+				                                                                           , program.vertShaderPath, program.fragShaderPath)
+				                                : nullptr;
+			if (!shader) {
+				std::cout << "failed to reload shader " << name << " from " << program.vertShaderPath << " and " << program.fragShaderPath
+				          << ", keeping the last good one" << std::endl;
+				continue;
+			}
+
+			// variants that never compiled get a handle now; callers holding the invalid one resolve again
+			if (adlShader *current = m_shaders.get(handle); current != nullptr) {
+				m_retiredPrograms.push_back(current->shaderProgramID);
+				*current = std::move(*shader);
+			}
+			else {
+				handle = m_shaders.insert(std::move(*shader));
+			}
+		}
+
+		// the edit may have added or dropped includes
+		watchShaderSources(program);
 	}
 
+	void adlAssetManager::releaseTexture(const adlTextureHandle handle) {
+		if (m_textures.release(handle)) {
+			unloadTexture(handle);
+		}
+	}
+
+	bool adlAssetManager::unloadTexture(const adlTextureHandle handle) {
+		const adlTexture *texture = m_textures.get(handle);
+		if (texture == nullptr) {
+			return false;
+		}
+
+		if (texture->textureID != 0) {
+			m_releaser(texture->textureID);
+		}
+		m_textures.remove(handle);
+
+		// unloading is rare, a scan keeps the name maps free of reverse lookups
+		std::erase_if(m_textureNames, [handle](const auto &entry) { return entry.second == handle; });
+		std::erase_if(m_atlasRegions, [handle](const auto &entry) { return entry.second.texture == handle; });
+		for (auto &[path, sources]: m_textureSources) {
+			std::erase_if(sources, [handle](const TextureSource &source) { return source.texture == handle; });
+		}
+
+		return true;
+	}
+
+	bool adlAssetManager::loadAtlas(const std::string &atlasName, const bool isPixelated) {
+		const adlArchiveEntry *tableEntry = m_archive ? m_archive->find(atlasName) : nullptr;
+		if (tableEntry == nullptr || tableEntry->type != adlArchiveEntryType::ATLAS_TABLE) {
+			std::cout << "atlas " << atlasName << " is not in the mounted archive" << std::endl;
+			return false;
+		}
+
+		const auto          bytes = m_archive->data(*tableEntry);
+		adlAtlasTableHeader header{};
+		if (bytes.size() < sizeof(header)) {
+			return false;
+		}
+		std::memcpy(&header, bytes.data(), sizeof(header));
+
+		const std::size_t entryBytes = static_cast<std::size_t>(header.entryCount) * sizeof(adlAtlasTableEntry);
+		if (header.magic != adlAtlasTableHeader::MAGIC || sizeof(header) + entryBytes > bytes.size()) {
+			std::cout << "atlas table " << atlasName << " is corrupt" << std::endl;
+			return false;
+		}
+
+		std::vector<adlTextureHandle> pages(header.pageCount);
+		for (std::uint32_t page = 0; page < header.pageCount; ++page) {
+			const auto pageName = adlAtlasTable::pageName(atlasName, page);
+			const auto itr      = m_textureNames.find(pageName);
+			pages[page]         = itr != m_textureNames.end() ? itr->second : makeTexture(pageName, pageName, isPixelated);
+			if (!pages[page].isValid()) {
+				return false;
+			}
+		}
+
+		const auto names = std::string_view(reinterpret_cast<const char *>(bytes.data()), bytes.size()).substr(sizeof(header) + entryBytes);
+		for (std::uint32_t i = 0; i < header.entryCount; ++i) {
+			adlAtlasTableEntry entry{};
+			std::memcpy(&entry, bytes.data() + sizeof(header) + i * sizeof(adlAtlasTableEntry), sizeof(entry));
+			if (entry.page >= header.pageCount || static_cast<std::size_t>(entry.nameOffset) + entry.nameLength > names.size()) {
+				std::cout << "atlas table " << atlasName << " is corrupt" << std::endl;
+				return false;
+			}
+
+			m_atlasRegions.insert_or_assign(std::string(names.substr(entry.nameOffset, entry.nameLength)), adlTextureRegion{
+				                                .texture = pages[entry.page],
+				                                .uvRect = {entry.u0, entry.v0, entry.u1, entry.v1},
+			                                });
+		}
+
+		return true;
+	}
+
+	adlTextureRegion adlAssetManager::resolveTexture(const std::string &name) const {
+		if (const auto itr = m_textureNames.find(name); itr != m_textureNames.end()) {
+			return {.texture = itr->second, .uvRect = {0.f, 0.f, 1.f, 1.f}};
+		}
+
+		if (const auto itr = m_atlasRegions.find(name); itr != m_atlasRegions.end()) {
+			return itr->second;
+		}
+
+		return {.texture = {}, .uvRect = {0.f, 0.f, 1.f, 1.f}};
+	}
 }
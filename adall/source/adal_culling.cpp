@@ -0,0 +1,154 @@
+#include <bit>
+
+#include "adall/adal_culling.h"
+#include "adall/adal_spatial.h"
+
+#if ADL_CULLING_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace adlSystem {
+	/* -------------------------------------------------------------------------
+		BoundsSoA
+	--------------------------------------------------------------------------*/
+	void BoundsSoA::resize(const std::size_t count) {
+		const std::size_t padded = (count + LANES - 1) / LANES * LANES;
+
+		minX.resize(padded);
+		minY.resize(padded);
+		maxX.resize(padded);
+		maxY.resize(padded);
+		entities.resize(padded, entt::null);
+
+		for (std::size_t i = count; i < padded; ++i) {
+			clear(i);
+			entities[i] = entt::null;
+		}
+	}
+
+	/* -------------------------------------------------------------------------
+		Culling
+	--------------------------------------------------------------------------*/
+	void Culling::gather(entt::registry &registry, adlCore::adlJobSystem &jobSystem) {
+		const auto &transforms = registry.storage<adlComponent::WorldTransform>();
+		const auto &bounds     = registry.storage<adlComponent::Bounds>();
+
+		// storage order keeps the reads sequential for the transforms at least
+		const std::size_t count = transforms.size();
+		m_bounds.resize(count);
+
+		jobSystem.parallelFor(0, count, 4096, [&](const std::size_t first, const std::size_t last) {
+			for (std::size_t i = first; i < last; ++i) {
+				const entt::entity entity = transforms.data()[i];
+				m_bounds.entities[i]      = entity;
+				if (!bounds.contains(entity)) {
+					m_bounds.clear(i);
+					continue;
+				}
+
+				glm::vec2 min, max;
+				SpatialIndex::worldBox(transforms.get(entity), bounds.get(entity), min, max);
+				m_bounds.minX[i] = min.x;
+				m_bounds.minY[i] = min.y;
+				m_bounds.maxX[i] = max.x;
+				m_bounds.maxY[i] = max.y;
+			}
+		});
+	}
+
+	bool Culling::viewRect(const adlComponent::Camera &camera, glm::vec2 &min, glm::vec2 &max) {
+		if (camera.width <= 0 || camera.height <= 0 || camera.scale <= 0.0f) {
+			return false;
+		}
+
+		// inverse of Camera2D's screen = (world - position) * scale + screen / 2
+		const glm::vec2 halfView = glm::vec2(camera.width, camera.height) * (0.5f / camera.scale);
+		min                      = camera.position - halfView;
+		max                      = camera.position + halfView;
+		return true;
+	}
+
+	void Culling::cull(const BoundsSoA &bounds, const std::size_t first, const std::size_t last, const glm::vec2 &viewMin, const glm::vec2 &viewMax,
+	                   std::vector<entt::entity> &out) {
+#if ADL_CULLING_SSE2
+		const __m128 viewMinX = _mm_set1_ps(viewMin.x);
+		const __m128 viewMinY = _mm_set1_ps(viewMin.y);
+		const __m128 viewMaxX = _mm_set1_ps(viewMax.x);
+		const __m128 viewMaxY = _mm_set1_ps(viewMax.y);
+
+		for (std::size_t i = first; i < last; i += BoundsSoA::LANES) {
+			const __m128 overlapX = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&bounds.minX[i]), viewMaxX),
+			                                   _mm_cmpge_ps(_mm_loadu_ps(&bounds.maxX[i]), viewMinX));
+			const __m128 overlapY = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&bounds.minY[i]), viewMaxY),
+			                                   _mm_cmpge_ps(_mm_loadu_ps(&bounds.maxY[i]), viewMinY));
+
+			// one bit per lane; most batches are all in or all out, so test the whole mask first
+			int mask = _mm_movemask_ps(_mm_and_ps(overlapX, overlapY));
+			if (mask == 0xF) {
+				out.insert(out.end(), bounds.entities.begin() + static_cast<std::ptrdiff_t>(i),
+				           bounds.entities.begin() + static_cast<std::ptrdiff_t>(i + BoundsSoA::LANES));
+				continue;
+			}
+			while (mask != 0) {
+				out.push_back(bounds.entities[i + static_cast<std::size_t>(std::countr_zero(static_cast<unsigned>(mask)))]);
+				mask &= mask - 1;
+			}
+		}
+#else
+		cullScalar(bounds, first, last, viewMin, viewMax, out);
+#endif
+	}
+
+	void Culling::cullScalar(const BoundsSoA &bounds, const std::size_t first, const std::size_t last, const glm::vec2 &viewMin, const glm::vec2 &viewMax,
+	                         std::vector<entt::entity> &out) {
+		for (std::size_t i = first; i < last; ++i) {
+			if (bounds.minX[i] <= viewMax.x && bounds.maxX[i] >= viewMin.x && bounds.minY[i] <= viewMax.y && bounds.maxY[i] >= viewMin.y) {
+				out.push_back(bounds.entities[i]);
+			}
+		}
+	}
+
+	void Culling::update(adlCore::adlRegistry &registry) {
+		auto       &entities  = registry.getRegistry();
+		const auto &jobSystem = registry.adlGetContext<std::shared_ptr<adlCore::adlJobSystem> >();
+
+		auto cameras = entities.view<const adlComponent::Camera, adlComponent::Visibility>();
+		if (cameras.begin() == cameras.end()) {
+			return;
+		}
+
+		gather(entities, *jobSystem);
+
+		// chunks are whole lanes; each keeps its own survivors so no job waits on another
+		const std::size_t count      = m_bounds.size();
+		const std::size_t chunkCount = std::clamp<std::size_t>(count / 16384, 1, jobSystem->threadCount() * 4);
+		const std::size_t chunkSize  = ((count + chunkCount - 1) / chunkCount + BoundsSoA::LANES - 1) / BoundsSoA::LANES * BoundsSoA::LANES;
+		m_chunkVisible.resize(chunkCount);
+
+		for (auto [entity, camera, visibility]: cameras.each()) {
+			visibility.entities.clear();
+
+			glm::vec2 viewMin, viewMax;
+			if (!viewRect(camera, viewMin, viewMax)) {
+				continue;
+			}
+
+			jobSystem->parallelFor(0, chunkCount, 1, [&](const std::size_t firstChunk, const std::size_t lastChunk) {
+				for (std::size_t chunk = firstChunk; chunk < lastChunk; ++chunk) {
+					m_chunkVisible[chunk].clear();
+					const std::size_t first = std::min(count, chunk * chunkSize);
+					cull(m_bounds, first, std::min(count, first + chunkSize), viewMin, viewMax, m_chunkVisible[chunk]);
+				}
+			});
+
+			std::size_t visibleCount = 0;
+			for (const auto &visible: m_chunkVisible) {
+				visibleCount += visible.size();
+			}
+			visibility.entities.reserve(visibleCount);
+			for (const auto &visible: m_chunkVisible) {
+				visibility.entities.insert(visibility.entities.end(), visible.begin(), visible.end());
+			}
+		}
+	}
+}
@@ -1,4 +1,6 @@
 #include "adall/adal_editor.h"
+#include "adall/adal_memory.h"
+#include "adall/adal_profiler.h"
 
 adlEditor::adlEditor(GLFWwindow *window)
 	: m_window(window) {
@@ -29,7 +31,156 @@ bool adlEditor::init() {
 	return true;
 }
 
-void adlEditor::render() {
+void adlEditor::drawMemoryPanel(adlCore::adlRegistry &registry) {
+	const auto *frameMemory = registry.getRegistry().ctx().find<std::shared_ptr<adlCore::adlFrameMemory> >();
+	if (frameMemory == nullptr) {
+		return;
+	}
+
+	ImGui::Begin("Memory");
+	if (ImGui::BeginTable("allocators", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+		ImGui::TableSetupColumn("Allocator");
+		ImGui::TableSetupColumn("Used KiB");
+		ImGui::TableSetupColumn("Peak KiB");
+		ImGui::TableSetupColumn("Capacity KiB");
+		ImGui::TableSetupColumn("Allocations");
+		ImGui::TableSetupColumn("Growths");
+		ImGui::TableHeadersRow();
+
+		for (const auto &stats: (*frameMemory)->stats()) {
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(stats.name.c_str());
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", static_cast<double>(stats.used) / 1024.0);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", static_cast<double>(stats.peak) / 1024.0);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", static_cast<double>(stats.capacity) / 1024.0);
+			ImGui::TableNextColumn();
+			ImGui::Text("%llu", static_cast<unsigned long long>(stats.allocationCount));
+			ImGui::TableNextColumn();
+			ImGui::Text("%llu", static_cast<unsigned long long>(stats.overflowCount));
+		}
+		ImGui::EndTable();
+	}
+	ImGui::End();
+}
+
+void adlEditor::drawTimeline() {
+	const auto &profiler = adlCore::adlProfiler::global();
+	const auto &events   = profiler.lastFrame();
+	const auto  threads  = profiler.threadNames();
+	if (threads.empty() || profiler.lastFrameEnd() <= profiler.lastFrameStart()) {
+		return;
+	}
+
+	// every thread's band is as tall as its deepest nesting
+	std::vector<std::uint32_t> depths(threads.size(), 0);
+	for (const auto &event: events) {
+		depths[event.thread] = std::max(depths[event.thread], event.depth + 1);
+	}
+	std::vector<float> bandTops(threads.size() + 1, 0.0f);
+	const float        rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+	for (std::size_t thread = 0; thread < threads.size(); ++thread) {
+		bandTops[thread + 1] = bandTops[thread] + static_cast<float>(std::max<std::uint32_t>(depths[thread], 1)) * rowHeight + 4.0f;
+	}
+
+	const float  labelWidth = 90.0f;
+	const ImVec2 origin     = ImGui::GetCursorScreenPos();
+	const float  width      = std::max(ImGui::GetContentRegionAvail().x - labelWidth, 1.0f);
+	const auto   frameStart = static_cast<double>(profiler.lastFrameStart());
+	const double scale      = width / static_cast<double>(profiler.lastFrameEnd() - profiler.lastFrameStart());
+	ImDrawList  *drawList   = ImGui::GetWindowDrawList();
+
+	for (std::size_t thread = 0; thread < threads.size(); ++thread) {
+		drawList->AddText({origin.x, origin.y + bandTops[thread] + 2.0f}, ImGui::GetColorU32(ImGuiCol_Text), threads[thread].c_str());
+	}
+
+	const ImVec2 mouse = ImGui::GetIO().MousePos;
+	for (const auto &event: events) {
+		const float left  = origin.x + labelWidth + static_cast<float>(std::max(0.0, (static_cast<double>(event.start) - frameStart) * scale));
+		const float right = origin.x + labelWidth + static_cast<float>(std::min(static_cast<double>(width), (static_cast<double>(event.end) - frameStart) * scale));
+		const float top   = origin.y + bandTops[event.thread] + static_cast<float>(event.depth) * rowHeight;
+		if (right <= left) {
+			continue;
+		}
+
+		// the same zone keeps the same colour from frame to frame
+		const auto  hash  = static_cast<std::uint32_t>(std::hash<std::string_view>{}(event.name));
+		const ImU32 color = IM_COL32(80 + (hash & 0x7F), 80 + (hash >> 8 & 0x7F), 80 + (hash >> 16 & 0x7F), 255);
+		drawList->AddRectFilled({left, top}, {std::max(right, left + 1.0f), top + rowHeight - 1.0f}, color);
+		if (right - left > 30.0f) {
+			drawList->PushClipRect({left, top}, {right, top + rowHeight}, true);
+			drawList->AddText({left + 2.0f, top + 2.0f}, IM_COL32(0, 0, 0, 255), event.name.data(), event.name.data() + event.name.size());
+			drawList->PopClipRect();
+		}
+
+		if (mouse.x >= left && mouse.x <= std::max(right, left + 1.0f) && mouse.y >= top && mouse.y < top + rowHeight) {
+			ImGui::SetTooltip("%.*s\n%.3f ms", static_cast<int>(event.name.size()), event.name.data(),
+			                  static_cast<double>(event.end - event.start) * 1.0e-6);
+		}
+	}
+
+	ImGui::Dummy({labelWidth + width, bandTops.back()});
+}
+
+void adlEditor::drawProfilerPanel() {
+	auto &profiler = adlCore::adlProfiler::global();
+
+	ImGui::Begin("Profiler");
+	ImGui::Text("Frame %.3f ms, %llu events dropped", static_cast<double>(profiler.lastFrameEnd() - profiler.lastFrameStart()) * 1.0e-6,
+	            static_cast<unsigned long long>(profiler.droppedCount()));
+
+	if (!profiler.isCapturing()) {
+		if (ImGui::Button("Start capture")) {
+			profiler.beginCapture();
+			m_traceStatus.clear();
+		}
+	}
+	else if (ImGui::Button("Stop capture and export")) {
+		profiler.endCapture();
+		m_traceStatus = profiler.exportChromeTrace("profile.json")
+			                ? "wrote " + std::to_string(profiler.capturedCount()) + " zones to profile.json"
+			                : "could not write profile.json";
+	}
+	if (!m_traceStatus.empty()) {
+		ImGui::SameLine();
+		ImGui::TextUnformatted(m_traceStatus.c_str());
+	}
+
+	drawTimeline();
+
+	if (ImGui::BeginTable("zones", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+		ImGui::TableSetupColumn("Zone");
+		ImGui::TableSetupColumn("Calls");
+		ImGui::TableSetupColumn("Frame ms");
+		ImGui::TableSetupColumn("Min ms");
+		ImGui::TableSetupColumn("Avg ms");
+		ImGui::TableSetupColumn("p99 ms");
+		ImGui::TableHeadersRow();
+
+		for (const auto &stats: profiler.stats()) {
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(stats.name.data(), stats.name.data() + stats.name.size());
+			ImGui::TableNextColumn();
+			ImGui::Text("%llu", static_cast<unsigned long long>(stats.calls));
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", stats.frameMs);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", stats.minMs);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", stats.averageMs);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", stats.p99Ms);
+		}
+		ImGui::EndTable();
+	}
+	ImGui::End();
+}
+
+void adlEditor::render(adlCore::adlRegistry &registry) {
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
 	ImGui::NewFrame();
@@ -40,6 +191,8 @@ void adlEditor::render() {
 	ImGui::Button("Press me");
 	ImGui::End();
 
+	drawMemoryPanel(registry);
+	drawProfilerPanel();
 
 	ImGui::Render();
 	int display_w, display_h;
@@ -0,0 +1,185 @@
+#include <filesystem>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "adall/adal_file_watcher.h"
+
+namespace fs = std::filesystem;
+
+namespace adlCore {
+	/* -------------------------------------------------------------------------
+		adlFileWatcher
+	--------------------------------------------------------------------------*/
+	adlFileWatcher::adlFileWatcher(const std::chrono::milliseconds debounce)
+		: m_debounce(debounce) {
+#ifdef __linux__
+		m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		m_wake    = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (m_inotify < 0 || m_wake < 0) {
+			std::cout << "failed to start the file watcher" << std::endl;
+			return;
+		}
+
+		m_thread = std::thread(&adlFileWatcher::watchLoop, this);
+#endif
+	}
+
+	adlFileWatcher::~adlFileWatcher() {
+#ifdef __linux__
+		if (m_thread.joinable()) {
+			const std::uint64_t one = 1;
+			static_cast<void>(write(m_wake, &one, sizeof(one)));
+			m_thread.join();
+		}
+		if (m_inotify >= 0) {
+			close(m_inotify);
+		}
+		if (m_wake >= 0) {
+			close(m_wake);
+		}
+#endif
+	}
+
+	std::string adlFileWatcher::normalize(const std::string &path) {
+		return fs::path(path).lexically_normal().generic_string();
+	}
+
+	bool adlFileWatcher::watch(const std::string &path) {
+#ifdef __linux__
+		if (!isRunning()) {
+			return false;
+		}
+
+		const std::string file      = normalize(path);
+		const std::string parent    = fs::path(file).parent_path().generic_string();
+		const std::string directory = parent.empty() ? std::string(".") : parent;
+
+		std::lock_guard lock(m_mutex);
+		if (m_files.contains(file)) {
+			return true;
+		}
+
+		// watching a directory twice gives back its first descriptor
+		const int descriptor = inotify_add_watch(m_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+		if (descriptor < 0) {
+			std::cout << "failed to watch " << directory << std::endl;
+			return false;
+		}
+
+		m_directories.emplace(descriptor, directory);
+		m_files.insert(file);
+		return true;
+#else
+		static_cast<void>(path);
+		return false;
+#endif
+	}
+
+	bool adlFileWatcher::takeChanges(std::vector<std::string> &changes) {
+		// the frame loop calls this; a busy watcher thread only delays the changes by a frame
+		const std::unique_lock lock(m_mutex, std::try_to_lock);
+		if (!lock.owns_lock() || m_changes.empty()) {
+			return false;
+		}
+
+		changes.insert(changes.end(), std::make_move_iterator(m_changes.begin()), std::make_move_iterator(m_changes.end()));
+		m_changes.clear();
+		return true;
+	}
+
+	void adlFileWatcher::readEvents() {
+#ifdef __linux__
+		alignas(inotify_event) char buffer[4096];
+
+		while (true) {
+			const ssize_t length = read(m_inotify, buffer, sizeof(buffer));
+			if (length <= 0) {
+				return;
+			}
+
+			const auto      now = Clock::now();
+			std::lock_guard lock(m_mutex);
+			for (ssize_t offset = 0; offset < length;) {
+				const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+				offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+				// the kernel dropped events, so any watched file may have changed
+				if ((event->mask & IN_Q_OVERFLOW) != 0) {
+					for (const auto &file: m_files) {
+						m_settling[file] = now;
+					}
+					continue;
+				}
+
+				const auto directory = m_directories.find(event->wd);
+				if (event->len == 0 || directory == m_directories.end()) {
+					continue;
+				}
+
+				auto file = normalize(directory->second + '/' + event->name);
+				if (m_files.contains(file)) {
+					m_settling[std::move(file)] = now;
+				}
+			}
+		}
+#endif
+	}
+
+	void adlFileWatcher::watchLoop() {
+#ifdef __linux__
+		while (true) {
+			// sleep until an event arrives or the next settling path is due
+			int timeout = -1;
+			if (!m_settling.empty()) {
+				auto due = Clock::time_point::max();
+				for (const auto &[file, time]: m_settling) {
+					due = std::min(due, time + m_debounce);
+				}
+				const auto wait = std::chrono::ceil<std::chrono::milliseconds>(due - Clock::now());
+				timeout         = static_cast<int>(std::max<std::chrono::milliseconds::rep>(wait.count(), 0));
+			}
+
+			pollfd descriptors[2] = {{.fd = m_inotify, .events = POLLIN, .revents = 0}, {.fd = m_wake, .events = POLLIN, .revents = 0}};
+			if (poll(descriptors, 2, timeout) < 0 && errno != EINTR) {
+				std::cout << "the file watcher stopped polling" << std::endl;
+				return;
+			}
+			if ((descriptors[1].revents & POLLIN) != 0) {
+				return;
+			}
+			if ((descriptors[0].revents & POLLIN) != 0) {
+				readEvents();
+			}
+
+			// settled paths are handed over oldest first, so several changed files reload in save order
+			const auto                                            now = Clock::now();
+			std::vector<std::pair<Clock::time_point, std::string> > settled;
+			for (auto itr = m_settling.begin(); itr != m_settling.end();) {
+				if (now - itr->second >= m_debounce) {
+					settled.emplace_back(itr->second, itr->first);
+					itr = m_settling.erase(itr);
+				}
+				else {
+					++itr;
+				}
+			}
+			if (settled.empty()) {
+				continue;
+			}
+			std::sort(settled.begin(), settled.end());
+
+			std::lock_guard lock(m_mutex);
+			for (auto &[time, file]: settled) {
+				if (std::find(m_changes.begin(), m_changes.end(), file) == m_changes.end()) {
+					m_changes.push_back(std::move(file));
+				}
+			}
+		}
+#endif
+	}
+}
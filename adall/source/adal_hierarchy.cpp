@@ -0,0 +1,229 @@
+#include "adall/adal_hierarchy.h"
+
+namespace adlSystem {
+	/* -------------------------------------------------------------------------
+		Hierarchy
+	--------------------------------------------------------------------------*/
+	Hierarchy::Hierarchy(adlCore::adlRegistry &registry)
+		: m_registry(registry) {
+		auto &entities = m_registry.getRegistry();
+		for (const auto entity: entities.view<const adlComponent::Transform>()) {
+			static_cast<void>(entities.get_or_emplace<adlComponent::WorldTransform>(entity));
+		}
+
+		entities.on_construct<adlComponent::Transform>().connect<&Hierarchy::onConstructed>(this);
+		entities.on_update<adlComponent::Transform>().connect<&Hierarchy::onChanged>(this);
+		entities.on_destroy<adlComponent::Transform>().connect<&Hierarchy::onRemoved>(this);
+		entities.on_construct<adlComponent::Parent>().connect<&Hierarchy::onReparented>(this);
+		entities.on_update<adlComponent::Parent>().connect<&Hierarchy::onReparented>(this);
+		entities.on_destroy<adlComponent::Parent>().connect<&Hierarchy::onReparented>(this);
+	}
+
+	Hierarchy::~Hierarchy() {
+		auto &entities = m_registry.getRegistry();
+		entities.on_construct<adlComponent::Transform>().disconnect(this);
+		entities.on_update<adlComponent::Transform>().disconnect(this);
+		entities.on_destroy<adlComponent::Transform>().disconnect(this);
+		entities.on_construct<adlComponent::Parent>().disconnect(this);
+		entities.on_update<adlComponent::Parent>().disconnect(this);
+		entities.on_destroy<adlComponent::Parent>().disconnect(this);
+	}
+
+	glm::mat3 Hierarchy::localMatrix(const adlComponent::Transform &transform) {
+		const float cosine = std::cos(transform.rotation);
+		const float sine   = std::sin(transform.rotation);
+
+		return {
+			cosine * transform.scale.x, sine * transform.scale.x, 0.0f,
+			-sine * transform.scale.y, cosine * transform.scale.y, 0.0f,
+			transform.position.x, transform.position.y, 1.0f,
+		};
+	}
+
+	void Hierarchy::onConstructed(entt::registry &registry, const entt::entity entity) {
+		static_cast<void>(registry.get_or_emplace<adlComponent::WorldTransform>(entity));
+		onReparented(registry, entity);
+	}
+
+	void Hierarchy::onChanged(entt::registry &, const entt::entity entity) {
+		const auto entityIndex = static_cast<std::size_t>(entt::to_entity(entity));
+
+		std::lock_guard lock(m_dirtyMutex);
+		if (entityIndex >= m_isDirty.size()) {
+			m_isDirty.resize(std::max<std::size_t>(entityIndex + 1, m_isDirty.size() * 2), 0);
+		}
+		if (m_isDirty[entityIndex] == 0) {
+			m_isDirty[entityIndex] = 1;
+			m_dirty.push_back(entity);
+		}
+	}
+
+	void Hierarchy::onReparented(entt::registry &, const entt::entity) {
+		std::lock_guard lock(m_dirtyMutex);
+		m_needsReorder = true;
+	}
+
+	void Hierarchy::onRemoved(entt::registry &registry, const entt::entity entity) {
+		// a world matrix without its Transform would only go stale
+		registry.remove<adlComponent::WorldTransform>(entity);
+		onReparented(registry, entity);
+	}
+
+	bool Hierarchy::setParent(const entt::entity child, const entt::entity parent) {
+		auto &entities = m_registry.getRegistry();
+		if (!entities.valid(child) || (parent != entt::null && !entities.valid(parent))) {
+			return false;
+		}
+
+		// parenting to a descendant would close a loop
+		for (entt::entity ancestor = parent; ancestor != entt::null;) {
+			if (ancestor == child) {
+				return false;
+			}
+			const auto *link = entities.try_get<adlComponent::Parent>(ancestor);
+			ancestor         = link != nullptr && entities.valid(link->entity) ? link->entity : entt::null;
+		}
+
+		if (const auto *old = entities.try_get<adlComponent::Parent>(child); old != nullptr && entities.valid(old->entity)) {
+			if (auto *siblings = entities.try_get<adlComponent::Children>(old->entity); siblings != nullptr) {
+				std::erase(siblings->entities, child);
+			}
+		}
+
+		if (parent == entt::null) {
+			entities.remove<adlComponent::Parent>(child);
+		}
+		else {
+			entities.emplace_or_replace<adlComponent::Parent>(child, parent);
+			entities.get_or_emplace<adlComponent::Children>(parent).entities.push_back(child);
+		}
+
+		return true;
+	}
+
+	void Hierarchy::reorder(entt::registry &registry) {
+		auto       &transforms = registry.storage<adlComponent::Transform>();
+		const auto &parents    = registry.storage<adlComponent::Parent>();
+		auto       &children   = registry.storage<adlComponent::Children>();
+
+		const entt::sparse_set &transformed = transforms;
+
+		m_order.clear();
+		m_parentSlot.clear();
+		m_trees.clear();
+		m_order.reserve(transforms.size());
+		m_parentSlot.reserve(transforms.size());
+		m_slotOf.assign(registry.storage<entt::entity>().size(), NO_PARENT);
+
+		const auto isPlaced = [this](const entt::entity entity) {
+			return m_slotOf[entt::to_entity(entity)] != NO_PARENT;
+		};
+		const auto place = [this](const entt::entity entity, const std::uint32_t parentSlot) {
+			m_slotOf[entt::to_entity(entity)] = static_cast<std::uint32_t>(m_order.size());
+			m_order.push_back(entity);
+			m_parentSlot.push_back(parentSlot);
+		};
+		const auto placeTree = [&](const entt::entity root) {
+			const auto first = static_cast<std::uint32_t>(m_order.size());
+			place(root, NO_PARENT);
+
+			// breadth first, so the tree is also sorted by depth
+			for (std::size_t slot = first; slot < m_order.size(); ++slot) {
+				const entt::entity entity = m_order[slot];
+				if (!children.contains(entity)) {
+					continue;
+				}
+
+				auto &list = children.get(entity).entities;
+				std::erase_if(list, [&registry](const entt::entity child) { return !registry.valid(child); });
+				for (const auto child: list) {
+					if (transforms.contains(child) && !isPlaced(child) && parents.contains(child) && parents.get(child).entity == entity) {
+						place(child, static_cast<std::uint32_t>(slot));
+					}
+				}
+			}
+
+			m_trees.push_back({.first = first, .last = static_cast<std::uint32_t>(m_order.size())});
+		};
+
+		for (const auto entity: transformed) {
+			if (!parents.contains(entity) || !transforms.contains(parents.get(entity).entity)) {
+				placeTree(entity);
+			}
+		}
+		// whatever is left had its Parent edited without setParent(); it stands on its own rather than vanish
+		for (const auto entity: transformed) {
+			if (!isPlaced(entity)) {
+				placeTree(entity);
+			}
+		}
+
+		// both storages then iterate in m_order, so position i of either is m_order[i]
+		transforms.sort_as(m_order.begin(), m_order.end());
+		registry.storage<adlComponent::WorldTransform>().sort_as(m_order.begin(), m_order.end());
+		m_isStale.assign(m_order.size(), 1);
+	}
+
+	void Hierarchy::update(adlCore::adlRegistry &registry) {
+		std::vector<entt::entity> dirty;
+		bool                      needsReorder;
+		{
+			std::lock_guard lock(m_dirtyMutex);
+			dirty.swap(m_dirty);
+			for (const auto entity: dirty) {
+				m_isDirty[entt::to_entity(entity)] = 0;
+			}
+			needsReorder   = m_needsReorder;
+			m_needsReorder = false;
+		}
+
+		auto &entities = registry.getRegistry();
+		if (needsReorder) {
+			reorder(entities);
+		}
+		else {
+			bool isAnyStale = false;
+			for (const auto entity: dirty) {
+				const auto entityIndex = static_cast<std::size_t>(entt::to_entity(entity));
+				if (entityIndex < m_slotOf.size() && m_slotOf[entityIndex] != NO_PARENT && m_order[m_slotOf[entityIndex]] == entity) {
+					m_isStale[m_slotOf[entityIndex]] = 1;
+					isAnyStale                       = true;
+				}
+			}
+			if (!isAnyStale) {
+				return;
+			}
+		}
+
+		const auto  transforms = entities.storage<adlComponent::Transform>().begin();
+		const auto  worlds     = entities.storage<adlComponent::WorldTransform>().begin();
+		const auto &jobSystem  = registry.adlGetContext<std::shared_ptr<adlCore::adlJobSystem> >();
+
+		// trees share nothing, and inside one every parent is done before its children are reached
+		jobSystem->parallelFor(0, m_trees.size(), 64, [&](const std::size_t firstTree, const std::size_t lastTree) {
+			for (std::size_t tree = firstTree; tree < lastTree; ++tree) {
+				for (std::uint32_t slot = m_trees[tree].first; slot < m_trees[tree].last; ++slot) {
+					const std::uint32_t parentSlot = m_parentSlot[slot];
+					if (parentSlot == NO_PARENT) {
+						if (m_isStale[slot] != 0) {
+							worlds[slot].matrix = localMatrix(transforms[slot]);
+						}
+						continue;
+					}
+
+					if (m_isStale[slot] != 0 || m_isStale[parentSlot] != 0) {
+						m_isStale[slot]     = 1;
+						worlds[slot].matrix = worlds[parentSlot].matrix * localMatrix(transforms[slot]);
+					}
+				}
+			}
+		});
+
+		for (std::size_t slot = 0; slot < m_isStale.size(); ++slot) {
+			if (m_isStale[slot] != 0) {
+				m_isStale[slot] = 0;
+				entities.patch<adlComponent::WorldTransform>(m_order[slot]);
+			}
+		}
+	}
+}
@@ -0,0 +1,219 @@
+#include "adall/adal_job.h"
+#include "adall/adal_profiler.h"
+
+namespace adlCore {
+	/* -------------------------------------------------------------------------
+		adlWorkStealingQueue
+	--------------------------------------------------------------------------*/
+	bool adlWorkStealingQueue::push(adlJob *job) {
+		const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+		const std::int64_t top    = m_top.load(std::memory_order_acquire);
+		if (bottom - top >= CAPACITY) {
+			return false;
+		}
+
+		m_jobs[bottom & MASK].store(job, std::memory_order_relaxed);
+		m_bottom.store(bottom + 1, std::memory_order_release);
+		return true;
+	}
+
+	adlJob *adlWorkStealingQueue::pop() {
+		const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+		m_bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		std::int64_t top = m_top.load(std::memory_order_relaxed);
+
+		if (top > bottom) {
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		adlJob *job = m_jobs[bottom & MASK].load(std::memory_order_relaxed);
+		if (top == bottom) {
+			// last job: race the thieves for it
+			if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				job = nullptr;
+			}
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+
+		return job;
+	}
+
+	adlJob *adlWorkStealingQueue::steal() {
+		std::int64_t top = m_top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const std::int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+		if (top >= bottom) {
+			return nullptr;
+		}
+
+		adlJob *job = m_jobs[top & MASK].load(std::memory_order_relaxed);
+		if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			return nullptr;
+		}
+
+		return job;
+	}
+
+	/* -------------------------------------------------------------------------
+		adlJobSystem
+	--------------------------------------------------------------------------*/
+	thread_local adlJobSystem *adlJobSystem::t_owner       = nullptr;
+	thread_local std::size_t   adlJobSystem::t_workerIndex = 0;
+
+	adlJobSystem::adlJobSystem(const std::size_t threadCount)
+		: m_previousOwner(t_owner),
+		  m_previousWorkerIndex(t_workerIndex) {
+		const std::size_t count = std::max<std::size_t>(threadCount, 1);
+
+		m_workers.reserve(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			m_workers.push_back(std::make_unique<Worker>());
+		}
+
+		t_owner       = this;
+		t_workerIndex = 0;
+
+		m_threads.reserve(count - 1);
+		for (std::size_t i = 1; i < count; ++i) {
+			m_threads.emplace_back(&adlJobSystem::workerLoop, this, i);
+		}
+	}
+
+	adlJobSystem::~adlJobSystem() {
+		m_running.store(false);
+		{
+			std::lock_guard lock(m_sleepMutex);
+			m_jobEpoch.fetch_add(1);
+		}
+		m_wakeCondition.notify_all();
+
+		for (auto &thread: m_threads) {
+			thread.join();
+		}
+
+		if (t_owner == this) {
+			t_owner       = m_previousOwner;
+			t_workerIndex = m_previousWorkerIndex;
+		}
+	}
+
+	std::size_t adlJobSystem::workerIndex() const {
+		return t_owner == this ? t_workerIndex : m_workers.size();
+	}
+
+	void adlJobSystem::workerLoop(const std::size_t workerIndex) {
+		t_owner       = this;
+		t_workerIndex = workerIndex;
+		adlProfiler::global().setThreadName("worker " + std::to_string(workerIndex));
+
+		constexpr int SPIN_COUNT = 64;
+
+		while (m_running.load(std::memory_order_relaxed)) {
+			const std::uint64_t epoch = m_jobEpoch.load();
+
+			bool didWork = false;
+			for (int spin = 0; spin < SPIN_COUNT; ++spin) {
+				if (adlJob *job = findJob()) {
+					execute(*job);
+					didWork = true;
+					break;
+				}
+				std::this_thread::yield();
+			}
+			if (didWork) {
+				continue;
+			}
+
+			// nothing to steal: sleep until a job is pushed after the epoch we observed
+			std::unique_lock lock(m_sleepMutex);
+			m_sleepingWorkers.fetch_add(1);
+			m_wakeCondition.wait(lock, [this, epoch] {
+				return m_jobEpoch.load() != epoch || !m_running.load();
+			});
+			m_sleepingWorkers.fetch_sub(1);
+		}
+	}
+
+	adlJob *adlJobSystem::allocateJob() {
+		if (t_owner != this) {
+			return nullptr;
+		}
+
+		// ring allocation, skipping slots whose job a thief or a nested wait has not finished yet;
+		// jobs mostly finish in submission order, so the next slot is nearly always free
+		Worker &worker = *m_workers[t_workerIndex];
+		for (std::size_t probe = 0; probe < JOB_PROBES; ++probe) {
+			adlJob *job    = &worker.jobPool[worker.nextJob];
+			worker.nextJob = (worker.nextJob + 1) % JOB_POOL_SIZE;
+			// only the owner allocates from its pool, and the acquire pairs with execute()'s release
+			if (!job->isPending.load(std::memory_order_acquire)) {
+				job->isPending.store(true, std::memory_order_relaxed);
+				return job;
+			}
+		}
+		return nullptr;
+	}
+
+	void adlJobSystem::submit(adlJob *job) {
+		if (!m_workers[t_workerIndex]->queue.push(job)) {
+			// deque full: running it here keeps the submission bounded
+			execute(*job);
+			return;
+		}
+
+		m_jobEpoch.fetch_add(1);
+		if (m_sleepingWorkers.load() > 0) {
+			{
+				std::lock_guard lock(m_sleepMutex);
+			}
+			m_wakeCondition.notify_one();
+		}
+	}
+
+	adlJob *adlJobSystem::findJob() {
+		const std::size_t self = t_workerIndex;
+		if (adlJob *job = m_workers[self]->queue.pop()) {
+			return job;
+		}
+
+		const std::size_t count = m_workers.size();
+		for (std::size_t offset = 1; offset < count; ++offset) {
+			if (adlJob *job = m_workers[(self + offset) % count]->queue.steal()) {
+				return job;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void adlJobSystem::execute(adlJob &job) {
+		adlJobCounter *counter = job.counter;
+		job.function(job);
+		job.isPending.store(false, std::memory_order_release);
+
+		if (counter != nullptr) {
+			counter->value.fetch_sub(1, std::memory_order_release);
+		}
+	}
+
+	void adlJobSystem::wait(const adlJobCounter &counter) {
+		if (t_owner != this) {
+			while (!counter.isDone()) {
+				std::this_thread::yield();
+			}
+			return;
+		}
+
+		while (!counter.isDone()) {
+			if (adlJob *job = findJob()) {
+				execute(*job);
+			}
+			else {
+				std::this_thread::yield();
+			}
+		}
+	}
+}
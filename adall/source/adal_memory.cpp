@@ -0,0 +1,132 @@
+#include "adall/adal_memory.h"
+
+namespace adlCore {
+	/* -------------------------------------------------------------------------
+		adlLinearArena
+	--------------------------------------------------------------------------*/
+	adlLinearArena::adlLinearArena(const std::size_t capacity)
+		: m_block(std::make_unique<std::byte[]>(std::max<std::size_t>(capacity, 64))),
+		  m_capacity(std::max<std::size_t>(capacity, 64)),
+		  m_cursor(m_block.get()),
+		  m_end(m_block.get() + m_capacity) {
+	}
+
+	void *adlLinearArena::allocateOverflow(const std::size_t size, const std::size_t alignment) {
+		// the tail of the full block is given up; blocks at least double so a long frame chains few of them
+		const std::size_t blockSize = std::max({size + alignment, m_capacity, m_overflow.empty() ? 0 : m_overflowBytes});
+
+		m_overflow.push_back(std::make_unique<std::byte[]>(blockSize));
+		m_overflowBytes += blockSize;
+		++m_overflowCount;
+
+		m_cursor = m_overflow.back().get();
+		m_end    = m_cursor + blockSize;
+
+		return allocate(size, alignment);
+	}
+
+	void adlLinearArena::reset() {
+		if (!m_overflow.empty()) {
+			// the frame just gone needed every block, so one block of that size fits the next one alike
+			m_capacity += m_overflowBytes;
+			m_overflow.clear();
+			m_overflowBytes = 0;
+			m_block         = std::make_unique<std::byte[]>(m_capacity);
+		}
+
+		m_cursor          = m_block.get();
+		m_end             = m_block.get() + m_capacity;
+		m_used            = 0;
+		m_allocationCount = 0;
+	}
+
+	adlMemoryStats adlLinearArena::stats(const std::string &name) const {
+		return {
+			.name            = name,
+			.capacity        = capacity(),
+			.used            = m_used,
+			.peak            = m_peak,
+			.allocationCount = m_allocationCount,
+			.overflowCount   = m_overflowCount,
+		};
+	}
+
+	/* -------------------------------------------------------------------------
+		adlPoolAllocator
+	--------------------------------------------------------------------------*/
+	adlPoolAllocator::adlPoolAllocator(const std::size_t blockSize, const std::size_t blocksPerChunk)
+		: m_blockSize((std::max(blockSize, sizeof(FreeBlock)) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1)),
+		  m_blocksPerChunk(std::max<std::size_t>(blocksPerChunk, 1)) {
+	}
+
+	void adlPoolAllocator::grow() {
+		// operator new[] aligns to at least max_align_t and every block size is a multiple of it
+		m_chunks.push_back(std::make_unique<std::byte[]>(m_blockSize * m_blocksPerChunk));
+		std::byte *chunk = m_chunks.back().get();
+
+		// thread the chunk back to front so blocks are handed out in address order
+		for (std::size_t i = m_blocksPerChunk; i-- > 0;) {
+			auto *block = reinterpret_cast<FreeBlock *>(chunk + i * m_blockSize);
+			block->next = m_free;
+			m_free      = block;
+		}
+	}
+
+	adlMemoryStats adlPoolAllocator::stats(const std::string &name) const {
+		return {
+			.name            = name,
+			.capacity        = m_chunks.size() * m_blocksPerChunk * m_blockSize,
+			.used            = m_usedBlocks * m_blockSize,
+			.peak            = m_peakBlocks * m_blockSize,
+			.allocationCount = m_allocationCount,
+			.overflowCount   = m_chunks.size(),
+		};
+	}
+
+	/* -------------------------------------------------------------------------
+		adlFrameMemory
+	--------------------------------------------------------------------------*/
+	std::atomic<std::uint64_t>              adlFrameMemory::s_nextID{1};
+	thread_local adlFrameMemory::ThreadCache adlFrameMemory::t_cache;
+
+	adlFrameMemory::adlFrameMemory(const std::size_t arenaCapacity)
+		: m_id(s_nextID.fetch_add(1, std::memory_order_relaxed)),
+		  m_arenaCapacity(arenaCapacity) {
+	}
+
+	adlFrameMemory::ThreadArena &adlFrameMemory::claim() {
+		std::lock_guard lock(m_mutex);
+
+		// the cache only remembers one instance, so a thread may come back for an arena it already has
+		const auto thread = std::this_thread::get_id();
+		auto       it     = std::find_if(m_arenas.begin(), m_arenas.end(), [thread](const auto &arena) {
+			return arena->thread == thread;
+		});
+		if (it == m_arenas.end()) {
+			m_arenas.push_back(std::make_unique<ThreadArena>(thread, m_arenaCapacity));
+			it = std::prev(m_arenas.end());
+		}
+
+		t_cache = {.owner = m_id, .arena = it->get()};
+		return **it;
+	}
+
+	void adlFrameMemory::reset() {
+		std::lock_guard lock(m_mutex);
+		for (const auto &arena: m_arenas) {
+			arena->arena.reset();
+		}
+	}
+
+	std::vector<adlMemoryStats> adlFrameMemory::stats() const {
+		std::lock_guard lock(m_mutex);
+
+		std::vector<adlMemoryStats> result;
+		result.reserve(m_arenas.size());
+		for (std::size_t i = 0; i < m_arenas.size(); ++i) {
+			result.push_back(m_arenas[i]->arena.stats("frame arena #" + std::to_string(i)));
+		}
+
+		return result;
+	}
+}
@@ -0,0 +1,234 @@
+#include <iomanip>
+
+#include "adall/adal_profiler.h"
+
+namespace adlCore {
+	/* -------------------------------------------------------------------------
+		adlProfiler
+	--------------------------------------------------------------------------*/
+	adlProfiler::adlProfiler()
+		: m_originTicks(ticks()),
+		  m_originTime(now()),
+		  m_frameStart(m_originTime) {
+	}
+
+	adlProfiler &adlProfiler::global() {
+		static adlProfiler profiler;
+		return profiler;
+	}
+
+	adlProfiler::ThreadTimeline &adlProfiler::join() {
+		std::lock_guard lock(m_mutex);
+
+		auto timeline   = std::make_unique<ThreadTimeline>();
+		timeline->index = static_cast<std::uint32_t>(m_timelines.size());
+		timeline->name  = "thread " + std::to_string(timeline->index);
+
+		t_timeline = timeline.get();
+		m_timelines.push_back(std::move(timeline));
+		return *t_timeline;
+	}
+
+	void adlProfiler::setThreadName(const std::string_view name) {
+		ThreadTimeline &timeline = local();
+
+		std::lock_guard lock(m_mutex);
+		timeline.name = name;
+	}
+
+	void adlProfiler::frameMark() {
+		const std::uint64_t frameEnd     = now();
+		const std::uint64_t frameEndTick = ticks();
+
+		// the longer the baseline, the better the rate; it only settles once some time has passed
+		if (ADL_PROFILE_TSC && frameEnd > m_originTime && frameEndTick > m_originTicks) {
+			m_nanosecondsPerTick = static_cast<double>(frameEnd - m_originTime) / static_cast<double>(frameEndTick - m_originTicks);
+		}
+
+		m_lastFrame.clear();
+		{
+			std::lock_guard lock(m_mutex);
+			for (const auto &timeline: m_timelines) {
+				const std::uint64_t head = timeline->head.load(std::memory_order_acquire);
+				std::uint64_t       tail = timeline->tail;
+				if (head - tail > RING_CAPACITY) {
+					m_droppedCount += head - tail - RING_CAPACITY;
+					tail = head - RING_CAPACITY;
+				}
+
+				const std::size_t first = m_lastFrame.size();
+				for (std::uint64_t i = tail; i < head; ++i) {
+					m_lastFrame.push_back(timeline->events[i & (RING_CAPACITY - 1)]);
+				}
+
+				// a thread still recording may have lapped the oldest slots while they were copied
+				const std::uint64_t after = timeline->head.load(std::memory_order_acquire);
+				if (after - tail > RING_CAPACITY) {
+					const std::uint64_t torn = std::min(after - tail - RING_CAPACITY, head - tail);
+					m_lastFrame.erase(m_lastFrame.begin() + static_cast<std::ptrdiff_t>(first),
+					                  m_lastFrame.begin() + static_cast<std::ptrdiff_t>(first + torn));
+					m_droppedCount += torn;
+				}
+
+				timeline->tail = head;
+			}
+		}
+
+		for (auto &event: m_lastFrame) {
+			event.start = toNanoseconds(event.start);
+			event.end   = toNanoseconds(event.end);
+		}
+
+		for (auto &[name, zone]: m_zones) {
+			zone.frameCalls = 0;
+			zone.frameTime  = 0;
+		}
+		for (const auto &event: m_lastFrame) {
+			ZoneHistory &zone = m_zones[event.name];
+			if (zone.durations.empty()) {
+				zone.durations.resize(HISTORY);
+			}
+
+			const std::uint64_t duration                 = event.end - event.start;
+			zone.durations[zone.callCount++ % HISTORY] = duration;
+			++zone.frameCalls;
+			zone.frameTime += duration;
+		}
+
+		if (m_isCapturing) {
+			const std::size_t room = MAX_CAPTURED_EVENTS - std::min(MAX_CAPTURED_EVENTS, m_capture.size());
+			const std::size_t kept = std::min(room, m_lastFrame.size());
+			m_capture.insert(m_capture.end(), m_lastFrame.begin(), m_lastFrame.begin() + static_cast<std::ptrdiff_t>(kept));
+			m_captureFrames.push_back(frameEnd);
+			m_droppedCount += m_lastFrame.size() - kept;
+		}
+
+		m_lastFrameStart = m_frameStart;
+		m_lastFrameEnd   = frameEnd;
+		m_frameStart     = frameEnd;
+	}
+
+	void adlProfiler::beginCapture() {
+		m_capture.clear();
+		m_captureFrames.clear();
+		m_isCapturing = true;
+	}
+
+	void adlProfiler::endCapture() {
+		m_isCapturing = false;
+	}
+
+	bool adlProfiler::exportChromeTrace(const std::string &path) const {
+		std::ofstream out(path);
+		if (!out) {
+			return false;
+		}
+
+		const auto writeString = [&out](const std::string_view string) {
+			out << '"';
+			for (const char character: string) {
+				if (character == '"' || character == '\\') {
+					out << '\\' << character;
+				}
+				else if (static_cast<unsigned char>(character) < 0x20) {
+					out << ' ';
+				}
+				else {
+					out << character;
+				}
+			}
+			out << '"';
+		};
+
+		// microseconds from the first event keep the numbers short; three decimals keep the nanoseconds
+		std::uint64_t origin = m_captureFrames.empty() ? 0 : m_captureFrames.front();
+		for (const auto &event: m_capture) {
+			origin = std::min(origin, event.start);
+		}
+		const auto writeTime = [&out, origin](const std::uint64_t time) {
+			const std::uint64_t nanoseconds = time - origin;
+			out << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000;
+		};
+
+		out << "{\"traceEvents\":[\n";
+		bool isFirst = true;
+		const auto separate = [&out, &isFirst] {
+			out << (isFirst ? "" : ",\n");
+			isFirst = false;
+		};
+
+		const auto names = threadNames();
+		for (std::size_t thread = 0; thread < names.size(); ++thread) {
+			separate();
+			out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread << ",\"args\":{\"name\":";
+			writeString(names[thread]);
+			out << "}}";
+		}
+		for (const auto &event: m_capture) {
+			separate();
+			out << "{\"name\":";
+			writeString(event.name);
+			out << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread << ",\"ts\":";
+			writeTime(event.start);
+			out << ",\"dur\":";
+			writeTime(origin + (event.end - event.start));
+			out << '}';
+		}
+		for (const auto frame: m_captureFrames) {
+			separate();
+			out << "{\"name\":\"frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":";
+			writeTime(frame);
+			out << '}';
+		}
+		out << "\n]}\n";
+
+		return out.good();
+	}
+
+	std::vector<adlZoneStats> adlProfiler::stats() const {
+		std::vector<adlZoneStats>  result;
+		std::vector<std::uint64_t> samples;
+		result.reserve(m_zones.size());
+
+		for (const auto &[name, zone]: m_zones) {
+			samples.assign(zone.durations.begin(), zone.durations.begin() + static_cast<std::ptrdiff_t>(std::min<std::uint64_t>(zone.callCount, HISTORY)));
+			if (samples.empty()) {
+				continue;
+			}
+			std::sort(samples.begin(), samples.end());
+
+			std::uint64_t sum = 0;
+			for (const auto sample: samples) {
+				sum += sample;
+			}
+			const std::size_t p99 = (samples.size() * 99 + 99) / 100 - 1;
+
+			result.push_back({
+				.name        = name,
+				.calls       = zone.frameCalls,
+				.frameMs     = static_cast<double>(zone.frameTime) * 1.0e-6,
+				.minMs       = static_cast<double>(samples.front()) * 1.0e-6,
+				.averageMs   = static_cast<double>(sum) / static_cast<double>(samples.size()) * 1.0e-6,
+				.p99Ms       = static_cast<double>(samples[p99]) * 1.0e-6,
+				.sampleCount = samples.size(),
+			});
+		}
+
+		std::sort(result.begin(), result.end(), [](const adlZoneStats &lhs, const adlZoneStats &rhs) {
+			return lhs.frameMs != rhs.frameMs ? lhs.frameMs > rhs.frameMs : lhs.name < rhs.name;
+		});
+		return result;
+	}
+
+	std::vector<std::string> adlProfiler::threadNames() const {
+		std::lock_guard lock(m_mutex);
+
+		std::vector<std::string> result;
+		result.reserve(m_timelines.size());
+		for (const auto &timeline: m_timelines) {
+			result.push_back(timeline->name);
+		}
+
+		return result;
+	}
+}
@@ -0,0 +1,156 @@
+#include <filesystem>
+
+#include "adall/adal_program_cache.h"
+
+namespace fs = std::filesystem;
+
+/* -------------------------------------------------------------------------
+	adlProgramCache
+--------------------------------------------------------------------------*/
+std::uint64_t adlProgramCache::makeKey(const std::string_view vertexSource, const std::string_view fragmentSource
+                                     , const std::string_view driverIdentity) {
+	// the separators keep "ab" + "c" and "a" + "bc" apart
+	std::uint64_t hash = adlHashName(vertexSource);
+	hash               = adlHashName(std::string_view("\0", 1), hash);
+	hash               = adlHashName(fragmentSource, hash);
+	hash               = adlHashName(std::string_view("\0", 1), hash);
+	return adlHashName(driverIdentity, hash);
+}
+
+std::string adlProgramCache::binaryPath(const std::uint64_t key) const {
+	char name[17];
+	std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+	return (fs::path(m_directory) / (std::string(name) + ".bin")).string();
+}
+
+bool adlProgramCache::open(const std::string &directory, const std::string_view driverIdentity) {
+	m_directory  = directory;
+	m_driverHash = adlHashName(driverIdentity);
+	m_entries.clear();
+
+	std::error_code error;
+	fs::create_directories(directory, error);
+	if (error) {
+		m_directory.clear();
+		return false;
+	}
+
+	std::ifstream         ifs(fs::path(directory) / "index.bin", std::ios::binary);
+	adlProgramCacheHeader header{};
+	if (!ifs.read(reinterpret_cast<char *>(&header), sizeof(header))
+	    || header.magic != adlProgramCacheHeader::MAGIC || header.version != adlProgramCacheHeader::VERSION) {
+		return true;
+	}
+
+	adlProgramCacheEntry entry{};
+	for (std::uint32_t i = 0; i < header.entryCount && ifs.read(reinterpret_cast<char *>(&entry), sizeof(entry)); ++i) {
+		m_entries.insert_or_assign(entry.key, entry);
+	}
+
+	// binaries from another driver or driver version would only be rejected one by one
+	if (header.driverHash != m_driverHash) {
+		clear();
+	}
+
+	return true;
+}
+
+bool adlProgramCache::find(const std::uint64_t key, std::uint32_t &binaryFormat, std::vector<std::byte> &binary) {
+	const auto itr = m_entries.find(key);
+	if (itr == m_entries.end()) {
+		return false;
+	}
+
+	const adlProgramCacheEntry entry = itr->second;
+
+	std::ifstream ifs(binaryPath(key), std::ios::binary | std::ios::ate);
+	if (ifs.fail() || static_cast<std::uint64_t>(ifs.tellg()) != entry.size) {
+		invalidate(key);
+		return false;
+	}
+
+	binary.resize(entry.size);
+	ifs.seekg(0);
+	ifs.read(reinterpret_cast<char *>(binary.data()), static_cast<std::streamsize>(binary.size()));
+	if (ifs.fail() || adlHashName({reinterpret_cast<const char *>(binary.data()), binary.size()}) != entry.checksum) {
+		invalidate(key);
+		return false;
+	}
+
+	binaryFormat = entry.binaryFormat;
+	return true;
+}
+
+bool adlProgramCache::store(const std::uint64_t key, const std::uint32_t binaryFormat, const std::span<const std::byte> binary) {
+	if (!isOpen()) {
+		return false;
+	}
+
+	std::ofstream ofs(binaryPath(key), std::ios::binary | std::ios::trunc);
+	ofs.write(reinterpret_cast<const char *>(binary.data()), static_cast<std::streamsize>(binary.size()));
+	ofs.close();
+	if (ofs.fail()) {
+		invalidate(key);
+		return false;
+	}
+
+	m_entries.insert_or_assign(key, adlProgramCacheEntry{
+		                           .key = key,
+		                           .size = binary.size(),
+		                           .checksum = adlHashName({reinterpret_cast<const char *>(binary.data()), binary.size()}),
+		                           .binaryFormat = binaryFormat,
+		                           .reserved = 0,
+	                           });
+	return saveIndex();
+}
+
+void adlProgramCache::invalidate(const std::uint64_t key) {
+	if (m_entries.erase(key) == 0) {
+		return;
+	}
+
+	std::error_code error;
+	fs::remove(binaryPath(key), error);
+	saveIndex();
+}
+
+void adlProgramCache::clear() {
+	std::error_code error;
+	for (const auto &[key, entry]: m_entries) {
+		fs::remove(binaryPath(key), error);
+	}
+	m_entries.clear();
+	saveIndex();
+}
+
+bool adlProgramCache::saveIndex() const {
+	if (!isOpen()) {
+		return false;
+	}
+
+	const adlProgramCacheHeader header{
+		.magic = adlProgramCacheHeader::MAGIC,
+		.version = adlProgramCacheHeader::VERSION,
+		.driverHash = m_driverHash,
+		.entryCount = static_cast<std::uint32_t>(m_entries.size()),
+		.reserved = 0,
+	};
+
+	// written aside and renamed over, so a crash mid-write never leaves a half index
+	const fs::path indexPath = fs::path(m_directory) / "index.bin";
+	const fs::path tempPath  = fs::path(m_directory) / "index.bin.tmp";
+	{
+		std::ofstream ofs(tempPath, std::ios::binary | std::ios::trunc);
+		ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		for (const auto &[key, entry]: m_entries) {
+			ofs.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+		}
+		if (ofs.fail()) {
+			return false;
+		}
+	}
+
+	std::error_code error;
+	fs::rename(tempPath, indexPath, error);
+	return !error;
+}
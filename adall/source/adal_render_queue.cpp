@@ -0,0 +1,81 @@
+#include <array>
+
+#include "adall/adal_render_queue.h"
+
+/* -------------------------------------------------------------------------
+	adlRenderQueue
+--------------------------------------------------------------------------*/
+adlRenderQueue::adlRenderQueue(const std::size_t bufferCount)
+	: m_buffers(std::max<std::size_t>(bufferCount, 1)) {
+}
+
+void adlRenderQueue::reset() {
+	for (auto &buffer: m_buffers) {
+		buffer.clear();
+	}
+	m_merged.clear();
+	m_sorted.clear();
+}
+
+void adlRenderQueue::merge() {
+	std::size_t count = 0;
+	for (const auto &buffer: m_buffers) {
+		count += buffer.commands().size();
+	}
+
+	m_merged.clear();
+	m_merged.reserve(count);
+	for (const auto &buffer: m_buffers) {
+		m_merged.insert(m_merged.end(), buffer.commands().begin(), buffer.commands().end());
+	}
+}
+
+void adlRenderQueue::sort() {
+	const auto count = static_cast<std::uint32_t>(m_merged.size());
+	m_entries.resize(count);
+	m_scratch.resize(count);
+
+	// all eight byte histograms in one pass over the keys
+	std::array<std::array<std::uint32_t, 256>, 8> histograms{};
+	for (std::uint32_t i = 0; i < count; ++i) {
+		const std::uint64_t key = m_merged[i].sortKey;
+		m_entries[i]            = {.key = key, .index = i};
+		for (int pass = 0; pass < 8; ++pass) {
+			++histograms[pass][key >> (pass * 8) & 0xFF];
+		}
+	}
+
+	// LSD passes are stable, so equal keys keep merge order
+	for (int pass = 0; pass < 8; ++pass) {
+		auto &histogram = histograms[pass];
+		// a byte that is the same in every key would only copy the entries around
+		if (count == 0 || histogram[m_entries[0].key >> (pass * 8) & 0xFF] == count) {
+			continue;
+		}
+
+		std::uint32_t offset = 0;
+		for (auto &bucket: histogram) {
+			const std::uint32_t size = bucket;
+			bucket                   = offset;
+			offset += size;
+		}
+
+		for (const auto &entry: m_entries) {
+			m_scratch[histogram[entry.key >> (pass * 8) & 0xFF]++] = entry;
+		}
+		m_entries.swap(m_scratch);
+	}
+
+	m_sorted.resize(count);
+	for (std::uint32_t i = 0; i < count; ++i) {
+		m_sorted[i] = m_merged[m_entries[i].index];
+	}
+}
+
+void adlRenderQueue::build(const std::vector<adlRenderCommand> &commands, adlSpriteBatch &batch) {
+	batch.begin(commands.size());
+	for (const auto &command: commands) {
+		batch.submit(command.sprite);
+	}
+	batch.end(false);
+}
@@ -0,0 +1,91 @@
+#include "adall/adal_render_thread.h"
+
+/* -------------------------------------------------------------------------
+	adlRenderThread
+--------------------------------------------------------------------------*/
+void adlRenderThread::start(GLFWwindow *window, adlStartCallback onStart, adlFrameCallback onFrame, adlStopCallback onStop) {
+	if (isRunning()) {
+		return;
+	}
+
+	m_window     = window;
+	m_hasPending = false;
+	m_isSynced   = true;
+	m_isStopping = false;
+
+	// a context can only be current on one thread at a time
+	glfwMakeContextCurrent(nullptr);
+	m_thread = std::thread(&adlRenderThread::renderLoop, this, std::move(onStart), std::move(onFrame), std::move(onStop));
+}
+
+void adlRenderThread::renderLoop(const adlStartCallback onStart, const adlFrameCallback onFrame, const adlStopCallback onStop) {
+	glfwMakeContextCurrent(m_window);
+	if (onStart) {
+		onStart();
+	}
+
+	adlRenderFrame frame;
+	while (true) {
+		{
+			std::unique_lock lock(m_mutex);
+			m_condition.wait(lock, [this] { return m_hasPending || m_isStopping; });
+			if (!m_hasPending) {
+				break;
+			}
+
+			std::swap(frame, m_pending);
+			m_hasPending = false;
+
+			// sync tasks run while submit() still holds the simulation back
+			for (auto &task: frame.syncTasks) {
+				task();
+			}
+			frame.syncTasks.clear();
+
+			m_isSynced = true;
+		}
+		m_condition.notify_all();
+
+		onFrame(frame);
+	}
+
+	if (onStop) {
+		onStop();
+	}
+	glfwMakeContextCurrent(nullptr);
+}
+
+void adlRenderThread::submit(adlRenderFrame &frame) {
+	{
+		std::unique_lock lock(m_mutex);
+		m_condition.wait(lock, [this] { return !m_hasPending; });
+
+		std::swap(frame, m_pending);
+		m_hasPending = true;
+		m_isSynced   = false;
+	}
+	m_condition.notify_all();
+
+	std::unique_lock lock(m_mutex);
+	m_condition.wait(lock, [this] { return m_isSynced; });
+
+	// the swapped-in frame is an old one; keep its capacity, drop its contents
+	frame.commands.clear();
+	frame.shaders.clear();
+	frame.syncTasks.clear();
+}
+
+void adlRenderThread::stop() {
+	if (!isRunning()) {
+		return;
+	}
+
+	{
+		std::lock_guard lock(m_mutex);
+		m_isStopping = true;
+	}
+	m_condition.notify_all();
+	m_thread.join();
+
+	glfwMakeContextCurrent(m_window);
+}
@@ -0,0 +1,362 @@
+#include "adall/adal_scene.h"
+
+#include "adall/adal_component.h"
+
+// scratch pools come from plain operator new and have to hold any scene component
+static_assert(__STDCPP_DEFAULT_NEW_ALIGNMENT__ >= 16);
+
+namespace adlCore {
+	/* -------------------------------------------------------------------------
+		adlSceneSchema
+	--------------------------------------------------------------------------*/
+	const adlSceneSchema &adlSceneSchema::engine() {
+		static const adlSceneSchema schema = [] {
+			adlSceneSchema engine;
+			engine.component<adlComponent::Transform>("Transform")
+			      .component<adlComponent::Bounds>("Bounds")
+			      .component<adlComponent::Camera>("Camera")
+			      .tag<adlComponent::Visibility>("Visibility")
+			      .component<adlComponent::Name>("Name")
+			      .stringField(&adlComponent::Name::id)
+			      .component<adlComponent::Group>("Group")
+			      .stringField(&adlComponent::Group::id)
+			      .afterLoad<adlComponent::Group>([](entt::registry &registry, const std::span<const entt::entity> entities) {
+				      for (const auto entity: entities) {
+					      if (const adlStringID id = registry.get<adlComponent::Group>(entity).id; id != 0) {
+						      registry.storage<adlComponent::GroupMember>(adlGroupStorageID(id)).emplace(entity);
+					      }
+				      }
+			      })
+			      .component<adlComponent::Parent>("Parent")
+			      .entityField(&adlComponent::Parent::entity)
+			      .afterLoad<adlComponent::Parent>([](entt::registry &registry, const std::span<const entt::entity> entities) {
+				      for (const auto entity: entities) {
+					      if (const entt::entity parent = registry.get<adlComponent::Parent>(entity).entity; registry.valid(parent)) {
+						      registry.get_or_emplace<adlComponent::Children>(parent).entities.push_back(entity);
+					      }
+				      }
+			      });
+			return engine;
+		}();
+
+		return schema;
+	}
+
+	/* -------------------------------------------------------------------------
+		adlScene
+	--------------------------------------------------------------------------*/
+	bool adlScene::save(const adlRegistry &registry, const std::string &path, const adlSceneSchema &schema) {
+		constexpr std::uint64_t DATA_ALIGNMENT = 16;
+		const auto              alignUp        = [](const std::uint64_t value) {
+			return (value + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+		};
+
+		std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+		if (ofs.fail()) {
+			std::cout << "failed to write scene " << path << std::endl;
+			return false;
+		}
+
+		const auto pad = [&ofs, &alignUp]() {
+			static constexpr char zeros[DATA_ALIGNMENT] = {};
+			const auto            position              = static_cast<std::uint64_t>(ofs.tellp());
+			ofs.write(zeros, static_cast<std::streamsize>(alignUp(position) - position));
+			return alignUp(position);
+		};
+		const auto write = [&ofs](const void *data, const std::uint64_t size) {
+			ofs.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+		};
+
+		const entt::registry &entities = registry.getRegistry();
+		const auto           &live     = *entities.storage<entt::entity>();
+
+		// the header is rewritten once every offset is known
+		adlSceneHeader header{
+			.magic = adlSceneHeader::MAGIC,
+			.version = adlSceneHeader::VERSION,
+			.entityCount = static_cast<std::uint32_t>(live.free_list()),
+			.sectionCount = 0,
+			.stringCount = 0,
+			.reserved = 0,
+			.entityOffset = 0,
+			.stringTableOffset = 0,
+			.sectionTableOffset = 0,
+		};
+		write(&header, sizeof(header));
+		header.entityOffset = pad();
+		write(live.data(), header.entityCount * sizeof(entt::entity));
+
+		// string fields are saved as indices into the scene's own string table, entry 0 being the empty string
+		std::vector<std::uint32_t> tableIndex;  ///< By interner id, 0 while not in the table.
+		std::vector<adlStringID>   tableIDs{0}; ///< Interner id by table index.
+		const auto                 toTableIndex = [&tableIndex, &tableIDs](const adlStringID id) -> std::uint32_t {
+			if (id == 0) {
+				return 0;
+			}
+			if (id >= tableIndex.size()) {
+				tableIndex.resize(std::max<std::size_t>(id + 1, tableIndex.size() * 2), 0);
+			}
+			if (tableIndex[id] == 0) {
+				tableIndex[id] = static_cast<std::uint32_t>(tableIDs.size());
+				tableIDs.push_back(id);
+			}
+			return tableIndex[id];
+		};
+
+		std::vector<adlSceneSection> sections;
+		std::vector<std::byte>       scratch;
+		for (const auto &type: schema.m_types) {
+			const entt::sparse_set *storage = type.storage(entities);
+			if (storage == nullptr || storage->empty()) {
+				continue;
+			}
+
+			adlSceneSection &section = sections.emplace_back(adlSceneSection{
+				.nameHash = type.nameHash,
+				.version = type.version,
+				.elementSize = type.elementSize,
+				.count = storage->size(),
+				.entityOffset = pad(),
+				.dataOffset = 0,
+			});
+			write(storage->data(), section.count * sizeof(entt::entity));
+			if (type.elementSize == 0) {
+				continue;
+			}
+
+			// values are contiguous a storage page at a time, so each page goes out in one write
+			section.dataOffset = pad();
+			for (std::size_t first = 0; first < section.count; first += type.pageSize) {
+				const std::size_t length = std::min<std::size_t>(type.pageSize, section.count - first);
+				const std::byte  *values = type.value(*storage, first);
+
+				if (!type.stringOffsets.empty()) {
+					scratch.assign(values, values + length * type.elementSize);
+					for (std::size_t i = 0; i < length; ++i) {
+						for (const auto offset: type.stringOffsets) {
+							adlStringID id;
+							std::memcpy(&id, scratch.data() + i * type.elementSize + offset, sizeof(id));
+							const std::uint32_t index = toTableIndex(id);
+							std::memcpy(scratch.data() + i * type.elementSize + offset, &index, sizeof(index));
+						}
+					}
+					values = scratch.data();
+				}
+
+				write(values, length * type.elementSize);
+			}
+		}
+
+		const auto           &interner = adlStringInterner::global();
+		std::vector<adlSceneString> strings;
+		std::string                 characters;
+		strings.reserve(tableIDs.size());
+		for (const auto id: tableIDs) {
+			const std::string_view string = interner.view(id);
+			strings.push_back({static_cast<std::uint32_t>(characters.size()), static_cast<std::uint32_t>(string.size())});
+			characters += string;
+		}
+
+		header.stringCount       = static_cast<std::uint32_t>(strings.size());
+		header.stringTableOffset = pad();
+		write(strings.data(), strings.size() * sizeof(adlSceneString));
+		write(characters.data(), characters.size());
+
+		header.sectionCount       = static_cast<std::uint32_t>(sections.size());
+		header.sectionTableOffset = pad();
+		write(sections.data(), sections.size() * sizeof(adlSceneSection));
+
+		ofs.seekp(0);
+		write(&header, sizeof(header));
+
+		if (ofs.fail()) {
+			std::cout << "failed to write scene " << path << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	bool adlScene::load(adlRegistry &registry, const std::string &path, const adlSceneSchema &schema, std::vector<entt::entity> *loaded) {
+		const auto fail = [&path](const std::string &reason) {
+			std::cout << "failed to load scene " << path << ": " << reason << std::endl;
+			return false;
+		};
+
+		adlMappedFile file;
+		if (!file.open(path)) {
+			return fail("cannot be opened");
+		}
+
+		const auto bytes = file.bytes();
+		if (bytes.size() < sizeof(adlSceneHeader)) {
+			return fail("not a scene");
+		}
+
+		adlSceneHeader header{};
+		std::memcpy(&header, bytes.data(), sizeof(header));
+		if (header.magic != adlSceneHeader::MAGIC || header.version != adlSceneHeader::VERSION) {
+			return fail("not a scene of version " + std::to_string(adlSceneHeader::VERSION));
+		}
+
+		const auto isInside = [&bytes](const std::uint64_t offset, const std::uint64_t count, const std::uint64_t size, const std::uint64_t alignment) {
+			return offset % alignment == 0 && offset <= bytes.size() && count <= (bytes.size() - offset) / size;
+		};
+		if (!isInside(header.entityOffset, header.entityCount, sizeof(entt::entity), alignof(entt::entity))
+		    || !isInside(header.stringTableOffset, header.stringCount, sizeof(adlSceneString), alignof(adlSceneString))
+		    || !isInside(header.sectionTableOffset, header.sectionCount, sizeof(adlSceneSection), alignof(adlSceneSection))) {
+			return fail("corrupt tables");
+		}
+
+		const std::span savedEntities{reinterpret_cast<const entt::entity *>(bytes.data() + header.entityOffset), header.entityCount};
+		const std::span strings{reinterpret_cast<const adlSceneString *>(bytes.data() + header.stringTableOffset), header.stringCount};
+		const std::span sections{reinterpret_cast<const adlSceneSection *>(bytes.data() + header.sectionTableOffset), header.sectionCount};
+		const auto      characters = bytes.subspan(header.stringTableOffset + strings.size_bytes());
+
+		for (const auto &string: strings) {
+			if (static_cast<std::uint64_t>(string.offset) + string.length > characters.size()) {
+				return fail("corrupt string table");
+			}
+		}
+
+		// position of every saved entity by its index, to find the entity it is loaded as
+		constexpr std::uint32_t    UNSAVED = std::numeric_limits<std::uint32_t>::max();
+		std::vector<std::uint32_t> savedSlot;
+		for (std::uint32_t i = 0; i < savedEntities.size(); ++i) {
+			const auto entityIndex = static_cast<std::size_t>(entt::to_entity(savedEntities[i]));
+			if (savedEntities[i] == entt::null) {
+				return fail("corrupt entity list");
+			}
+			if (entityIndex >= savedSlot.size()) {
+				savedSlot.resize(std::max<std::size_t>(entityIndex + 1, savedSlot.size() * 2), UNSAVED);
+			}
+			if (savedSlot[entityIndex] != UNSAVED) {
+				return fail("corrupt entity list");
+			}
+			savedSlot[entityIndex] = i;
+		}
+		const auto slotOf = [&savedSlot, &savedEntities](const entt::entity entity) {
+			const auto entityIndex = static_cast<std::size_t>(entt::to_entity(entity));
+			if (entity == entt::null || entityIndex >= savedSlot.size() || savedSlot[entityIndex] == UNSAVED) {
+				return UNSAVED;
+			}
+			return savedEntities[savedSlot[entityIndex]] == entity ? savedSlot[entityIndex] : UNSAVED;
+		};
+
+		struct Pool {
+			const adlSceneSchema::ComponentType *type;
+			const adlSceneSection               *section;
+		};
+
+		// every pool is checked before anything is created, so a bad file leaves the registry untouched
+		std::vector<Pool>          pools;
+		std::vector<std::uint32_t> poolOf(savedEntities.size(), 0); ///< Last pool each saved entity was seen in, plus one.
+		for (const auto &section: sections) {
+			const auto type = std::find_if(schema.m_types.begin(), schema.m_types.end(), [&section](const auto &entry) {
+				return entry.nameHash == section.nameHash;
+			});
+			if (type == schema.m_types.end()) {
+				std::cout << "skipping a component the schema does not know in scene " << path << std::endl;
+				continue;
+			}
+
+			std::uint32_t elementSize = type->elementSize;
+			if (section.version > type->version) {
+				return fail(type->name + " version " + std::to_string(section.version) + " is newer than the schema");
+			}
+			if (section.version < type->version) {
+				const auto migration = type->migrations.find(section.version);
+				if (migration == type->migrations.end()) {
+					return fail("no migration from " + type->name + " version " + std::to_string(section.version));
+				}
+				elementSize = migration->second.first;
+			}
+
+			if (section.elementSize != elementSize || !isInside(section.entityOffset, section.count, sizeof(entt::entity), alignof(entt::entity))
+			    || (elementSize != 0 && !isInside(section.dataOffset, section.count, elementSize, 16))) {
+				return fail("corrupt " + type->name + " pool");
+			}
+
+			const auto poolNumber = static_cast<std::uint32_t>(pools.size() + 1);
+			const auto *entities  = reinterpret_cast<const entt::entity *>(bytes.data() + section.entityOffset);
+			for (std::size_t i = 0; i < section.count; ++i) {
+				const std::uint32_t slot = slotOf(entities[i]);
+				if (slot == UNSAVED || poolOf[slot] == poolNumber) {
+					return fail("corrupt " + type->name + " pool");
+				}
+				poolOf[slot] = poolNumber;
+			}
+
+			pools.push_back({&*type, &section});
+		}
+
+		std::vector<entt::entity> created(savedEntities.size());
+		registry.makeEntities(created.begin(), created.end());
+
+		// a scene loaded into a fresh registry gets its saved entities back, so its pools can be inserted as saved
+		const bool isSameEntities = std::equal(created.begin(), created.end(), savedEntities.begin());
+		const auto toCreated      = [&slotOf, &created](const entt::entity entity) {
+			const std::uint32_t slot = slotOf(entity);
+			return slot == UNSAVED ? entt::entity{entt::null} : created[slot];
+		};
+
+		std::vector<adlStringID> stringIDs(strings.size());
+		for (std::size_t i = 0; i < strings.size(); ++i) {
+			stringIDs[i] = adlIntern({reinterpret_cast<const char *>(characters.data()) + strings[i].offset, strings[i].length});
+		}
+
+		auto                     &entities = registry.getRegistry();
+		std::vector<entt::entity> poolEntities;
+		std::vector<std::byte>    scratch;
+		for (const auto &[type, section]: pools) {
+			std::span targets{reinterpret_cast<const entt::entity *>(bytes.data() + section->entityOffset), section->count};
+			if (!isSameEntities) {
+				poolEntities.resize(targets.size());
+				std::transform(targets.begin(), targets.end(), poolEntities.begin(), toCreated);
+				targets = poolEntities;
+			}
+
+			const std::byte *values = nullptr;
+			if (type->elementSize != 0) {
+				values = bytes.data() + section->dataOffset;
+
+				const bool isCurrent = section->version == type->version;
+				if (!isCurrent || !type->stringOffsets.empty() || !type->entityOffsets.empty()) {
+					scratch.resize(section->count * type->elementSize);
+					if (isCurrent) {
+						std::memcpy(scratch.data(), values, scratch.size());
+					}
+					else {
+						type->migrations.at(section->version).second(values, section->count, scratch.data());
+					}
+
+					for (std::size_t i = 0; i < section->count; ++i) {
+						std::byte *value = scratch.data() + i * type->elementSize;
+						for (const auto offset: type->stringOffsets) {
+							std::uint32_t index;
+							std::memcpy(&index, value + offset, sizeof(index));
+							const adlStringID id = index < stringIDs.size() ? stringIDs[index] : 0;
+							std::memcpy(value + offset, &id, sizeof(id));
+						}
+						for (const auto offset: type->entityOffsets) {
+							entt::entity entity;
+							std::memcpy(&entity, value + offset, sizeof(entity));
+							entity = toCreated(entity);
+							std::memcpy(value + offset, &entity, sizeof(entity));
+						}
+					}
+					values = scratch.data();
+				}
+			}
+
+			type->insert(entities, targets, values);
+			if (type->afterLoad) {
+				type->afterLoad(entities, targets);
+			}
+		}
+
+		if (loaded != nullptr) {
+			*loaded = std::move(created);
+		}
+		return true;
+	}
+}
@@ -0,0 +1,105 @@
+#include "adall/adal_scheduler.h"
+
+namespace adlCore {
+	/* -------------------------------------------------------------------------
+		adlScheduler
+	--------------------------------------------------------------------------*/
+	bool adlScheduler::isConflicting(const SystemNode &lhs, const SystemNode &rhs) {
+		const auto contains = [](const std::vector<entt::id_type> &ids, const entt::id_type id) {
+			return std::find(ids.begin(), ids.end(), id) != ids.end();
+		};
+
+		for (const auto id: lhs.writes) {
+			if (contains(rhs.writes, id) || contains(rhs.reads, id)) {
+				return true;
+			}
+		}
+		for (const auto id: lhs.reads) {
+			if (contains(rhs.writes, id)) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void adlScheduler::build() {
+		for (auto &node: m_systems) {
+			node.successors.clear();
+			node.predecessorCount = 0;
+			node.level            = 0;
+		}
+
+		// registration order decides the order of conflicting systems, so edges only point forward
+		for (std::size_t later = 0; later < m_systems.size(); ++later) {
+			for (std::size_t earlier = 0; earlier < later; ++earlier) {
+				if (isConflicting(m_systems[earlier], m_systems[later])) {
+					m_systems[earlier].successors.push_back(later);
+					++m_systems[later].predecessorCount;
+					m_systems[later].level = std::max(m_systems[later].level, m_systems[earlier].level + 1);
+				}
+			}
+		}
+
+		m_pending = std::make_unique<std::atomic<std::int32_t>[]>(m_systems.size());
+		m_isDirty = false;
+	}
+
+	void adlScheduler::launch(RunContext &context, const std::size_t index) {
+		context.jobSystem.run([this, &context, index] {
+			const auto &node = m_systems[index];
+			{
+				ADL_PROFILE_ZONE(node.profileName);
+				node.update(context.registry, context.deltaTime);
+			}
+
+			for (const auto successor: node.successors) {
+				if (m_pending[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+					launch(context, successor);
+				}
+			}
+		}, &context.counter);
+	}
+
+	void adlScheduler::run(adlRegistry &registry, adlJobSystem &jobSystem, const float deltaTime) {
+		if (m_systems.empty()) {
+			return;
+		}
+		if (m_isDirty) {
+			build();
+		}
+
+		for (std::size_t i = 0; i < m_systems.size(); ++i) {
+			m_systems[i].assure(registry.getRegistry());
+			m_pending[i].store(m_systems[i].predecessorCount, std::memory_order_relaxed);
+		}
+
+		// successors are launched before their predecessor's job completes, so the counter only drains at the end
+		adlJobCounter counter;
+		RunContext    context{.registry = registry, .jobSystem = jobSystem, .counter = counter, .deltaTime = deltaTime};
+
+		for (std::size_t i = 0; i < m_systems.size(); ++i) {
+			if (m_systems[i].predecessorCount == 0) {
+				launch(context, i);
+			}
+		}
+
+		jobSystem.wait(counter);
+	}
+
+	std::vector<std::vector<std::string> > adlScheduler::stages() {
+		if (m_isDirty) {
+			build();
+		}
+
+		std::vector<std::vector<std::string> > result;
+		for (const auto &node: m_systems) {
+			if (result.size() <= node.level) {
+				result.resize(node.level + 1);
+			}
+			result[node.level].push_back(node.name);
+		}
+
+		return result;
+	}
+}
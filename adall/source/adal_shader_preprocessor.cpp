@@ -0,0 +1,201 @@
+#include <filesystem>
+
+#include "adall/adal_shader_preprocessor.h"
+
+namespace fs = std::filesystem;
+
+static bool readSourceFile(const std::string &path, std::string &source) {
+	std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+	if (ifs.fail()) {
+		return false;
+	}
+
+	source.resize(static_cast<std::size_t>(ifs.tellg()));
+	ifs.seekg(0);
+	ifs.read(source.data(), static_cast<std::streamsize>(source.size()));
+
+	return !ifs.fail();
+}
+
+/// @return The quoted path of an #include line, or an empty view if the line is not one.
+static std::string_view parseInclude(std::string_view line) {
+	const auto trim = [](std::string_view &text) {
+		while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+			text.remove_prefix(1);
+		}
+	};
+
+	trim(line);
+	if (!line.starts_with('#')) {
+		return {};
+	}
+	line.remove_prefix(1);
+	trim(line);
+	if (!line.starts_with("include")) {
+		return {};
+	}
+	line.remove_prefix(7);
+	trim(line);
+
+	if (line.size() < 2 || line.front() != '"') {
+		return {};
+	}
+	const auto close = line.find('"', 1);
+	return close == std::string_view::npos ? std::string_view() : line.substr(1, close - 1);
+}
+
+/* -------------------------------------------------------------------------
+	adlShaderPreprocessor
+--------------------------------------------------------------------------*/
+adlShaderPreprocessor::adlShaderPreprocessor(adlShaderSourceReader reader)
+	: m_reader(reader ? std::move(reader) : adlShaderSourceReader(readSourceFile)) {
+}
+
+std::uint64_t adlShaderPreprocessor::feature(const std::string &name) {
+	const auto itr = std::find(m_features.begin(), m_features.end(), name);
+	if (itr != m_features.end()) {
+		return 1ull << static_cast<std::uint64_t>(itr - m_features.begin());
+	}
+
+	if (m_features.size() == MAX_FEATURES) {
+		return 0;
+	}
+
+	m_features.push_back(name);
+	return 1ull << (m_features.size() - 1);
+}
+
+const std::string *adlShaderPreprocessor::readFile(const std::string &path) {
+	if (const auto itr = m_files.find(path); itr != m_files.end()) {
+		return &itr->second;
+	}
+
+	std::string source;
+	if (!m_reader(path, source)) {
+		return nullptr;
+	}
+
+	return &m_files.emplace(path, std::move(source)).first->second;
+}
+
+bool adlShaderPreprocessor::expandFile(const std::string &path, std::unordered_set<std::string> &included
+                                     , std::string &out, const std::uint32_t depth) {
+	constexpr std::uint32_t MAX_DEPTH = 32;
+
+	// every file is pasted once, which also breaks include cycles
+	if (!included.insert(path).second) {
+		return true;
+	}
+
+	const std::string *source = readFile(path);
+	if (source == nullptr) {
+		std::cout << "failed to read shader source " << path << std::endl;
+		return false;
+	}
+
+	const fs::path   directory = fs::path(path).parent_path();
+	std::string_view rest      = *source;
+	while (!rest.empty()) {
+		const auto       end  = rest.find('\n');
+		std::string_view line = rest.substr(0, end);
+		rest                  = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+
+		const auto includePath = parseInclude(line);
+		if (includePath.empty()) {
+			out.append(line);
+			out.push_back('\n');
+			continue;
+		}
+
+		if (depth == MAX_DEPTH) {
+			std::cout << "shader includes nested too deep in " << path << std::endl;
+			return false;
+		}
+
+		const auto resolved = (directory / includePath).lexically_normal().generic_string();
+		if (!expandFile(resolved, included, out, depth + 1)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+const adlShaderPreprocessor::Expansion &adlShaderPreprocessor::expand(const std::string &path) {
+	if (const auto itr = m_expansions.find(path); itr != m_expansions.end()) {
+		return itr->second;
+	}
+
+	Expansion                       expansion{.version = {}, .body = {}, .isValid = false, .files = {}};
+	std::unordered_set<std::string> included;
+	std::string                     expanded;
+	expansion.isValid = expandFile(path, included, expanded, 0);
+	expansion.files.assign(included.begin(), included.end());
+	std::erase(expansion.files, path);
+	expansion.files.insert(expansion.files.begin(), path);
+
+	// defines may not come before #version, so it is split off and every variant puts it back first
+	const auto versionBegin = expanded.find("#version");
+	if (expansion.isValid && versionBegin != std::string::npos
+	    && expanded.find_first_not_of(" \t\r\n") == versionBegin) {
+		const auto versionEnd = expanded.find('\n', versionBegin);
+		expansion.version     = expanded.substr(0, versionEnd == std::string::npos ? versionEnd : versionEnd + 1);
+		expansion.body        = expanded.substr(expansion.version.size());
+	}
+	else {
+		expansion.body = std::move(expanded);
+	}
+
+	return m_expansions.emplace(path, std::move(expansion)).first->second;
+}
+
+const std::string *adlShaderPreprocessor::preprocess(const std::string &path, const std::uint64_t permutation) {
+	VariantKey key{.path = path, .permutation = permutation};
+	if (const auto itr = m_variants.find(key); itr != m_variants.end()) {
+		return &itr->second;
+	}
+
+	const Expansion &expansion = expand(path);
+	if (!expansion.isValid) {
+		return nullptr;
+	}
+
+	std::string defines;
+	for (std::size_t bit = 0; bit < m_features.size(); ++bit) {
+		if ((permutation >> bit & 1) != 0) {
+			defines += "#define " + m_features[bit] + " 1\n";
+		}
+	}
+
+	std::string source;
+	source.reserve(expansion.version.size() + defines.size() + expansion.body.size());
+	source.append(expansion.version).append(defines).append(expansion.body);
+
+	return &m_variants.emplace(std::move(key), std::move(source)).first->second;
+}
+
+const std::vector<std::string> *adlShaderPreprocessor::sources(const std::string &path) const {
+	const auto itr = m_expansions.find(path);
+	return itr != m_expansions.end() ? &itr->second.files : nullptr;
+}
+
+void adlShaderPreprocessor::forget(const std::string &path) {
+	m_files.erase(path);
+
+	for (auto itr = m_expansions.begin(); itr != m_expansions.end();) {
+		if (std::find(itr->second.files.begin(), itr->second.files.end(), path) == itr->second.files.end()) {
+			++itr;
+			continue;
+		}
+
+		const std::string root = itr->first;
+		std::erase_if(m_variants, [&root](const auto &entry) { return entry.first.path == root; });
+		itr = m_expansions.erase(itr);
+	}
+}
+
+void adlShaderPreprocessor::clear() {
+	m_files.clear();
+	m_expansions.clear();
+	m_variants.clear();
+}
@@ -0,0 +1,387 @@
+#include "adall/adal_snapshot.h"
+
+/// Entities per chunk of the entity storage and of tag pools, which have no pages.
+static constexpr std::size_t ENTITY_CHUNK = 1024;
+
+/// Longest run of deltas on a whole block, which bounds the work of reading a chunk back.
+static constexpr std::uint32_t MAX_DELTA_DEPTH = 15;
+
+/// Hashes bytes eight at a time. Only the same bytes on the same platform have to hash alike.
+static std::uint64_t hashBytes(const std::byte *data, const std::size_t size) {
+	std::uint64_t hash = 0x9E3779B97F4A7C15ull ^ size;
+	std::size_t   i    = 0;
+	for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+		std::uint64_t word;
+		std::memcpy(&word, data + i, sizeof(word));
+		hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 32;
+	}
+	for (; i < size; ++i) {
+		hash = (hash ^ static_cast<std::uint64_t>(data[i])) * 0x100000001B3ull;
+	}
+
+	return hash;
+}
+
+static std::uint64_t combineHash(const std::uint64_t hash, const std::uint64_t value) {
+	return (hash ^ (value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2))) * 0xC4CEB9FE1A85EC53ull;
+}
+
+/// Chunk hashes are sums of these, so changing one element changes its term alone.
+static std::uint64_t hashElement(const std::size_t position, const std::byte *data, const std::size_t size) {
+	return combineHash(hashBytes(data, size), position);
+}
+
+namespace adlCore {
+	/* -------------------------------------------------------------------------
+		adlSnapshotRing
+	--------------------------------------------------------------------------*/
+	adlSnapshotRing::adlSnapshotRing(const std::size_t capacity, const adlSceneSchema &schema)
+		: m_schema(schema),
+		  m_capacity(std::max<std::size_t>(capacity, 1)) {
+	}
+
+	void adlSnapshotRing::captureChunk(Stream &stream, const Stream *previous, std::vector<std::byte> &mirror, const std::size_t first
+	                                 , const std::byte *data, const std::size_t length) {
+		const std::size_t stride = stream.stride;
+		const std::size_t size   = length * stride;
+		const std::size_t index  = stream.chunks.size();
+		std::byte        *old    = mirror.data() + first * stride;
+
+		// the mirror holds previous, so a chunk previous has is diffed against the mirror's bytes
+		const Chunk *before = previous != nullptr && index < previous->chunks.size() ? &previous->chunks[index] : nullptr;
+		if (before != nullptr && (*before)->size == size) {
+			if (std::memcmp(old, data, size) == 0) {
+				stream.chunks.push_back(*before);
+				return;
+			}
+
+			if ((*before)->depth < MAX_DELTA_DEPTH) {
+				auto delta   = std::make_shared<Block>();
+				delta->base  = *before;
+				delta->depth = (*before)->depth + 1;
+				delta->size  = size;
+				delta->hash  = (*before)->hash;
+				for (std::size_t i = 0; i < length; ++i) {
+					if (std::memcmp(old + i * stride, data + i * stride, stride) != 0) {
+						delta->changed.push_back(static_cast<std::uint32_t>(i));
+						delta->bytes.insert(delta->bytes.end(), data + i * stride, data + (i + 1) * stride);
+						delta->hash += hashElement(i, data + i * stride, stride) - hashElement(i, old + i * stride, stride);
+					}
+				}
+
+				// a delta has to save at least half the chunk to be worth reading back through
+				if (delta->bytes.size() + delta->changed.size() * sizeof(std::uint32_t) < size / 2) {
+					stream.chunks.push_back(std::move(delta));
+					std::memcpy(old, data, size);
+					return;
+				}
+			}
+		}
+
+		auto whole   = std::make_shared<Block>();
+		whole->depth = 0;
+		whole->size  = size;
+		whole->bytes.assign(data, data + size);
+		whole->hash = 0;
+		for (std::size_t i = 0; i < length; ++i) {
+			whole->hash += hashElement(i, data + i * stride, stride);
+		}
+		stream.chunks.push_back(std::move(whole));
+		std::memcpy(old, data, size);
+	}
+
+	void adlSnapshotRing::materialize(const Block &block, std::byte *out) {
+		if (block.base == nullptr) {
+			std::memcpy(out, block.bytes.data(), block.size);
+			return;
+		}
+
+		materialize(*block.base, out);
+		const std::size_t stride = block.bytes.size() / block.changed.size();
+		for (std::size_t i = 0; i < block.changed.size(); ++i) {
+			std::memcpy(out + block.changed[i] * stride, block.bytes.data() + i * stride, stride);
+		}
+	}
+
+	void adlSnapshotRing::gather(const Stream &stream, std::vector<std::byte> &out) {
+		out.resize(stream.count * stream.stride);
+
+		std::size_t offset = 0;
+		for (const auto &chunk: stream.chunks) {
+			materialize(*chunk, out.data() + offset);
+			offset += chunk->size;
+		}
+	}
+
+	void adlSnapshotRing::resetMirror(const Frame &frame) {
+		m_mirror.assign(1 + 2 * m_schema.m_types.size(), {});
+		gather(frame.entities, m_mirror[0]);
+		for (const auto &pool: frame.pools) {
+			const auto type = static_cast<std::size_t>(pool.type - m_schema.m_types.data());
+			gather(pool.entities, m_mirror[1 + 2 * type]);
+			gather(pool.values, m_mirror[2 + 2 * type]);
+		}
+
+		m_mirrorFrame = frame.frame;
+	}
+
+	std::uint64_t adlSnapshotRing::capture(const adlRegistry &registry, const std::uint64_t frame) {
+		while (!m_frames.empty() && m_frames.back().frame >= frame) {
+			m_frames.pop_back();
+		}
+
+		// after a rollback the newest frame is an older one than the mirror holds
+		const Frame *previous = m_frames.empty() ? nullptr : &m_frames.back();
+		if (previous != nullptr && m_mirrorFrame != previous->frame) {
+			resetMirror(*previous);
+		}
+		m_mirror.resize(1 + 2 * m_schema.m_types.size());
+
+		const entt::registry &entities = registry.getRegistry();
+		const auto           &live     = *entities.storage<entt::entity>();
+
+		Frame next{
+			.frame = frame,
+			.checksum = 0,
+			.liveCount = live.free_list(),
+			.entities = {sizeof(entt::entity), live.size(), {}},
+			.pools = {},
+		};
+		m_mirror[0].resize(live.size() * sizeof(entt::entity));
+		for (std::size_t first = 0; first < live.size(); first += ENTITY_CHUNK) {
+			captureChunk(next.entities, previous != nullptr ? &previous->entities : nullptr, m_mirror[0], first
+			           , reinterpret_cast<const std::byte *>(live.data() + first), std::min(ENTITY_CHUNK, live.size() - first));
+		}
+
+		for (std::size_t typeIndex = 0; typeIndex < m_schema.m_types.size(); ++typeIndex) {
+			const auto             &type     = m_schema.m_types[typeIndex];
+			const entt::sparse_set *storage  = type.storage(entities);
+			auto                   &mirrored = m_mirror[1 + 2 * typeIndex];
+			auto                   &values   = m_mirror[2 + 2 * typeIndex];
+			if (storage == nullptr || storage->empty()) {
+				mirrored.clear();
+				values.clear();
+				continue;
+			}
+
+			const Pool *before = nullptr;
+			if (previous != nullptr) {
+				for (const auto &pool: previous->pools) {
+					before = pool.type == &type ? &pool : before;
+				}
+			}
+
+			Pool &pool = next.pools.emplace_back(Pool{
+				.type = &type,
+				.entities = {sizeof(entt::entity), storage->size(), {}},
+				.values = {type.elementSize, type.elementSize != 0 ? storage->size() : 0, {}},
+			});
+			mirrored.resize(pool.entities.count * pool.entities.stride);
+			values.resize(pool.values.count * pool.values.stride);
+
+			// values are contiguous a storage page at a time, so chunks are pages
+			const std::size_t chunkSize = type.pageSize != 0 ? type.pageSize : ENTITY_CHUNK;
+			for (std::size_t first = 0; first < storage->size(); first += chunkSize) {
+				const std::size_t length = std::min(chunkSize, storage->size() - first);
+				captureChunk(pool.entities, before != nullptr ? &before->entities : nullptr, mirrored, first
+				           , reinterpret_cast<const std::byte *>(storage->data() + first), length);
+				if (type.elementSize != 0) {
+					captureChunk(pool.values, before != nullptr ? &before->values : nullptr, values, first, type.value(*storage, first), length);
+				}
+			}
+		}
+		m_mirrorFrame = frame;
+
+		std::uint64_t checksum = combineHash(next.liveCount, next.entities.count);
+		const auto    hashStream = [&checksum](const Stream &stream) {
+			for (const auto &chunk: stream.chunks) {
+				checksum = combineHash(checksum, chunk->hash);
+			}
+		};
+		hashStream(next.entities);
+		for (const auto &pool: next.pools) {
+			checksum = combineHash(combineHash(checksum, pool.type->nameHash), pool.entities.count);
+			hashStream(pool.entities);
+			hashStream(pool.values);
+		}
+		next.checksum = checksum;
+
+		m_frames.push_back(std::move(next));
+		if (m_frames.size() > m_capacity) {
+			m_frames.pop_front();
+		}
+
+		return checksum;
+	}
+
+	bool adlSnapshotRing::patch(entt::registry &registry, const Frame &frame) const {
+		std::vector<std::byte> captured;
+
+		const auto &live = *std::as_const(registry).storage<entt::entity>();
+		if (live.size() != frame.entities.count || live.free_list() != frame.liveCount) {
+			return false;
+		}
+		gather(frame.entities, captured);
+		if (std::memcmp(captured.data(), live.data(), captured.size()) != 0) {
+			return false;
+		}
+
+		// every schema pool has to hold the same entities in the same order
+		for (const auto &type: m_schema.m_types) {
+			const entt::sparse_set *storage = type.storage(registry);
+			const Pool             *pool    = nullptr;
+			for (const auto &candidate: frame.pools) {
+				pool = candidate.type == &type ? &candidate : pool;
+			}
+
+			const std::size_t count = pool != nullptr ? pool->entities.count : 0;
+			if ((storage != nullptr ? storage->size() : 0) != count) {
+				return false;
+			}
+			if (count == 0) {
+				continue;
+			}
+			gather(pool->entities, captured);
+			if (std::memcmp(captured.data(), storage->data(), captured.size()) != 0) {
+				return false;
+			}
+		}
+
+		// everything that changed is found before anything is written, as a change to derived state means a rebuild
+		struct Change {
+			const adlSceneSchema::ComponentType *type;
+			entt::entity                         entity;
+			std::size_t                          offset; ///< Into changes.
+		};
+		std::vector<Change>    changed;
+		std::vector<std::byte> changes;
+		for (const auto &pool: frame.pools) {
+			const auto &type = *pool.type;
+			if (type.elementSize == 0) {
+				continue;
+			}
+
+			const entt::sparse_set &storage = *type.storage(registry);
+			std::size_t             first   = 0;
+			for (const auto &chunk: pool.values.chunks) {
+				captured.resize(chunk->size);
+				materialize(*chunk, captured.data());
+
+				const std::byte *current = type.value(storage, first);
+				if (std::memcmp(captured.data(), current, captured.size()) != 0) {
+					for (std::size_t offset = 0; offset < captured.size(); offset += type.elementSize) {
+						if (std::memcmp(captured.data() + offset, current + offset, type.elementSize) == 0) {
+							continue;
+						}
+						if (type.afterLoad) {
+							return false;
+						}
+
+						changed.push_back({&type, storage.data()[first + offset / type.elementSize], changes.size()});
+						changes.insert(changes.end(), captured.begin() + static_cast<std::ptrdiff_t>(offset)
+						             , captured.begin() + static_cast<std::ptrdiff_t>(offset + type.elementSize));
+					}
+				}
+				first += chunk->size / type.elementSize;
+			}
+		}
+
+		for (const auto &change: changed) {
+			change.type->overwrite(registry, change.entity, changes.data() + change.offset);
+		}
+
+		return true;
+	}
+
+	void adlSnapshotRing::rebuild(entt::registry &registry, const Frame &frame) {
+		// pools are emptied through their signals, so listeners drop what they derived from them
+		registry.clear();
+
+		std::vector<std::byte> bytes;
+		const auto             toEntities = [&bytes](std::vector<entt::entity> &entities) {
+			entities.resize(bytes.size() / sizeof(entt::entity));
+			std::memcpy(entities.data(), bytes.data(), bytes.size());
+		};
+
+		// the entities come back alive in index order, which never leaves a gap, then move to their captured
+		// positions; the ones past the free list are released again, in the order they will be reused
+		std::vector<entt::entity> order;
+		gather(frame.entities, bytes);
+		toEntities(order);
+		std::vector<entt::entity> byIndex = order;
+		std::sort(byIndex.begin(), byIndex.end(), [](const entt::entity lhs, const entt::entity rhs) {
+			return entt::to_entity(lhs) < entt::to_entity(rhs);
+		});
+
+		auto &live = registry.storage<entt::entity>();
+		live.clear();
+		// the base storage, so no entity signal fires for entities that were never destroyed
+		auto &base = static_cast<entt::basic_storage<entt::entity> &>(live);
+		for (const auto entity: byIndex) {
+			static_cast<void>(base.emplace(entity));
+		}
+		// sort_as() orders the storage as its iteration goes, from the back of the storage to the front
+		live.sort_as(order.rbegin(), order.rend());
+		live.free_list(frame.liveCount);
+
+		std::vector<entt::entity> entities;
+		for (const auto &pool: frame.pools) {
+			gather(pool.entities, bytes);
+			toEntities(entities);
+			gather(pool.values, bytes);
+
+			pool.type->insert(registry, entities, pool.type->elementSize != 0 ? bytes.data() : nullptr);
+			if (pool.type->afterLoad) {
+				pool.type->afterLoad(registry, entities);
+			}
+		}
+	}
+
+	bool adlSnapshotRing::restore(adlRegistry &registry, const std::uint64_t frame) const {
+		const auto itr = std::find_if(m_frames.begin(), m_frames.end(), [frame](const Frame &captured) {
+			return captured.frame == frame;
+		});
+		if (itr == m_frames.end()) {
+			return false;
+		}
+
+		if (!patch(registry.getRegistry(), *itr)) {
+			rebuild(registry.getRegistry(), *itr);
+		}
+		return true;
+	}
+
+	std::optional<std::uint64_t> adlSnapshotRing::checksum(const std::uint64_t frame) const {
+		for (const auto &captured: m_frames) {
+			if (captured.frame == frame) {
+				return captured.checksum;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	std::size_t adlSnapshotRing::byteSize() const {
+		std::unordered_set<const Block *> counted;
+		std::size_t                       size  = 0;
+		const auto                        count = [&counted, &size](const Stream &stream) {
+			for (const auto &chunk: stream.chunks) {
+				// evicted frames' blocks live on as the bases of newer deltas
+				for (const Block *block = chunk.get(); block != nullptr && counted.insert(block).second; block = block->base.get()) {
+					size += block->bytes.size() + block->changed.size() * sizeof(std::uint32_t);
+				}
+			}
+		};
+
+		for (const auto &frame: m_frames) {
+			count(frame.entities);
+			for (const auto &pool: frame.pools) {
+				count(pool.entities);
+				count(pool.values);
+			}
+		}
+
+		return size;
+	}
+}
@@ -0,0 +1,433 @@
+#include "adall/adal_spatial.h"
+
+namespace adlSystem {
+	/* -------------------------------------------------------------------------
+		SpatialIndex
+	--------------------------------------------------------------------------*/
+	SpatialIndex::SpatialIndex(adlCore::adlRegistry &registry, const float cellSize)
+		: m_registry(registry),
+		  m_cellSize(cellSize > 0.0f ? cellSize : 64.0f),
+		  m_inverseCellSize(1.0f / m_cellSize) {
+		auto &entities = m_registry.getRegistry();
+		entities.on_construct<adlComponent::WorldTransform>().connect<&SpatialIndex::onChanged>(this);
+		entities.on_update<adlComponent::WorldTransform>().connect<&SpatialIndex::onChanged>(this);
+		entities.on_destroy<adlComponent::WorldTransform>().connect<&SpatialIndex::onRemoved>(this);
+		entities.on_construct<adlComponent::Bounds>().connect<&SpatialIndex::onChanged>(this);
+		entities.on_update<adlComponent::Bounds>().connect<&SpatialIndex::onChanged>(this);
+		entities.on_destroy<adlComponent::Bounds>().connect<&SpatialIndex::onRemoved>(this);
+	}
+
+	SpatialIndex::~SpatialIndex() {
+		auto &entities = m_registry.getRegistry();
+		entities.on_construct<adlComponent::WorldTransform>().disconnect(this);
+		entities.on_update<adlComponent::WorldTransform>().disconnect(this);
+		entities.on_destroy<adlComponent::WorldTransform>().disconnect(this);
+		entities.on_construct<adlComponent::Bounds>().disconnect(this);
+		entities.on_update<adlComponent::Bounds>().disconnect(this);
+		entities.on_destroy<adlComponent::Bounds>().disconnect(this);
+	}
+
+	SpatialIndex::CellRange SpatialIndex::cellRange(const glm::vec2 &min, const glm::vec2 &max) const {
+		// clamped so far-away boxes cannot overflow the cell coordinates
+		static constexpr float LIMIT = 1.0e9f;
+		const auto             cell  = [this](const float value) {
+			return static_cast<std::int32_t>(std::floor(std::clamp(value * m_inverseCellSize, -LIMIT, LIMIT)));
+		};
+
+		return {.x0 = cell(min.x), .y0 = cell(min.y), .x1 = cell(max.x), .y1 = cell(max.y)};
+	}
+
+	void SpatialIndex::worldBox(const adlComponent::WorldTransform &transform, const adlComponent::Bounds &bounds, glm::vec2 &min, glm::vec2 &max) {
+		// the box's corners spread along both matrix columns; summing their absolute reach covers any rotation or shear
+		const glm::mat3 &matrix = transform.matrix;
+		const glm::vec2  center(matrix[2]);
+		const glm::vec2  extent(std::abs(matrix[0].x) * bounds.halfExtents.x + std::abs(matrix[1].x) * bounds.halfExtents.y,
+		                        std::abs(matrix[0].y) * bounds.halfExtents.x + std::abs(matrix[1].y) * bounds.halfExtents.y);
+
+		min = center - extent;
+		max = center + extent;
+	}
+
+	std::uint64_t SpatialIndex::homeCell(const glm::vec2 &min, const glm::vec2 &max) const {
+		const glm::vec2 half = (max - min) * 0.5f;
+		if (std::max(half.x, half.y) > m_cellSize) {
+			return OVERSIZED_CELL;
+		}
+
+		const glm::vec2 center = min + half;
+		const CellRange cell   = cellRange(center, center);
+		return cellKey(cell.x0, cell.y0);
+	}
+
+	std::vector<std::uint32_t> &SpatialIndex::cellList(const std::uint64_t cell) {
+		return cell == OVERSIZED_CELL ? m_oversized : m_shards[shardOf(cell)].cells[cell];
+	}
+
+	void SpatialIndex::fileEntry(const std::uint32_t index) {
+		Entry &entry = m_entries[index];
+		entry.list   = &cellList(entry.cell);
+		entry.slot   = static_cast<std::uint32_t>(entry.list->size());
+		entry.list->push_back(index);
+
+		if (entry.cell != OVERSIZED_CELL) {
+			const glm::vec2 half = (entry.max - entry.min) * 0.5f;
+			m_looseMargin        = std::max({m_looseMargin, half.x, half.y});
+		}
+	}
+
+	void SpatialIndex::unfileEntry(const std::uint32_t index) {
+		const Entry &entry = m_entries[index];
+		auto        &list  = *entry.list;
+
+		// swap-and-pop; the entry moved into the hole learns its new slot
+		const std::uint32_t moved = list.back();
+		list[entry.slot]          = moved;
+		m_entries[moved].slot     = entry.slot;
+		list.pop_back();
+
+		if (list.empty() && entry.cell != OVERSIZED_CELL) {
+			m_shards[shardOf(entry.cell)].cells.erase(entry.cell);
+		}
+	}
+
+	void SpatialIndex::removeEntry(const entt::entity entity) {
+		const auto entityIndex = static_cast<std::size_t>(entt::to_entity(entity));
+		if (entityIndex >= m_entryOf.size() || m_entryOf[entityIndex] == INVALID_ENTRY) {
+			return;
+		}
+
+		const std::uint32_t index = m_entryOf[entityIndex];
+		const auto          last  = static_cast<std::uint32_t>(m_entries.size() - 1);
+		unfileEntry(index);
+		m_entryOf[entityIndex] = INVALID_ENTRY;
+
+		if (index != last) {
+			// the last entry moves into the hole; only its cell list slot has to follow
+			const Entry &moved                       = m_entries[last];
+			(*moved.list)[moved.slot]                = index;
+			m_entryOf[entt::to_entity(moved.entity)] = index;
+			m_entries[index]                         = moved;
+		}
+		m_entries.pop_back();
+	}
+
+	void SpatialIndex::onChanged(entt::registry &, const entt::entity entity) {
+		const auto entityIndex = static_cast<std::size_t>(entt::to_entity(entity));
+
+		std::lock_guard lock(m_dirtyMutex);
+		if (entityIndex >= m_isDirty.size()) {
+			m_isDirty.resize(std::max<std::size_t>(entityIndex + 1, m_isDirty.size() * 2), 0);
+		}
+		if (m_isDirty[entityIndex] == 0) {
+			m_isDirty[entityIndex] = 1;
+			m_dirty.push_back(entity);
+		}
+	}
+
+	void SpatialIndex::onRemoved(entt::registry &, const entt::entity entity) {
+		removeEntry(entity);
+	}
+
+	void SpatialIndex::update(adlCore::adlRegistry &registry) {
+		std::vector<entt::entity> dirty;
+		{
+			std::lock_guard lock(m_dirtyMutex);
+			dirty.swap(m_dirty);
+			for (const auto entity: dirty) {
+				m_isDirty[entt::to_entity(entity)] = 0;
+			}
+		}
+
+		// refiling most entries one by one costs more than starting over
+		if (m_needsRebuild || dirty.size() > m_entries.size() / 4) {
+			rebuild(registry);
+			return;
+		}
+		if (dirty.empty()) {
+			return;
+		}
+
+		auto       &entities   = registry.getRegistry();
+		const auto &transforms = entities.storage<adlComponent::WorldTransform>();
+		const auto &bounds     = entities.storage<adlComponent::Bounds>();
+		const auto &jobSystem  = registry.adlGetContext<std::shared_ptr<adlCore::adlJobSystem> >();
+
+		// the box math runs in parallel, only the cell moves are serial
+		m_moved.resize(dirty.size());
+		jobSystem->parallelFor(0, dirty.size(), 256, [&](const std::size_t first, const std::size_t last) {
+			for (std::size_t i = first; i < last; ++i) {
+				const entt::entity entity = dirty[i];
+				Entry             &moved  = m_moved[i];
+				moved.entity              = entt::null;
+				if (!entities.valid(entity) || !transforms.contains(entity) || !bounds.contains(entity)) {
+					continue;
+				}
+
+				worldBox(transforms.get(entity), bounds.get(entity), moved.min, moved.max);
+				moved.cell   = homeCell(moved.min, moved.max);
+				moved.entity = entity;
+			}
+		});
+
+		for (const auto &moved: m_moved) {
+			if (moved.entity == entt::null) {
+				continue;
+			}
+
+			const auto entityIndex = static_cast<std::size_t>(entt::to_entity(moved.entity));
+			if (entityIndex >= m_entryOf.size()) {
+				m_entryOf.resize(std::max<std::size_t>(entityIndex + 1, m_entryOf.size() * 2), INVALID_ENTRY);
+			}
+
+			if (const std::uint32_t index = m_entryOf[entityIndex]; index == INVALID_ENTRY) {
+				m_entryOf[entityIndex] = static_cast<std::uint32_t>(m_entries.size());
+				m_entries.push_back(moved);
+				fileEntry(m_entryOf[entityIndex]);
+			}
+			else if (m_entries[index].cell != moved.cell) {
+				unfileEntry(index);
+				m_entries[index] = moved;
+				fileEntry(index);
+			}
+			else {
+				// same cell, so the grid does not change; only a grown box can widen the margin
+				Entry &entry = m_entries[index];
+				entry.min    = moved.min;
+				entry.max    = moved.max;
+				if (entry.cell != OVERSIZED_CELL) {
+					const glm::vec2 half = (entry.max - entry.min) * 0.5f;
+					m_looseMargin        = std::max({m_looseMargin, half.x, half.y});
+				}
+			}
+		}
+	}
+
+	void SpatialIndex::rebuild(adlCore::adlRegistry &registry) {
+		auto       &entities   = registry.getRegistry();
+		const auto &transforms = entities.storage<adlComponent::WorldTransform>();
+		const auto &bounds     = entities.storage<adlComponent::Bounds>();
+		const auto &jobSystem  = registry.adlGetContext<std::shared_ptr<adlCore::adlJobSystem> >();
+
+		m_entries.clear();
+		for (const auto entity: entities.view<const adlComponent::WorldTransform, const adlComponent::Bounds>()) {
+			m_entries.push_back({.min = {}, .max = {}, .cell = OVERSIZED_CELL, .list = nullptr, .slot = 0, .entity = entity});
+		}
+		m_entryOf.assign(entities.storage<entt::entity>().size(), INVALID_ENTRY);
+		for (auto &shard: m_shards) {
+			shard.cells.clear();
+		}
+		m_oversized.clear();
+
+		// every chunk sorts its entries into one bucket per shard, plus one for oversized entries,
+		// then every shard drains its buckets
+		constexpr std::size_t BUCKETS    = SHARD_COUNT + 1;
+		const std::size_t     count      = m_entries.size();
+		const std::size_t     chunkCount = std::clamp<std::size_t>(count / 1024, 1, jobSystem->threadCount() * 4);
+		const std::size_t     chunkSize  = (count + chunkCount - 1) / chunkCount;
+		m_buckets.resize(chunkCount * BUCKETS);
+		for (auto &bucket: m_buckets) {
+			bucket.clear();
+		}
+		std::vector<float> margins(chunkCount, 0.0f);
+
+		jobSystem->parallelFor(0, chunkCount, 1, [&](const std::size_t firstChunk, const std::size_t lastChunk) {
+			for (std::size_t chunk = firstChunk; chunk < lastChunk; ++chunk) {
+				auto             *buckets = &m_buckets[chunk * BUCKETS];
+				const std::size_t end     = std::min(count, (chunk + 1) * chunkSize);
+				for (std::size_t i = chunk * chunkSize; i < end; ++i) {
+					Entry &entry = m_entries[i];
+					worldBox(transforms.get(entry.entity), bounds.get(entry.entity), entry.min, entry.max);
+					entry.cell                               = homeCell(entry.min, entry.max);
+					m_entryOf[entt::to_entity(entry.entity)] = static_cast<std::uint32_t>(i);
+
+					if (entry.cell == OVERSIZED_CELL) {
+						buckets[SHARD_COUNT].emplace_back(entry.cell, static_cast<std::uint32_t>(i));
+						continue;
+					}
+
+					const glm::vec2 half = (entry.max - entry.min) * 0.5f;
+					margins[chunk]       = std::max({margins[chunk], half.x, half.y});
+					buckets[shardOf(entry.cell)].emplace_back(entry.cell, static_cast<std::uint32_t>(i));
+				}
+			}
+		});
+
+		jobSystem->parallelFor(0, BUCKETS, 1, [&](const std::size_t firstShard, const std::size_t lastShard) {
+			for (std::size_t shard = firstShard; shard < lastShard; ++shard) {
+				for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+					for (const auto &[cell, index]: m_buckets[chunk * BUCKETS + shard]) {
+						auto &list            = shard == SHARD_COUNT ? m_oversized : m_shards[shard].cells[cell];
+						m_entries[index].list = &list;
+						m_entries[index].slot = static_cast<std::uint32_t>(list.size());
+						list.push_back(index);
+					}
+				}
+			}
+		});
+
+		m_looseMargin  = *std::max_element(margins.begin(), margins.end());
+		m_needsRebuild = false;
+	}
+
+	template<typename TFunction>
+	void SpatialIndex::forEachInCell(const std::int32_t x, const std::int32_t y, TFunction &&function) const {
+		const std::uint64_t key   = cellKey(x, y);
+		const auto         &shard = m_shards[shardOf(key)];
+		if (const auto it = shard.cells.find(key); it != shard.cells.end()) {
+			for (const auto index: it->second) {
+				function(index);
+			}
+		}
+	}
+
+	template<typename TFunction>
+	void SpatialIndex::forEachCandidate(const glm::vec2 &min, const glm::vec2 &max, TFunction &&function) const {
+		for (const auto index: m_oversized) {
+			function(index);
+		}
+
+		// a box filed by its center reaches at most the margin past its cell
+		const CellRange range = cellRange(min - m_looseMargin, max + m_looseMargin);
+
+		const auto rangeCells = static_cast<std::uint64_t>(static_cast<std::int64_t>(range.x1) - range.x0 + 1)
+		                        * static_cast<std::uint64_t>(static_cast<std::int64_t>(range.y1) - range.y0 + 1);
+		if (rangeCells > cellCount()) {
+			// a range wider than the occupied cells is cheaper to answer by walking what is occupied
+			for (const auto &shard: m_shards) {
+				for (const auto &[key, indices]: shard.cells) {
+					const auto x = static_cast<std::int32_t>(key >> 32);
+					const auto y = static_cast<std::int32_t>(key & 0xFFFFFFFF);
+					if (x >= range.x0 && x <= range.x1 && y >= range.y0 && y <= range.y1) {
+						for (const auto index: indices) {
+							function(index);
+						}
+					}
+				}
+			}
+			return;
+		}
+
+		for (std::int32_t y = range.y0; y <= range.y1; ++y) {
+			for (std::int32_t x = range.x0; x <= range.x1; ++x) {
+				forEachInCell(x, y, function);
+			}
+		}
+	}
+
+	void SpatialIndex::queryAABB(const glm::vec2 &min, const glm::vec2 &max, std::vector<entt::entity> &out) const {
+		forEachCandidate(min, max, [&](const std::uint32_t index) {
+			const Entry &entry = m_entries[index];
+			if (entry.min.x <= max.x && entry.max.x >= min.x && entry.min.y <= max.y && entry.max.y >= min.y) {
+				out.push_back(entry.entity);
+			}
+		});
+	}
+
+	void SpatialIndex::queryRadius(const glm::vec2 &center, const float radius, std::vector<entt::entity> &out) const {
+		const float radiusSquared = radius * radius;
+		forEachCandidate(center - radius, center + radius, [&](const std::uint32_t index) {
+			const Entry    &entry   = m_entries[index];
+			const glm::vec2 nearest = glm::clamp(center, entry.min, entry.max);
+			const glm::vec2 offset  = center - nearest;
+			if (glm::dot(offset, offset) <= radiusSquared) {
+				out.push_back(entry.entity);
+			}
+		});
+	}
+
+	void SpatialIndex::queryRay(const glm::vec2 &origin, const glm::vec2 &direction, const float maxDistance, std::vector<RayHit> &out) const {
+		if (maxDistance < 0.0f || (direction.x == 0.0f && direction.y == 0.0f)) {
+			return;
+		}
+
+		const std::size_t firstHit = out.size();
+
+		// slab test; an axis the ray runs parallel to either always or never overlaps
+		const auto test = [&](const std::uint32_t index) {
+			const Entry &entry = m_entries[index];
+			float        enter = 0.0f, exit = maxDistance;
+			for (int axis = 0; axis < 2; ++axis) {
+				if (direction[axis] == 0.0f) {
+					if (origin[axis] < entry.min[axis] || origin[axis] > entry.max[axis]) {
+						return;
+					}
+					continue;
+				}
+
+				const float inverse = 1.0f / direction[axis];
+				float       near    = (entry.min[axis] - origin[axis]) * inverse;
+				float       far     = (entry.max[axis] - origin[axis]) * inverse;
+				if (near > far) {
+					std::swap(near, far);
+				}
+				enter = std::max(enter, near);
+				exit  = std::min(exit, far);
+				if (enter > exit) {
+					return;
+				}
+			}
+
+			out.push_back({.entity = entry.entity, .distance = enter});
+		};
+
+		for (const auto index: m_oversized) {
+			test(index);
+		}
+
+		// walk the cells the segment crosses, in order (Amanatides-Woo), plus the ring of
+		// neighbours whose boxes may reach into them
+		const glm::vec2    end   = origin + direction * maxDistance;
+		const CellRange    from  = cellRange(origin, origin);
+		const CellRange    to    = cellRange(end, end);
+		const std::int32_t reach = static_cast<std::int32_t>(std::ceil(m_looseMargin * m_inverseCellSize));
+
+		std::int32_t   x = from.x0, y = from.y0;
+		const int      stepX = direction.x > 0.0f ? 1 : -1;
+		const int      stepY = direction.y > 0.0f ? 1 : -1;
+		constexpr auto NEVER = std::numeric_limits<float>::infinity();
+
+		const auto boundary = [this](const std::int32_t cell, const int step) {
+			return static_cast<float>(step > 0 ? cell + 1 : cell) * m_cellSize;
+		};
+		float       nextX  = direction.x != 0.0f ? (boundary(x, stepX) - origin.x) / direction.x : NEVER;
+		float       nextY  = direction.y != 0.0f ? (boundary(y, stepY) - origin.y) / direction.y : NEVER;
+		const float deltaX = direction.x != 0.0f ? m_cellSize / std::abs(direction.x) : NEVER;
+		const float deltaY = direction.y != 0.0f ? m_cellSize / std::abs(direction.y) : NEVER;
+
+		const std::int64_t cellsToVisit = std::abs(static_cast<std::int64_t>(to.x0) - x) + std::abs(static_cast<std::int64_t>(to.y0) - y) + 1;
+		for (std::int64_t visited = 0; visited < cellsToVisit; ++visited) {
+			for (std::int32_t ny = y - reach; ny <= y + reach; ++ny) {
+				for (std::int32_t nx = x - reach; nx <= x + reach; ++nx) {
+					forEachInCell(nx, ny, test);
+				}
+			}
+
+			if (nextX < nextY) {
+				x += stepX;
+				nextX += deltaX;
+			}
+			else {
+				y += stepY;
+				nextY += deltaY;
+			}
+		}
+
+		// an entity met from several cells enters at the same distance each time, so duplicates end up adjacent
+		const auto hits = out.begin() + static_cast<std::ptrdiff_t>(firstHit);
+		std::sort(hits, out.end(), [](const RayHit &lhs, const RayHit &rhs) {
+			return lhs.distance != rhs.distance ? lhs.distance < rhs.distance : lhs.entity < rhs.entity;
+		});
+		out.erase(std::unique(hits, out.end(), [](const RayHit &lhs, const RayHit &rhs) {
+			return lhs.entity == rhs.entity;
+		}), out.end());
+	}
+
+	std::size_t SpatialIndex::cellCount() const {
+		std::size_t count = 0;
+		for (const auto &shard: m_shards) {
+			count += shard.cells.size();
+		}
+
+		return count;
+	}
+}
@@ -0,0 +1,90 @@
+#include "adall/adal_sprite.h"
+
+namespace adlSystem {
+	/* -------------------------------------------------------------------------
+		SpriteRecorder
+	--------------------------------------------------------------------------*/
+	adlRenderCommand SpriteRecorder::makeCommand(const adlComponent::Sprite &sprite, const adlComponent::WorldTransform &transform
+	                                           , const adlComponent::Bounds &bounds, const GLuint shaderProgramID, const GLuint textureID) {
+		// the columns hold the box's axes, scaled; their lengths are the scale and the first one's angle the rotation
+		const glm::mat3 &matrix = transform.matrix;
+		const glm::vec2  size   = 2.0f * bounds.halfExtents * glm::vec2(glm::length(glm::vec2(matrix[0])), glm::length(glm::vec2(matrix[1])));
+
+		return adlRenderCommand{
+			.sortKey = adlMakeSortKey(sprite.layer, shaderProgramID, textureID, sprite.depth),
+			.sprite = adlSprite{
+				.position = glm::vec2(matrix[2]) - size * 0.5f,
+				.size = size,
+				.uvRect = sprite.uvRect,
+				.rotation = std::atan2(matrix[0].y, matrix[0].x),
+				.color = sprite.color,
+				.textureID = textureID,
+				.shaderProgramID = shaderProgramID,
+			},
+		};
+	}
+
+	std::size_t SpriteRecorder::record(adlCore::adlRegistry &registry, adlRenderQueue &queue, const entt::entity camera) {
+		const entt::registry &entities  = registry.getRegistry();
+		const auto           &jobSystem = registry.adlGetContext<std::shared_ptr<adlCore::adlJobSystem> >();
+		const auto           &assets    = registry.adlGetContext<std::shared_ptr<adlCore::adlAssetManager> >();
+
+		m_shaders.clear();
+		const auto *visibility = entities.valid(camera) ? entities.try_get<adlComponent::Visibility>(camera) : nullptr;
+		const auto *sprites    = entities.storage<adlComponent::Sprite>();
+		const auto *transforms = entities.storage<adlComponent::WorldTransform>();
+		const auto *bounds     = entities.storage<adlComponent::Bounds>();
+		if (visibility == nullptr || sprites == nullptr || transforms == nullptr || bounds == nullptr) {
+			return 0;
+		}
+
+		m_workerShaders.resize(queue.bufferCount());
+		for (auto &shaders: m_workerShaders) {
+			shaders.clear();
+		}
+
+		std::atomic<std::size_t> recorded{0};
+		jobSystem->parallelFor(0, visibility->entities.size(), 1024, [&](const std::size_t first, const std::size_t last) {
+			const std::size_t       worker  = jobSystem->workerIndex();
+			adlRenderCommandBuffer &buffer  = queue.buffer(worker);
+			auto                   &shaders = m_workerShaders[worker];
+
+			std::size_t count = 0;
+			for (std::size_t i = first; i < last; ++i) {
+				// culling only keeps entities with Bounds and a WorldTransform
+				const entt::entity entity = visibility->entities[i];
+				if (!sprites->contains(entity)) {
+					continue;
+				}
+
+				const auto       &sprite  = sprites->get(entity);
+				const adlShader  *shader  = assets->getShader(sprite.shader);
+				const adlTexture *texture = assets->getTexture(sprite.texture);
+				// async textures have no GL texture until their upload
+				if (shader == nullptr || texture == nullptr || texture->textureID == 0) {
+					continue;
+				}
+
+				const adlRenderCommand command = makeCommand(sprite, transforms->get(entity), bounds->get(entity), shader->shaderProgramID, texture->textureID);
+				buffer.push(command.sortKey, command.sprite);
+				++count;
+
+				// a frame uses a handful of programs, so a linear search beats a set
+				if (std::find(shaders.begin(), shaders.end(), sprite.shader) == shaders.end()) {
+					shaders.push_back(sprite.shader);
+				}
+			}
+			recorded.fetch_add(count, std::memory_order_relaxed);
+		});
+
+		for (const auto &shaders: m_workerShaders) {
+			for (const auto shader: shaders) {
+				if (std::find(m_shaders.begin(), m_shaders.end(), shader) == m_shaders.end()) {
+					m_shaders.push_back(shader);
+				}
+			}
+		}
+
+		return recorded.load(std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,50 @@
+#include <mutex>
+
+#include "adall/adal_string.h"
+
+/* -------------------------------------------------------------------------
+	adlStringInterner
+--------------------------------------------------------------------------*/
+adlStringInterner::adlStringInterner() {
+	m_strings.emplace_back();
+	m_ids.emplace(m_strings.back(), 0);
+}
+
+adlStringInterner &adlStringInterner::global() {
+	static adlStringInterner interner;
+	return interner;
+}
+
+adlStringID adlStringInterner::intern(const std::string_view string) {
+	if (const adlStringID id = find(string); id != 0 || string.empty()) {
+		return id;
+	}
+
+	std::unique_lock lock(m_mutex);
+	// another thread may have interned it between the two locks
+	if (const auto itr = m_ids.find(string); itr != m_ids.end()) {
+		return itr->second;
+	}
+
+	const auto id = static_cast<adlStringID>(m_strings.size());
+	m_strings.emplace_back(string);
+	m_ids.emplace(m_strings.back(), id);
+
+	return id;
+}
+
+adlStringID adlStringInterner::find(const std::string_view string) const {
+	std::shared_lock lock(m_mutex);
+	const auto       itr = m_ids.find(string);
+	return itr != m_ids.end() ? itr->second : 0;
+}
+
+std::string_view adlStringInterner::view(const adlStringID id) const {
+	std::shared_lock lock(m_mutex);
+	return id < m_strings.size() ? std::string_view(m_strings[id]) : std::string_view();
+}
+
+std::size_t adlStringInterner::size() const {
+	std::shared_lock lock(m_mutex);
+	return m_strings.size();
+}
@@ -1,35 +1,103 @@
 #include "adall/adal_system.h"
 
 namespace adlSystem {
-	Renderer::Renderer(GLFWwindow *window, adlCore::adlRegistry &registry) : m_window(window) {
-
+	Renderer::Renderer(GLFWwindow *window, const std::size_t maxQuads)
+		: m_VAO(0),
+		  m_IBO(0),
+		  m_frameUBO(0),
+		  m_window(window),
+		  m_maxQuads(maxQuads),
+		  m_modelName(adlIntern("model")),
+		  m_materialName(adlIntern("material")) {
+		init();
 	}
 
 	void Renderer::init() {
 		glGenVertexArrays(1, &m_VAO);
 		glBindVertexArray(m_VAO);
 
-		glGenBuffers(1, &m_VBO);
-		glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(adlVertex), nullptr, GL_DYNAMIC_DRAW);
+		if (!m_vertexStream.init(std::make_unique<adlGLStreamBackend>(GL_ARRAY_BUFFER), m_maxQuads * 4 * sizeof(adlVertex))) {
+			std::cout << "failed to create renderer vertex stream" << std::endl;
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, m_vertexStream.bufferID());
+
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(adlVertex), reinterpret_cast<void *>(offsetof(adlVertex, position)));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(adlVertex), reinterpret_cast<void *>(offsetof(adlVertex, uvs)));
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(adlVertex), reinterpret_cast<void *>(offsetof(adlVertex, color)));
 
-		GLuint indices[] = {
-			0, 1, 2,
-			2, 3, 0,
-		};
+		// every batch draws with a base vertex, so a single static buffer of quad indices serves all of them
+		const auto indices = adlSpriteBatch::makeQuadIndices(m_maxQuads);
 
 		glGenBuffers(1, &m_IBO);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IBO);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint), indices, GL_DYNAMIC_DRAW);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indices.size() * sizeof(GLuint)), indices.data(), GL_STATIC_DRAW);
 
 		glBindVertexArray(0);
+
+		// 144 bytes once a frame, a plain buffer update lets the driver handle the renaming
+		glGenBuffers(1, &m_frameUBO);
+		glBindBuffer(GL_UNIFORM_BUFFER, m_frameUBO);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(adlFrameUniforms), nullptr, GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_UNIFORM_BUFFER, adlFrameUniforms::BINDING, m_frameUBO);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+
+	void Renderer::setFrameUniforms(const adlFrameUniforms &frameUniforms) {
+		glBindBuffer(GL_UNIFORM_BUFFER, m_frameUBO);
+
+		// the time changes every frame, the matrices only when the main camera does
+		constexpr std::size_t MATRIX_BYTES = offsetof(adlFrameUniforms, time);
+		if (!m_hasFrameUniforms || std::memcmp(&m_frameUniforms, &frameUniforms, MATRIX_BYTES) != 0) {
+			glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(adlFrameUniforms), &frameUniforms);
+		}
+		else {
+			glBufferSubData(GL_UNIFORM_BUFFER, MATRIX_BYTES, sizeof(adlFrameUniforms) - MATRIX_BYTES, &frameUniforms.time);
+		}
+		m_frameUniforms    = frameUniforms;
+		m_hasFrameUniforms = true;
+
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
 	}
 
-	void Renderer::render() {
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	void Renderer::setProgramUniforms(adlShader &shader) {
+		// a program that does not declare one of them (or whose compiler dropped it) simply has nothing to set
+		static_cast<void>(m_uniformState.set(shader, m_modelName, glm::mat4(1.0f)));
+		static_cast<void>(m_uniformState.set(shader, m_materialName, GLint{0}));
+	}
+
+	void Renderer::render(const adlSpriteBatch &batch) {
+		if (batch.vertices().empty()) {
+			return;
+		}
+
 		glBindVertexArray(m_VAO);
 
-		glDrawElements(GL_TRIANGLES, 3, GL_UNSIGNED_INT, ())
+		GLuint     boundShader = 0, boundTexture = 0;
+		const bool isStreamed  = batch.stream(m_vertexStream, [&](const adlDrawBatch &draw, const GLint baseVertex) {
+			if (draw.shaderProgramID != boundShader) {
+				glUseProgram(draw.shaderProgramID);
+				boundShader = draw.shaderProgramID;
+			}
+			if (draw.textureID != boundTexture) {
+				glBindTexture(GL_TEXTURE_2D, draw.textureID);
+				boundTexture = draw.textureID;
+			}
+
+			// a batch built with a larger per-draw limit than the index buffer covers is split here
+			for (std::size_t drawn = 0; drawn < draw.quadCount; drawn += m_maxQuads) {
+				const auto quadCount = std::min<std::size_t>(draw.quadCount - drawn, m_maxQuads);
+				glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(quadCount * 6), GL_UNSIGNED_INT, nullptr,
+				                         baseVertex + static_cast<GLint>((draw.firstQuad + drawn) * 4));
+			}
+		});
+		if (!isStreamed) {
+			std::cout << "failed to stream the sprite batch, " << batch.vertices().size() / 4 << " quads were not all drawn" << std::endl;
+		}
+
+		glBindVertexArray(0);
 	}
 
 	void Renderer::update() {
@@ -45,8 +113,71 @@ namespace adlSystem {
 		glCullFace(GL_BACK);
 	}
 
+	Camera2D::Camera2D(adlCore::adlRegistry &registry, GLFWwindow *window)
+		: m_window(window),
+		  m_observer(registry.getRegistry(), entt::collector.group<adlComponent::Camera>().update<adlComponent::Camera>()) {
+		if (m_window != nullptr) {
+			glfwGetFramebufferSize(m_window, &m_framebufferSize.x, &m_framebufferSize.y);
+			m_hasResized = true;
+		}
+	}
+
+	bool Camera2D::rebuild(adlComponent::Camera &camera) {
+		if (camera.width <= 0 || camera.height <= 0) {
+			return false;
+		}
+
+		camera.orthorProjection = glm::ortho(0.0f, static_cast<float>(camera.width),
+		                                     0.0f, static_cast<float>(camera.height), -1.0f, 1.0f);
 
+		const glm::vec2 halfScreen = glm::vec2(camera.width, camera.height) * 0.5f;
+		camera.cameraMatrix        = glm::translate(glm::mat4(1.0f), glm::vec3(halfScreen, 0.0f))
+		                             * glm::scale(glm::mat4(1.0f), glm::vec3(camera.scale, camera.scale, 1.0f))
+		                             * glm::translate(glm::mat4(1.0f), glm::vec3(-camera.position, 0.0f));
+		return true;
+	}
 
+	void Camera2D::setMainCamera(const entt::entity camera) {
+		m_mainCamera   = camera;
+		m_hasResized   = m_framebufferSize.x > 0 && m_framebufferSize.y > 0;
+		m_needsPublish = true;
+	}
 
+	void Camera2D::resize(const int width, const int height) {
+		m_framebufferSize = {width, height};
+		m_hasResized      = true;
+	}
 
+	void Camera2D::update(adlCore::adlRegistry &registry) {
+		auto &entities = registry.getRegistry();
+		auto &cameras  = entities.storage<adlComponent::Camera>();
+
+		// patched like any other change, so the observer picks the camera up below
+		if (m_hasResized) {
+			m_hasResized = false;
+			if (entities.valid(m_mainCamera) && cameras.contains(m_mainCamera)) {
+				entities.patch<adlComponent::Camera>(m_mainCamera, [this](adlComponent::Camera &camera) {
+					camera.width  = m_framebufferSize.x;
+					camera.height = m_framebufferSize.y;
+				});
+			}
+		}
+
+		// only a handful of cameras ever change in one step, so this stays serial
+		for (const auto entity: m_observer) {
+			if (cameras.contains(entity) && rebuild(cameras.get(entity))) {
+				++m_rebuildCount;
+				m_needsPublish |= entity == m_mainCamera;
+			}
+		}
+		m_observer.clear();
+
+		if (m_needsPublish && entities.valid(m_mainCamera) && cameras.contains(m_mainCamera)) {
+			const auto &camera = cameras.get(m_mainCamera);
+			m_view             = camera.cameraMatrix;
+			m_projection       = camera.orthorProjection;
+			m_needsPublish     = false;
+			++m_revision;
+		}
+	}
 }
@@ -1,96 +1,343 @@
 #include <stb/stb_image.h>
 #include "adall/adal_view.h"
 
+/* -------------------------------------------------------------------------
+	adlGLStreamBackend
+--------------------------------------------------------------------------*/
+std::byte *adlGLStreamBackend::create(const std::size_t bytes) {
+	destroy();
+
+	glGenBuffers(1, &m_bufferID);
+	glBindBuffer(m_target, m_bufferID);
+
+	m_persistent = GLAD_GL_ARB_buffer_storage != 0;
+	if (m_persistent) {
+		constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(m_target, static_cast<GLsizeiptr>(bytes), nullptr, flags);
+
+		auto *mapped = static_cast<std::byte *>(glMapBufferRange(m_target, 0, static_cast<GLsizeiptr>(bytes), flags));
+		if (mapped == nullptr) {
+			destroy();
+			return nullptr;
+		}
+		return mapped;
+	}
+
+	// no persistent mapping (e.g. core 4.1 on macOS): write into a CPU shadow and upload the written
+	// range on flush. The fences still keep the CPU off ranges the GPU is reading, so nothing is orphaned.
+	glBufferData(m_target, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+	m_shadow.assign(bytes, std::byte{0});
+	return m_shadow.data();
+}
+
+void adlGLStreamBackend::destroy() {
+	for (auto &[region, sync]: m_fences) {
+		glDeleteSync(sync);
+	}
+	m_fences.clear();
+
+	if (m_bufferID != 0) {
+		if (m_persistent) {
+			glBindBuffer(m_target, m_bufferID);
+			glUnmapBuffer(m_target);
+		}
+		glDeleteBuffers(1, &m_bufferID);
+		m_bufferID = 0;
+	}
+
+	m_shadow.clear();
+	m_persistent = false;
+}
+
+void adlGLStreamBackend::flush(const std::size_t offset, const std::size_t bytes) {
+	if (m_persistent || bytes == 0) {
+		return;
+	}
+
+	glBindBuffer(m_target, m_bufferID);
+	glBufferSubData(m_target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes), m_shadow.data() + offset);
+}
+
+void adlGLStreamBackend::fence(const std::size_t region) {
+	if (const auto itr = m_fences.find(region); itr != m_fences.end()) {
+		glDeleteSync(itr->second);
+	}
+	m_fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool adlGLStreamBackend::waitFence(const std::size_t region, const std::uint64_t timeoutNs) {
+	const auto itr = m_fences.find(region);
+	if (itr == m_fences.end()) {
+		return true;
+	}
+
+	const GLenum result = glClientWaitSync(itr->second, GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNs);
+	if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+		return false;
+	}
+
+	glDeleteSync(itr->second);
+	m_fences.erase(itr);
+	return true;
+}
+
+/* -------------------------------------------------------------------------
+	adlStreamBuffer
+--------------------------------------------------------------------------*/
+adlStreamBuffer::~adlStreamBuffer() {
+	if (m_backend) {
+		m_backend->destroy();
+	}
+}
+
+bool adlStreamBuffer::init(std::unique_ptr<adlStreamBackend> backend, const std::size_t regionSize) {
+	if (!backend || regionSize == 0) {
+		return false;
+	}
+
+	m_backend    = std::move(backend);
+	m_regionSize = regionSize;
+	m_region     = 0;
+	m_head       = 0;
+	m_flushBegin = 0;
+	m_inFrame    = false;
+
+	m_mapped = m_backend->create(m_regionSize * REGION_COUNT);
+	return m_mapped != nullptr;
+}
+
+bool adlStreamBuffer::beginFrame(const std::uint64_t timeoutNs) {
+	if (m_mapped == nullptr) {
+		return false;
+	}
+
+	m_head       = 0;
+	m_flushBegin = 0;
+	m_inFrame    = m_backend->waitFence(m_region, timeoutNs);
+	return m_inFrame;
+}
+
+adlStreamBuffer::Allocation adlStreamBuffer::allocate(const std::size_t bytes, const std::size_t alignment) {
+	if (!m_inFrame) {
+		return {.data = nullptr, .offset = 0};
+	}
+
+	// alignment is applied to the absolute offset so it also works for non power-of-two vertex strides
+	const std::size_t regionBase = m_region * m_regionSize;
+	const std::size_t granule    = std::max<std::size_t>(alignment, 1);
+	const std::size_t absolute   = (regionBase + m_head + granule - 1) / granule * granule;
+	const std::size_t head       = absolute - regionBase;
+
+	if (head + bytes > m_regionSize) {
+		return {.data = nullptr, .offset = 0};
+	}
+
+	m_head = head + bytes;
+	return {.data = m_mapped + absolute, .offset = absolute};
+}
+
+void adlStreamBuffer::flush() {
+	if (!m_inFrame || m_head == m_flushBegin) {
+		return;
+	}
+
+	m_backend->flush(m_region * m_regionSize + m_flushBegin, m_head - m_flushBegin);
+	m_flushBegin = m_head;
+}
+
+void adlStreamBuffer::endFrame() {
+	if (!m_inFrame) {
+		return;
+	}
+
+	flush();
+	m_backend->fence(m_region);
+
+	m_region     = (m_region + 1) % REGION_COUNT;
+	m_head       = 0;
+	m_flushBegin = 0;
+	m_inFrame    = false;
+}
+
 /* -------------------------------------------------------------------------
 	adlTextureLoader
 --------------------------------------------------------------------------*/
-bool adlTextureLoader::adlLoadTexture(const std::string &texturePath, int &width, int &height, bool isPixelated) {
+void adlImageDeleter::operator()(unsigned char *pixels) const {
+	stbi_image_free(pixels);
+}
+
+bool adlTextureLoader::decodeImage(const std::string &texturePath, adlImage &image) {
+	int channels = 0;
+
+	// always ask stb for 4 components, so every decoded image is RGBA8 whatever the file stores
+	unsigned char *data = stbi_load(texturePath.c_str(), &image.width, &image.height, &channels, 4);
+	if (!data) {
+		return false;
+	}
+
+	image.pixels.reset(data);
+	return true;
+}
+
+bool adlTextureLoader::decodeImage(const std::span<const std::byte> encoded, adlImage &image) {
 	int channels = 0;
 
-	unsigned char *data = stbi_load(texturePath.c_str(), &width, &height, &channels, 4);
+	unsigned char *data = stbi_load_from_memory(reinterpret_cast<const stbi_uc *>(encoded.data()), static_cast<int>(encoded.size())
+	                                          , &image.width, &image.height, &channels, 4);
 	if (!data) {
 		return false;
 	}
 
-	if (isPixelated) {
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	image.pixels.reset(data);
+	return true;
+}
+
+bool adlTextureLoader::loadImage(const std::string &texturePath, adlImage &image, const adlArchive *archive) {
+	const adlArchiveEntry *entry = archive != nullptr ? archive->find(texturePath) : nullptr;
+	if (entry == nullptr) {
+		return decodeImage(texturePath, image);
 	}
-	else {
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	const auto bytes = archive->data(*entry);
+	switch (entry->type) {
+		case adlArchiveEntryType::TEXTURE_RGBA8:
+			if (bytes.size() != static_cast<std::size_t>(entry->width) * entry->height * 4) {
+				return false;
+			}
+			image.width  = static_cast<int>(entry->width);
+			image.height = static_cast<int>(entry->height);
+			image.pixels.reset();
+			image.view = reinterpret_cast<const unsigned char *>(bytes.data());
+			return true;
+		case adlArchiveEntryType::TEXTURE_ENCODED:
+			return decodeImage(bytes, image);
+		default:
+			return false;
 	}
+}
 
-	GLint format;
-	if (channels == 3) format = GL_RGB;
-	else format = GL_RGBA;
+static void setTextureFilter(const bool isPixelated) {
+	const GLint filter = isPixelated ? GL_NEAREST : GL_LINEAR;
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+}
 
-	glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+GLuint adlTextureLoader::uploadImage(const adlImage &image, const bool isPixelated) {
+	if (image.data() == nullptr) {
+		return 0;
+	}
+
+	GLuint textureID = 0;
+	glGenTextures(1, &textureID);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+
+	setTextureFilter(isPixelated);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.data());
 
-	stbi_image_free(data);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	return textureID;
+}
+
+bool adlTextureLoader::adlLoadTexture(const std::string &texturePath, int &width, int &height, bool isPixelated) {
+	adlImage image;
+	if (!decodeImage(texturePath, image)) {
+		return false;
+	}
+
+	setTextureFilter(isPixelated);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels.get());
+
+	width  = image.width;
+	height = image.height;
 	return true;
 }
 
 std::shared_ptr<adlTexture>
-	adlTextureLoader::makeADLTexture(const std::string &texturePath, adlTextureType textureType) {
-	return nullptr;
+	adlTextureLoader::makeADLTexture(const std::string &texturePath, adlTextureType textureType, const adlArchive *archive) {
+	adlImage image;
+	if (!loadImage(texturePath, image, archive)) {
+		return nullptr;
+	}
+
+	const GLuint textureID = uploadImage(image, textureType == adlTextureType::PIXEL);
+	if (textureID == 0) {
+		return nullptr;
+	}
+
+	return std::make_shared<adlTexture>(adlTexture{.width = image.width, .height = image.height, .textureID = textureID});
 }
 
 /* -------------------------------------------------------------------------
 	adlShaderLoader
 --------------------------------------------------------------------------*/
-GLuint adlShaderLoader::compileGLShader(const GLuint shaderType, const std::string &shaderPath) {
-	const auto shaderID = glCreateShader(shaderType);
+bool adlShaderLoader::readShaderSource(const std::string &shaderPath, const adlArchive *archive, std::string &source) {
+	if (const adlArchiveEntry *entry = archive != nullptr ? archive->find(shaderPath) : nullptr) {
+		const auto bytes = archive->data(*entry);
+		source.assign(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+		return true;
+	}
 
-	std::ifstream ifs(shaderPath);
+	std::ifstream ifs(shaderPath, std::ios::binary | std::ios::ate);
 	if (ifs.fail()) {
-		return 0;
-	}
-	std::string contents, line;
-	while (std::getline(ifs, line)) {
-		contents += line + "\n";
+		return false;
 	}
-	ifs.close();
 
-	const char *contentsPtr = contents.data();
-	glShaderSource(shaderID, 1, &contentsPtr, nullptr);
+	source.resize(static_cast<std::size_t>(ifs.tellg()));
+	ifs.seekg(0);
+	ifs.read(source.data(), static_cast<std::streamsize>(source.size()));
+
+	return !ifs.fail();
+}
+
+GLuint adlShaderLoader::compileGLShaderSource(const GLuint shaderType, const std::string_view source, const std::string_view path) {
+	const auto shaderID = glCreateShader(shaderType);
+
+	const char *contentsPtr = source.data();
+	const auto  length      = static_cast<GLint>(source.size());
+	glShaderSource(shaderID, 1, &contentsPtr, &length);
 	glCompileShader(shaderID);
 
-	if (!isCompileSuccess(shaderID)) {
+	if (!isCompileSuccess(shaderID, path)) {
 		return 0;
 	}
 
 	return shaderID;
 }
 
-bool adlShaderLoader::isCompileSuccess(const GLuint shaderID) {
+bool adlShaderLoader::isCompileSuccess(const GLuint shaderID, const std::string_view path) {
 	GLint status;
 
 	glGetShaderiv(shaderID, GL_COMPILE_STATUS, &status);
 	if (status != GL_TRUE) {
-		GLint maxLength;
+		GLint maxLength = 0;
 		glGetShaderiv(shaderID, GL_INFO_LOG_LENGTH, &maxLength);
 
-		std::string error(maxLength, ' ');
+		std::string error(static_cast<std::size_t>(std::max(maxLength, 0)), ' ');
 		glGetShaderInfoLog(shaderID, maxLength, &maxLength, error.data());
+		error.resize(static_cast<std::size_t>(std::max(maxLength, 0)));
 		glDeleteShader(shaderID);
 
+		std::cout << "failed to compile shader " << path << ":\n" << error << std::endl;
+
 		return false;
 	}
 
 	return true;
 }
 
-bool adlShaderLoader::isValidGLProgram(const GLuint programID) {
+bool adlShaderLoader::isValidGLProgram(const GLuint programID, const std::string_view vertPath, const std::string_view fragPath) {
 	GLint status;
 
 	glGetProgramiv(programID, GL_LINK_STATUS, &status);
 	if (status != GL_TRUE) {
-		GLint maxLength;
+		GLint maxLength = 0;
 		glGetProgramiv(programID, GL_INFO_LOG_LENGTH, &maxLength);
 
-		std::string error(maxLength, ' ');
+		std::string error(static_cast<std::size_t>(std::max(maxLength, 0)), ' ');
 		glGetProgramInfoLog(programID, maxLength, &maxLength, error.data());
+		error.resize(static_cast<std::size_t>(std::max(maxLength, 0)));
+
+		std::cout << "failed to link shaders " << vertPath << " and " << fragPath << ":\n" << error << std::endl;
 
 		return false;
 	}
@@ -98,25 +345,62 @@ bool adlShaderLoader::isValidGLProgram(const GLuint programID) {
 	return true;
 }
 
-std::shared_ptr<adlShader> adlShaderLoader::makeADLShader(const std::string &vertShaderPath
-                                                        , const std::string &fragShaderPath) {
+std::string adlShaderLoader::driverIdentity() {
+	const auto getString = [](const GLenum name) {
+		const auto *value = reinterpret_cast<const char *>(glGetString(name));
+		return value != nullptr ? std::string(value) : std::string();
+	};
+
+	return getString(GL_VENDOR) + "|" + getString(GL_RENDERER) + "|" + getString(GL_VERSION);
+}
+
+GLuint adlShaderLoader::loadGLProgramBinary(const std::uint64_t key, adlProgramCache &cache) {
+	std::uint32_t          binaryFormat = 0;
+	std::vector<std::byte> binary;
+	if (!cache.find(key, binaryFormat, binary)) {
+		return 0;
+	}
+
 	const GLuint programID = glCreateProgram();
-	const GLuint vShaderID = compileGLShader(GL_VERTEX_SHADER, vertShaderPath);
-	const GLuint fShaderID = compileGLShader(GL_FRAGMENT_SHADER, fragShaderPath);
+	glProgramBinary(programID, binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+	GLint status = GL_FALSE;
+	glGetProgramiv(programID, GL_LINK_STATUS, &status);
+	if (status != GL_TRUE) {
+		// drivers may refuse binaries after an update without changing their version string
+		glDeleteProgram(programID);
+		cache.invalidate(key);
+		return 0;
+	}
+
+	return programID;
+}
+
+GLuint adlShaderLoader::linkGLProgram(const std::string_view vertSource, const std::string_view fragSource
+                                     , const std::string_view vertPath, const std::string_view fragPath, const bool isRetrievable) {
+	const GLuint vShaderID = compileGLShaderSource(GL_VERTEX_SHADER, vertSource, vertPath);
+	const GLuint fShaderID = compileGLShaderSource(GL_FRAGMENT_SHADER, fragSource, fragPath);
 
 	if (vShaderID == 0 || fShaderID == 0) {
-		return nullptr;
+		glDeleteShader(vShaderID);
+		glDeleteShader(fShaderID);
+		return 0;
+	}
+
+	const GLuint programID = glCreateProgram();
+	if (isRetrievable) {
+		glProgramParameteri(programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	}
 
 	glAttachShader(programID, vShaderID);
 	glAttachShader(programID, fShaderID);
 
 	glLinkProgram(programID);
-	if (!isValidGLProgram(programID)) {
+	if (!isValidGLProgram(programID, vertPath, fragPath)) {
 		glDeleteProgram(programID);
 		glDeleteShader(vShaderID);
 		glDeleteShader(fShaderID);
-		return nullptr;
+		return 0;
 	}
 
 	glDetachShader(programID, vShaderID);
@@ -125,7 +409,202 @@ std::shared_ptr<adlShader> adlShaderLoader::makeADLShader(const std::string &ver
 	glDeleteShader(vShaderID);
 	glDeleteShader(fShaderID);
 
-	return std::make_shared<adlShader>(adlShader({.shaderProgramID = programID, .uniformLocationMap = {}}));
+	return programID;
+}
+
+std::shared_ptr<adlShader> adlShaderLoader::makeADLShader(const std::string &vertShaderPath
+                                                        , const std::string &fragShaderPath
+                                                        , const adlArchive *archive
+                                                        , adlProgramCache *cache) {
+	std::string vertSource, fragSource;
+	if (!readShaderSource(vertShaderPath, archive, vertSource) || !readShaderSource(fragShaderPath, archive, fragSource)) {
+		return nullptr;
+	}
+
+	return makeADLShaderFromSource(vertSource, fragSource, cache, vertShaderPath, fragShaderPath);
+}
+
+std::shared_ptr<adlShader> adlShaderLoader::makeADLShaderFromSource(const std::string_view vertSource
+                                                                  , const std::string_view fragSource
+                                                                  , adlProgramCache *cache
+                                                                  , const std::string_view vertPath
+                                                                  , const std::string_view fragPath) {
+	// without any binary format the driver cannot give binaries back, so the cache is useless
+	GLint binaryFormatCount = 0;
+	if (cache != nullptr && cache->isOpen()) {
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+	}
+
+	const std::uint64_t key = binaryFormatCount > 0 ? adlProgramCache::makeKey(vertSource, fragSource, driverIdentity()) : 0;
+
+	GLuint programID = binaryFormatCount > 0 ? loadGLProgramBinary(key, *cache) : 0;
+	if (programID == 0) {
+		programID = linkGLProgram(vertSource, fragSource, vertPath, fragPath, binaryFormatCount > 0);
+		if (programID == 0) {
+			return nullptr;
+		}
+
+		if (binaryFormatCount > 0) {
+			GLint binaryLength = 0;
+			glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+
+			std::vector<std::byte> binary(static_cast<std::size_t>(std::max(binaryLength, 0)));
+			GLenum                 binaryFormat = 0;
+			glGetProgramBinary(programID, binaryLength, &binaryLength, &binaryFormat, binary.data());
+			if (binaryLength > 0) {
+				binary.resize(static_cast<std::size_t>(binaryLength));
+				cache->store(key, binaryFormat, binary);
+			}
+		}
+	}
+
+	return std::make_shared<adlShader>(adlShader{.shaderProgramID = programID, .uniforms = reflectUniforms(programID)});
+}
+
+adlUniformTable adlShaderLoader::reflectUniforms(const GLuint programID) {
+	adlUniformTable table;
+
+	GLint uniformCount = 0, maxNameLength = 0;
+	glGetProgramiv(programID, GL_ACTIVE_UNIFORMS, &uniformCount);
+	glGetProgramiv(programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+	std::string name(static_cast<std::size_t>(std::max(maxNameLength, 1)), '\0');
+	for (GLint i = 0; i < uniformCount; ++i) {
+		GLsizei length = 0;
+		GLint   count  = 0;
+		GLenum  type   = 0;
+		glGetActiveUniform(programID, static_cast<GLuint>(i), maxNameLength, &length, &count, &type, name.data());
+
+		// block members have no location, they are fed through their buffer
+		const GLint location = glGetUniformLocation(programID, name.c_str());
+		if (location < 0) {
+			continue;
+		}
+
+		std::string_view uniformName(name.data(), static_cast<std::size_t>(length));
+		if (uniformName.ends_with("[0]")) {
+			uniformName.remove_suffix(3);
+		}
+
+		table.uniforms.push_back({
+			.name = adlIntern(uniformName),
+			.location = location,
+			.type = type,
+			.count = count,
+			.shadowOffset = static_cast<std::uint32_t>(table.shadow.size()),
+			.isWritten = false,
+		});
+		table.shadow.resize(table.shadow.size() + adlUniformTypeSize(type) * static_cast<std::size_t>(count));
+	}
+
+	std::sort(table.uniforms.begin(), table.uniforms.end(), [](const adlUniform &lhs, const adlUniform &rhs) {
+		return lhs.name < rhs.name;
+	});
+
+	// GLSL 4.10 has no layout(binding), so the block is bound to its slot here
+	if (const GLuint blockIndex = glGetUniformBlockIndex(programID, adlFrameUniforms::BLOCK_NAME); blockIndex != GL_INVALID_INDEX) {
+		glUniformBlockBinding(programID, blockIndex, adlFrameUniforms::BINDING);
+	}
+
+	return table;
 }
 
+/* -------------------------------------------------------------------------
+	adlUniform
+--------------------------------------------------------------------------*/
+std::uint32_t adlUniformTypeSize(const GLenum type) {
+	switch (type) {
+		case GL_FLOAT:
+		case GL_INT:
+		case GL_UNSIGNED_INT:
+		case GL_BOOL:
+		case GL_SAMPLER_2D:
+			return 4;
+		case GL_FLOAT_VEC2:
+		case GL_INT_VEC2:
+			return 8;
+		case GL_FLOAT_VEC3:
+		case GL_INT_VEC3:
+			return 12;
+		case GL_FLOAT_VEC4:
+		case GL_INT_VEC4:
+			return 16;
+		case GL_FLOAT_MAT3:
+			return 36;
+		case GL_FLOAT_MAT4:
+			return 64;
+		default:
+			return 0;
+	}
+}
+
+adlUniform *adlUniformTable::find(const adlStringID name) {
+	const auto itr = std::lower_bound(uniforms.begin(), uniforms.end(), name, [](const adlUniform &uniform, const adlStringID value) {
+		return uniform.name < value;
+	});
+	return itr != uniforms.end() && itr->name == name ? &*itr : nullptr;
+}
 
+void adlGLUniformBackend::setUniform(const GLuint programID, const GLint location, const GLenum type, const GLsizei count, const void *data) {
+	const auto *f = static_cast<const GLfloat *>(data);
+	const auto *i = static_cast<const GLint *>(data);
+	const auto *u = static_cast<const GLuint *>(data);
+
+	switch (type) {
+		case GL_FLOAT: glProgramUniform1fv(programID, location, count, f);
+			break;
+		case GL_FLOAT_VEC2: glProgramUniform2fv(programID, location, count, f);
+			break;
+		case GL_FLOAT_VEC3: glProgramUniform3fv(programID, location, count, f);
+			break;
+		case GL_FLOAT_VEC4: glProgramUniform4fv(programID, location, count, f);
+			break;
+		case GL_INT:
+		case GL_BOOL:
+		case GL_SAMPLER_2D: glProgramUniform1iv(programID, location, count, i);
+			break;
+		case GL_UNSIGNED_INT: glProgramUniform1uiv(programID, location, count, u);
+			break;
+		case GL_INT_VEC2: glProgramUniform2iv(programID, location, count, i);
+			break;
+		case GL_INT_VEC3: glProgramUniform3iv(programID, location, count, i);
+			break;
+		case GL_INT_VEC4: glProgramUniform4iv(programID, location, count, i);
+			break;
+		case GL_FLOAT_MAT3: glProgramUniformMatrix3fv(programID, location, count, GL_FALSE, f);
+			break;
+		case GL_FLOAT_MAT4: glProgramUniformMatrix4fv(programID, location, count, GL_FALSE, f);
+			break;
+		default:
+			break;
+	}
+}
+
+/* -------------------------------------------------------------------------
+	adlUniformState
+--------------------------------------------------------------------------*/
+bool adlUniformState::set(adlShader &shader, const adlStringID name, const void *data, const GLsizei count) {
+	adlUniform *uniform = shader.uniforms.find(name);
+	if (uniform == nullptr || count <= 0 || count > uniform->count) {
+		return false;
+	}
+
+	const std::uint32_t elementSize = adlUniformTypeSize(uniform->type);
+	if (elementSize == 0) {
+		return false;
+	}
+
+	const std::size_t bytes  = static_cast<std::size_t>(elementSize) * static_cast<std::size_t>(count);
+	std::byte        *shadow = shader.uniforms.shadow.data() + uniform->shadowOffset;
+	if (uniform->isWritten && std::memcmp(shadow, data, bytes) == 0) {
+		++m_skipped;
+		return true;
+	}
+
+	std::memcpy(shadow, data, bytes);
+	uniform->isWritten = true;
+	m_backend->setUniform(shader.shaderProgramID, uniform->location, uniform->type, count, data);
+	++m_submitted;
+
+	return true;
+}
@@ -0,0 +1,192 @@
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+
+#include "bench.h"
+
+using adlBenchClock = std::chrono::steady_clock;
+
+static double secondsSince(const adlBenchClock::time_point start) {
+	return std::chrono::duration<double>(adlBenchClock::now() - start).count();
+}
+
+static double timeIterations(const adlBenchBody &body, const std::size_t iterations) {
+	const auto start = adlBenchClock::now();
+	for (std::size_t i = 0; i < iterations; ++i) {
+		body();
+	}
+	return std::chrono::duration<double, std::nano>(adlBenchClock::now() - start).count();
+}
+
+adlBenchScratchFile::~adlBenchScratchFile() {
+	std::error_code error;
+	std::filesystem::remove(path, error);
+}
+
+std::shared_ptr<adlCore::adlJobSystem> adlBenchJobSystem() {
+	static const auto jobSystem = std::make_shared<adlCore::adlJobSystem>();
+	return jobSystem;
+}
+
+void adlBenchConfig::makeQuick() {
+	warmupSeconds = 0.02;
+	minSeconds    = 0.1;
+	minSamples    = 3;
+}
+
+adlBenchResult adlRunBenchmark(const adlBenchBody &body, const adlBenchCase &benchCase, const adlBenchConfig &config) {
+	adlBenchResult result;
+	result.name              = benchCase.name;
+	result.itemsPerIteration = benchCase.itemsPerIteration;
+	result.coldNs            = timeIterations(body, 1);
+
+	// warm up in windows that double in length; stop once two in a row agree within 5 %, or after
+	// four times the warm-up budget for bodies that never settle
+	const auto    warmupStart = adlBenchClock::now();
+	std::size_t   window      = 1;
+	double        previous    = 0.0;
+	double        perIteration = result.coldNs;
+	while (true) {
+		perIteration = timeIterations(body, window) / static_cast<double>(window);
+		result.warmupIterations += window;
+
+		const double elapsed    = secondsSince(warmupStart);
+		const bool   hasSettled = previous > 0.0 && std::abs(perIteration - previous) <= 0.05 * previous;
+		if ((elapsed >= config.warmupSeconds && hasSettled) || elapsed >= 4.0 * config.warmupSeconds) {
+			break;
+		}
+		previous = perIteration;
+		if (perIteration * static_cast<double>(window) * 1.0e-9 < config.sampleSeconds) {
+			window *= 2;
+		}
+	}
+
+	result.iterationsPerSample = std::max<std::size_t>(1, static_cast<std::size_t>(config.sampleSeconds * 1.0e9 / std::max(perIteration, 1.0)));
+
+	std::vector<double> samples;
+	const auto          sampleStart = adlBenchClock::now();
+	while (samples.size() < config.maxSamples && (samples.size() < config.minSamples || secondsSince(sampleStart) < config.minSeconds)) {
+		samples.push_back(timeIterations(body, result.iterationsPerSample) / static_cast<double>(result.iterationsPerSample));
+	}
+
+	std::sort(samples.begin(), samples.end());
+	double sum = 0.0;
+	for (const double sample: samples) {
+		sum += sample;
+	}
+	result.sampleCount = samples.size();
+	result.meanNs      = sum / static_cast<double>(samples.size());
+	result.minNs       = samples.front();
+	result.maxNs       = samples.back();
+	result.medianNs    = samples.size() % 2 == 1
+		                     ? samples[samples.size() / 2]
+		                     : 0.5 * (samples[samples.size() / 2 - 1] + samples[samples.size() / 2]);
+	result.p99Ns = samples[(samples.size() * 99 + 99) / 100 - 1];
+
+	double squares = 0.0;
+	for (const double sample: samples) {
+		squares += (sample - result.meanNs) * (sample - result.meanNs);
+	}
+	result.stddevNs = samples.size() > 1 ? std::sqrt(squares / static_cast<double>(samples.size() - 1)) : 0.0;
+
+	return result;
+}
+
+static std::string formatTime(const double nanoseconds) {
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(2);
+	if (nanoseconds >= 1.0e6) {
+		out << nanoseconds * 1.0e-6 << " ms";
+	}
+	else if (nanoseconds >= 1.0e3) {
+		out << nanoseconds * 1.0e-3 << " us";
+	}
+	else {
+		out << nanoseconds << " ns";
+	}
+	return out.str();
+}
+
+void adlWriteBenchTable(std::ostream &out, const std::vector<adlBenchResult> &results) {
+	std::size_t nameWidth = 4;
+	for (const auto &result: results) {
+		nameWidth = std::max(nameWidth, result.name.size());
+	}
+
+	out << std::left << std::setw(static_cast<int>(nameWidth)) << "case" << std::right
+		<< std::setw(12) << "cold" << std::setw(12) << "median" << std::setw(12) << "p99"
+		<< std::setw(9) << "stddev" << std::setw(14) << "items/s" << '\n';
+	for (const auto &result: results) {
+		std::ostringstream deviation;
+		deviation << std::fixed << std::setprecision(1) << (result.meanNs > 0.0 ? 100.0 * result.stddevNs / result.meanNs : 0.0) << " %";
+		std::ostringstream throughput;
+		throughput << std::scientific << std::setprecision(3) << result.itemsPerSecond();
+
+		out << std::left << std::setw(static_cast<int>(nameWidth)) << result.name << std::right
+			<< std::setw(12) << formatTime(result.coldNs) << std::setw(12) << formatTime(result.medianNs)
+			<< std::setw(12) << formatTime(result.p99Ns) << std::setw(9) << deviation.str()
+			<< std::setw(14) << throughput.str() << '\n';
+	}
+}
+
+void adlWriteBenchJSON(std::ostream &out, const std::vector<adlBenchResult> &results, const adlBenchConfig &config) {
+	// case names are plain identifiers and slashes, so nothing needs escaping
+	out << std::setprecision(17);
+	out << "{\n  \"config\": {\"warmup_seconds\": " << config.warmupSeconds << ", \"min_seconds\": " << config.minSeconds
+		<< ", \"sample_seconds\": " << config.sampleSeconds << ", \"min_samples\": " << config.minSamples << ", \"full\": " << (config.isFull ? "true" : "false") << "},\n";
+	out << "  \"results\": [\n";
+	for (std::size_t i = 0; i < results.size(); ++i) {
+		const auto &result = results[i];
+		out << "    {\"name\": \"" << result.name << "\", \"items\": " << result.itemsPerIteration
+			<< ", \"samples\": " << result.sampleCount << ", \"iterations_per_sample\": " << result.iterationsPerSample
+			<< ", \"warmup_iterations\": " << result.warmupIterations << ", \"cold_ns\": " << result.coldNs
+			<< ", \"min_ns\": " << result.minNs << ", \"median_ns\": " << result.medianNs << ", \"mean_ns\": " << result.meanNs
+			<< ", \"p99_ns\": " << result.p99Ns << ", \"max_ns\": " << result.maxNs << ", \"stddev_ns\": " << result.stddevNs
+			<< ", \"items_per_second\": " << result.itemsPerSecond() << '}' << (i + 1 < results.size() ? "," : "") << '\n';
+	}
+	out << "  ]\n}\n";
+}
+
+void adlWriteBenchCSV(std::ostream &out, const std::vector<adlBenchResult> &results) {
+	out << std::setprecision(17);
+	out << "name,items,samples,iterations_per_sample,warmup_iterations,cold_ns,min_ns,median_ns,mean_ns,p99_ns,max_ns,stddev_ns,items_per_second\n";
+	for (const auto &result: results) {
+		out << result.name << ',' << result.itemsPerIteration << ',' << result.sampleCount << ',' << result.iterationsPerSample << ','
+			<< result.warmupIterations << ',' << result.coldNs << ',' << result.minNs << ',' << result.medianNs << ','
+			<< result.meanNs << ',' << result.p99Ns << ',' << result.maxNs << ',' << result.stddevNs << ','
+			<< result.itemsPerSecond() << '\n';
+	}
+}
+
+bool adlReadBenchBaseline(const std::string &path, std::map<std::string, double> &medians) {
+	std::ifstream in(path);
+	std::string   line;
+	if (!in || !std::getline(in, line)) {
+		return false;
+	}
+
+	const auto split = [](const std::string &row) {
+		std::vector<std::string> fields;
+		std::istringstream       stream(row);
+		for (std::string field; std::getline(stream, field, ',');) {
+			fields.push_back(field);
+		}
+		return fields;
+	};
+
+	const auto header = split(line);
+	const auto column = std::find(header.begin(), header.end(), "median_ns");
+	if (header.empty() || header.front() != "name" || column == header.end()) {
+		return false;
+	}
+	const auto medianIndex = static_cast<std::size_t>(column - header.begin());
+
+	while (std::getline(in, line)) {
+		if (const auto fields = split(line); fields.size() > medianIndex) {
+			medians[fields.front()] = std::strtod(fields[medianIndex].c_str(), nullptr);
+		}
+	}
+
+	return true;
+}
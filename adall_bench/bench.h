@@ -0,0 +1,125 @@
+#ifndef ADAL_BENCH_H
+#define ADAL_BENCH_H
+
+#include <functional>
+#include <map>
+#include <ostream>
+
+#include "adall/adal_job.h"
+#include "adall/adal_pch.h"
+
+// ###################################################################
+//                          adlBenchCase
+// ###################################################################
+
+/// One timed iteration of a benchmark.
+typedef std::function<void()> adlBenchBody;
+
+/// A named benchmark. setup() runs once, untimed, and returns the body; the state the body works on lives in
+/// its captures. An empty body skips the case, e.g. when its input files are missing.
+struct adlBenchCase {
+	std::string                   name;
+	std::size_t                   itemsPerIteration = 1; ///< Work items one iteration handles, for the items per second column.
+	std::function<adlBenchBody()> setup;
+};
+
+// ###################################################################
+//                          adlBenchConfig
+// ###################################################################
+struct adlBenchConfig {
+	double      warmupSeconds  = 0.2;     ///< Least time spent warming up before sampling.
+	double      minSeconds     = 1.0;     ///< Least time spent sampling.
+	double      sampleSeconds  = 0.005;   ///< Fast bodies are batched until one sample takes about this long.
+	std::size_t minSamples     = 10;
+	std::size_t maxSamples     = 2000;
+	std::string filter;                   ///< Only cases whose name contains this run.
+	std::string assetDirectory = "asset"; ///< Where shader sources are read from.
+	bool        isFull         = false;   ///< Runs the largest cases at full scale instead of a size that sets up in seconds.
+
+	/// @brief Shortens every phase for a smoke run.
+	void makeQuick();
+
+	/// @brief Picks the size of a case that has a reduced default.
+	[[nodiscard]] inline std::size_t scale(const std::size_t reduced, const std::size_t full) const { return isFull ? full : reduced; };
+};
+
+// ###################################################################
+//                          adlBenchResult
+// ###################################################################
+
+/// Timings of one case, in nanoseconds per iteration.
+struct adlBenchResult {
+	std::string name;
+	std::size_t itemsPerIteration   = 1;
+	std::size_t iterationsPerSample = 1;
+	std::size_t sampleCount         = 0;
+	std::size_t warmupIterations    = 0;
+	double      coldNs              = 0; ///< The first iteration, before caches, allocators and branch predictors were warm.
+	double      minNs               = 0;
+	double      medianNs            = 0;
+	double      meanNs              = 0;
+	double      p99Ns               = 0;
+	double      maxNs               = 0;
+	double      stddevNs            = 0;
+
+	[[nodiscard]] inline double itemsPerSecond() const {
+		return medianNs > 0.0 ? static_cast<double>(itemsPerIteration) * 1.0e9 / medianNs : 0.0;
+	};
+};
+
+// ###################################################################
+//                          harness
+// ###################################################################
+
+/// Stops the compiler from dropping a value a body computes and never uses.
+template<typename T>
+inline void adlBenchKeep(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "g"(&value) : "memory");
+#else
+	static const void *volatile sink;
+	sink = &value;
+#endif
+}
+
+/// Removes a file once the last user of it is gone.
+struct adlBenchScratchFile {
+	std::string path;
+
+	~adlBenchScratchFile();
+};
+
+/// The job system every case shares, made by the first caller, which becomes its worker 0. Call it from main().
+std::shared_ptr<adlCore::adlJobSystem> adlBenchJobSystem();
+
+/// Runs one case: one cold iteration, warm-up until the per-iteration time settles, then batched samples.
+adlBenchResult adlRunBenchmark(const adlBenchBody &body, const adlBenchCase &benchCase, const adlBenchConfig &config);
+
+void adlWriteBenchTable(std::ostream &out, const std::vector<adlBenchResult> &results);
+
+void adlWriteBenchJSON(std::ostream &out, const std::vector<adlBenchResult> &results, const adlBenchConfig &config);
+
+void adlWriteBenchCSV(std::ostream &out, const std::vector<adlBenchResult> &results);
+
+/// Reads the median of every case from an earlier CSV run.
+/// @return False if the file cannot be read or has no median_ns column.
+bool adlReadBenchBaseline(const std::string &path, std::map<std::string, double> &medians);
+
+// ###################################################################
+//                          suites
+// ###################################################################
+
+/// Job system, scheduler, allocators, string interning and profiler zones.
+void adlAddCoreBenchmarks(std::vector<adlBenchCase> &cases, const adlBenchConfig &config);
+
+/// Registry iteration, bulk creation, named entities, prefabs, hierarchy, spatial index and culling.
+void adlAddEcsBenchmarks(std::vector<adlBenchCase> &cases, const adlBenchConfig &config);
+
+/// Asset lookups, async texture decoding, shader source loading, atlas packing, vertex generation and the render
+/// queue; all without GL.
+void adlAddRenderBenchmarks(std::vector<adlBenchCase> &cases, const adlBenchConfig &config);
+
+/// Binary scene save and load against a JSON baseline, and rollback snapshots.
+void adlAddSceneBenchmarks(std::vector<adlBenchCase> &cases, const adlBenchConfig &config);
+
+#endif //ADAL_BENCH_H
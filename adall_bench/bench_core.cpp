@@ -0,0 +1,166 @@
+#include "entt/entt.hpp"
+
+#include "adall/adal_component.h"
+#include "adall/adal_memory.h"
+#include "adall/adal_profiler.h"
+#include "adall/adal_string.h"
+
+#include "bench.h"
+
+void adlAddCoreBenchmarks(std::vector<adlBenchCase> &cases, const adlBenchConfig &) {
+	static constexpr std::size_t ELEMENT_COUNT = 1 << 20;
+
+	cases.push_back({"core/parallel_for", ELEMENT_COUNT, [] {
+		auto values = std::make_shared<std::vector<float> >(ELEMENT_COUNT, 1.0f);
+
+		return adlBenchBody{[values] {
+			adlBenchJobSystem()->parallelFor(0, values->size(), 16384, [&values](const std::size_t first, const std::size_t last) {
+				for (std::size_t i = first; i < last; ++i) {
+					(*values)[i] = (*values)[i] * 0.5f + 1.0f;
+				}
+			});
+		}};
+	}});
+
+	// the same transform update on its own job system of 1, 2, 4... threads up to every core, to show the scaling
+	static constexpr std::size_t TRANSFORM_COUNT = 1000000;
+
+	std::vector<std::size_t> threadCounts;
+	const std::size_t        coreCount = std::max(1u, std::thread::hardware_concurrency());
+	for (std::size_t threads = 1; threads < coreCount; threads *= 2) {
+		threadCounts.push_back(threads);
+	}
+	threadCounts.push_back(coreCount);
+
+	for (const std::size_t threads: threadCounts) {
+		cases.push_back({"core/transform_update/threads=" + std::to_string(threads), TRANSFORM_COUNT, [threads] {
+			struct State {
+				entt::registry        registry;
+				adlCore::adlJobSystem jobSystem; ///< Gives worker 0 of the shared job system back to main() when the case ends.
+
+				explicit State(const std::size_t threadCount)
+					: jobSystem(threadCount) {
+				}
+			};
+			auto state = std::make_shared<State>(threads);
+
+			std::vector<entt::entity> entities(TRANSFORM_COUNT);
+			state->registry.create(entities.begin(), entities.end());
+			for (std::size_t i = 0; i < TRANSFORM_COUNT; ++i) {
+				state->registry.emplace<adlComponent::Transform>(entities[i], glm::vec2(static_cast<float>(i % 1024), static_cast<float>(i / 1024)),
+				                                                 static_cast<float>(i) * 0.001f);
+			}
+
+			return adlBenchBody{[state] {
+				auto &transforms = state->registry.storage<adlComponent::Transform>();
+				state->jobSystem.parallelFor(0, transforms.size(), 4096, [&transforms](const std::size_t first, const std::size_t last) {
+					constexpr std::size_t PAGE_SIZE = entt::component_traits<adlComponent::Transform>::page_size;
+
+					auto *const *pages = transforms.raw();
+					for (std::size_t i = first; i < last; ++i) {
+						adlComponent::Transform &transform = pages[i / PAGE_SIZE][i % PAGE_SIZE];
+						transform.rotation += 0.01f;
+						transform.position += glm::vec2(std::cos(transform.rotation), std::sin(transform.rotation)) * 0.5f;
+					}
+				});
+			}};
+		}});
+	}
+
+	static constexpr std::size_t JOB_COUNT = 1024;
+
+	cases.push_back({"core/job_run_wait", JOB_COUNT, [] {
+		return adlBenchBody{[] {
+			const auto             jobSystem = adlBenchJobSystem();
+			adlCore::adlJobCounter counter;
+			for (std::size_t i = 0; i < JOB_COUNT; ++i) {
+				jobSystem->run([] {}, &counter);
+			}
+			jobSystem->wait(counter);
+		}};
+	}});
+
+	// 64 byte blocks, the size of a typical small component or command
+	static constexpr std::size_t ALLOCATION_COUNT = 4096, BLOCK_SIZE = 64;
+
+	cases.push_back({"core/new_delete", ALLOCATION_COUNT, [] {
+		auto blocks = std::make_shared<std::vector<std::byte *> >(ALLOCATION_COUNT);
+
+		return adlBenchBody{[blocks] {
+			for (auto &block: *blocks) {
+				block = new std::byte[BLOCK_SIZE];
+				adlBenchKeep(block);
+			}
+			for (const auto block: *blocks) {
+				delete[] block;
+			}
+		}};
+	}});
+
+	cases.push_back({"core/linear_arena", ALLOCATION_COUNT, [] {
+		auto arena = std::make_shared<adlCore::adlLinearArena>(ALLOCATION_COUNT * BLOCK_SIZE);
+
+		return adlBenchBody{[arena] {
+			for (std::size_t i = 0; i < ALLOCATION_COUNT; ++i) {
+				adlBenchKeep(arena->allocate(BLOCK_SIZE));
+			}
+			arena->reset();
+		}};
+	}});
+
+	cases.push_back({"core/pool_allocator", ALLOCATION_COUNT, [] {
+		struct State {
+			adlCore::adlPoolAllocator pool{BLOCK_SIZE};
+			std::vector<void *>       blocks = std::vector<void *>(ALLOCATION_COUNT);
+		};
+		auto state = std::make_shared<State>();
+
+		return adlBenchBody{[state] {
+			for (auto &block: state->blocks) {
+				block = state->pool.allocate();
+				adlBenchKeep(block);
+			}
+			for (const auto block: state->blocks) {
+				state->pool.deallocate(block);
+			}
+		}};
+	}});
+
+	static constexpr std::size_t STRING_COUNT = 1024;
+
+	cases.push_back({"core/intern_existing", STRING_COUNT, [] {
+		auto strings = std::make_shared<std::vector<std::string> >();
+		for (std::size_t i = 0; i < STRING_COUNT; ++i) {
+			strings->push_back("u_benchUniform" + std::to_string(i));
+			adlIntern(strings->back());
+		}
+
+		return adlBenchBody{[strings] {
+			for (const auto &string: *strings) {
+				adlBenchKeep(adlIntern(string));
+			}
+		}};
+	}});
+
+	static constexpr std::size_t ZONE_COUNT = 1024;
+
+	// includes the frame mark that drains them, which is the whole cost a zone adds to a frame
+	cases.push_back({"core/profiler_zones", ZONE_COUNT, [] {
+		return adlBenchBody{[] {
+			for (std::size_t i = 0; i < ZONE_COUNT; ++i) {
+				ADL_PROFILE_ZONE("bench zone");
+			}
+			ADL_PROFILE_FRAME();
+		}};
+	}});
+
+	// only what the zone itself costs on the recording thread: two tick reads and a ring write; the ring laps
+	// here and the next frame mark counts the lapped zones as dropped
+	cases.push_back({"core/profiler_zones_record_only", ZONE_COUNT, [] {
+		return adlBenchBody{[] {
+			for (std::size_t i = 0; i < ZONE_COUNT; ++i) {
+				ADL_PROFILE_ZONE("bench zone");
+			}
+		}};
+	}});
+}
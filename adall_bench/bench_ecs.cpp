@@ -0,0 +1,479 @@
+#include <random>
+#include <tuple>
+
+#include "adall/adal_culling.h"
+#include "adall/adal_hierarchy.h"
+#include "adall/adal_spatial.h"
+
+#include "bench.h"
+
+using namespace adlComponent;
+
+namespace {
+	/// A registry with the shared job system in its context, as the systems expect.
+	struct World {
+		adlCore::adlRegistry      registry;
+		std::vector<entt::entity> entities;
+		std::mt19937              random{42};
+
+		World() {
+			registry.adlAddContext<std::shared_ptr<adlCore::adlJobSystem> >(adlBenchJobSystem());
+		}
+
+		/// @brief Spreads count boxes over a square of side extent, with their world matrices set directly.
+		void scatter(const std::size_t count, const float extent) {
+			entt::registry                       &entities = registry.getRegistry();
+			std::uniform_real_distribution<float> position(0.0f, extent);
+			std::uniform_real_distribution<float> halfExtent(1.0f, 8.0f);
+
+			this->entities.resize(count);
+			registry.makeEntities(this->entities.begin(), this->entities.end());
+			for (const auto entity: this->entities) {
+				glm::mat3 matrix{1.0f};
+				matrix[2] = glm::vec3(position(random), position(random), 1.0f);
+				entities.emplace<WorldTransform>(entity, matrix);
+				entities.emplace<Bounds>(entity, glm::vec2(halfExtent(random), halfExtent(random)));
+			}
+		}
+
+		/// @brief Moves a random tenth of the scattered boxes, through patch() so listeners see it.
+		void moveTenth() {
+			entt::registry                             &entities = registry.getRegistry();
+			std::uniform_int_distribution<std::size_t> pick(0, this->entities.size() - 1);
+			std::uniform_real_distribution<float>       step(-4.0f, 4.0f);
+
+			for (std::size_t i = 0; i < this->entities.size() / 10; ++i) {
+				entities.patch<WorldTransform>(this->entities[pick(random)], [&](WorldTransform &transform) {
+					transform.matrix[2].x += step(random);
+					transform.matrix[2].y += step(random);
+				});
+			}
+		}
+	};
+
+	/// @brief Builds rootCount trees of depth levels below each root, fanout children per node.
+	void growForest(World &world, adlSystem::Hierarchy &hierarchy, const std::size_t rootCount, const std::size_t fanout, const std::size_t levels) {
+		entt::registry &entities = world.registry.getRegistry();
+
+		for (std::size_t root = 0; root < rootCount; ++root) {
+			std::vector<entt::entity> level{entities.create()};
+			entities.emplace<Transform>(level.front(), glm::vec2(static_cast<float>(root) * 16.0f, 0.0f));
+			world.entities.push_back(level.front());
+
+			for (std::size_t depth = 0; depth < levels; ++depth) {
+				std::vector<entt::entity> next;
+				for (const auto parent: level) {
+					for (std::size_t i = 0; i < fanout; ++i) {
+						const auto child = entities.create();
+						entities.emplace<Transform>(child, glm::vec2(1.0f, static_cast<float>(i)), 0.1f);
+						hierarchy.setParent(child, parent);
+						next.push_back(child);
+						world.entities.push_back(child);
+					}
+				}
+				level = std::move(next);
+			}
+		}
+	}
+
+	/// @brief Turns a random tenth of a forest's nodes, leaving the hierarchy to propagate them.
+	void turnTenth(World &world) {
+		entt::registry                             &entities = world.registry.getRegistry();
+		std::uniform_int_distribution<std::size_t> pick(0, world.entities.size() - 1);
+
+		for (std::size_t i = 0; i < world.entities.size() / 10; ++i) {
+			entities.patch<Transform>(world.entities[pick(world.random)], [](Transform &transform) {
+				transform.rotation += 0.01f;
+			});
+		}
+	}
+
+	template<int TLane>
+	struct Lane {
+		float value = 1.0f;
+	};
+
+	/// A system that only writes a component of its own, so any number of lanes may run side by side.
+	template<int TLane>
+	struct LaneSystem {
+		using adlAccess = adlCore::adlSystemSignature<adlCore::adlReads<Bounds>, adlCore::adlWrites<Lane<TLane> > >;
+
+		void update(adlCore::adlRegistry &registry, const float deltaTime) {
+			adlAccess::view(registry.getRegistry()).each([deltaTime](Lane<TLane> &lane, const Bounds &bounds) {
+				lane.value = std::sqrt(lane.value * lane.value + bounds.halfExtents.x * deltaTime);
+			});
+		}
+	};
+}
+
+void adlAddEcsBenchmarks(std::vector<adlBenchCase> &cases, const adlBenchConfig &config) {
+	static constexpr std::size_t VIEW_COUNT = 1 << 18;
+
+	cases.push_back({"ecs/view_read", VIEW_COUNT, [] {
+		auto world = std::make_shared<World>();
+		world->scatter(VIEW_COUNT, 4096.0f);
+
+		return adlBenchBody{[world] {
+			const auto view = world->registry.getRegistry().view<const WorldTransform, const Bounds>();
+
+			float sum = 0.0f;
+			view.each([&sum](const WorldTransform &transform, const Bounds &bounds) {
+				sum += transform.matrix[2].x * bounds.halfExtents.x + transform.matrix[2].y * bounds.halfExtents.y;
+			});
+			adlBenchKeep(sum);
+		}};
+	}});
+
+	cases.push_back({"ecs/view_write", VIEW_COUNT, [] {
+		auto world = std::make_shared<World>();
+		world->scatter(VIEW_COUNT, 4096.0f);
+
+		return adlBenchBody{[world] {
+			world->registry.getRegistry().view<WorldTransform, const Bounds>().each([](WorldTransform &transform, const Bounds &bounds) {
+				transform.matrix[2].x += bounds.halfExtents.x * 0.001f;
+			});
+		}};
+	}});
+
+	static constexpr std::size_t BULK_COUNT = 1 << 16;
+
+	cases.push_back({"ecs/make_destroy_entities", BULK_COUNT, [] {
+		auto world = std::make_shared<World>();
+		world->entities.resize(BULK_COUNT);
+
+		return adlBenchBody{[world] {
+			world->registry.makeEntities(world->entities.begin(), world->entities.end());
+			world->registry.destroyEntities(world->entities.begin(), world->entities.end());
+		}};
+	}});
+
+	cases.push_back({"ecs/prefab_instantiate", BULK_COUNT, [] {
+		struct State {
+			World                     world;
+			adlCore::adlEntityManager manager{world.registry};
+			adlCore::adlPrefab        prefab;
+		};
+		auto state = std::make_shared<State>();
+		state->prefab.with(Transform{}).with(Bounds{}).inGroup("bench");
+		state->world.entities.resize(BULK_COUNT);
+
+		return adlBenchBody{[state] {
+			state->manager.makeEntities(state->world.entities, state->prefab);
+			state->manager.killEntities(state->world.entities);
+		}};
+	}});
+
+	// one entity at a time against the bulk calls, with the three components a sprite starts with
+	const std::size_t spawnCount = config.scale(BULK_COUNT, 500000);
+
+	for (const bool isBatched: {false, true}) {
+		cases.push_back({isBatched ? "ecs/spawn_batched" : "ecs/spawn_per_entity", spawnCount, [spawnCount, isBatched] {
+			struct State {
+				World                     world;
+				adlCore::adlEntityManager manager{world.registry};
+				adlCore::adlPrefab        prefab;
+			};
+			auto state = std::make_shared<State>();
+			state->prefab.with(Transform{}).with(WorldTransform{}).with(Bounds{});
+			state->world.entities.resize(spawnCount);
+
+			if (isBatched) {
+				return adlBenchBody{[state] {
+					state->manager.makeEntities(state->world.entities, state->prefab);
+					state->manager.killEntities(state->world.entities);
+				}};
+			}
+			return adlBenchBody{[state] {
+				for (auto &entity: state->world.entities) {
+					entity = state->manager.makeEntity(state->prefab).getEntity();
+				}
+				for (const auto entity: state->world.entities) {
+					adlCore::adlEntity handle{state->world.registry, entity};
+					state->manager.killEntity(handle);
+				}
+			}};
+		}});
+	}
+
+	// named entities spread over eight groups
+	static constexpr std::size_t GROUP_COUNT = 8;
+	const std::size_t            namedCount  = config.scale(1 << 16, 1000000);
+
+	struct NamedState {
+		World                     world;
+		adlCore::adlEntityManager manager{world.registry};
+		std::vector<std::string>  names, groups;
+	};
+	const auto nameEntities = [namedCount] {
+		auto state = std::make_shared<NamedState>();
+		for (std::size_t i = 0; i < GROUP_COUNT; ++i) {
+			state->groups.push_back("group " + std::to_string(i));
+		}
+		for (std::size_t i = 0; i < namedCount; ++i) {
+			state->names.push_back("entity " + std::to_string(i));
+		}
+		state->world.entities.resize(namedCount);
+		return state;
+	};
+
+	cases.push_back({"ecs/make_named_entities", namedCount, [nameEntities] {
+		const auto state = nameEntities();
+
+		return adlBenchBody{[state] {
+			for (std::size_t i = 0; i < state->names.size(); ++i) {
+				state->world.entities[i] = state->manager.makeEntity(state->names[i], state->groups[i % GROUP_COUNT]).getEntity();
+			}
+			state->manager.killEntities(state->world.entities);
+		}};
+	}});
+
+	cases.push_back({"ecs/for_each_in_group", namedCount / GROUP_COUNT, [nameEntities] {
+		const auto state = nameEntities();
+		for (std::size_t i = 0; i < state->names.size(); ++i) {
+			static_cast<void>(state->manager.makeEntity(state->names[i], state->groups[i % GROUP_COUNT]));
+		}
+
+		return adlBenchBody{[state] {
+			std::uint32_t sum = 0;
+			state->manager.forEachInGroup(state->groups[3], [&sum](const adlCore::adlEntity entity) {
+				sum += static_cast<std::uint32_t>(entity.getEntity());
+			});
+			adlBenchKeep(sum);
+		}};
+	}});
+
+	static constexpr std::size_t NAMED_COUNT = 1 << 14, LOOKUP_COUNT = 1024;
+
+	cases.push_back({"ecs/find_entity_by_name", LOOKUP_COUNT, [] {
+		struct State {
+			World                     world;
+			adlCore::adlEntityManager manager{world.registry};
+			std::vector<std::string>  names;
+		};
+		auto state = std::make_shared<State>();
+		for (std::size_t i = 0; i < NAMED_COUNT; ++i) {
+			state->names.push_back("entity " + std::to_string(i));
+			static_cast<void>(state->manager.makeEntity(state->names.back()));
+		}
+
+		return adlBenchBody{[state] {
+			for (std::size_t i = 0; i < LOOKUP_COUNT; ++i) {
+				adlBenchKeep(state->manager.findEntity(state->names[i * 13 % NAMED_COUNT]));
+			}
+		}};
+	}});
+
+	// 256 trees of 1 + 4 + 16 + 64 + 256 nodes
+	static constexpr std::size_t TREE_COUNT = 256, TREE_SIZE = 1 + 4 + 16 + 64 + 256;
+
+	cases.push_back({"ecs/hierarchy_update_10pct", TREE_COUNT * TREE_SIZE, [] {
+		struct State {
+			World                world;
+			adlSystem::Hierarchy hierarchy{world.registry};
+		};
+		auto state = std::make_shared<State>();
+		growForest(state->world, state->hierarchy, TREE_COUNT, 4, 4);
+		state->hierarchy.update(state->world.registry);
+
+		return adlBenchBody{[state] {
+			turnTenth(state->world);
+			state->hierarchy.update(state->world.registry);
+		}};
+	}});
+
+	// the same node count as chains 256 deep, where a turned node moves everything below it, and as a few
+	// roots with one level of children each, which leaves few trees to spread over the workers
+	static constexpr std::size_t SHAPE_COUNT = 1 << 16, CHAIN_DEPTH = 256, WIDE_ROOT_COUNT = 16;
+
+	for (const bool isDeep: {true, false}) {
+		cases.push_back({isDeep ? "ecs/hierarchy_deep_10pct" : "ecs/hierarchy_wide_10pct", SHAPE_COUNT, [isDeep] {
+			struct State {
+				World                world;
+				adlSystem::Hierarchy hierarchy{world.registry};
+			};
+			auto state = std::make_shared<State>();
+			if (isDeep) {
+				growForest(state->world, state->hierarchy, SHAPE_COUNT / CHAIN_DEPTH, 1, CHAIN_DEPTH - 1);
+			}
+			else {
+				growForest(state->world, state->hierarchy, WIDE_ROOT_COUNT, SHAPE_COUNT / WIDE_ROOT_COUNT - 1, 1);
+			}
+			state->hierarchy.update(state->world.registry);
+
+			return adlBenchBody{[state] {
+				turnTenth(state->world);
+				state->hierarchy.update(state->world.registry);
+			}};
+		}});
+	}
+
+	static constexpr std::size_t SPATIAL_COUNT = 1 << 16;
+
+	cases.push_back({"ecs/spatial_update_10pct", SPATIAL_COUNT, [] {
+		struct State {
+			World                   world;
+			adlSystem::SpatialIndex index{world.registry};
+		};
+		auto state = std::make_shared<State>();
+		state->world.scatter(SPATIAL_COUNT, 8192.0f);
+		state->index.update(state->world.registry);
+
+		return adlBenchBody{[state] {
+			state->world.moveTenth();
+			state->index.update(state->world.registry);
+		}};
+	}});
+
+	// a level's worth of scenery that never moves, and a crowd that moves every frame; entt's 20 bit entity
+	// index caps a registry at 2^20 - 1 entities, so at full scale the scenery fills what the crowd leaves
+	const std::size_t dynamicCount = config.scale(1 << 14, 100000), staticCount = config.scale(1 << 18, (1 << 20) - 1 - dynamicCount);
+
+	cases.push_back({"ecs/spatial_update_dynamic", dynamicCount, [staticCount, dynamicCount] {
+		struct State {
+			World                   world;
+			adlSystem::SpatialIndex index{world.registry};
+		};
+		auto state = std::make_shared<State>();
+		state->world.scatter(dynamicCount + staticCount, 32768.0f);
+		state->index.update(state->world.registry);
+
+		return adlBenchBody{[state, dynamicCount] {
+			entt::registry                       &entities = state->world.registry.getRegistry();
+			std::uniform_real_distribution<float> step(-4.0f, 4.0f);
+
+			for (std::size_t i = 0; i < dynamicCount; ++i) {
+				entities.patch<WorldTransform>(state->world.entities[i], [&](WorldTransform &transform) {
+					transform.matrix[2].x += step(state->world.random);
+					transform.matrix[2].y += step(state->world.random);
+				});
+			}
+			state->index.update(state->world.registry);
+		}};
+	}});
+
+	static constexpr std::size_t QUERY_COUNT = 256;
+
+	cases.push_back({"ecs/spatial_query_aabb", QUERY_COUNT, [] {
+		struct State {
+			World                     world;
+			adlSystem::SpatialIndex   index{world.registry};
+			std::vector<glm::vec2>    corners;
+			std::vector<entt::entity> found;
+		};
+		auto state = std::make_shared<State>();
+		state->world.scatter(SPATIAL_COUNT, 8192.0f);
+		state->index.update(state->world.registry);
+
+		std::uniform_real_distribution<float> corner(0.0f, 8192.0f - 256.0f);
+		for (std::size_t i = 0; i < QUERY_COUNT; ++i) {
+			state->corners.emplace_back(corner(state->world.random), corner(state->world.random));
+		}
+
+		return adlBenchBody{[state] {
+			for (const auto &corner: state->corners) {
+				state->found.clear();
+				state->index.queryAABB(corner, corner + glm::vec2(256.0f), state->found);
+				adlBenchKeep(state->found.size());
+			}
+		}};
+	}});
+
+	const std::size_t cullCount = config.scale(VIEW_COUNT, 1000000);
+
+	cases.push_back({"ecs/culling", cullCount, [cullCount] {
+		struct State {
+			World              world;
+			adlSystem::Culling culling;
+		};
+		auto state = std::make_shared<State>();
+		state->world.scatter(cullCount, 8192.0f);
+
+		entt::registry &entities = state->world.registry.getRegistry();
+		const auto      camera   = entities.create();
+		entities.emplace<Camera>(camera, Camera{.width = 1920, .height = 1080, .scale = 1.0f, .position = glm::vec2(4096.0f)});
+		entities.emplace<Visibility>(camera);
+
+		return adlBenchBody{[state] {
+			state->culling.update(state->world.registry);
+		}};
+	}});
+
+	cases.push_back({"ecs/scheduler_run", TREE_COUNT * TREE_SIZE, [] {
+		struct State {
+			World                                   world;
+			std::shared_ptr<adlSystem::Hierarchy>   hierarchy = std::make_shared<adlSystem::Hierarchy>(world.registry);
+			std::shared_ptr<adlSystem::SpatialIndex> index    = std::make_shared<adlSystem::SpatialIndex>(world.registry);
+			std::shared_ptr<adlSystem::Culling>     culling   = std::make_shared<adlSystem::Culling>();
+			adlCore::adlScheduler                   scheduler;
+		};
+		auto state = std::make_shared<State>();
+		growForest(state->world, *state->hierarchy, TREE_COUNT, 4, 4);
+		for (const auto entity: state->world.entities) {
+			state->world.registry.getRegistry().emplace<Bounds>(entity);
+		}
+
+		entt::registry &entities = state->world.registry.getRegistry();
+		const auto      camera   = entities.create();
+		entities.emplace<Camera>(camera, Camera{.width = 1920, .height = 1080, .scale = 1.0f, .position = glm::vec2(2048.0f, 0.0f)});
+		entities.emplace<Visibility>(camera);
+
+		state->scheduler.addSystem("Hierarchy", state->hierarchy);
+		state->scheduler.addSystem("SpatialIndex", state->index);
+		state->scheduler.addSystem("Culling", state->culling);
+
+		return adlBenchBody{[state] {
+			entt::registry                             &registry = state->world.registry.getRegistry();
+			std::uniform_int_distribution<std::size_t> pick(0, state->world.entities.size() - 1);
+
+			for (std::size_t i = 0; i < state->world.entities.size() / 10; ++i) {
+				registry.patch<Transform>(state->world.entities[pick(state->world.random)], [](Transform &transform) {
+					transform.position.x += 0.5f;
+				});
+			}
+			state->scheduler.run(state->world.registry, *adlBenchJobSystem(), 1.0f / 60.0f);
+		}};
+	}});
+
+	// four systems that never conflict, called one after another and then through the scheduler
+	static constexpr std::size_t LANE_ENTITY_COUNT = 1 << 16;
+
+	for (const bool isScheduled: {false, true}) {
+		cases.push_back({isScheduled ? "ecs/lanes_scheduled" : "ecs/lanes_serial", 4 * LANE_ENTITY_COUNT, [isScheduled] {
+			struct State {
+				World                 world;
+				adlCore::adlScheduler scheduler;
+				std::tuple<std::shared_ptr<LaneSystem<0> >, std::shared_ptr<LaneSystem<1> >,
+				           std::shared_ptr<LaneSystem<2> >, std::shared_ptr<LaneSystem<3> > > systems{
+					std::make_shared<LaneSystem<0> >(), std::make_shared<LaneSystem<1> >(),
+					std::make_shared<LaneSystem<2> >(), std::make_shared<LaneSystem<3> >()
+				};
+			};
+			auto state = std::make_shared<State>();
+			state->world.scatter(LANE_ENTITY_COUNT, 4096.0f);
+
+			entt::registry &entities = state->world.registry.getRegistry();
+			for (const auto entity: state->world.entities) {
+				entities.emplace<Lane<0> >(entity);
+				entities.emplace<Lane<1> >(entity);
+				entities.emplace<Lane<2> >(entity);
+				entities.emplace<Lane<3> >(entity);
+			}
+
+			if (isScheduled) {
+				std::apply([&state](auto &... system) {
+					std::size_t lane = 0;
+					(state->scheduler.addSystem("Lane " + std::to_string(lane++), system), ...);
+				}, state->systems);
+
+				return adlBenchBody{[state] {
+					state->scheduler.run(state->world.registry, *adlBenchJobSystem(), 1.0f / 60.0f);
+				}};
+			}
+			return adlBenchBody{[state] {
+				std::apply([&state](auto &... system) {
+					(system->update(state->world.registry, 1.0f / 60.0f), ...);
+				}, state->systems);
+			}};
+		}});
+	}
+}
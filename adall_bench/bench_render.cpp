@@ -0,0 +1,276 @@
+#include <filesystem>
+#include <random>
+
+#include "adall/adal_archive.h"
+#include "adall/adal_atlas.h"
+#include "adall/adal_core.h"
+#include "adall/adal_render_queue.h"
+#include "adall/adal_shader_preprocessor.h"
+
+#include "bench.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+	/// @brief Makes count sprites spread over textureCount textures and two shaders, in random order.
+	std::vector<adlSprite> makeSprites(const std::size_t count, const GLuint textureCount) {
+		std::mt19937                          random{42};
+		std::uniform_real_distribution<float> position(0.0f, 4096.0f);
+		std::uniform_real_distribution<float> rotation(0.0f, 6.2831853f);
+		std::uniform_int_distribution<GLuint> texture(1, textureCount);
+
+		std::vector<adlSprite> sprites(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			sprites[i].position        = {position(random), position(random)};
+			sprites[i].size            = {16.0f, 16.0f};
+			sprites[i].rotation        = i % 4 == 0 ? rotation(random) : 0.0f;
+			sprites[i].textureID       = texture(random);
+			sprites[i].shaderProgramID = 1 + static_cast<GLuint>(i % 2);
+		}
+
+		return sprites;
+	}
+
+	/// @brief Encodes a run-length compressed 32-bit TGA of random runs, so decoding needs no image encoder here.
+	std::vector<std::byte> encodeTGA(const std::uint16_t width, const std::uint16_t height, std::mt19937 &random) {
+		std::uniform_int_distribution<std::uint32_t> color;
+		std::uniform_int_distribution<std::size_t>   runLength(1, 32);
+
+		std::vector<std::byte> encoded(18, std::byte{0});
+		encoded[2]  = std::byte{10}; // run-length encoded true color
+		encoded[12] = static_cast<std::byte>(width & 0xFF);
+		encoded[13] = static_cast<std::byte>(width >> 8);
+		encoded[14] = static_cast<std::byte>(height & 0xFF);
+		encoded[15] = static_cast<std::byte>(height >> 8);
+		encoded[16] = std::byte{32};
+		encoded[17] = std::byte{0x28}; // top-left origin, 8 alpha bits
+
+		for (std::size_t left = static_cast<std::size_t>(width) * height; left > 0;) {
+			const std::size_t   run   = std::min(runLength(random), left);
+			const std::uint32_t pixel = color(random);
+			encoded.push_back(static_cast<std::byte>(0x80 | (run - 1)));
+			for (int shift = 0; shift < 32; shift += 8) {
+				encoded.push_back(static_cast<std::byte>(pixel >> shift & 0xFF));
+			}
+			left -= run;
+		}
+
+		return encoded;
+	}
+}
+
+void adlAddRenderBenchmarks(std::vector<adlBenchCase> &cases, const adlBenchConfig &config) {
+	static constexpr std::size_t SPRITE_COUNT = 1 << 16;
+
+	// vertex generation: sort by state, write four adlVertex per sprite, cut draw batches
+	for (const bool sortByState: {true, false}) {
+		cases.push_back({sortByState ? "render/sprite_batch_sorted" : "render/sprite_batch_in_order", SPRITE_COUNT, [sortByState] {
+			struct State {
+				std::vector<adlSprite> sprites = makeSprites(SPRITE_COUNT, 8);
+				adlSpriteBatch         batch;
+			};
+			auto state = std::make_shared<State>();
+
+			return adlBenchBody{[state, sortByState] {
+				state->batch.begin(state->sprites.size());
+				for (const auto &sprite: state->sprites) {
+					state->batch.submit(sprite);
+				}
+				state->batch.end(sortByState);
+				adlBenchKeep(state->batch.vertices().data());
+			}};
+		}});
+	}
+
+	cases.push_back({"render/queue_sort_build", SPRITE_COUNT, [] {
+		struct State {
+			std::vector<adlSprite> sprites = makeSprites(SPRITE_COUNT, 8);
+			std::vector<float>     depths;
+			adlRenderQueue         queue{4};
+			adlSpriteBatch         batch;
+		};
+		auto state = std::make_shared<State>();
+
+		std::mt19937                          random{7};
+		std::uniform_real_distribution<float> depth(0.0f, 1.0f);
+		for (std::size_t i = 0; i < SPRITE_COUNT; ++i) {
+			state->depths.push_back(depth(random));
+		}
+
+		return adlBenchBody{[state] {
+			state->queue.reset();
+			for (std::size_t i = 0; i < state->sprites.size(); ++i) {
+				const adlSprite &sprite = state->sprites[i];
+				const auto       key    = adlMakeSortKey(static_cast<std::uint8_t>(i % 3), sprite.shaderProgramID, sprite.textureID, state->depths[i]);
+				state->queue.buffer(i % state->queue.bufferCount()).push(key, sprite);
+			}
+			state->queue.merge();
+			state->queue.sort();
+			adlRenderQueue::build(state->queue.sorted(), state->batch);
+			adlBenchKeep(state->batch.vertices().data());
+		}};
+	}});
+
+	static constexpr std::size_t ATLAS_IMAGE_COUNT = 10000;
+
+	cases.push_back({"render/atlas_pack", ATLAS_IMAGE_COUNT, [] {
+		auto sizes = std::make_shared<std::vector<glm::ivec2> >();
+
+		std::mt19937                       random{3};
+		std::uniform_int_distribution<int> side(8, 64);
+		for (std::size_t i = 0; i < ATLAS_IMAGE_COUNT; ++i) {
+			sizes->emplace_back(side(random), side(random));
+		}
+
+		return adlBenchBody{[sizes] {
+			adlAtlasBuilder builder;
+			for (std::size_t i = 0; i < sizes->size(); ++i) {
+				builder.add("image" + std::to_string(i), (*sizes)[i].x, (*sizes)[i].y);
+			}
+			adlBenchKeep(builder.pack());
+		}};
+	}});
+
+	// shader source loading, from disk and from the preprocessor's memo
+	const std::string shaderPath = (fs::path(config.assetDirectory) / "shader" / "basic.vert.glsl").generic_string();
+
+	cases.push_back({"assets/shader_load_cold", 1, [shaderPath] {
+		if (!fs::exists(shaderPath)) {
+			std::cerr << "skipping, " << shaderPath << " not found" << std::endl;
+			return adlBenchBody{};
+		}
+		auto preprocessor = std::make_shared<adlShaderPreprocessor>();
+
+		return adlBenchBody{[preprocessor, shaderPath] {
+			preprocessor->clear();
+			adlBenchKeep(preprocessor->preprocess(shaderPath));
+		}};
+	}});
+
+	cases.push_back({"assets/shader_load_cached", 1, [shaderPath] {
+		if (!fs::exists(shaderPath)) {
+			std::cerr << "skipping, " << shaderPath << " not found" << std::endl;
+			return adlBenchBody{};
+		}
+		auto preprocessor = std::make_shared<adlShaderPreprocessor>();
+		if (preprocessor->preprocess(shaderPath) == nullptr) {
+			return adlBenchBody{};
+		}
+
+		return adlBenchBody{[preprocessor, shaderPath] {
+			adlBenchKeep(preprocessor->preprocess(shaderPath));
+		}};
+	}});
+
+	// asset map lookups, against textures streamed from an archive through a stand-in uploader
+	// a frame's worth of lookups at random over a table too large for the cache, so each one pays for its
+	// hash and pointer chase rather than finding the last frame's entries still warm
+	static constexpr std::size_t TEXTURE_COUNT = 1 << 16, LOOKUP_COUNT = 100000;
+
+	struct AssetState {
+		adlBenchScratchFile                    archive;
+		adlCore::adlAssetManager               assets{1};
+		std::vector<std::string>               names;
+		std::vector<adlCore::adlTextureHandle> handles;
+		std::vector<std::uint32_t>             lookups; ///< Texture index of every lookup.
+	};
+	const auto loadAssets = []() -> std::shared_ptr<AssetState> {
+		auto state = std::make_shared<AssetState>();
+		state->archive.path = (fs::temp_directory_path() / "adall_bench_assets.adla").string();
+
+		adlArchiveWriter                   writer;
+		const std::array<std::byte, 4 * 4> pixels{};
+		for (std::size_t i = 0; i < TEXTURE_COUNT; ++i) {
+			state->names.push_back("texture/bench_" + std::to_string(i) + ".png");
+			writer.add(state->names.back(), adlArchiveEntryType::TEXTURE_RGBA8, pixels, 2, 2);
+		}
+		if (!writer.write(state->archive.path) || !state->assets.mountArchive(state->archive.path)) {
+			return nullptr;
+		}
+
+		GLuint nextID = 1;
+		state->assets.setTextureUploader([&nextID](const adlImage &, bool) { return nextID++; });
+		for (const auto &name: state->names) {
+			state->handles.push_back(state->assets.makeTextureAsync(name, name));
+		}
+		while (state->assets.pendingTextureCount() > 0) {
+			state->assets.processUploads();
+			std::this_thread::yield();
+		}
+		state->assets.setTextureUploader([](const adlImage &, bool) { return GLuint{0}; });
+
+		std::mt19937                                  random{5};
+		std::uniform_int_distribution<std::uint32_t> texture(0, TEXTURE_COUNT - 1);
+		for (std::size_t i = 0; i < LOOKUP_COUNT; ++i) {
+			state->lookups.push_back(texture(random));
+		}
+
+		return state;
+	};
+
+	cases.push_back({"assets/resolve_texture_by_name", LOOKUP_COUNT, [loadAssets] {
+		const auto state = loadAssets();
+		if (!state) {
+			return adlBenchBody{};
+		}
+
+		return adlBenchBody{[state] {
+			for (std::size_t i = 0; i < LOOKUP_COUNT; ++i) {
+				adlBenchKeep(state->assets.resolveTexture(state->names[state->lookups[i]]));
+			}
+		}};
+	}});
+
+	cases.push_back({"assets/get_texture_by_handle", LOOKUP_COUNT, [loadAssets] {
+		const auto state = loadAssets();
+		if (!state) {
+			return adlBenchBody{};
+		}
+
+		return adlBenchBody{[state] {
+			for (std::size_t i = 0; i < LOOKUP_COUNT; ++i) {
+				adlBenchKeep(state->assets.getTexture(state->handles[state->lookups[i]]));
+			}
+		}};
+	}});
+
+	// async texture loading end to end, the GL upload stubbed out so the decode threads set the pace
+	static constexpr std::uint16_t DECODE_SIDE  = 256;
+	const std::size_t              decodeCount = config.scale(64, 512);
+
+	cases.push_back({"assets/decode_textures_async", decodeCount, [decodeCount] {
+		struct State {
+			adlBenchScratchFile                    archive;
+			adlCore::adlAssetManager               assets;
+			std::vector<std::string>               names;
+			std::vector<adlCore::adlTextureHandle> handles;
+		};
+		auto state = std::make_shared<State>();
+		state->archive.path = (fs::temp_directory_path() / "adall_bench_decode.adla").string();
+
+		adlArchiveWriter writer;
+		std::mt19937     random{42};
+		for (std::size_t i = 0; i < decodeCount; ++i) {
+			state->names.push_back("texture/decode_" + std::to_string(i) + ".tga");
+			writer.add(state->names.back(), adlArchiveEntryType::TEXTURE_ENCODED, encodeTGA(DECODE_SIDE, DECODE_SIDE, random));
+		}
+		if (!writer.write(state->archive.path) || !state->assets.mountArchive(state->archive.path)) {
+			return adlBenchBody{};
+		}
+		state->assets.setTextureUploader([](const adlImage &, bool) { return GLuint{1}; });
+		state->handles.resize(decodeCount);
+
+		return adlBenchBody{[state] {
+			for (std::size_t i = 0; i < state->names.size(); ++i) {
+				state->handles[i] = state->assets.makeTextureAsync(state->names[i], state->names[i]);
+			}
+			while (state->assets.pendingTextureCount() > 0) {
+				state->assets.processUploads(std::numeric_limits<std::size_t>::max());
+				std::this_thread::yield();
+			}
+			for (const auto &handle: state->handles) {
+				state->assets.unloadTexture(handle);
+			}
+		}};
+	}});
+}
@@ -0,0 +1,357 @@
+#include <cctype>
+#include <charconv>
+#include <filesystem>
+#include <random>
+
+#include "adall/adal_component.h"
+#include "adall/adal_scene.h"
+#include "adall/adal_snapshot.h"
+
+#include "bench.h"
+
+namespace fs = std::filesystem;
+
+using namespace adlComponent;
+
+namespace {
+	/// @brief Fills a registry with count boxes; every eighth is named and every fourth parented to an earlier one.
+	void buildScene(adlCore::adlRegistry &registry, const std::size_t count) {
+		entt::registry                       &entities = registry.getRegistry();
+		std::mt19937                          random{42};
+		std::uniform_real_distribution<float> position(0.0f, 4096.0f);
+		std::uniform_real_distribution<float> halfExtent(1.0f, 8.0f);
+
+		std::vector<entt::entity> created(count);
+		registry.makeEntities(created.begin(), created.end());
+		for (std::size_t i = 0; i < count; ++i) {
+			entities.emplace<Transform>(created[i], glm::vec2(position(random), position(random)), 0.0f);
+			entities.emplace<Bounds>(created[i], glm::vec2(halfExtent(random), halfExtent(random)));
+			if (i % 8 == 0) {
+				entities.emplace<Name>(created[i], adlIntern("entity_" + std::to_string(i)));
+			}
+			if (i % 4 == 3) {
+				entities.emplace<Parent>(created[i], created[i - 3]);
+			}
+		}
+	}
+
+	/// @brief Writes every entity as one JSON object, the way a text scene format would.
+	bool saveJSON(const adlCore::adlRegistry &registry, const std::string &path) {
+		const entt::registry &entities = registry.getRegistry();
+		const auto           &live     = *entities.storage<entt::entity>();
+
+		std::string text = "[\n";
+		char        buffer[32];
+		const auto  number = [&text, &buffer](const auto value) {
+			text.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+		};
+		const auto array = [&text, &number](const std::initializer_list<float> values) {
+			text += '[';
+			for (const float value: values) {
+				if (text.back() != '[') {
+					text += ',';
+				}
+				number(value);
+			}
+			text += ']';
+		};
+
+		for (std::size_t i = 0; i < live.free_list(); ++i) {
+			const entt::entity entity = live.data()[i];
+			text += "{\"entity\":";
+			number(entt::to_integral(entity));
+
+			if (const auto *transform = entities.try_get<Transform>(entity); transform != nullptr) {
+				text += ",\"transform\":";
+				array({transform->position.x, transform->position.y, transform->rotation, transform->scale.x, transform->scale.y});
+			}
+			if (const auto *bounds = entities.try_get<Bounds>(entity); bounds != nullptr) {
+				text += ",\"bounds\":";
+				array({bounds->halfExtents.x, bounds->halfExtents.y});
+			}
+			// names are the bench's own, nothing to escape
+			if (const auto *name = entities.try_get<Name>(entity); name != nullptr) {
+				text += ",\"name\":\"";
+				text += adlStringInterner::global().view(name->id);
+				text += '"';
+			}
+			if (const auto *parent = entities.try_get<Parent>(entity); parent != nullptr) {
+				text += ",\"parent\":";
+				number(entt::to_integral(parent->entity));
+			}
+			text += i + 1 < live.free_list() ? "},\n" : "}\n";
+		}
+		text += "]\n";
+
+		std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+		ofs.write(text.data(), static_cast<std::streamsize>(text.size()));
+		return !ofs.fail();
+	}
+
+	/// Reads the subset of JSON saveJSON() writes: an array of objects holding numbers, strings and arrays of numbers.
+	class JSONReader {
+	private:
+		const char *m_at, *m_end;
+
+		void skipSpace() {
+			while (m_at != m_end && std::isspace(static_cast<unsigned char>(*m_at))) {
+				++m_at;
+			}
+		}
+
+	public:
+		explicit JSONReader(const std::string_view text)
+			: m_at(text.data()),
+			  m_end(text.data() + text.size()) {
+		}
+
+		bool consume(const char token) {
+			skipSpace();
+			if (m_at == m_end || *m_at != token) {
+				return false;
+			}
+			++m_at;
+			return true;
+		}
+
+		bool string(std::string_view &value) {
+			if (!consume('"')) {
+				return false;
+			}
+			const char *first = m_at;
+			while (m_at != m_end && *m_at != '"') {
+				++m_at;
+			}
+			if (m_at == m_end) {
+				return false;
+			}
+			value = {first, static_cast<std::size_t>(m_at++ - first)};
+			return true;
+		}
+
+		template<typename T>
+		bool number(T &value) {
+			skipSpace();
+			const auto [end, error] = std::from_chars(m_at, m_end, value);
+			m_at = end;
+			return error == std::errc{};
+		}
+
+		template<std::size_t N>
+		bool numbers(float (&values)[N]) {
+			if (!consume('[')) {
+				return false;
+			}
+			for (std::size_t i = 0; i < N; ++i) {
+				if ((i > 0 && !consume(',')) || !number(values[i])) {
+					return false;
+				}
+			}
+			return consume(']');
+		}
+	};
+
+	/// @brief Parses a saveJSON() file into records first, since parents may come after their children, then
+	/// creates the entities and gives them their components one by one.
+	bool loadJSON(adlCore::adlRegistry &registry, const std::string &path) {
+		std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+		std::string   text(static_cast<std::size_t>(ifs.tellg()), '\0');
+		ifs.seekg(0);
+		ifs.read(text.data(), static_cast<std::streamsize>(text.size()));
+
+		struct Record {
+			std::uint32_t    entity    = 0;
+			std::uint32_t    parent    = entt::to_integral(entt::entity{entt::null});
+			bool             hasBounds = false;
+			float            transform[5]{};
+			float            bounds[2]{};
+			std::string_view name;
+		};
+		std::vector<Record> records;
+
+		JSONReader reader(text);
+		if (!reader.consume('[')) {
+			return false;
+		}
+		while (reader.consume('{')) {
+			Record &record = records.emplace_back();
+			do {
+				std::string_view key;
+				if (!reader.string(key) || !reader.consume(':')) {
+					return false;
+				}
+
+				bool isRead;
+				if (key == "entity") {
+					isRead = reader.number(record.entity);
+				}
+				else if (key == "transform") {
+					isRead = reader.numbers(record.transform);
+				}
+				else if (key == "bounds") {
+					isRead           = reader.numbers(record.bounds);
+					record.hasBounds = true;
+				}
+				else if (key == "name") {
+					isRead = reader.string(record.name);
+				}
+				else if (key == "parent") {
+					isRead = reader.number(record.parent);
+				}
+				else {
+					return false;
+				}
+				if (!isRead) {
+					return false;
+				}
+			} while (reader.consume(','));
+
+			if (!reader.consume('}')) {
+				return false;
+			}
+			reader.consume(',');
+		}
+
+		std::vector<entt::entity> created(records.size());
+		registry.makeEntities(created.begin(), created.end());
+
+		std::vector<entt::entity> byIndex;
+		for (std::size_t i = 0; i < records.size(); ++i) {
+			const auto entityIndex = static_cast<std::size_t>(entt::to_entity(entt::entity{records[i].entity}));
+			if (entityIndex >= byIndex.size()) {
+				byIndex.resize(std::max<std::size_t>(entityIndex + 1, byIndex.size() * 2), entt::null);
+			}
+			byIndex[entityIndex] = created[i];
+		}
+
+		entt::registry &entities = registry.getRegistry();
+		for (std::size_t i = 0; i < records.size(); ++i) {
+			const Record &record = records[i];
+			entities.emplace<Transform>(created[i], glm::vec2(record.transform[0], record.transform[1]), record.transform[2]
+			                          , glm::vec2(record.transform[3], record.transform[4]));
+			if (record.hasBounds) {
+				entities.emplace<Bounds>(created[i], glm::vec2(record.bounds[0], record.bounds[1]));
+			}
+			if (!record.name.empty()) {
+				entities.emplace<Name>(created[i], adlIntern(record.name));
+			}
+
+			const auto parentIndex = static_cast<std::size_t>(entt::to_entity(entt::entity{record.parent}));
+			if (entt::entity{record.parent} != entt::null && parentIndex < byIndex.size() && byIndex[parentIndex] != entt::null) {
+				entities.emplace<Parent>(created[i], byIndex[parentIndex]);
+				entities.get_or_emplace<Children>(byIndex[parentIndex]).entities.push_back(created[i]);
+			}
+		}
+
+		return true;
+	}
+}
+
+void adlAddSceneBenchmarks(std::vector<adlBenchCase> &cases, const adlBenchConfig &) {
+	static constexpr std::size_t ENTITY_COUNT = 1000000;
+
+	struct SceneState {
+		adlBenchScratchFile                   file;
+		adlCore::adlRegistry                  source;
+		std::unique_ptr<adlCore::adlRegistry> target;
+	};
+	const auto makeState = [](const std::string &fileName) {
+		auto state       = std::make_shared<SceneState>();
+		state->file.path = (fs::temp_directory_path() / fileName).string();
+		buildScene(state->source, ENTITY_COUNT);
+		return state;
+	};
+
+	for (const bool isBinary: {true, false}) {
+		const std::string fileName = isBinary ? "adall_bench_scene.adls" : "adall_bench_scene.json";
+
+		cases.push_back({isBinary ? "scene/save_binary" : "scene/save_json", ENTITY_COUNT, [makeState, fileName, isBinary] {
+			auto state = makeState(fileName);
+
+			return adlBenchBody{[state, isBinary] {
+				adlBenchKeep(isBinary ? adlCore::adlScene::save(state->source, state->file.path) : saveJSON(state->source, state->file.path));
+			}};
+		}});
+
+		// every iteration loads into a fresh registry so entities keep their saved ids; dropping the last one is
+		// timed too, alike for both formats
+		cases.push_back({isBinary ? "scene/load_binary" : "scene/load_json", ENTITY_COUNT, [makeState, fileName, isBinary] {
+			auto state = makeState(fileName);
+			if (!(isBinary ? adlCore::adlScene::save(state->source, state->file.path) : saveJSON(state->source, state->file.path))) {
+				return adlBenchBody{};
+			}
+
+			return adlBenchBody{[state, isBinary] {
+				state->target = std::make_unique<adlCore::adlRegistry>();
+				adlBenchKeep(isBinary ? adlCore::adlScene::load(*state->target, state->file.path) : loadJSON(*state->target, state->file.path));
+			}};
+		}});
+	}
+
+	// rollback: a frame moves a random tenth of the entities, as a simulation step would
+	static constexpr std::size_t SNAPSHOT_COUNT = 1 << 16;
+
+	struct SnapshotState {
+		adlCore::adlRegistry      registry;
+		adlCore::adlSnapshotRing  ring{60};
+		std::vector<entt::entity> entities;
+		std::mt19937              random{5};
+		std::uint64_t             frame = 0;
+
+		SnapshotState() {
+			buildScene(registry, SNAPSHOT_COUNT);
+			const auto &live = *std::as_const(registry.getRegistry()).storage<entt::entity>();
+			entities.assign(live.data(), live.data() + live.free_list());
+		}
+
+		void moveTenth() {
+			std::uniform_int_distribution<std::size_t> pick(0, entities.size() - 1);
+			for (std::size_t i = 0; i < entities.size() / 10; ++i) {
+				registry.getRegistry().patch<Transform>(entities[pick(random)], [](Transform &transform) {
+					transform.position.x += 1.0f;
+				});
+			}
+		}
+	};
+
+	for (const bool isMoving: {false, true}) {
+		cases.push_back({isMoving ? "snapshot/capture_10pct" : "snapshot/capture_unchanged", SNAPSHOT_COUNT, [isMoving] {
+			auto state = std::make_shared<SnapshotState>();
+			for (std::size_t i = 0; i < 120; ++i) {
+				if (isMoving) {
+					state->moveTenth();
+				}
+				state->ring.capture(state->registry, state->frame++);
+			}
+			std::cerr << "60 frames hold " << state->ring.byteSize() / 1024 << " KiB" << std::endl;
+
+			return adlBenchBody{[state, isMoving] {
+				if (isMoving) {
+					state->moveTenth();
+				}
+				adlBenchKeep(state->ring.capture(state->registry, state->frame++));
+			}};
+		}});
+	}
+
+	cases.push_back({"snapshot/restore_10pct", SNAPSHOT_COUNT, [] {
+		auto state = std::make_shared<SnapshotState>();
+		state->ring.capture(state->registry, 0);
+
+		return adlBenchBody{[state] {
+			state->moveTenth();
+			adlBenchKeep(state->ring.restore(state->registry, 0));
+		}};
+	}});
+
+	// a made entity rules out patching, so every pool is rebuilt
+	cases.push_back({"snapshot/restore_rebuild", SNAPSHOT_COUNT, [] {
+		auto state = std::make_shared<SnapshotState>();
+		state->ring.capture(state->registry, 0);
+
+		return adlBenchBody{[state] {
+			static_cast<void>(state->registry.makeEntity());
+			adlBenchKeep(state->ring.restore(state->registry, 0));
+		}};
+	}});
+}
@@ -0,0 +1,171 @@
+#include <charconv>
+#include <cmath>
+
+#include "bench.h"
+
+/// @brief Reads a whole argument value as a finite number above zero.
+template<typename TNumber>
+static bool parsePositive(const std::string_view text, TNumber &value) {
+	TNumber parsed{};
+	const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), parsed);
+	if (error != std::errc{} || end != text.data() + text.size() || !(parsed > 0)) {
+		return false;
+	}
+	if constexpr (std::is_floating_point_v<TNumber>) {
+		if (!std::isfinite(parsed)) {
+			return false;
+		}
+	}
+
+	value = parsed;
+	return true;
+}
+
+static void printUsage() {
+	std::cerr << "usage: adallengine_bench [--list] [--quick] [--full] [--filter=<text>] [--format=table|json|csv] [--out=<file>]"
+			" [--warmup=<s>] [--min-time=<s>] [--min-samples=<n>] [--assets=<dir>]"
+			" [--baseline=<csv> [--threshold=<%>]]\n"
+			"numbers have to be above zero" << std::endl;
+}
+
+int main(int argc, char **argv) {
+	adlBenchConfig config;
+	std::string    format    = "table", outputPath, baselinePath;
+	double         threshold = 10.0;
+	bool           isListing = false;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string argument = argv[i];
+		const auto        value    = argument.substr(argument.find('=') + 1);
+
+		bool isValid = true;
+		if (argument == "--list") {
+			isListing = true;
+		}
+		else if (argument == "--quick") {
+			config.makeQuick();
+		}
+		else if (argument == "--full") {
+			config.isFull = true;
+		}
+		else if (argument.starts_with("--format=")) {
+			format = argument.substr(9);
+		}
+		else if (argument.starts_with("--out=")) {
+			outputPath = argument.substr(6);
+		}
+		else if (argument.starts_with("--filter=")) {
+			config.filter = argument.substr(9);
+		}
+		else if (argument.starts_with("--warmup=")) {
+			isValid = parsePositive(value, config.warmupSeconds);
+		}
+		else if (argument.starts_with("--min-time=")) {
+			isValid = parsePositive(value, config.minSeconds);
+		}
+		else if (argument.starts_with("--min-samples=")) {
+			isValid = parsePositive(value, config.minSamples);
+		}
+		else if (argument.starts_with("--assets=")) {
+			config.assetDirectory = argument.substr(9);
+		}
+		else if (argument.starts_with("--baseline=")) {
+			baselinePath = argument.substr(11);
+		}
+		else if (argument.starts_with("--threshold=")) {
+			isValid = parsePositive(value, threshold);
+		}
+		else {
+			isValid = false;
+		}
+
+		if (!isValid) {
+			std::cerr << "invalid argument " << argument << std::endl;
+			printUsage();
+			return 1;
+		}
+	}
+
+	if (format != "table" && format != "json" && format != "csv") {
+		std::cerr << "unknown format " << format << std::endl;
+		return 1;
+	}
+
+	// the job system has to be made here: whoever makes it becomes worker 0
+	static_cast<void>(adlBenchJobSystem());
+
+	std::vector<adlBenchCase> cases;
+	adlAddCoreBenchmarks(cases, config);
+	adlAddEcsBenchmarks(cases, config);
+	adlAddRenderBenchmarks(cases, config);
+	adlAddSceneBenchmarks(cases, config);
+
+	std::vector<adlBenchResult> results;
+	for (const auto &benchCase: cases) {
+		if (!config.filter.empty() && benchCase.name.find(config.filter) == std::string::npos) {
+			continue;
+		}
+		if (isListing) {
+			std::cout << benchCase.name << std::endl;
+			continue;
+		}
+
+		// progress goes to stderr so stdout stays machine readable
+		std::cerr << benchCase.name << std::endl;
+		const adlBenchBody body = benchCase.setup();
+		if (!body) {
+			continue;
+		}
+		results.push_back(adlRunBenchmark(body, benchCase, config));
+	}
+	if (isListing) {
+		return 0;
+	}
+
+	std::ofstream file;
+	if (!outputPath.empty()) {
+		file.open(outputPath);
+		if (!file) {
+			std::cerr << "failed to write " << outputPath << std::endl;
+			return 1;
+		}
+	}
+	std::ostream &out = outputPath.empty() ? std::cout : file;
+
+	if (format == "json") {
+		adlWriteBenchJSON(out, results, config);
+	}
+	else if (format == "csv") {
+		adlWriteBenchCSV(out, results);
+	}
+	else {
+		adlWriteBenchTable(out, results);
+	}
+
+	if (baselinePath.empty()) {
+		return 0;
+	}
+
+	std::map<std::string, double> baseline;
+	if (!adlReadBenchBaseline(baselinePath, baseline)) {
+		std::cerr << "failed to read baseline " << baselinePath << std::endl;
+		return 1;
+	}
+
+	// the median is the statistic least moved by a noisy neighbour, so regressions are judged on it alone
+	bool hasRegressed = false;
+	for (const auto &result: results) {
+		const auto itr = baseline.find(result.name);
+		if (itr == baseline.end() || itr->second <= 0.0) {
+			continue;
+		}
+
+		const double change = (result.medianNs / itr->second - 1.0) * 100.0;
+		if (change > threshold) {
+			std::cerr << "regression: " << result.name << " is " << change << "% slower than the baseline" << std::endl;
+			hasRegressed = true;
+		}
+	}
+
+	return hasRegressed ? 1 : 0;
+}
@@ -0,0 +1,165 @@
+#include <filesystem>
+
+#include "adall/adal_archive.h"
+#include "adall/adal_atlas.h"
+#include "adall/adal_view.h"
+
+namespace fs = std::filesystem;
+
+static adlArchiveEntryType classify(const fs::path &path) {
+	const auto extension = path.extension().string();
+
+	if (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp" || extension == ".tga") {
+		return adlArchiveEntryType::TEXTURE_RGBA8;
+	}
+	if (extension == ".glsl" || extension == ".vert" || extension == ".frag") {
+		return adlArchiveEntryType::SHADER_SOURCE;
+	}
+
+	return adlArchiveEntryType::BLOB;
+}
+
+static bool readFile(const fs::path &path, std::vector<std::byte> &contents) {
+	std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+	if (ifs.fail()) {
+		return false;
+	}
+
+	contents.resize(static_cast<std::size_t>(ifs.tellg()));
+	ifs.seekg(0);
+	ifs.read(reinterpret_cast<char *>(contents.data()), static_cast<std::streamsize>(contents.size()));
+
+	return !ifs.fail();
+}
+
+static bool addFile(adlArchiveWriter &writer, adlAtlasBuilder *atlas, const fs::path &path, const bool keepEncoded) {
+	std::vector<std::byte> contents;
+	if (!readFile(path, contents)) {
+		std::cout << "failed to read " << path << std::endl;
+		return false;
+	}
+
+	// entries are named by their path as given, which is the path the engine asks for at runtime
+	const auto name = path.generic_string();
+	const auto type = classify(path);
+
+	if (type != adlArchiveEntryType::TEXTURE_RGBA8) {
+		return writer.add(name, type, contents);
+	}
+
+	adlImage image;
+	if (!adlTextureLoader::decodeImage(contents, image)) {
+		std::cout << "failed to decode " << path << std::endl;
+		return false;
+	}
+
+	if (atlas != nullptr) {
+		atlas->add(name, std::move(image));
+		return true;
+	}
+
+	const auto width  = static_cast<std::uint32_t>(image.width);
+	const auto height = static_cast<std::uint32_t>(image.height);
+	if (keepEncoded) {
+		return writer.add(name, adlArchiveEntryType::TEXTURE_ENCODED, contents, width, height);
+	}
+
+	return writer.add(name, adlArchiveEntryType::TEXTURE_RGBA8
+	                , {reinterpret_cast<const std::byte *>(image.data()), image.byteSize()}, width, height);
+}
+
+static bool addAtlas(adlArchiveWriter &writer, adlAtlasBuilder &atlas, const std::string &atlasName) {
+	if (!atlas.pack()) {
+		std::cout << "an image does not fit on a " << atlas.pageWidth() << "x" << atlas.pageHeight() << " atlas page" << std::endl;
+		return false;
+	}
+	atlas.compose();
+
+	const auto width  = static_cast<std::uint32_t>(atlas.pageWidth());
+	const auto height = static_cast<std::uint32_t>(atlas.pageHeight());
+	for (std::size_t page = 0; page < atlas.pageCount(); ++page) {
+		const auto &pixels = atlas.pagePixels(page);
+		if (!writer.add(adlAtlasTable::pageName(atlasName, page), adlArchiveEntryType::TEXTURE_RGBA8
+		              , {reinterpret_cast<const std::byte *>(pixels.data()), pixels.size()}, width, height)) {
+			return false;
+		}
+	}
+
+	std::cout << "packed " << atlas.regions().size() << " images into " << atlas.pageCount() << " atlas pages, "
+			<< static_cast<int>(atlas.occupancy() * 100.f) << "% occupied" << std::endl;
+	return writer.add(atlasName, adlArchiveEntryType::ATLAS_TABLE, adlAtlasTable::write(atlas));
+}
+
+int main(int argc, char **argv) {
+	bool                     keepEncoded = false;
+	std::string              archivePath, atlasName;
+	int                      atlasSize   = 2048, atlasPadding = 1;
+	std::vector<std::string> inputs;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string argument = argv[i];
+		if (argument == "--encoded-textures") {
+			keepEncoded = true;
+		}
+		else if (argument.starts_with("--atlas=")) {
+			atlasName = argument.substr(8);
+		}
+		else if (argument.starts_with("--atlas-size=")) {
+			atlasSize = std::stoi(argument.substr(13));
+		}
+		else if (argument.starts_with("--atlas-padding=")) {
+			atlasPadding = std::stoi(argument.substr(16));
+		}
+		else if (archivePath.empty()) {
+			archivePath = argument;
+		}
+		else {
+			inputs.push_back(argument);
+		}
+	}
+
+	if (archivePath.empty() || inputs.empty()) {
+		std::cout << "usage: adallengine_pack [--encoded-textures] [--atlas=<name> [--atlas-size=<px>] [--atlas-padding=<px>]]"
+				" <archive> <file or directory>..." << std::endl;
+		return 1;
+	}
+
+	std::vector<fs::path> files;
+	for (const auto &input: inputs) {
+		if (fs::is_directory(input)) {
+			for (const auto &entry: fs::recursive_directory_iterator(input)) {
+				if (entry.is_regular_file()) {
+					files.push_back(entry.path());
+				}
+			}
+		}
+		else {
+			files.emplace_back(input);
+		}
+	}
+	// directory iteration order is unspecified, sort so the same inputs always give the same archive
+	std::sort(files.begin(), files.end());
+
+	// with --atlas every texture is packed into shared pages instead of getting an entry of its own
+	adlAtlasBuilder  atlas(atlasSize, atlasSize, atlasPadding);
+	adlAtlasBuilder *atlasPtr = atlasName.empty() ? nullptr : &atlas;
+
+	adlArchiveWriter writer;
+	for (const auto &file: files) {
+		if (!addFile(writer, atlasPtr, file, keepEncoded)) {
+			return 1;
+		}
+	}
+
+	if (atlasPtr != nullptr && !addAtlas(writer, atlas, atlasName)) {
+		return 1;
+	}
+
+	if (!writer.write(archivePath)) {
+		std::cout << "failed to write " << archivePath << std::endl;
+		return 1;
+	}
+
+	std::cout << "packed " << writer.entryCount() << " entries into " << archivePath << std::endl;
+	return 0;
+}
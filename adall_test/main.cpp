@@ -0,0 +1,67 @@
+#include "test.h"
+
+int main(int argc, char **argv) {
+	std::string filter;
+	bool        isListing = false;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string argument = argv[i];
+		if (argument == "--list") {
+			isListing = true;
+		}
+		else if (!argument.starts_with("--") && filter.empty()) {
+			filter = argument;
+		}
+		else {
+			std::cerr << "usage: adallengine_test [--list] [<name prefix>]" << std::endl;
+			return 1;
+		}
+	}
+
+	std::vector<adlTestCase> cases;
+	adlAddBatchTests(cases);
+	adlAddStreamTests(cases);
+	adlAddSchedulerTests(cases);
+	adlAddProgramCacheTests(cases);
+	adlAddShaderPreprocessorTests(cases);
+	adlAddCameraTests(cases);
+	adlAddFileWatcherTests(cases);
+	adlAddSnapshotTests(cases);
+	adlAddUniformTests(cases);
+	adlAddSpriteTests(cases);
+	adlAddCullingTests(cases);
+	adlAddAtlasTests(cases);
+
+	std::size_t runCount = 0, failedCount = 0;
+	for (const auto &testCase: cases) {
+		if (!testCase.name.starts_with(filter)) {
+			continue;
+		}
+		if (isListing) {
+			std::cout << testCase.name << std::endl;
+			continue;
+		}
+
+		testCase.body();
+		++runCount;
+
+		if (adlTestTakeFailures() > 0) {
+			++failedCount;
+			std::cout << "FAILED " << testCase.name << std::endl;
+		}
+		else {
+			std::cout << "ok     " << testCase.name << std::endl;
+		}
+	}
+	if (isListing) {
+		return 0;
+	}
+
+	if (runCount == 0) {
+		std::cerr << "no test matches " << filter << std::endl;
+		return 1;
+	}
+
+	std::cout << runCount - failedCount << " of " << runCount << " passed" << std::endl;
+	return failedCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,33 @@
+#include <filesystem>
+#include <utility>
+
+#include "test.h"
+
+namespace fs = std::filesystem;
+
+static std::size_t s_failures = 0;
+
+void adlTestFail(const char *expression, const char *file, const int line) {
+	++s_failures;
+	std::cout << "    " << file << ":" << line << ": check failed: " << expression << std::endl;
+}
+
+std::size_t adlTestTakeFailures() {
+	return std::exchange(s_failures, 0);
+}
+
+adlTestDirectory::adlTestDirectory(const std::string &name)
+	: path((fs::temp_directory_path() / ("adall_test_" + name)).generic_string()) {
+	std::error_code error;
+	fs::remove_all(path, error);
+	fs::create_directories(path, error);
+}
+
+adlTestDirectory::~adlTestDirectory() {
+	std::error_code error;
+	fs::remove_all(path, error);
+}
+
+std::string adlTestDirectory::file(const std::string &name) const {
+	return path + '/' + name;
+}
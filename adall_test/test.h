@@ -0,0 +1,103 @@
+#ifndef ADAL_TEST_H
+#define ADAL_TEST_H
+
+#include <functional>
+
+#include "adall/adal_pch.h"
+
+// ###################################################################
+//                          adlTestCase
+// ###################################################################
+
+/// A named check of one behavior. Names are "<suite>/<case>", and ctest runs one suite per test.
+struct adlTestCase {
+	std::string           name;
+	std::function<void()> body;
+};
+
+// ###################################################################
+//                          checks
+// ###################################################################
+
+/// Records a failed check of the running case and prints where it was. The case carries on, so one run
+/// reports every check that failed.
+void adlTestFail(const char *expression, const char *file, int line);
+
+/// Gets the failed checks since the last call.
+std::size_t adlTestTakeFailures();
+
+/// Fails the running case if a condition does not hold.
+#define ADL_CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			adlTestFail(#condition, __FILE__, __LINE__); \
+		} \
+	} while (false)
+
+/// Fails the running case and leaves it if a condition does not hold, for checks later ones depend on.
+#define ADL_REQUIRE(condition) \
+	do { \
+		if (!(condition)) { \
+			adlTestFail(#condition, __FILE__, __LINE__); \
+			return; \
+		} \
+	} while (false)
+
+// ###################################################################
+//                          fixtures
+// ###################################################################
+
+/// A directory under the system temp directory, made empty on construction and removed with everything in it
+/// on destruction.
+struct adlTestDirectory {
+	std::string path;
+
+	explicit adlTestDirectory(const std::string &name);
+
+	~adlTestDirectory();
+
+	/// @brief Gets the path of a file in the directory.
+	[[nodiscard]] std::string file(const std::string &name) const;
+};
+
+// ###################################################################
+//                          suites
+// ###################################################################
+
+/// Sprite batching: sorting by state, run splitting and vertex generation.
+void adlAddBatchTests(std::vector<adlTestCase> &cases);
+
+/// The triple-buffered stream buffer: region cycling, fence waits, alignment and flush ranges.
+void adlAddStreamTests(std::vector<adlTestCase> &cases);
+
+/// The system scheduler: stages derived from read and write sets, ordering and overlap when running.
+void adlAddSchedulerTests(std::vector<adlTestCase> &cases);
+
+/// The on-disk program binary cache: keys, persistence, invalidation and driver changes.
+void adlAddProgramCacheTests(std::vector<adlTestCase> &cases);
+
+/// The shader preprocessor: include resolution, permutation defines, memoizing and forgetting files.
+void adlAddShaderPreprocessorTests(std::vector<adlTestCase> &cases);
+
+/// The 2D camera system: rebuilding only changed cameras and republishing only when the main one changed.
+void adlAddCameraTests(std::vector<adlTestCase> &cases);
+
+/// The file watcher: debouncing bursts of writes, renamed saves and the order changes are reported in.
+void adlAddFileWatcherTests(std::vector<adlTestCase> &cases);
+
+/// The snapshot ring: dropping the oldest frames, sharing unchanged chunks and restoring by patch or rebuild.
+void adlAddSnapshotTests(std::vector<adlTestCase> &cases);
+
+/// Per-program uniforms: what adlUniformState forwards to its backend and what it drops.
+void adlAddUniformTests(std::vector<adlTestCase> &cases);
+
+/// Sprite recording: commands built from world matrices and bounds, their order and what is left out.
+void adlAddSpriteTests(std::vector<adlTestCase> &cases);
+
+/// Camera culling: the SIMD and scalar passes and update() against a brute-force overlap scan.
+void adlAddCullingTests(std::vector<adlTestCase> &cases);
+
+/// Atlas packing: rects apart and inside their page, UVs, page coverage and composed pixels.
+void adlAddAtlasTests(std::vector<adlTestCase> &cases);
+
+#endif //ADAL_TEST_H
@@ -0,0 +1,117 @@
+#include <random>
+
+#include "adall/adal_atlas.h"
+
+#include "test.h"
+
+namespace {
+	constexpr int PAGE_SIZE = 1024, PADDING = 1;
+
+	/// @brief Queues count images of random sides in [minSide, maxSide] and packs them.
+	bool packRandom(adlAtlasBuilder &builder, const std::size_t count, const int minSide, const int maxSide) {
+		std::mt19937                       random{11};
+		std::uniform_int_distribution<int> side(minSide, maxSide);
+		for (std::size_t i = 0; i < count; ++i) {
+			builder.add("image" + std::to_string(i), side(random), side(random));
+		}
+		return builder.pack();
+	}
+
+	/// @brief Gets the share of each page covered by images, padding excluded.
+	std::vector<double> pageCoverage(const adlAtlasBuilder &builder) {
+		std::vector<double> coverage(builder.pageCount(), 0.0);
+		for (const auto &region: builder.regions()) {
+			coverage[region.page] += static_cast<double>(region.rect.width) * region.rect.height;
+		}
+		for (auto &share: coverage) {
+			share /= static_cast<double>(builder.pageWidth()) * builder.pageHeight();
+		}
+		return coverage;
+	}
+}
+
+void adlAddAtlasTests(std::vector<adlTestCase> &cases) {
+	cases.push_back({"atlas/rects_stay_inside_their_page_apart", [] {
+		adlAtlasBuilder builder(PAGE_SIZE, PAGE_SIZE, PADDING);
+		ADL_REQUIRE(packRandom(builder, 3000, 8, 96));
+		ADL_REQUIRE(builder.pageCount() > 1);
+
+		// every image and the padding after it claims its pixels; no pixel may be claimed twice
+		std::vector<std::vector<std::uint8_t> > claimed(builder.pageCount(), std::vector<std::uint8_t>(PAGE_SIZE * PAGE_SIZE, 0));
+		std::size_t                             overlaps = 0;
+		for (const auto &region: builder.regions()) {
+			ADL_REQUIRE(region.page < builder.pageCount());
+			const adlRect &rect = region.rect;
+			ADL_CHECK(rect.x >= 0 && rect.y >= 0 && rect.x + rect.width <= PAGE_SIZE && rect.y + rect.height <= PAGE_SIZE);
+
+			const int right = std::min(rect.x + rect.width + PADDING, PAGE_SIZE), bottom = std::min(rect.y + rect.height + PADDING, PAGE_SIZE);
+			for (int y = std::max(rect.y, 0); y < bottom; ++y) {
+				for (int x = std::max(rect.x, 0); x < right; ++x) {
+					overlaps += claimed[region.page][static_cast<std::size_t>(y) * PAGE_SIZE + x]++ != 0 ? 1 : 0;
+				}
+			}
+		}
+		ADL_CHECK(overlaps == 0);
+	}});
+
+	cases.push_back({"atlas/uvs_match_the_rects", [] {
+		adlAtlasBuilder builder(PAGE_SIZE, 512, PADDING);
+		ADL_REQUIRE(packRandom(builder, 500, 1, 64));
+
+		for (const auto &region: builder.regions()) {
+			const glm::vec4 expected(static_cast<float>(region.rect.x) / PAGE_SIZE, static_cast<float>(region.rect.y) / 512.0f,
+			                         static_cast<float>(region.rect.x + region.rect.width) / PAGE_SIZE,
+			                         static_cast<float>(region.rect.y + region.rect.height) / 512.0f);
+			ADL_CHECK(region.uvRect == expected);
+		}
+	}});
+
+	cases.push_back({"atlas/full_pages_are_mostly_covered", [] {
+		adlAtlasBuilder builder(PAGE_SIZE, PAGE_SIZE, PADDING);
+		ADL_REQUIRE(packRandom(builder, 3000, 8, 96));
+
+		// the last page only holds what was left over, every other one should be nearly full
+		const auto coverage = pageCoverage(builder);
+		ADL_REQUIRE(coverage.size() > 1);
+		for (std::size_t page = 0; page + 1 < coverage.size(); ++page) {
+			ADL_CHECK(coverage[page] >= 0.88);
+		}
+
+		double total = 0.0;
+		for (const double share: coverage) {
+			total += share;
+		}
+		ADL_CHECK(std::abs(builder.occupancy() - total / static_cast<double>(coverage.size())) < 1e-4);
+	}});
+
+	cases.push_back({"atlas/compose_copies_pixels_into_the_rects", [] {
+		adlAtlasBuilder builder(64, 64, PADDING);
+		for (int i = 0; i < 12; ++i) {
+			adlImage image;
+			image.width  = 5 + i;
+			image.height = 3 + i % 4;
+			image.pixels.reset(static_cast<unsigned char *>(std::malloc(static_cast<std::size_t>(image.width) * image.height * 4)));
+			std::memset(image.pixels.get(), 10 + i, static_cast<std::size_t>(image.width) * image.height * 4);
+			builder.add("image" + std::to_string(i), std::move(image));
+		}
+		ADL_REQUIRE(builder.pack());
+		builder.compose();
+
+		for (std::size_t i = 0; i < builder.regions().size(); ++i) {
+			const auto &region = builder.regions()[i];
+			const auto &pixels = builder.pagePixels(region.page);
+			for (const auto &[x, y]: {std::pair{region.rect.x, region.rect.y}, std::pair{region.rect.x + region.rect.width - 1, region.rect.y + region.rect.height - 1}}) {
+				ADL_CHECK(pixels[(static_cast<std::size_t>(y) * 64 + x) * 4] == 10 + i);
+			}
+		}
+	}});
+
+	cases.push_back({"atlas/images_larger_than_a_page_fail", [] {
+		adlAtlasBuilder builder(64, 64, PADDING);
+		builder.add("fits", 63, 63);
+		ADL_CHECK(builder.pack());
+
+		builder.add("too wide", 64, 8);
+		ADL_CHECK(!builder.pack());
+	}});
+}
@@ -0,0 +1,202 @@
+#include "adall/adal_batch.h"
+
+#include "test.h"
+
+namespace {
+	adlSprite makeSprite(const GLuint shaderProgramID, const GLuint textureID, const float x) {
+		adlSprite sprite;
+		sprite.position        = {x, 0.0f};
+		sprite.shaderProgramID = shaderProgramID;
+		sprite.textureID       = textureID;
+		return sprite;
+	}
+}
+
+void adlAddBatchTests(std::vector<adlTestCase> &cases) {
+	cases.push_back({"batch/sorts_by_shader_then_texture", [] {
+		adlSpriteBatch batch;
+		batch.begin();
+		batch.submit(makeSprite(2, 1, 0.0f));
+		batch.submit(makeSprite(1, 2, 1.0f));
+		batch.submit(makeSprite(1, 1, 2.0f));
+		batch.submit(makeSprite(2, 1, 3.0f));
+		batch.end();
+
+		const auto &draws = batch.drawBatches();
+		ADL_REQUIRE(draws.size() == 3);
+		ADL_CHECK(draws[0].shaderProgramID == 1 && draws[0].textureID == 1 && draws[0].firstQuad == 0 && draws[0].quadCount == 1);
+		ADL_CHECK(draws[1].shaderProgramID == 1 && draws[1].textureID == 2 && draws[1].firstQuad == 1 && draws[1].quadCount == 1);
+		ADL_CHECK(draws[2].shaderProgramID == 2 && draws[2].textureID == 1 && draws[2].firstQuad == 2 && draws[2].quadCount == 2);
+	}});
+
+	cases.push_back({"batch/keeps_submission_order_within_a_run", [] {
+		adlSpriteBatch batch;
+		batch.begin();
+		for (int i = 0; i < 8; ++i) {
+			batch.submit(makeSprite(1, static_cast<GLuint>(i % 2), static_cast<float>(i)));
+		}
+		batch.end();
+
+		// texture 0 got the even sprites, texture 1 the odd ones, each run in the order they came in
+		const auto &vertices = batch.vertices();
+		ADL_REQUIRE(vertices.size() == 32);
+		for (std::size_t quad = 0; quad < 8; ++quad) {
+			const float expected = static_cast<float>(quad < 4 ? quad * 2 : (quad - 4) * 2 + 1);
+			ADL_CHECK(vertices[quad * 4].position.x == expected);
+		}
+	}});
+
+	cases.push_back({"batch/splits_runs_at_the_draw_limit", [] {
+		adlSpriteBatch batch(3);
+		batch.begin();
+		for (int i = 0; i < 7; ++i) {
+			batch.submit(makeSprite(1, 1, static_cast<float>(i)));
+		}
+		batch.end();
+
+		const auto &draws = batch.drawBatches();
+		ADL_REQUIRE(draws.size() == 3);
+		ADL_CHECK(draws[0].firstQuad == 0 && draws[0].quadCount == 3);
+		ADL_CHECK(draws[1].firstQuad == 3 && draws[1].quadCount == 3);
+		ADL_CHECK(draws[2].firstQuad == 6 && draws[2].quadCount == 1);
+	}});
+
+	cases.push_back({"batch/unsorted_end_only_merges_neighbours", [] {
+		adlSpriteBatch batch;
+		batch.begin();
+		batch.submit(makeSprite(1, 1, 0.0f));
+		batch.submit(makeSprite(1, 2, 1.0f));
+		batch.submit(makeSprite(1, 1, 2.0f));
+		batch.submit(makeSprite(1, 1, 3.0f));
+		batch.end(false);
+
+		const auto &draws = batch.drawBatches();
+		ADL_REQUIRE(draws.size() == 3);
+		ADL_CHECK(draws[0].textureID == 1 && draws[0].quadCount == 1);
+		ADL_CHECK(draws[1].textureID == 2 && draws[1].quadCount == 1);
+		ADL_CHECK(draws[2].textureID == 1 && draws[2].quadCount == 2);
+		ADL_CHECK(batch.vertices()[4].position.x == 1.0f);
+	}});
+
+	cases.push_back({"batch/writes_corners_uvs_and_color", [] {
+		adlSprite sprite  = makeSprite(1, 1, 10.0f);
+		sprite.position.y = 20.0f;
+		sprite.size       = {4.0f, 2.0f};
+		sprite.uvRect     = {0.25f, 0.5f, 0.75f, 1.0f};
+		sprite.color      = {.r = 1, .g = 2, .b = 3, .a = 4};
+
+		adlSpriteBatch batch;
+		batch.begin();
+		batch.submit(sprite);
+		batch.end();
+
+		// counter-clockwise from the bottom-left corner
+		const auto &vertices = batch.vertices();
+		ADL_REQUIRE(vertices.size() == 4);
+		ADL_CHECK(vertices[0].position == glm::vec2(10.0f, 20.0f) && vertices[0].uvs == glm::vec2(0.25f, 0.5f));
+		ADL_CHECK(vertices[1].position == glm::vec2(14.0f, 20.0f) && vertices[1].uvs == glm::vec2(0.75f, 0.5f));
+		ADL_CHECK(vertices[2].position == glm::vec2(14.0f, 22.0f) && vertices[2].uvs == glm::vec2(0.75f, 1.0f));
+		ADL_CHECK(vertices[3].position == glm::vec2(10.0f, 22.0f) && vertices[3].uvs == glm::vec2(0.25f, 1.0f));
+		for (const auto &vertex: vertices) {
+			ADL_CHECK(vertex.color.r == 1 && vertex.color.g == 2 && vertex.color.b == 3 && vertex.color.a == 4);
+		}
+	}});
+
+	cases.push_back({"batch/rotates_around_the_center", [] {
+		adlSprite sprite = makeSprite(1, 1, 0.0f);
+		sprite.size      = {2.0f, 2.0f};
+		sprite.rotation  = glm::half_pi<float>();
+
+		adlSpriteBatch batch;
+		batch.begin();
+		batch.submit(sprite);
+		batch.end();
+
+		// a quarter turn moves the bottom-left corner to the bottom-right
+		const glm::vec2 corner = batch.vertices()[0].position;
+		ADL_CHECK(std::abs(corner.x - 2.0f) < 1.0e-5f && std::abs(corner.y) < 1.0e-5f);
+	}});
+
+	cases.push_back({"batch/ignores_submits_outside_begin_end", [] {
+		adlSpriteBatch batch;
+		batch.submit(makeSprite(1, 1, 0.0f));
+		batch.begin();
+		batch.end();
+		batch.submit(makeSprite(1, 1, 0.0f));
+
+		ADL_CHECK(batch.spriteCount() == 0);
+		ADL_CHECK(batch.drawBatches().empty() && batch.vertices().empty());
+	}});
+
+	cases.push_back({"batch/quad_indices", [] {
+		const auto indices = adlSpriteBatch::makeQuadIndices(2);
+		ADL_CHECK((indices == std::vector<GLuint>{0, 1, 2, 2, 3, 0, 4, 5, 6, 6, 7, 4}));
+	}});
+
+	cases.push_back({"batch/streams_more_quads_than_a_region", [] {
+		static constexpr std::size_t QUAD_BYTES = 4 * sizeof(adlVertex);
+
+		// 20000 quads over two textures, against regions of the default 16384
+		adlSpriteBatch batch;
+		batch.begin();
+		for (int i = 0; i < 20000; ++i) {
+			batch.submit(makeSprite(1, i < 12000 ? 1 : 2, static_cast<float>(i)));
+		}
+		batch.end();
+
+		adlStreamBuffer stream;
+		ADL_REQUIRE(stream.init(std::make_unique<adlCPUStreamBackend>(), adlSpriteBatch::DEFAULT_MAX_QUADS * QUAD_BYTES));
+
+		std::vector<std::pair<adlDrawBatch, GLint> > draws;
+		ADL_REQUIRE(batch.stream(stream, [&draws](const adlDrawBatch &draw, const GLint baseVertex) {
+			draws.emplace_back(draw, baseVertex);
+		}));
+
+		// the first region takes all of texture 1 and the start of texture 2, the second region the rest
+		const auto secondBase = static_cast<GLint>(adlSpriteBatch::DEFAULT_MAX_QUADS * 4);
+		ADL_REQUIRE(draws.size() == 3);
+		ADL_CHECK(draws[0].first.textureID == 1 && draws[0].first.firstQuad == 0 && draws[0].first.quadCount == 12000 && draws[0].second == 0);
+		ADL_CHECK(draws[1].first.textureID == 2 && draws[1].first.firstQuad == 12000 && draws[1].first.quadCount == 4384 && draws[1].second == 0);
+		ADL_CHECK(draws[2].first.textureID == 2 && draws[2].first.firstQuad == 0 && draws[2].first.quadCount == 3616 && draws[2].second == secondBase);
+		ADL_CHECK(stream.currentRegion() == 2);
+	}});
+
+	cases.push_back({"batch/streams_into_regions_of_any_size", [] {
+		static constexpr std::size_t QUAD_BYTES = 4 * sizeof(adlVertex), REGION_SIZE = 7 * QUAD_BYTES + 5;
+
+		// regions that do not start on a vertex boundary may hold a quad less than their size suggests
+		adlSpriteBatch batch;
+		batch.begin();
+		for (int i = 0; i < 30; ++i) {
+			batch.submit(makeSprite(1, static_cast<GLuint>(i / 10), static_cast<float>(i)));
+		}
+		batch.end();
+
+		adlStreamBuffer stream;
+		ADL_REQUIRE(stream.init(std::make_unique<adlCPUStreamBackend>(), REGION_SIZE));
+
+		std::size_t drawnQuads = 0;
+		ADL_REQUIRE(batch.stream(stream, [&](const adlDrawBatch &draw, const GLint baseVertex) {
+			const std::size_t regionBase = stream.currentRegion() * REGION_SIZE;
+			const std::size_t begin      = (static_cast<std::size_t>(baseVertex) + draw.firstQuad * 4) * sizeof(adlVertex);
+			ADL_CHECK(begin >= regionBase && begin + draw.quadCount * QUAD_BYTES <= regionBase + REGION_SIZE);
+			ADL_CHECK(draw.textureID == drawnQuads / 10); // quads come out in arena order
+			drawnQuads += draw.quadCount;
+		}));
+		ADL_CHECK(drawnQuads == 30);
+	}});
+
+	cases.push_back({"batch/streams_nothing_without_a_quad_of_room", [] {
+		adlSpriteBatch batch;
+		batch.begin();
+		batch.submit(makeSprite(1, 1, 0.0f));
+		batch.end();
+
+		adlStreamBuffer stream;
+		ADL_REQUIRE(stream.init(std::make_unique<adlCPUStreamBackend>(), 4 * sizeof(adlVertex) - 1));
+
+		bool isDrawn = false;
+		ADL_CHECK(!batch.stream(stream, [&isDrawn](const adlDrawBatch &, GLint) { isDrawn = true; }));
+		ADL_CHECK(!isDrawn);
+	}});
+}
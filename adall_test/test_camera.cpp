@@ -0,0 +1,108 @@
+#include "adall/adal_system.h"
+
+#include "test.h"
+
+namespace {
+	entt::entity makeCamera(adlCore::adlRegistry &registry, const int width, const int height) {
+		auto      &entities = registry.getRegistry();
+		const auto entity   = entities.create();
+		auto      &camera   = entities.emplace<adlComponent::Camera>(entity);
+		camera.width        = width;
+		camera.height       = height;
+		return entity;
+	}
+}
+
+void adlAddCameraTests(std::vector<adlTestCase> &cases) {
+	cases.push_back({"camera/static_cameras_cost_nothing", [] {
+		adlCore::adlRegistry registry;
+		adlSystem::Camera2D  camera2D(registry, nullptr);
+		const auto           main = makeCamera(registry, 800, 600);
+		makeCamera(registry, 320, 200);
+		camera2D.setMainCamera(main);
+
+		camera2D.update(registry);
+		ADL_CHECK(camera2D.rebuildCount() == 2);
+		ADL_CHECK(camera2D.revision() == 1);
+
+		for (int step = 0; step < 100; ++step) {
+			camera2D.update(registry);
+		}
+		ADL_CHECK(camera2D.rebuildCount() == 2);
+		ADL_CHECK(camera2D.revision() == 1);
+	}});
+
+	cases.push_back({"camera/patches_rebuild_and_republish", [] {
+		adlCore::adlRegistry registry;
+		adlSystem::Camera2D  camera2D(registry, nullptr);
+		const auto           main  = makeCamera(registry, 800, 600);
+		const auto           other = makeCamera(registry, 320, 200);
+		camera2D.setMainCamera(main);
+		camera2D.update(registry);
+
+		auto &entities = registry.getRegistry();
+		entities.patch<adlComponent::Camera>(main, [](adlComponent::Camera &camera) { camera.position = {100.0f, 50.0f}; });
+		camera2D.update(registry);
+		ADL_CHECK(camera2D.rebuildCount() == 3);
+		ADL_CHECK(camera2D.revision() == 2);
+		// the published view moves the camera's position to the middle of the screen
+		const glm::vec4 centre = camera2D.view() * glm::vec4(100.0f, 50.0f, 0.0f, 1.0f);
+		ADL_CHECK(centre.x == 400.0f && centre.y == 300.0f);
+
+		// another camera changing is rebuilt, but the published matrices stay
+		entities.patch<adlComponent::Camera>(other, [](adlComponent::Camera &camera) { camera.scale = 2.0f; });
+		camera2D.update(registry);
+		ADL_CHECK(camera2D.rebuildCount() == 4);
+		ADL_CHECK(camera2D.revision() == 2);
+
+		// writing through get() bypasses the tracking and is not seen
+		entities.get<adlComponent::Camera>(main).scale = 3.0f;
+		camera2D.update(registry);
+		ADL_CHECK(camera2D.rebuildCount() == 4);
+	}});
+
+	cases.push_back({"camera/resize_reaches_the_main_camera", [] {
+		adlCore::adlRegistry registry;
+		adlSystem::Camera2D  camera2D(registry, nullptr);
+		const auto           main  = makeCamera(registry, 800, 600);
+		const auto           other = makeCamera(registry, 320, 200);
+		camera2D.setMainCamera(main);
+		camera2D.update(registry);
+
+		camera2D.resize(1024, 768);
+		ADL_CHECK(camera2D.framebufferSize() == glm::ivec2(1024, 768));
+		camera2D.update(registry);
+
+		const auto &entities = registry.getRegistry();
+		ADL_CHECK(entities.get<adlComponent::Camera>(main).width == 1024);
+		ADL_CHECK(entities.get<adlComponent::Camera>(main).height == 768);
+		ADL_CHECK(entities.get<adlComponent::Camera>(other).width == 320);
+		ADL_CHECK(camera2D.rebuildCount() == 3);
+		ADL_CHECK(camera2D.revision() == 2);
+
+		const glm::vec4 corner = camera2D.projection() * glm::vec4(1024.0f, 768.0f, 0.0f, 1.0f);
+		ADL_CHECK(corner.x == 1.0f && corner.y == 1.0f);
+
+		camera2D.update(registry);
+		ADL_CHECK(camera2D.rebuildCount() == 3);
+		ADL_CHECK(camera2D.revision() == 2);
+	}});
+
+	cases.push_back({"camera/empty_cameras_are_not_built", [] {
+		adlCore::adlRegistry registry;
+		adlSystem::Camera2D  camera2D(registry, nullptr);
+		const auto           main = makeCamera(registry, 0, 0);
+		camera2D.setMainCamera(main);
+
+		camera2D.update(registry);
+		ADL_CHECK(camera2D.rebuildCount() == 0);
+		// published anyway, with the identity it still holds
+		ADL_CHECK(camera2D.revision() == 1);
+		ADL_CHECK(camera2D.view() == glm::mat4(1.0f));
+
+		camera2D.resize(640, 480);
+		camera2D.update(registry);
+		ADL_CHECK(camera2D.rebuildCount() == 1);
+		ADL_CHECK(camera2D.revision() == 2);
+	}});
+}
@@ -0,0 +1,260 @@
+#include <random>
+
+#include "adall/adal_culling.h"
+#include "adall/adal_hierarchy.h"
+
+#include "test.h"
+
+using adlSystem::BoundsSoA;
+using adlSystem::Culling;
+using namespace adlComponent;
+
+namespace {
+	/// A registry with a job system of its own in its context.
+	struct World {
+		adlCore::adlJobSystem jobSystem{4};
+		adlCore::adlRegistry  registry;
+		entt::registry       &entities = registry.getRegistry();
+		std::mt19937          random{7};
+
+		World() {
+			registry.adlAddContext<std::shared_ptr<adlCore::adlJobSystem> >(std::shared_ptr<adlCore::adlJobSystem>(&jobSystem, [](auto *) {}));
+		}
+
+		entt::entity makeBox(const glm::vec2 position, const glm::vec2 halfExtents, const float rotation = 0.0f) {
+			const float c = std::cos(rotation), s = std::sin(rotation);
+
+			WorldTransform transform;
+			transform.matrix[0] = glm::vec3(c, s, 0.0f);
+			transform.matrix[1] = glm::vec3(-s, c, 0.0f);
+			transform.matrix[2] = glm::vec3(position, 1.0f);
+
+			const auto entity = entities.create();
+			entities.emplace<WorldTransform>(entity, transform);
+			entities.emplace<Bounds>(entity, halfExtents);
+			return entity;
+		}
+
+		/// @brief Scatters count boxes, every seventh one rotated and every eleventh one without Bounds.
+		void scatter(const std::size_t count, const float extent) {
+			std::uniform_real_distribution<float> position(-extent, extent);
+			std::uniform_real_distribution<float> halfExtent(0.5f, 20.0f);
+			std::uniform_real_distribution<float> rotation(0.0f, 6.2831853f);
+
+			for (std::size_t i = 0; i < count; ++i) {
+				const auto entity = makeBox({position(random), position(random)}, {halfExtent(random), halfExtent(random)},
+				                            i % 7 == 0 ? rotation(random) : 0.0f);
+				if (i % 11 == 0) {
+					entities.remove<Bounds>(entity);
+				}
+			}
+		}
+
+		entt::entity makeCamera(const glm::vec2 position, const int width, const int height, const float scale = 1.0f) {
+			const auto camera = entities.create();
+			entities.emplace<Camera>(camera, Camera{.width = width, .height = height, .scale = scale, .position = position});
+			entities.emplace<Visibility>(camera);
+			return camera;
+		}
+
+		/// @brief Every entity whose corners, moved by its world matrix, span a box touching [viewMin, viewMax],
+		/// in WorldTransform storage order.
+		[[nodiscard]] std::vector<entt::entity> bruteForce(const glm::vec2 viewMin, const glm::vec2 viewMax) const {
+			std::vector<entt::entity> visible;
+			const auto               &transforms = entities.storage<WorldTransform>();
+			for (std::size_t i = 0; i < transforms.size(); ++i) {
+				const entt::entity entity = transforms.data()[i];
+				const auto        *bounds = entities.try_get<Bounds>(entity);
+				if (bounds == nullptr) {
+					continue;
+				}
+
+				glm::vec2 min(std::numeric_limits<float>::infinity()), max(-std::numeric_limits<float>::infinity());
+				for (const glm::vec2 corner: {glm::vec2(-1.0f, -1.0f), glm::vec2(1.0f, -1.0f), glm::vec2(1.0f, 1.0f), glm::vec2(-1.0f, 1.0f)}) {
+					const glm::vec2 world(transforms.get(entity).matrix * glm::vec3(corner * bounds->halfExtents, 1.0f));
+					min = glm::min(min, world);
+					max = glm::max(max, world);
+				}
+				if (min.x <= viewMax.x && max.x >= viewMin.x && min.y <= viewMax.y && max.y >= viewMin.y) {
+					visible.push_back(entity);
+				}
+			}
+			return visible;
+		}
+
+		[[nodiscard]] std::vector<entt::entity> expected(const entt::entity camera) const {
+			glm::vec2 viewMin, viewMax;
+			if (!Culling::viewRect(entities.get<Camera>(camera), viewMin, viewMax)) {
+				return {};
+			}
+			return bruteForce(viewMin, viewMax);
+		}
+
+		[[nodiscard]] const std::vector<entt::entity> &visible(const entt::entity camera) const {
+			return entities.get<Visibility>(camera).entities;
+		}
+
+		[[nodiscard]] bool sees(const entt::entity camera, const entt::entity entity) const {
+			const auto &seen = visible(camera);
+			return std::find(seen.begin(), seen.end(), entity) != seen.end();
+		}
+	};
+}
+
+void adlAddCullingTests(std::vector<adlTestCase> &cases) {
+	cases.push_back({"culling/both_paths_match_a_brute_force_scan", [] {
+		static constexpr std::size_t COUNT = 1001; // not a whole number of lanes
+
+		std::mt19937                          random{3};
+		std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+		std::uniform_real_distribution<float> halfExtent(0.0f, 30.0f);
+
+		BoundsSoA bounds;
+		bounds.resize(COUNT);
+		ADL_REQUIRE(bounds.size() % BoundsSoA::LANES == 0 && bounds.size() > COUNT);
+		for (std::size_t i = 0; i < COUNT; ++i) {
+			const glm::vec2 center(position(random), position(random)), half(halfExtent(random), halfExtent(random));
+			bounds.minX[i]     = center.x - half.x;
+			bounds.minY[i]     = center.y - half.y;
+			bounds.maxX[i]     = center.x + half.x;
+			bounds.maxY[i]     = center.y + half.y;
+			bounds.entities[i] = static_cast<entt::entity>(i);
+			if (i % 13 == 0) {
+				bounds.clear(i);
+			}
+		}
+
+		const std::vector<std::pair<glm::vec2, glm::vec2> > views = {
+			{glm::vec2(-100.0f), glm::vec2(100.0f)},
+			{glm::vec2(-1.0e9f), glm::vec2(1.0e9f)},
+			{glm::vec2(bounds.maxX[1], bounds.minY[1]), glm::vec2(bounds.maxX[1] + 5.0f, bounds.maxY[1])}, // touching box 1's right edge
+			{glm::vec2(2000.0f), glm::vec2(3000.0f)},
+		};
+		for (const auto &[viewMin, viewMax]: views) {
+			std::vector<entt::entity> expected;
+			for (std::size_t i = 0; i < COUNT; ++i) {
+				if (bounds.minX[i] <= viewMax.x && bounds.maxX[i] >= viewMin.x && bounds.minY[i] <= viewMax.y && bounds.maxY[i] >= viewMin.y) {
+					expected.push_back(bounds.entities[i]);
+				}
+			}
+
+			// one call over everything, and one per lane batch the way update() splits chunks
+			std::vector<entt::entity> simd, scalar, batched;
+			Culling::cull(bounds, 0, bounds.size(), viewMin, viewMax, simd);
+			Culling::cullScalar(bounds, 0, bounds.size(), viewMin, viewMax, scalar);
+			for (std::size_t first = 0; first < bounds.size(); first += BoundsSoA::LANES) {
+				Culling::cull(bounds, first, first + BoundsSoA::LANES, viewMin, viewMax, batched);
+			}
+			ADL_CHECK(simd == expected);
+			ADL_CHECK(scalar == expected);
+			ADL_CHECK(batched == expected);
+			ADL_CHECK(std::find(simd.begin(), simd.end(), entt::entity{entt::null}) == simd.end());
+		}
+	}});
+
+	cases.push_back({"culling/update_matches_a_brute_force_scan", [] {
+		World world;
+		world.scatter(1001, 600.0f);
+		const auto wide   = world.makeCamera({0.0f, 0.0f}, 640, 480);
+		const auto zoomed = world.makeCamera({100.0f, -50.0f}, 640, 480, 4.0f);
+
+		Culling culling;
+		culling.update(world.registry);
+		ADL_CHECK(culling.bounds().size() % BoundsSoA::LANES == 0);
+		ADL_CHECK(!world.visible(wide).empty());
+		ADL_CHECK(world.visible(wide) == world.expected(wide));
+		ADL_CHECK(world.visible(zoomed) == world.expected(zoomed));
+	}});
+
+	cases.push_back({"culling/boxes_touching_the_view_edges_are_visible", [] {
+		World      world;
+		const auto camera = world.makeCamera({0.0f, 0.0f}, 100, 100); // sees [-50, 50]
+
+		const auto right   = world.makeBox({60.0f, 0.0f}, {10.0f, 10.0f});
+		const auto top     = world.makeBox({0.0f, 55.0f}, {1.0f, 5.0f});
+		const auto corner  = world.makeBox({-52.0f, -52.0f}, {2.0f, 2.0f});
+		const auto outside = world.makeBox({60.5f, 0.0f}, {10.0f, 10.0f});
+
+		Culling culling;
+		culling.update(world.registry);
+		ADL_CHECK(world.sees(camera, right));
+		ADL_CHECK(world.sees(camera, top));
+		ADL_CHECK(world.sees(camera, corner));
+		ADL_CHECK(!world.sees(camera, outside));
+		ADL_CHECK(world.visible(camera) == world.expected(camera));
+	}});
+
+	cases.push_back({"culling/entities_without_bounds_are_never_visible", [] {
+		World      world;
+		const auto camera = world.makeCamera({0.0f, 0.0f}, 100, 100);
+
+		const auto boxed = world.makeBox({0.0f, 0.0f}, {1.0f, 1.0f});
+		const auto bare  = world.makeBox({0.0f, 0.0f}, {1.0f, 1.0f});
+		world.entities.remove<Bounds>(bare);
+
+		Culling culling;
+		culling.update(world.registry);
+		ADL_CHECK(world.visible(camera) == std::vector<entt::entity>{boxed});
+	}});
+
+	cases.push_back({"culling/rotated_and_parented_boxes_use_their_world_box", [] {
+		World                world;
+		adlSystem::Hierarchy hierarchy(world.registry);
+
+		// a thin box turned upright reaches 50 up, where the unturned box would not
+		const auto turned = world.entities.create();
+		world.entities.emplace<Transform>(turned, glm::vec2(0.0f, 0.0f), 1.5707963f);
+		world.entities.emplace<Bounds>(turned, glm::vec2(50.0f, 1.0f));
+
+		// a child 10 to the right of a parent 1000 to the right lives at 1010, not at 10
+		const auto parent = world.entities.create();
+		world.entities.emplace<Transform>(parent, glm::vec2(1000.0f, 0.0f));
+		const auto child = world.entities.create();
+		world.entities.emplace<Transform>(child, glm::vec2(10.0f, 0.0f));
+		world.entities.emplace<Bounds>(child, glm::vec2(1.0f));
+		ADL_REQUIRE(hierarchy.setParent(child, parent));
+		hierarchy.update(world.registry);
+
+		const auto above   = world.makeCamera({0.0f, 45.0f}, 4, 4);
+		const auto atChild = world.makeCamera({1010.0f, 0.0f}, 4, 4);
+		const auto atLocal = world.makeCamera({10.0f, 0.0f}, 4, 4);
+
+		Culling culling;
+		culling.update(world.registry);
+		ADL_CHECK(world.sees(above, turned));
+		ADL_CHECK(world.sees(atChild, child));
+		ADL_CHECK(!world.sees(atLocal, child));
+		for (const auto camera: {above, atChild, atLocal}) {
+			ADL_CHECK(world.visible(camera) == world.expected(camera));
+		}
+	}});
+
+	cases.push_back({"culling/a_camera_without_area_sees_nothing", [] {
+		World world;
+		world.makeBox({0.0f, 0.0f}, {10.0f, 10.0f});
+		const auto flat = world.makeCamera({0.0f, 0.0f}, 0, 100);
+		world.entities.get<Visibility>(flat).entities.push_back(entt::null); // left over from an earlier step
+
+		Culling culling;
+		culling.update(world.registry);
+		ADL_CHECK(world.visible(flat).empty());
+	}});
+
+	cases.push_back({"culling/cameras_sharing_chunks_see_only_their_own", [] {
+		// enough boxes for several chunks, so both cameras reuse the same chunk lists
+		World world;
+		world.scatter(40003, 4000.0f);
+		const auto left  = world.makeCamera({-2000.0f, 0.0f}, 1920, 1080);
+		const auto right = world.makeCamera({2000.0f, 0.0f}, 1920, 1080);
+		const auto empty = world.makeCamera({100000.0f, 0.0f}, 1920, 1080);
+
+		Culling culling;
+		for (int step = 0; step < 2; ++step) {
+			culling.update(world.registry);
+			ADL_CHECK(!world.visible(left).empty() && !world.visible(right).empty());
+			ADL_CHECK(world.visible(left) == world.expected(left));
+			ADL_CHECK(world.visible(right) == world.expected(right));
+			ADL_CHECK(world.visible(empty).empty());
+		}
+	}});
+}
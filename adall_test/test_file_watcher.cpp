@@ -0,0 +1,112 @@
+#include <filesystem>
+#include <thread>
+
+#include "adall/adal_file_watcher.h"
+
+#include "test.h"
+
+namespace fs = std::filesystem;
+
+using namespace adlCore;
+
+namespace {
+	constexpr auto DEBOUNCE = std::chrono::milliseconds(100);
+
+	void writeFile(const std::string &path, const std::string &contents) {
+		std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+		ofs << contents;
+	}
+
+	/// Collects changes until none came for a few debounce intervals, long enough for any pending one to settle.
+	std::vector<std::string> collectChanges(adlFileWatcher &watcher) {
+		std::vector<std::string> changes;
+		auto                     quietSince = std::chrono::steady_clock::now();
+		while (std::chrono::steady_clock::now() - quietSince < DEBOUNCE * 5) {
+			if (watcher.takeChanges(changes)) {
+				quietSince = std::chrono::steady_clock::now();
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+		return changes;
+	}
+}
+
+void adlAddFileWatcherTests(std::vector<adlTestCase> &cases) {
+	// where there is no inotify the watcher never runs, and reporting nothing is all it promises
+	cases.push_back({"file_watcher/coalesces_a_burst_of_writes", [] {
+		const adlTestDirectory directory("file_watcher_burst");
+		const std::string      path = directory.file("shader.frag");
+		writeFile(path, "0");
+
+		adlFileWatcher watcher(DEBOUNCE);
+		if (!watcher.isRunning()) {
+			return;
+		}
+		ADL_REQUIRE(watcher.watch(path));
+
+		// writes closer together than the debounce interval are one save
+		for (int write = 1; write <= 5; ++write) {
+			writeFile(path, std::to_string(write));
+			std::this_thread::sleep_for(DEBOUNCE / 5);
+		}
+
+		std::vector<std::string> changes;
+		ADL_CHECK(!watcher.takeChanges(changes));
+
+		changes = collectChanges(watcher);
+		ADL_REQUIRE(changes.size() == 1);
+		ADL_CHECK(changes.front() == adlFileWatcher::normalize(path));
+	}});
+
+	cases.push_back({"file_watcher/sees_saves_renamed_over_the_file", [] {
+		const adlTestDirectory directory("file_watcher_rename");
+		const std::string      path = directory.file("texture.png");
+		writeFile(path, "old");
+
+		adlFileWatcher watcher(DEBOUNCE);
+		if (!watcher.isRunning()) {
+			return;
+		}
+		ADL_REQUIRE(watcher.watch(path));
+
+		writeFile(directory.file("texture.png.tmp"), "new");
+		fs::rename(directory.file("texture.png.tmp"), path);
+
+		const auto changes = collectChanges(watcher);
+		ADL_REQUIRE(changes.size() == 1);
+		ADL_CHECK(changes.front() == adlFileWatcher::normalize(path));
+	}});
+
+	cases.push_back({"file_watcher/reports_only_watched_files_in_save_order", [] {
+		const adlTestDirectory directory("file_watcher_order");
+		const std::string      first  = directory.file("a.glsl");
+		const std::string      second = directory.file("b.glsl");
+
+		adlFileWatcher watcher(DEBOUNCE);
+		if (!watcher.isRunning()) {
+			return;
+		}
+		// watched before they exist, as the directory is what is watched
+		ADL_REQUIRE(watcher.watch(second));
+		ADL_REQUIRE(watcher.watch(first));
+
+		writeFile(directory.file("unwatched.glsl"), "x");
+		writeFile(second, "b");
+		std::this_thread::sleep_for(DEBOUNCE / 2);
+		writeFile(first, "a");
+
+		const auto changes = collectChanges(watcher);
+		ADL_REQUIRE(changes.size() == 2);
+		ADL_CHECK(changes[0] == adlFileWatcher::normalize(second));
+		ADL_CHECK(changes[1] == adlFileWatcher::normalize(first));
+	}});
+
+	cases.push_back({"file_watcher/missing_directory_fails", [] {
+		adlFileWatcher watcher(DEBOUNCE);
+		if (!watcher.isRunning()) {
+			return;
+		}
+		const adlTestDirectory directory("file_watcher_missing");
+		ADL_CHECK(!watcher.watch(directory.file("missing/shader.frag")));
+	}});
+}
@@ -0,0 +1,143 @@
+#include <filesystem>
+
+#include "adall/adal_program_cache.h"
+
+#include "test.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+	constexpr std::string_view DRIVER        = "Vendor, Renderer, 4.6.0 1.2";
+	constexpr std::uint32_t    BINARY_FORMAT = 0x8e21;
+
+	std::vector<std::byte> makeBinary(const std::size_t bytes, const std::uint8_t seed) {
+		std::vector<std::byte> binary(bytes);
+		for (std::size_t i = 0; i < bytes; ++i) {
+			binary[i] = static_cast<std::byte>(seed + i * 7);
+		}
+		return binary;
+	}
+}
+
+void adlAddProgramCacheTests(std::vector<adlTestCase> &cases) {
+	cases.push_back({"program_cache/key_covers_every_input", [] {
+		const std::uint64_t key = adlProgramCache::makeKey("vs", "fs", DRIVER);
+
+		ADL_CHECK(key == adlProgramCache::makeKey("vs", "fs", DRIVER));
+		ADL_CHECK(key != adlProgramCache::makeKey("vs ", "fs", DRIVER));
+		ADL_CHECK(key != adlProgramCache::makeKey("vs", "fs ", DRIVER));
+		ADL_CHECK(key != adlProgramCache::makeKey("vs", "fs", "another driver"));
+		// moving bytes across the boundary between two sources changes the key
+		ADL_CHECK(adlProgramCache::makeKey("ab", "c", DRIVER) != adlProgramCache::makeKey("a", "bc", DRIVER));
+	}});
+
+	cases.push_back({"program_cache/stored_binaries_survive_reopening", [] {
+		const adlTestDirectory directory("program_cache_reopen");
+		const auto             binary = makeBinary(300, 1);
+		const std::uint64_t    key    = adlProgramCache::makeKey("vs", "fs", DRIVER);
+		{
+			adlProgramCache cache;
+			ADL_REQUIRE(cache.open(directory.path, DRIVER));
+			ADL_CHECK(cache.entryCount() == 0);
+			ADL_CHECK(cache.store(key, BINARY_FORMAT, binary));
+		}
+
+		adlProgramCache cache;
+		ADL_REQUIRE(cache.open(directory.path, DRIVER));
+		ADL_CHECK(cache.entryCount() == 1);
+
+		std::uint32_t          format = 0;
+		std::vector<std::byte> loaded;
+		ADL_REQUIRE(cache.find(key, format, loaded));
+		ADL_CHECK(format == BINARY_FORMAT);
+		ADL_CHECK(loaded == binary);
+
+		ADL_CHECK(!cache.find(key + 1, format, loaded));
+	}});
+
+	cases.push_back({"program_cache/store_replaces_the_binary", [] {
+		const adlTestDirectory directory("program_cache_replace");
+		adlProgramCache        cache;
+		ADL_REQUIRE(cache.open(directory.path, DRIVER));
+
+		ADL_CHECK(cache.store(1, BINARY_FORMAT, makeBinary(100, 1)));
+		ADL_CHECK(cache.store(1, BINARY_FORMAT + 1, makeBinary(40, 2)));
+		ADL_CHECK(cache.entryCount() == 1);
+
+		std::uint32_t          format = 0;
+		std::vector<std::byte> loaded;
+		ADL_REQUIRE(cache.find(1, format, loaded));
+		ADL_CHECK(format == BINARY_FORMAT + 1);
+		ADL_CHECK(loaded == makeBinary(40, 2));
+	}});
+
+	cases.push_back({"program_cache/invalidate_and_clear_drop_files", [] {
+		const adlTestDirectory directory("program_cache_invalidate");
+		adlProgramCache        cache;
+		ADL_REQUIRE(cache.open(directory.path, DRIVER));
+		ADL_CHECK(cache.store(1, BINARY_FORMAT, makeBinary(16, 1)));
+		ADL_CHECK(cache.store(2, BINARY_FORMAT, makeBinary(16, 2)));
+		ADL_CHECK(cache.store(3, BINARY_FORMAT, makeBinary(16, 3)));
+
+		cache.invalidate(2);
+		ADL_CHECK(cache.entryCount() == 2);
+		ADL_CHECK(!fs::exists(directory.file("0000000000000002.bin")));
+		ADL_CHECK(fs::exists(directory.file("0000000000000001.bin")));
+
+		cache.clear();
+		ADL_CHECK(cache.entryCount() == 0);
+		ADL_CHECK(!fs::exists(directory.file("0000000000000001.bin")));
+
+		adlProgramCache reopened;
+		ADL_REQUIRE(reopened.open(directory.path, DRIVER));
+		ADL_CHECK(reopened.entryCount() == 0);
+	}});
+
+	cases.push_back({"program_cache/damaged_binaries_are_dropped", [] {
+		const adlTestDirectory directory("program_cache_damaged");
+		adlProgramCache        cache;
+		ADL_REQUIRE(cache.open(directory.path, DRIVER));
+		ADL_CHECK(cache.store(1, BINARY_FORMAT, makeBinary(64, 1)));
+		ADL_CHECK(cache.store(2, BINARY_FORMAT, makeBinary(64, 2)));
+
+		// same size, different bytes: only the checksum catches it
+		{
+			std::ofstream ofs(directory.file("0000000000000001.bin"), std::ios::binary | std::ios::trunc);
+			const auto    other = makeBinary(64, 9);
+			ofs.write(reinterpret_cast<const char *>(other.data()), static_cast<std::streamsize>(other.size()));
+		}
+		// truncated
+		fs::resize_file(directory.file("0000000000000002.bin"), 10);
+
+		std::uint32_t          format = 0;
+		std::vector<std::byte> loaded;
+		ADL_CHECK(!cache.find(1, format, loaded));
+		ADL_CHECK(!cache.find(2, format, loaded));
+		ADL_CHECK(cache.entryCount() == 0);
+	}});
+
+	cases.push_back({"program_cache/another_driver_empties_the_cache", [] {
+		const adlTestDirectory directory("program_cache_driver");
+		{
+			adlProgramCache cache;
+			ADL_REQUIRE(cache.open(directory.path, DRIVER));
+			ADL_CHECK(cache.store(1, BINARY_FORMAT, makeBinary(16, 1)));
+		}
+
+		adlProgramCache cache;
+		ADL_REQUIRE(cache.open(directory.path, "Vendor, Renderer, 4.6.0 1.3"));
+		ADL_CHECK(cache.entryCount() == 0);
+		ADL_CHECK(!fs::exists(directory.file("0000000000000001.bin")));
+
+		std::uint32_t          format = 0;
+		std::vector<std::byte> loaded;
+		ADL_CHECK(!cache.find(1, format, loaded));
+	}});
+
+	cases.push_back({"program_cache/closed_cache_stores_nothing", [] {
+		adlProgramCache cache;
+		ADL_CHECK(!cache.isOpen());
+		ADL_CHECK(!cache.store(1, BINARY_FORMAT, makeBinary(16, 1)));
+		ADL_CHECK(cache.entryCount() == 0);
+	}});
+}
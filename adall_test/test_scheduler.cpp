@@ -0,0 +1,150 @@
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "adall/adal_scheduler.h"
+
+#include "test.h"
+
+using namespace adlCore;
+
+namespace {
+	struct Position {
+		float x = 0.0f;
+	};
+
+	struct Velocity {
+		float x = 0.0f;
+	};
+
+	struct Health {
+		int value = 0;
+	};
+
+	/// A system with a given signature that logs its runs and can hold its job for a while.
+	template<typename TAccess>
+	struct DummySystem {
+		using adlAccess = TAccess;
+
+		std::string                 name;
+		std::vector<std::string>   *log   = nullptr;
+		std::mutex                 *mutex = nullptr;
+		std::chrono::milliseconds   sleep{0};
+
+		void update(adlRegistry &, float) {
+			if (sleep.count() > 0) {
+				std::this_thread::sleep_for(sleep);
+			}
+			std::lock_guard lock(*mutex);
+			log->push_back(name);
+		}
+	};
+
+	typedef adlSystemSignature<adlReads<Velocity>, adlWrites<Position> > Move;
+	typedef adlSystemSignature<adlReads<Position>, adlWrites<> >         ReadPosition;
+	typedef adlSystemSignature<adlReads<>, adlWrites<Health> >           Heal;
+	typedef adlSystemSignature<adlReads<Velocity>, adlWrites<> >         ReadVelocity;
+
+	struct Fixture {
+		std::vector<std::string> log;
+		std::mutex               mutex;
+		adlScheduler             scheduler;
+
+		template<typename TAccess>
+		void add(const std::string &name, const std::chrono::milliseconds sleep = std::chrono::milliseconds(0)) {
+			auto system   = std::make_shared<DummySystem<TAccess> >();
+			system->name  = name;
+			system->log   = &log;
+			system->mutex = &mutex;
+			system->sleep = sleep;
+			scheduler.addSystem(name, system);
+		}
+
+		[[nodiscard]] std::ptrdiff_t position(const std::string &name) const {
+			return std::find(log.begin(), log.end(), name) - log.begin();
+		}
+	};
+}
+
+void adlAddSchedulerTests(std::vector<adlTestCase> &cases) {
+	cases.push_back({"scheduler/stages_follow_conflicts", [] {
+		Fixture fixture;
+		fixture.add<Move>("move");
+		fixture.add<ReadPosition>("render");
+		fixture.add<Heal>("heal");
+		fixture.add<ReadVelocity>("steer");
+		fixture.add<Move>("collide");
+
+		// render reads what move writes; heal and steer share nothing written; collide writes what render reads
+		const std::vector<std::vector<std::string> > expected = {
+			{"move", "heal", "steer"},
+			{"render"},
+			{"collide"},
+		};
+		ADL_CHECK(fixture.scheduler.stages() == expected);
+	}});
+
+	cases.push_back({"scheduler/readers_never_conflict", [] {
+		Fixture fixture;
+		fixture.add<ReadVelocity>("a");
+		fixture.add<ReadVelocity>("b");
+		fixture.add<ReadPosition>("c");
+
+		ADL_CHECK(fixture.scheduler.stages().size() == 1);
+	}});
+
+	cases.push_back({"scheduler/runs_conflicting_systems_in_order", [] {
+		adlJobSystem jobSystem(4);
+		adlRegistry  registry;
+		Fixture      fixture;
+		fixture.add<Move>("move");
+		fixture.add<ReadPosition>("render");
+		fixture.add<Heal>("heal");
+		fixture.add<Move>("collide");
+
+		for (int run = 0; run < 50; ++run) {
+			fixture.log.clear();
+			fixture.scheduler.run(registry, jobSystem, 1.0f);
+
+			ADL_REQUIRE(fixture.log.size() == 4);
+			ADL_CHECK(fixture.position("move") < fixture.position("render"));
+			ADL_CHECK(fixture.position("render") < fixture.position("collide"));
+		}
+	}});
+
+	cases.push_back({"scheduler/overlaps_independent_systems", [] {
+		adlJobSystem jobSystem(4);
+		adlRegistry  registry;
+		Fixture      fixture;
+
+		// four independent 50 ms systems take 200 ms one after another; sleeping needs no free core,
+		// so the speedup shows on any machine
+		constexpr auto SLEEP = std::chrono::milliseconds(50);
+		fixture.add<Move>("move", SLEEP);
+		fixture.add<Heal>("heal", SLEEP);
+		fixture.add<ReadVelocity>("steer", SLEEP);
+		fixture.add<ReadVelocity>("look", SLEEP);
+		ADL_REQUIRE(fixture.scheduler.stages().size() == 1);
+
+		const auto start = std::chrono::steady_clock::now();
+		fixture.scheduler.run(registry, jobSystem, 1.0f);
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+
+		ADL_CHECK(fixture.log.size() == 4);
+		ADL_CHECK(elapsed < SLEEP * 3);
+	}});
+
+	cases.push_back({"scheduler/creates_pools_before_running", [] {
+		adlJobSystem jobSystem(2);
+		adlRegistry  registry;
+		Fixture      fixture;
+		fixture.add<Move>("move");
+
+		// the const overload looks a pool up without creating it
+		const entt::registry &pools = registry.getRegistry();
+		ADL_CHECK(pools.storage<Position>() == nullptr);
+		fixture.scheduler.run(registry, jobSystem, 1.0f);
+		ADL_CHECK(pools.storage<Position>() != nullptr);
+		ADL_CHECK(pools.storage<Velocity>() != nullptr);
+	}});
+}
@@ -0,0 +1,129 @@
+#include "adall/adal_shader_preprocessor.h"
+
+#include "test.h"
+
+namespace {
+	/// Sources kept in memory, counting how often each was read.
+	struct MemorySources {
+		std::unordered_map<std::string, std::string> files;
+		std::unordered_map<std::string, int>         reads;
+
+		adlShaderSourceReader reader() {
+			return [this](const std::string &path, std::string &source) {
+				++reads[path];
+				const auto itr = files.find(path);
+				if (itr == files.end()) {
+					return false;
+				}
+				source = itr->second;
+				return true;
+			};
+		};
+	};
+}
+
+void adlAddShaderPreprocessorTests(std::vector<adlTestCase> &cases) {
+	cases.push_back({"shader_preprocessor/pastes_includes_relative_to_the_includer", [] {
+		MemorySources sources;
+		sources.files["shaders/sprite.frag"]       = "#version 450\n#include \"common/color.glsl\"\nvoid main() {}\n";
+		sources.files["shaders/common/color.glsl"] = "#include \"../lib.glsl\"\nvec4 tint;\n";
+		sources.files["shaders/lib.glsl"]          = "float lib;\n";
+
+		adlShaderPreprocessor preprocessor(sources.reader());
+		const std::string    *source = preprocessor.preprocess("shaders/sprite.frag");
+		ADL_REQUIRE(source != nullptr);
+		ADL_CHECK(*source == "#version 450\nfloat lib;\nvec4 tint;\nvoid main() {}\n");
+
+		const auto *files = preprocessor.sources("shaders/sprite.frag");
+		ADL_REQUIRE(files != nullptr);
+		ADL_CHECK(files->size() == 3);
+		ADL_CHECK(files->front() == "shaders/sprite.frag");
+	}});
+
+	cases.push_back({"shader_preprocessor/pastes_each_file_once", [] {
+		MemorySources sources;
+		sources.files["a.glsl"] = "#include \"b.glsl\"\n#include \"c.glsl\"\nA\n";
+		sources.files["b.glsl"] = "#include \"c.glsl\"\nB\n";
+		sources.files["c.glsl"] = "  #  include \"a.glsl\"\nC\n";
+
+		adlShaderPreprocessor preprocessor(sources.reader());
+		const std::string    *source = preprocessor.preprocess("a.glsl");
+		ADL_REQUIRE(source != nullptr);
+		// c is pasted where b first asks for it, and its cycle back to a is dropped
+		ADL_CHECK(*source == "C\nB\nA\n");
+	}});
+
+	cases.push_back({"shader_preprocessor/defines_follow_the_version_line", [] {
+		MemorySources sources;
+		sources.files["s.frag"] = "\n#version 450 core\nbody\n";
+
+		adlShaderPreprocessor preprocessor(sources.reader());
+		const std::uint64_t   tint  = preprocessor.feature("USE_TINT");
+		const std::uint64_t   alpha = preprocessor.feature("USE_ALPHA");
+		ADL_CHECK(tint == 1);
+		ADL_CHECK(alpha == 2);
+		ADL_CHECK(preprocessor.feature("USE_TINT") == tint);
+
+		const std::string *plain = preprocessor.preprocess("s.frag");
+		const std::string *both  = preprocessor.preprocess("s.frag", tint | alpha);
+		ADL_REQUIRE(plain != nullptr && both != nullptr);
+		ADL_CHECK(*plain == "\n#version 450 core\nbody\n");
+		ADL_CHECK(*both == "\n#version 450 core\n#define USE_TINT 1\n#define USE_ALPHA 1\nbody\n");
+		ADL_CHECK(preprocessor.variantCount() == 2);
+	}});
+
+	cases.push_back({"shader_preprocessor/reads_and_expands_once", [] {
+		MemorySources sources;
+		sources.files["s.frag"]   = "#version 450\n#include \"lib.glsl\"\n";
+		sources.files["lib.glsl"] = "lib\n";
+
+		adlShaderPreprocessor preprocessor(sources.reader());
+		const std::string    *first  = preprocessor.preprocess("s.frag", 0);
+		const std::string    *second = preprocessor.preprocess("s.frag", 0);
+		ADL_CHECK(first == second);
+
+		const std::uint64_t tint = preprocessor.feature("USE_TINT");
+		ADL_CHECK(preprocessor.preprocess("s.frag", tint) != nullptr);
+		ADL_CHECK(sources.reads["s.frag"] == 1);
+		ADL_CHECK(sources.reads["lib.glsl"] == 1);
+	}});
+
+	cases.push_back({"shader_preprocessor/missing_include_fails", [] {
+		MemorySources sources;
+		sources.files["s.frag"] = "#version 450\n#include \"missing.glsl\"\n";
+
+		adlShaderPreprocessor preprocessor(sources.reader());
+		ADL_CHECK(preprocessor.preprocess("s.frag") == nullptr);
+		// the failure is remembered, with the file it tried
+		ADL_CHECK(preprocessor.preprocess("s.frag") == nullptr);
+		ADL_CHECK(sources.reads["missing.glsl"] == 1);
+
+		sources.files["missing.glsl"] = "found\n";
+		preprocessor.forget("missing.glsl");
+		const std::string *source = preprocessor.preprocess("s.frag");
+		ADL_REQUIRE(source != nullptr);
+		ADL_CHECK(*source == "#version 450\nfound\n");
+	}});
+
+	cases.push_back({"shader_preprocessor/forget_drops_only_dependent_shaders", [] {
+		MemorySources sources;
+		sources.files["a.frag"]   = "#version 450\n#include \"lib.glsl\"\n";
+		sources.files["b.frag"]   = "#version 450\nb\n";
+		sources.files["lib.glsl"] = "old\n";
+
+		adlShaderPreprocessor preprocessor(sources.reader());
+		ADL_REQUIRE(preprocessor.preprocess("a.frag") != nullptr);
+		ADL_REQUIRE(preprocessor.preprocess("b.frag") != nullptr);
+
+		sources.files["lib.glsl"] = "new\n";
+		preprocessor.forget("lib.glsl");
+		ADL_CHECK(preprocessor.sources("a.frag") == nullptr);
+		ADL_CHECK(preprocessor.sources("b.frag") != nullptr);
+		ADL_CHECK(preprocessor.variantCount() == 1);
+
+		const std::string *source = preprocessor.preprocess("a.frag");
+		ADL_REQUIRE(source != nullptr);
+		ADL_CHECK(*source == "#version 450\nnew\n");
+		ADL_CHECK(sources.reads["b.frag"] == 1);
+	}});
+}
@@ -0,0 +1,152 @@
+#include "adall/adal_snapshot.h"
+
+#include "test.h"
+
+using namespace adlCore;
+using adlComponent::Transform;
+
+namespace {
+	/// Several storage pages of transforms, so captures mix shared, delta and whole chunks.
+	constexpr std::size_t ENTITY_COUNT = 5000;
+
+	struct Scene {
+		adlRegistry               registry;
+		std::vector<entt::entity> entities;
+
+		Scene() {
+			auto &storage = registry.getRegistry();
+			for (std::size_t i = 0; i < ENTITY_COUNT; ++i) {
+				const auto entity = storage.create();
+				storage.emplace<Transform>(entity, Transform{.position = {static_cast<float>(i), 0.0f}, .rotation = 0.0f, .scale = {1.0f, 1.0f}});
+				entities.push_back(entity);
+			}
+		}
+
+		/// Moves every stride-th entity, as a simulation step would.
+		void step(const std::size_t stride) {
+			for (std::size_t i = 0; i < entities.size(); i += stride) {
+				registry.getRegistry().patch<Transform>(entities[i], [](Transform &transform) { transform.position.y += 1.0f; });
+			}
+		}
+
+		[[nodiscard]] std::vector<entt::entity> storageOrder() const {
+			const auto &live = *std::as_const(registry.getRegistry()).storage<entt::entity>();
+			return {live.data(), live.data() + live.size()};
+		}
+	};
+
+	struct SignalCount {
+		std::size_t count = 0;
+
+		void onSignal(entt::registry &, entt::entity) { ++count; };
+	};
+}
+
+void adlAddSnapshotTests(std::vector<adlTestCase> &cases) {
+	cases.push_back({"snapshot/ring_drops_the_oldest_frames", [] {
+		Scene           scene;
+		adlSnapshotRing ring(4);
+		for (std::uint64_t frame = 1; frame <= 6; ++frame) {
+			scene.step(7);
+			ring.capture(scene.registry, frame);
+		}
+
+		ADL_CHECK(ring.frameCount() == 4);
+		ADL_CHECK(!ring.checksum(1).has_value());
+		ADL_CHECK(!ring.checksum(2).has_value());
+		for (std::uint64_t frame = 3; frame <= 6; ++frame) {
+			ADL_CHECK(ring.checksum(frame).has_value());
+		}
+		ADL_CHECK(!ring.restore(scene.registry, 2));
+	}});
+
+	cases.push_back({"snapshot/unchanged_frames_share_their_chunks", [] {
+		Scene           scene;
+		adlSnapshotRing ring(60);
+		const auto      checksum = ring.capture(scene.registry, 0);
+		const auto      size     = ring.byteSize();
+
+		for (std::uint64_t frame = 1; frame < 30; ++frame) {
+			ADL_CHECK(ring.capture(scene.registry, frame) == checksum);
+		}
+		ADL_CHECK(ring.byteSize() == size);
+
+		// a few moved entities cost about their own bytes, not another copy
+		scene.step(500);
+		ADL_CHECK(ring.capture(scene.registry, 30) != checksum);
+		ADL_CHECK(ring.byteSize() < size + size / 10);
+	}});
+
+	cases.push_back({"snapshot/restore_patches_changed_values", [] {
+		Scene           scene;
+		adlSnapshotRing ring(8);
+		scene.step(3);
+		const auto checksum = ring.capture(scene.registry, 1);
+		const auto order    = scene.storageOrder();
+		for (std::uint64_t frame = 2; frame <= 5; ++frame) {
+			scene.step(frame);
+			ring.capture(scene.registry, frame);
+		}
+
+		SignalCount destroyed, updated;
+		auto       &storage = scene.registry.getRegistry();
+		storage.on_destroy<Transform>().connect<&SignalCount::onSignal>(destroyed);
+		storage.on_update<Transform>().connect<&SignalCount::onSignal>(updated);
+
+		ADL_REQUIRE(ring.restore(scene.registry, 1));
+		storage.on_destroy<Transform>().disconnect(&destroyed);
+		storage.on_update<Transform>().disconnect(&updated);
+
+		// only the entities moved since frame 1 were written, and through patch()
+		ADL_CHECK(destroyed.count == 0);
+		ADL_CHECK(updated.count > 0 && updated.count < ENTITY_COUNT);
+		ADL_CHECK(scene.storageOrder() == order);
+		ADL_CHECK(ring.capture(scene.registry, 1) == checksum);
+		// the frames after the one captured again are gone
+		ADL_CHECK(ring.frameCount() == 1);
+	}});
+
+	cases.push_back({"snapshot/restore_rebuilds_after_entity_changes", [] {
+		Scene           scene;
+		adlSnapshotRing ring(8);
+		auto           &storage  = scene.registry.getRegistry();
+		const auto      checksum = ring.capture(scene.registry, 1);
+		const auto      order    = scene.storageOrder();
+		const auto      removed  = scene.entities[10];
+
+		storage.destroy(removed);
+		storage.destroy(scene.entities[20]);
+		const auto added = storage.create();
+		storage.emplace<Transform>(added);
+		// misses the destroyed ones
+		scene.step(3);
+		ring.capture(scene.registry, 2);
+
+		ADL_REQUIRE(ring.restore(scene.registry, 1));
+		ADL_CHECK(storage.valid(removed));
+		ADL_CHECK(storage.all_of<Transform>(removed));
+		ADL_CHECK(storage.get<Transform>(removed).position.x == 10.0f);
+		ADL_CHECK(storage.storage<Transform>().size() == ENTITY_COUNT);
+		ADL_CHECK(scene.storageOrder() == order);
+		ADL_CHECK(ring.capture(scene.registry, 1) == checksum);
+
+		// the free list is back too: the next entity is the one frame 1 would have made, not the recycled one
+		const auto next = storage.create();
+		ADL_CHECK(next != added);
+		ADL_CHECK(next == static_cast<entt::entity>(ENTITY_COUNT));
+	}});
+
+	cases.push_back({"snapshot/checksums_follow_state", [] {
+		Scene           first, second;
+		adlSnapshotRing firstRing(4), secondRing(4);
+
+		for (std::uint64_t frame = 0; frame < 4; ++frame) {
+			first.step(5);
+			second.step(5);
+			ADL_CHECK(firstRing.capture(first.registry, frame) == secondRing.capture(second.registry, frame));
+		}
+
+		second.registry.getRegistry().patch<Transform>(second.entities[4321], [](Transform &transform) { transform.rotation = 1.0f; });
+		ADL_CHECK(firstRing.capture(first.registry, 4) != secondRing.capture(second.registry, 4));
+	}});
+}
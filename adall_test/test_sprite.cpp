@@ -0,0 +1,113 @@
+#include "adall/adal_sprite.h"
+
+#include "test.h"
+
+using adlSystem::SpriteRecorder;
+
+namespace {
+	/// A world matrix as the hierarchy composes it: translation, then rotation, then scale.
+	adlComponent::WorldTransform makeTransform(const glm::vec2 position, const float rotation, const glm::vec2 scale) {
+		const float c = std::cos(rotation), s = std::sin(rotation);
+
+		adlComponent::WorldTransform transform;
+		transform.matrix[0] = glm::vec3(c * scale.x, s * scale.x, 0.0f);
+		transform.matrix[1] = glm::vec3(-s * scale.y, c * scale.y, 0.0f);
+		transform.matrix[2] = glm::vec3(position, 1.0f);
+		return transform;
+	}
+
+	bool isNear(const glm::vec2 lhs, const glm::vec2 rhs) {
+		return glm::length(lhs - rhs) < 1e-3f;
+	}
+}
+
+void adlAddSpriteTests(std::vector<adlTestCase> &cases) {
+	cases.push_back({"sprite/command_covers_the_world_box", [] {
+		adlComponent::Sprite sprite;
+		sprite.uvRect = {0.25f, 0.0f, 0.5f, 1.0f};
+		sprite.color  = {.r = 10, .g = 20, .b = 30, .a = 40};
+
+		const auto command = SpriteRecorder::makeCommand(sprite, makeTransform({100.0f, 50.0f}, 0.0f, {2.0f, 3.0f}),
+		                                                 adlComponent::Bounds{.halfExtents = {4.0f, 5.0f}}, 7, 9);
+		ADL_CHECK(command.sprite.position == glm::vec2(92.0f, 35.0f));
+		ADL_CHECK(command.sprite.size == glm::vec2(16.0f, 30.0f));
+		ADL_CHECK(command.sprite.rotation == 0.0f);
+		ADL_CHECK(command.sprite.uvRect == sprite.uvRect);
+		ADL_CHECK(command.sprite.color.r == 10 && command.sprite.color.a == 40);
+		ADL_CHECK(command.sprite.shaderProgramID == 7 && command.sprite.textureID == 9);
+		ADL_CHECK(command.sortKey == adlMakeSortKey(0, 7, 9, 0.0f));
+	}});
+
+	cases.push_back({"sprite/rotated_quads_match_the_transformed_corners", [] {
+		const auto                 transform = makeTransform({-20.0f, 30.0f}, 0.7f, {1.5f, 0.5f});
+		const adlComponent::Bounds bounds{.halfExtents = {10.0f, 6.0f}};
+
+		std::vector<adlRenderCommand> commands = {SpriteRecorder::makeCommand(adlComponent::Sprite{}, transform, bounds, 1, 1)};
+		adlSpriteBatch                batch;
+		adlRenderQueue::build(commands, batch);
+		ADL_REQUIRE(batch.vertices().size() == 4);
+
+		// every corner of the box, moved by the matrix, is a vertex of the quad
+		for (const glm::vec2 corner: {glm::vec2(-1.0f, -1.0f), glm::vec2(1.0f, -1.0f), glm::vec2(1.0f, 1.0f), glm::vec2(-1.0f, 1.0f)}) {
+			const glm::vec2 world(transform.matrix * glm::vec3(corner * bounds.halfExtents, 1.0f));
+			ADL_CHECK(std::any_of(batch.vertices().begin(), batch.vertices().end(), [world](const adlVertex &vertex) {
+				return isNear(vertex.position, world);
+			}));
+		}
+	}});
+
+	cases.push_back({"sprite/layers_order_before_state_and_depth", [] {
+		const auto                 transform = makeTransform({0.0f, 0.0f}, 0.0f, {1.0f, 1.0f});
+		const adlComponent::Bounds bounds;
+
+		adlComponent::Sprite back, front, frontFar;
+		back.layer     = 0;
+		front.layer    = 1;
+		frontFar.layer = 1;
+		frontFar.depth = 0.5f;
+
+		adlRenderQueue queue(2);
+		queue.buffer(1).push(SpriteRecorder::makeCommand(frontFar, transform, bounds, 1, 1).sortKey, adlSprite{.position = {3.0f, 0.0f}});
+		queue.buffer(0).push(SpriteRecorder::makeCommand(front, transform, bounds, 2, 2).sortKey, adlSprite{.position = {2.0f, 0.0f}});
+		queue.buffer(1).push(SpriteRecorder::makeCommand(back, transform, bounds, 9, 9).sortKey, adlSprite{.position = {1.0f, 0.0f}});
+		queue.merge();
+		queue.sort();
+
+		// layer first; inside layer 1 the lower program groups first, depth only splits equal state
+		ADL_REQUIRE(queue.sorted().size() == 3);
+		ADL_CHECK(queue.sorted()[0].sprite.position.x == 1.0f);
+		ADL_CHECK(queue.sorted()[1].sprite.position.x == 3.0f);
+		ADL_CHECK(queue.sorted()[2].sprite.position.x == 2.0f);
+	}});
+
+	cases.push_back({"sprite/unloaded_sprites_are_not_recorded", [] {
+		adlCore::adlJobSystem jobSystem(2);
+		adlCore::adlRegistry  registry;
+		registry.adlAddContext<std::shared_ptr<adlCore::adlJobSystem> >(std::shared_ptr<adlCore::adlJobSystem>(&jobSystem, [](auto *) {}));
+		registry.adlAddContext<std::shared_ptr<adlCore::adlAssetManager> >(std::make_shared<adlCore::adlAssetManager>(1));
+
+		auto      &entities = registry.getRegistry();
+		const auto camera   = entities.create();
+		auto      &visible  = entities.emplace<adlComponent::Visibility>(camera).entities;
+		for (int i = 0; i < 100; ++i) {
+			const auto entity = entities.create();
+			entities.emplace<adlComponent::WorldTransform>(entity);
+			entities.emplace<adlComponent::Bounds>(entity);
+			// handles never handed out by the asset manager
+			entities.emplace<adlComponent::Sprite>(entity);
+			visible.push_back(entity);
+		}
+
+		adlRenderQueue  queue(jobSystem.threadCount() + 1);
+		SpriteRecorder  recorder;
+		ADL_CHECK(recorder.record(registry, queue, camera) == 0);
+		ADL_CHECK(recorder.shaders().empty());
+		queue.merge();
+		queue.sort();
+		ADL_CHECK(queue.sorted().empty());
+
+		// a camera that culls nothing records nothing
+		ADL_CHECK(recorder.record(registry, queue, entities.create()) == 0);
+		ADL_CHECK(recorder.record(registry, queue, entt::null) == 0);
+	}});
+}
@@ -0,0 +1,165 @@
+#include "adall/adal_view.h"
+
+#include "test.h"
+
+namespace {
+	/// What a RecordingStreamBackend was asked to do, kept by the test after the buffer took the backend.
+	struct StreamLog {
+		std::vector<std::pair<std::size_t, std::size_t> > flushes; ///< (offset, bytes)
+		std::vector<std::size_t>                          fences, waits;
+		std::unordered_set<std::size_t>                   pending;    ///< Fenced regions the "GPU" still reads.
+		bool                                              isBusy = false; ///< Waits on pending regions time out.
+		bool                                              isDestroyed = false;
+	};
+
+	class RecordingStreamBackend final : public adlStreamBackend {
+	private:
+		std::shared_ptr<StreamLog> m_log;
+		std::vector<std::byte>     m_storage;
+
+	public:
+		explicit RecordingStreamBackend(std::shared_ptr<StreamLog> log)
+			: m_log(std::move(log)) {
+		};
+
+		std::byte *create(const std::size_t bytes) override {
+			m_storage.assign(bytes, std::byte{0});
+			return m_storage.data();
+		};
+
+		void destroy() override { m_log->isDestroyed = true; };
+
+		void flush(const std::size_t offset, const std::size_t bytes) override { m_log->flushes.emplace_back(offset, bytes); };
+
+		void fence(const std::size_t region) override {
+			m_log->fences.push_back(region);
+			m_log->pending.insert(region);
+		};
+
+		bool waitFence(const std::size_t region, std::uint64_t) override {
+			m_log->waits.push_back(region);
+			if (m_log->isBusy && m_log->pending.contains(region)) {
+				return false;
+			}
+			m_log->pending.erase(region);
+			return true;
+		};
+
+		[[nodiscard]] GLuint bufferID() const override { return 0; };
+	};
+
+	/// A stream buffer of 3 regions of 100 bytes over a recording backend.
+	std::shared_ptr<StreamLog> makeStream(adlStreamBuffer &stream) {
+		auto log = std::make_shared<StreamLog>();
+		stream.init(std::make_unique<RecordingStreamBackend>(log), 100);
+		return log;
+	}
+}
+
+void adlAddStreamTests(std::vector<adlTestCase> &cases) {
+	cases.push_back({"stream/cycles_through_the_regions", [] {
+		adlStreamBuffer stream;
+		const auto      log = makeStream(stream);
+
+		std::vector<std::size_t> offsets;
+		for (int frame = 0; frame < 4; ++frame) {
+			ADL_REQUIRE(stream.beginFrame());
+			offsets.push_back(stream.allocate(10, 4).offset);
+			stream.endFrame();
+		}
+
+		ADL_CHECK((offsets == std::vector<std::size_t>{0, 100, 200, 0}));
+		ADL_CHECK((log->fences == std::vector<std::size_t>{0, 1, 2, 0}));
+		ADL_CHECK((log->waits == std::vector<std::size_t>{0, 1, 2, 0}));
+		ADL_CHECK(stream.currentRegion() == 1);
+	}});
+
+	cases.push_back({"stream/waits_for_the_region_fence", [] {
+		adlStreamBuffer stream;
+		const auto      log = makeStream(stream);
+
+		for (int frame = 0; frame < 3; ++frame) {
+			ADL_REQUIRE(stream.beginFrame());
+			stream.endFrame();
+		}
+
+		// region 0 is still read by the GPU: nothing may be written into it
+		log->isBusy = true;
+		ADL_CHECK(!stream.beginFrame());
+		ADL_CHECK(stream.allocate(10).data == nullptr);
+		stream.endFrame();
+		ADL_CHECK(log->fences.size() == 3);
+		ADL_CHECK(stream.currentRegion() == 0);
+
+		log->isBusy = false;
+		ADL_CHECK(stream.beginFrame());
+		ADL_CHECK(stream.allocate(10).offset == 0);
+	}});
+
+	cases.push_back({"stream/aligns_absolute_offsets", [] {
+		adlStreamBuffer stream;
+		makeStream(stream);
+
+		ADL_REQUIRE(stream.beginFrame());
+		stream.endFrame();
+		ADL_REQUIRE(stream.beginFrame());
+
+		// region 1 starts at 100; a 20 byte stride lands on 100, then rounds 103 up to 120
+		ADL_CHECK(stream.allocate(3, 20).offset == 100);
+		ADL_CHECK(stream.allocate(20, 20).offset == 120);
+		ADL_CHECK(stream.bytesUsed() == 40);
+
+		// 16-byte alignment moves 140 to 144, and 64 bytes from there end past the region
+		ADL_CHECK(stream.allocate(64, 16).data == nullptr);
+		ADL_CHECK(stream.allocate(44, 1).offset == 140);
+		ADL_CHECK(stream.bytesUsed() == 84);
+	}});
+
+	cases.push_back({"stream/flushes_only_new_bytes", [] {
+		adlStreamBuffer stream;
+		const auto      log = makeStream(stream);
+
+		ADL_REQUIRE(stream.beginFrame());
+		stream.allocate(16);
+		stream.flush();
+		stream.flush();
+		stream.allocate(8);
+		stream.endFrame();
+
+		const std::vector<std::pair<std::size_t, std::size_t> > expected = {{0, 16}, {16, 8}};
+		ADL_CHECK(log->flushes == expected);
+	}});
+
+	cases.push_back({"stream/allocates_nothing_outside_a_frame", [] {
+		adlStreamBuffer stream;
+		ADL_CHECK(!stream.beginFrame());
+
+		const auto log = makeStream(stream);
+		ADL_CHECK(stream.allocate(1).data == nullptr);
+		stream.endFrame();
+		ADL_CHECK(log->fences.empty());
+	}});
+
+	cases.push_back({"stream/releases_the_backend", [] {
+		std::shared_ptr<StreamLog> log;
+		{
+			adlStreamBuffer stream;
+			log = makeStream(stream);
+			ADL_CHECK(!log->isDestroyed);
+		}
+		ADL_CHECK(log->isDestroyed);
+	}});
+
+	cases.push_back({"stream/cpu_backend_never_blocks", [] {
+		adlStreamBuffer stream;
+		ADL_REQUIRE(stream.init(std::make_unique<adlCPUStreamBackend>(), 64));
+		for (int frame = 0; frame < 7; ++frame) {
+			ADL_REQUIRE(stream.beginFrame(0));
+			const auto allocation = stream.allocate(64, 1);
+			ADL_REQUIRE(allocation.data != nullptr);
+			std::memset(allocation.data, frame, 64);
+			stream.endFrame();
+		}
+		ADL_CHECK(stream.currentRegion() == 7 % adlStreamBuffer::REGION_COUNT);
+	}});
+}
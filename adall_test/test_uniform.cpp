@@ -0,0 +1,138 @@
+#include "adall/adal_view.h"
+
+#include "test.h"
+
+namespace {
+	/// One call a RecordingUniformBackend was asked to make.
+	struct UniformCall {
+		GLuint                 programID;
+		GLint                  location;
+		GLenum                 type;
+		GLsizei                count;
+		std::vector<std::byte> data;
+	};
+
+	class RecordingUniformBackend final : public adlUniformBackend {
+	public:
+		std::vector<UniformCall> calls;
+
+		void setUniform(const GLuint programID, const GLint location, const GLenum type, const GLsizei count, const void *data) override {
+			const auto *bytes = static_cast<const std::byte *>(data);
+			calls.push_back({programID, location, type, count, {bytes, bytes + adlUniformTypeSize(type) * static_cast<std::size_t>(count)}});
+		};
+	};
+
+	/// A program as adlShaderLoader::reflectUniforms() would describe it, without a GL context.
+	adlShader makeShader(const GLuint programID, const std::vector<std::tuple<std::string, GLenum, GLsizei> > &uniforms) {
+		adlShader shader{.shaderProgramID = programID, .uniforms = {}};
+		GLint     location = 0;
+		for (const auto &[name, type, count]: uniforms) {
+			shader.uniforms.uniforms.push_back({
+				.name = adlIntern(name),
+				.location = location++,
+				.type = type,
+				.count = count,
+				.shadowOffset = static_cast<std::uint32_t>(shader.uniforms.shadow.size()),
+				.isWritten = false,
+			});
+			shader.uniforms.shadow.resize(shader.uniforms.shadow.size() + adlUniformTypeSize(type) * static_cast<std::size_t>(count));
+		}
+		std::sort(shader.uniforms.uniforms.begin(), shader.uniforms.uniforms.end(), [](const adlUniform &lhs, const adlUniform &rhs) {
+			return lhs.name < rhs.name;
+		});
+		return shader;
+	}
+
+	adlShader makeSpriteShader(const GLuint programID) {
+		return makeShader(programID, {{"model", GL_FLOAT_MAT4, 1}, {"material", GL_SAMPLER_2D, 1}, {"tints", GL_FLOAT_VEC4, 4}});
+	}
+}
+
+void adlAddUniformTests(std::vector<adlTestCase> &cases) {
+	cases.push_back({"uniform/first_set_is_sent", [] {
+		RecordingUniformBackend backend;
+		adlUniformState         state(backend);
+		adlShader               shader = makeSpriteShader(7);
+
+		// a fresh program holds zeros, and a zero value must still reach it
+		const glm::mat4 model(0.0f);
+		ADL_CHECK(state.set(shader, adlIntern("model"), model));
+		ADL_REQUIRE(backend.calls.size() == 1);
+		ADL_CHECK(backend.calls[0].programID == 7);
+		ADL_CHECK(backend.calls[0].location == shader.uniforms.find(adlIntern("model"))->location);
+		ADL_CHECK(backend.calls[0].type == GL_FLOAT_MAT4);
+		ADL_CHECK(std::memcmp(backend.calls[0].data.data(), &model, sizeof(model)) == 0);
+		ADL_CHECK(state.submittedCount() == 1);
+		ADL_CHECK(state.skippedCount() == 0);
+	}});
+
+	cases.push_back({"uniform/unchanged_values_are_dropped", [] {
+		RecordingUniformBackend backend;
+		adlUniformState         state(backend);
+		adlShader               shader = makeSpriteShader(7);
+		const adlStringID       model  = adlIntern("model");
+
+		for (int frame = 0; frame < 10; ++frame) {
+			ADL_CHECK(state.set(shader, model, glm::mat4(1.0f)));
+			ADL_CHECK(state.set(shader, adlIntern("material"), GLint{0}));
+		}
+		ADL_CHECK(backend.calls.size() == 2);
+		ADL_CHECK(state.skippedCount() == 18);
+
+		ADL_CHECK(state.set(shader, model, glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 0.0f, 0.0f))));
+		ADL_CHECK(backend.calls.size() == 3);
+		ADL_CHECK(state.set(shader, model, glm::mat4(1.0f)));
+		ADL_CHECK(backend.calls.size() == 4);
+	}});
+
+	cases.push_back({"uniform/programs_are_tracked_apart", [] {
+		RecordingUniformBackend backend;
+		adlUniformState         state(backend);
+		adlShader               first  = makeSpriteShader(1);
+		adlShader               second = makeSpriteShader(2);
+
+		ADL_CHECK(state.set(first, adlIntern("material"), GLint{0}));
+		ADL_CHECK(state.set(second, adlIntern("material"), GLint{0}));
+		ADL_REQUIRE(backend.calls.size() == 2);
+		ADL_CHECK(backend.calls[1].programID == 2);
+
+		// a reloaded program comes with a fresh table, so it is sent its values again
+		second = makeSpriteShader(3);
+		ADL_CHECK(state.set(second, adlIntern("material"), GLint{0}));
+		ADL_CHECK(backend.calls.size() == 3);
+	}});
+
+	cases.push_back({"uniform/arrays_compare_the_elements_set", [] {
+		RecordingUniformBackend backend;
+		adlUniformState         state(backend);
+		adlShader               shader = makeSpriteShader(7);
+		const adlStringID       tints  = adlIntern("tints");
+
+		const std::array<glm::vec4, 4> colors = {glm::vec4(1.0f), glm::vec4(0.5f), glm::vec4(0.25f), glm::vec4(0.0f)};
+		ADL_CHECK(state.set(shader, tints, colors.data(), 4));
+		ADL_REQUIRE(backend.calls.size() == 1);
+		ADL_CHECK(backend.calls[0].count == 4);
+		ADL_CHECK(backend.calls[0].data.size() == sizeof(colors));
+
+		// a prefix equal to what was sent is dropped
+		ADL_CHECK(state.set(shader, tints, colors.data(), 2));
+		ADL_CHECK(backend.calls.size() == 1);
+	}});
+
+	cases.push_back({"uniform/bad_sets_fail", [] {
+		RecordingUniformBackend backend;
+		adlUniformState         state(backend);
+		adlShader               shader = makeSpriteShader(7);
+		const glm::vec4         color(1.0f);
+
+		ADL_CHECK(!state.set(shader, adlIntern("missing"), color));
+		ADL_CHECK(!state.set(shader, adlIntern("tints"), &color, 5));
+		ADL_CHECK(!state.set(shader, adlIntern("tints"), &color, 0));
+
+		adlShader unhandled = makeShader(8, {{"cube", GL_SAMPLER_CUBE, 1}});
+		ADL_CHECK(!state.set(unhandled, adlIntern("cube"), GLint{0}));
+
+		ADL_CHECK(backend.calls.empty());
+		ADL_CHECK(state.submittedCount() == 0);
+	}});
+}
@@ -1,6 +1,7 @@
 #version 410 core
 
 in vec2 fragmentTexCoord;
+in vec4 fragmentColor;
 
 out vec4 screenColor;
 
@@ -8,5 +9,5 @@ uniform sampler2D material;
 
 void main()
 {
-    screenColor = texture(material, fragmentTexCoord);
+    screenColor = texture(material, fragmentTexCoord) * fragmentColor;
 }
\ No newline at end of file
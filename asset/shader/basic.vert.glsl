@@ -2,15 +2,18 @@
 
 layout (location=0) in vec3 vertexPos;
 layout (location=1) in vec2 vertexTexCoord;
+layout (location=2) in vec4 vertexColor;
 
 out vec2 fragmentTexCoord;
+out vec4 fragmentColor;
+
+#include "frame.glsl"
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main()
 {
     gl_Position = projection * view * model * vec4(vertexPos, 1.0);
     fragmentTexCoord = vertexTexCoord;
-}
\ No newline at end of file
+    fragmentColor = vertexColor;
+}
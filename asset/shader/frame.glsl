@@ -0,0 +1,7 @@
+// per-frame data shared by every program, see adlFrameUniforms
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec4 time;
+};